@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//! \file
+
+#ifndef TNT_FILAMENT_BACKEND_FILEBLOBCACHE_H
+#define TNT_FILAMENT_BACKEND_FILEBLOBCACHE_H
+
+#include <backend/Platform.h>
+
+#include <utils/compiler.h>
+
+#include <stddef.h>
+
+namespace filament::backend {
+
+/**
+ * A Platform::BlobCache that stores each blob in its own file, in a directory.
+ *
+ * The total size of the cache is bounded, the least recently used blobs are evicted when it is
+ * exceeded. The order of use is saved to the directory when the cache is destroyed, so it carries
+ * over to the next run.
+ *
+ * Several FileBlobCache must not use the same directory at the same time.
+ *
+ * \code
+ * FileBlobCache cache("/path/to/cache", 64 * 1024 * 1024);
+ * platform->setBlobCache(&cache);
+ * Engine* engine = Engine::create(Engine::Backend::OPENGL, platform);
+ * \endcode
+ */
+class UTILS_PUBLIC FileBlobCache : public Platform::BlobCache {
+public:
+    /**
+     * @param directory path of the directory holding the cache, created if needed
+     * @param maxSize   maximum size of the blobs in the cache, in bytes
+     */
+    FileBlobCache(const char* directory, size_t maxSize) noexcept;
+
+    ~FileBlobCache() noexcept override;
+
+    FileBlobCache(FileBlobCache const& rhs) = delete;
+    FileBlobCache& operator=(FileBlobCache const& rhs) = delete;
+
+    void insert(const void* key, size_t keySize,
+            const void* value, size_t valueSize) noexcept override;
+
+    size_t retrieve(const void* key, size_t keySize,
+            void* value, size_t valueSize) noexcept override;
+
+    //! returns the size of all the blobs in the cache, in bytes
+    size_t getSize() const noexcept;
+
+private:
+    struct Impl;
+    Impl* mImpl;
+};
+
+} // namespace filament::backend
+
+#endif // TNT_FILAMENT_BACKEND_FILEBLOBCACHE_H
@@ -23,6 +23,8 @@
 
 #include <utils/compiler.h>
 
+#include <stddef.h>
+
 namespace filament {
 namespace backend {
 
@@ -37,6 +39,36 @@ public:
         uintptr_t image = 0;
     };
 
+    /**
+     * A key/value store of binary blobs that persists across runs, used by the backends to cache
+     * the results of expensive work, such as compiled shader programs.
+     *
+     * Keys and values are opaque, keys include the identity of the driver that produced the
+     * values. Implementations must be thread safe and are free to drop entries at any time.
+     *
+     * @see FileBlobCache
+     */
+    class UTILS_PUBLIC BlobCache {
+    public:
+        virtual ~BlobCache() noexcept;
+
+        /**
+         * Stores a copy of the value associated with the given key, replacing any previous value.
+         */
+        virtual void insert(const void* key, size_t keySize,
+                const void* value, size_t valueSize) noexcept = 0;
+
+        /**
+         * Retrieves the value associated with the given key.
+         *
+         * @return the size of the value, or 0 if the key is not in the cache. The value is only
+         *         copied if \p valueSize is large enough to hold it, so calling this with a
+         *         \p valueSize of 0 returns the size to allocate.
+         */
+        virtual size_t retrieve(const void* key, size_t keySize,
+                void* value, size_t valueSize) noexcept = 0;
+    };
+
     virtual ~Platform() noexcept;
 
     /**
@@ -66,6 +98,29 @@ public:
      * thread, or if the platform does not need to perform any special processing.
      */
     virtual bool pumpEvents() noexcept { return false; }
+
+    /**
+     * Sets the cache used by insertBlob() and retrieveBlob(), none by default. The cache must
+     * outlive the Engine using this Platform.
+     */
+    void setBlobCache(BlobCache* blobCache) noexcept { mBlobCache = blobCache; }
+
+    /**
+     * Stores a blob in the persistent cache, by default this forwards to the BlobCache set with
+     * setBlobCache(), if any. Called from the backend's thread.
+     */
+    virtual void insertBlob(const void* key, size_t keySize,
+            const void* value, size_t valueSize) noexcept;
+
+    /**
+     * Retrieves a blob from the persistent cache, see BlobCache::retrieve(). By default this
+     * forwards to the BlobCache set with setBlobCache(), if any. Called from the backend's thread.
+     */
+    virtual size_t retrieveBlob(const void* key, size_t keySize,
+            void* value, size_t valueSize) noexcept;
+
+private:
+    BlobCache* mBlobCache = nullptr;
 };
 
 
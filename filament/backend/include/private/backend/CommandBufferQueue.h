@@ -48,6 +48,7 @@ class CommandBufferQueue {
     mutable std::vector<Slice> mCommandBuffersToExecute;
     size_t mFreeSpace = 0;
     size_t mHighWatermark = 0;
+    uint64_t mFlushedSize = 0;
     uint32_t mExitRequested = 0;
 
     static constexpr uint32_t EXIT_REQUESTED = 0x31415926;
@@ -61,6 +62,9 @@ public:
 
     size_t getHighWatermark() const noexcept { return mHighWatermark; }
 
+    // total size of the commands flushed so far, only valid on the thread calling flush()
+    uint64_t getFlushedSize() const noexcept { return mFlushedSize; }
+
     // wait for commands to be available and returns an array containing these commands
     std::vector<Slice> waitForCommands() const;
 
@@ -66,6 +66,11 @@ public:
     // sets the material name and variant for diagnostic purposes only
     Program& diagnostics(utils::CString const& name, Variant variant);
 
+    // sets an identifier of this program's content, that is stable across runs. Backends can
+    // use it as the key of a persistent program cache (see Platform::BlobCache), 0 disables
+    // caching.
+    Program& cacheId(uint64_t cacheId) noexcept;
+
     // sets one of the program's shader (e.g. vertex, fragment)
     Program& shader(Shader shader, void const* data, size_t size) noexcept;
 
@@ -105,6 +110,8 @@ public:
 
     Variant getVariant() const noexcept { return mVariant; }
 
+    uint64_t getCacheId() const noexcept { return mCacheId; }
+
     bool hasSamplers() const noexcept { return mHasSamplers; }
 
 private:
@@ -116,6 +123,7 @@ private:
     SamplerGroupInfo mSamplerGroups = {};
     std::array<ShaderBlob, SHADER_TYPE_COUNT> mShadersSource;
     utils::CString mName;
+    uint64_t mCacheId = 0;
     bool mHasSamplers = false;
     Variant mVariant;
 };
@@ -0,0 +1,277 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <backend/FileBlobCache.h>
+
+#include <utils/Hash.h>
+#include <utils/Log.h>
+#include <utils/Path.h>
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+using namespace utils;
+
+namespace filament::backend {
+
+// Each blob is stored in its own file, named after the hash of its key. The file starts with a
+// header, followed by the key, which is compared on retrieval to rule out hash collisions, then by
+// the value.
+struct BlobHeader {
+    uint32_t magic;
+    uint32_t keySize;
+    uint64_t valueSize;
+};
+
+static constexpr uint32_t BLOB_MAGIC = 0x31434246; // "FBC1"
+static constexpr const char* BLOB_EXTENSION = "blob";
+static constexpr const char* INDEX_NAME = "index";
+
+struct FileBlobCache::Impl {
+    struct Entry {
+        uint64_t hash;
+        size_t size;    // size of the file
+    };
+
+    // most recently used first
+    using EntryList = std::list<Entry>;
+
+    Impl(const char* directory, size_t maxSize) : directory(directory), maxSize(maxSize) {}
+
+    Path getBlobPath(uint64_t hash) const;
+    void load();
+    void saveIndex() const;
+    void remove(EntryList::iterator pos);
+    void evict();
+
+    const Path directory;
+    const size_t maxSize;
+    size_t size = 0;
+    EntryList entries;
+    std::unordered_map<uint64_t, EntryList::iterator> map;
+    mutable std::mutex lock;
+};
+
+Path FileBlobCache::Impl::getBlobPath(uint64_t hash) const {
+    char name[32];
+    snprintf(name, sizeof(name), "%016" PRIx64 ".%s", hash, BLOB_EXTENSION);
+    return directory.concat(name);
+}
+
+static size_t getFileSize(Path const& path) {
+    std::unique_ptr<FILE, decltype(&fclose)> file(fopen(path.c_str(), "rb"), &fclose);
+    if (!file || fseek(file.get(), 0, SEEK_END) != 0) {
+        return 0;
+    }
+    long size = ftell(file.get());
+    return size > 0 ? size_t(size) : 0;
+}
+
+void FileBlobCache::Impl::load() {
+    if (!directory.mkdirRecursive()) {
+        slog.w << "FileBlobCache: cannot create " << directory.c_str() << io::endl;
+        return;
+    }
+
+    // find all the blobs in the directory
+    std::unordered_map<uint64_t, Path> blobs;
+    for (Path const& path : directory.listContents()) {
+        if (path.getExtension() == BLOB_EXTENSION) {
+            std::string name = path.getNameWithoutExtension();
+            char* end = nullptr;
+            uint64_t hash = strtoull(name.c_str(), &end, 16);
+            if (end && *end == '\0' && !name.empty()) {
+                blobs[hash] = path;
+            }
+        }
+    }
+
+    // the index records the blobs from the most to the least recently used
+    FILE* index = fopen(directory.concat(INDEX_NAME).c_str(), "r");
+    if (index) {
+        uint64_t hash;
+        uint64_t fileSize;
+        while (fscanf(index, "%" SCNx64 " %" SCNu64, &hash, &fileSize) == 2) {
+            auto pos = blobs.find(hash);
+            if (pos != blobs.end() && map.find(hash) == map.end()) {
+                entries.push_back({ hash, size_t(fileSize) });
+                map[hash] = std::prev(entries.end());
+                size += size_t(fileSize);
+                blobs.erase(pos);
+            }
+        }
+        fclose(index);
+    }
+
+    // blobs missing from the index (e.g. if the process was killed) are the least recently used
+    for (auto const& [hash, path] : blobs) {
+        const size_t fileSize = getFileSize(path);
+        entries.push_back({ hash, fileSize });
+        map[hash] = std::prev(entries.end());
+        size += fileSize;
+    }
+
+    evict();
+}
+
+void FileBlobCache::Impl::saveIndex() const {
+    const std::string path = directory.concat(INDEX_NAME).getPath();
+    const std::string temp = path + ".tmp";
+    FILE* index = fopen(temp.c_str(), "w");
+    if (!index) {
+        return;
+    }
+    bool ok = true;
+    for (Entry const& entry : entries) {
+        ok = ok && fprintf(index, "%016" PRIx64 " %" PRIu64 "\n",
+                entry.hash, uint64_t(entry.size)) > 0;
+    }
+    ok = (fclose(index) == 0) && ok;
+    // rename() doesn't replace existing files on all platforms
+    ::remove(path.c_str());
+    if (!ok || ::rename(temp.c_str(), path.c_str()) != 0) {
+        ::remove(temp.c_str());
+    }
+}
+
+void FileBlobCache::Impl::remove(EntryList::iterator pos) {
+    ::remove(getBlobPath(pos->hash).c_str());
+    size -= pos->size;
+    map.erase(pos->hash);
+    entries.erase(pos);
+}
+
+void FileBlobCache::Impl::evict() {
+    while (size > maxSize && !entries.empty()) {
+        remove(std::prev(entries.end()));
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+
+FileBlobCache::FileBlobCache(const char* directory, size_t maxSize) noexcept
+        : mImpl(new Impl(directory, maxSize)) {
+    mImpl->load();
+}
+
+FileBlobCache::~FileBlobCache() noexcept {
+    mImpl->saveIndex();
+    delete mImpl;
+}
+
+size_t FileBlobCache::getSize() const noexcept {
+    std::lock_guard<std::mutex> guard(mImpl->lock);
+    return mImpl->size;
+}
+
+void FileBlobCache::insert(const void* key, size_t keySize,
+        const void* value, size_t valueSize) noexcept {
+    const size_t fileSize = sizeof(BlobHeader) + keySize + valueSize;
+    if (keySize > UINT32_MAX || fileSize > mImpl->maxSize) {
+        return;
+    }
+
+    const uint64_t hash = hash::fnv1a(key, keySize);
+
+    std::lock_guard<std::mutex> guard(mImpl->lock);
+
+    auto pos = mImpl->map.find(hash);
+    if (pos != mImpl->map.end()) {
+        mImpl->remove(pos->second);
+    }
+
+    // write to a temporary file first, so that a partially written blob is never picked up
+    const std::string path = mImpl->getBlobPath(hash).getPath();
+    const std::string temp = path + ".tmp";
+    FILE* file = fopen(temp.c_str(), "wb");
+    if (!file) {
+        return;
+    }
+    const BlobHeader header = { BLOB_MAGIC, uint32_t(keySize), uint64_t(valueSize) };
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+              fwrite(key, 1, keySize, file) == keySize &&
+              fwrite(value, 1, valueSize, file) == valueSize;
+    ok = (fclose(file) == 0) && ok;
+    if (!ok || ::rename(temp.c_str(), path.c_str()) != 0) {
+        ::remove(temp.c_str());
+        return;
+    }
+
+    mImpl->entries.push_front({ hash, fileSize });
+    mImpl->map[hash] = mImpl->entries.begin();
+    mImpl->size += fileSize;
+    mImpl->evict();
+}
+
+size_t FileBlobCache::retrieve(const void* key, size_t keySize,
+        void* value, size_t valueSize) noexcept {
+    const uint64_t hash = hash::fnv1a(key, keySize);
+
+    std::lock_guard<std::mutex> guard(mImpl->lock);
+
+    auto pos = mImpl->map.find(hash);
+    if (pos == mImpl->map.end()) {
+        return 0;
+    }
+
+    std::unique_ptr<FILE, decltype(&fclose)> file(
+            fopen(mImpl->getBlobPath(hash).c_str(), "rb"), &fclose);
+
+    BlobHeader header{};
+    bool ok = file && fread(&header, sizeof(header), 1, file.get()) == 1 &&
+            header.magic == BLOB_MAGIC;
+    if (!ok) {
+        // the blob is unreadable, forget about it
+        mImpl->remove(pos->second);
+        return 0;
+    }
+
+    if (header.keySize != keySize) {
+        return 0;
+    }
+    std::unique_ptr<uint8_t[]> storedKey(new uint8_t[keySize]);
+    if (fread(storedKey.get(), 1, keySize, file.get()) != keySize) {
+        mImpl->remove(pos->second);
+        return 0;
+    }
+    if (memcmp(storedKey.get(), key, keySize) != 0) {
+        // hash collision
+        return 0;
+    }
+
+    if (value && valueSize >= header.valueSize) {
+        if (fread(value, 1, header.valueSize, file.get()) != header.valueSize) {
+            mImpl->remove(pos->second);
+            return 0;
+        }
+    }
+
+    // this is now the most recently used blob
+    auto& entries = mImpl->entries;
+    entries.splice(entries.begin(), entries, pos->second);
+
+    return size_t(header.valueSize);
+}
+
+} // namespace filament::backend
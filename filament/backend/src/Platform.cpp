@@ -83,6 +83,20 @@ namespace backend {
 // this generates the vtable in this translation unit
 Platform::~Platform() noexcept = default;
 
+Platform::BlobCache::~BlobCache() noexcept = default;
+
+void Platform::insertBlob(const void* key, size_t keySize,
+        const void* value, size_t valueSize) noexcept {
+    if (mBlobCache) {
+        mBlobCache->insert(key, keySize, value, valueSize);
+    }
+}
+
+size_t Platform::retrieveBlob(const void* key, size_t keySize,
+        void* value, size_t valueSize) noexcept {
+    return mBlobCache ? mBlobCache->retrieve(key, keySize, value, valueSize) : 0;
+}
+
 // Creates the platform-specific Platform object. The caller takes ownership and is
 // responsible for destroying it. Initialization of the backend API is deferred until
 // createDriver(). The passed-in backend hint is replaced with the resolved backend.
@@ -33,6 +33,11 @@ Program& Program::diagnostics(utils::CString const& name, Variant variant) {
     return *this;
 }
 
+Program& Program::cacheId(uint64_t cacheId) noexcept {
+    mCacheId = cacheId;
+    return *this;
+}
+
 Program& Program::shader(Program::Shader shader, void const* data, size_t size) noexcept {
     ShaderBlob blob(size);
     std::copy_n((const uint8_t *)data, size, blob.data());
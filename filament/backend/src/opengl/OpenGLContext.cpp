@@ -139,6 +139,9 @@ OpenGLContext::OpenGLContext() noexcept {
     glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &gets.uniform_buffer_offset_alignment);
     glGetIntegerv(GL_MAX_SAMPLES, &gets.max_samples);
     glGetIntegerv(GL_MAX_DRAW_BUFFERS, &gets.max_draw_buffers);
+#if !defined(__EMSCRIPTEN__)
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &gets.num_program_binary_formats);
+#endif
 #ifdef GL_EXT_texture_filter_anisotropic
     if (ext.EXT_texture_filter_anisotropic) {
         glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &gets.max_anisotropy);
@@ -154,6 +157,7 @@ OpenGLContext::OpenGLContext() noexcept {
             << "GL_MAX_SAMPLES = " << gets.max_samples << '\n'
             << "GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT = " << gets.max_anisotropy << '\n'
             << "GL_MAX_UNIFORM_BLOCK_SIZE = " << gets.max_uniform_block_size << '\n'
+            << "GL_NUM_PROGRAM_BINARY_FORMATS = " << gets.num_program_binary_formats << '\n'
             << "GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT = " << gets.uniform_buffer_offset_alignment << '\n'
             ;
     flush(slog.v);
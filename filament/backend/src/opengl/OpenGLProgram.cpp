@@ -24,8 +24,15 @@
 #include <utils/debug.h>
 
 #include <private/backend/BackendUtils.h>
+#include <private/backend/OpenGLPlatform.h>
 
 #include <ctype.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
 
 namespace filament {
 
@@ -40,6 +47,67 @@ static void logCompilationError(utils::io::ostream& out,
 static void logProgramLinkError(utils::io::ostream& out,
         const char* name, GLuint program) noexcept;
 
+// Program binaries are only valid for the driver that produced them, so the driver's identity is
+// part of their key in the platform's blob cache.
+static std::string getProgramBinaryKey(uint64_t cacheId) noexcept {
+    char id[32];
+    snprintf(id, sizeof(id), "%016" PRIx64, cacheId);
+    std::string key("filament-gl-program:");
+    key += id;
+    for (GLenum name : { GL_VENDOR, GL_RENDERER, GL_VERSION }) {
+        const char* str = (const char*)glGetString(name);
+        key += ':';
+        key += str ? str : "";
+    }
+    return key;
+}
+
+static GLuint loadProgramBinary(Platform& platform, std::string const& key) noexcept {
+#if !defined(__EMSCRIPTEN__)
+    // the blob is the binary format followed by the binary
+    const size_t size = platform.retrieveBlob(key.data(), key.size(), nullptr, 0);
+    if (size <= sizeof(GLenum)) {
+        return 0;
+    }
+    std::vector<uint8_t> blob(size);
+    if (platform.retrieveBlob(key.data(), key.size(), blob.data(), size) != size) {
+        return 0;
+    }
+    GLenum format;
+    memcpy(&format, blob.data(), sizeof(format));
+    GLuint program = glCreateProgram();
+    glProgramBinary(program, format, blob.data() + sizeof(format), GLsizei(size - sizeof(format)));
+    // the driver can reject the binary, e.g. after an update, we then compile the program again
+    GLint status = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &status);
+    if (status != GL_TRUE) {
+        glDeleteProgram(program);
+        return 0;
+    }
+    return program;
+#else
+    return 0;
+#endif
+}
+
+static void storeProgramBinary(Platform& platform, std::string const& key,
+        GLuint program) noexcept {
+#if !defined(__EMSCRIPTEN__)
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) {
+        return;
+    }
+    GLenum format = 0;
+    std::vector<uint8_t> blob(sizeof(format) + length);
+    glGetProgramBinary(program, length, &length, &format, blob.data() + sizeof(format));
+    if (glGetError() == GL_NO_ERROR && length > 0) {
+        memcpy(blob.data(), &format, sizeof(format));
+        platform.insertBlob(key.data(), key.size(), blob.data(), sizeof(format) + length);
+    }
+#endif
+}
+
 OpenGLProgram::OpenGLProgram(OpenGLDriver* gl, const Program& programBuilder) noexcept
         :  HwProgram(programBuilder.getName()), mIsValid(false) {
 
@@ -48,9 +116,18 @@ OpenGLProgram::OpenGLProgram(OpenGLDriver* gl, const Program& programBuilder) no
     const auto& shadersSource = programBuilder.getShadersSource();
     OpenGLContext& context = gl->getContext();
 
+    // Programs that have a cache id can be restored from the binary saved by a previous run,
+    // which skips compiling and linking their shaders.
+    GLuint program = 0;
+    std::string binaryKey;
+    if (programBuilder.getCacheId() && context.gets.num_program_binary_formats > 0) {
+        binaryKey = getProgramBinaryKey(programBuilder.getCacheId());
+        program = loadProgramBinary(gl->mPlatform, binaryKey);
+    }
+
     // build all shaders
     #pragma nounroll
-    for (size_t i = 0; i < Program::SHADER_TYPE_COUNT; i++) {
+    for (size_t i = 0; i < Program::SHADER_TYPE_COUNT && !program; i++) {
         GLenum glShaderType;
         Shader type = (Shader)i;
         switch (type) {
@@ -153,21 +230,32 @@ highp uint packHalf2x16(vec2 v) {
     // we need at least a vertex and fragment program
     const uint8_t validShaderSet = mValidShaderSet;
     const uint8_t mask = VERTEX_SHADER_BIT | FRAGMENT_SHADER_BIT;
-    if (UTILS_LIKELY((mValidShaderSet & mask) == mask)) {
-        GLint status;
-        GLuint program = glCreateProgram();
-        for (size_t i = 0; i < Program::SHADER_TYPE_COUNT; i++) {
-            if (validShaderSet & (1U << i)) {
-                glAttachShader(program, this->gl.shaders[i]);
+    if (UTILS_LIKELY(program || (mValidShaderSet & mask) == mask)) {
+        if (!program) {
+            GLint status;
+            program = glCreateProgram();
+            for (size_t i = 0; i < Program::SHADER_TYPE_COUNT; i++) {
+                if (validShaderSet & (1U << i)) {
+                    glAttachShader(program, this->gl.shaders[i]);
+                }
             }
-        }
-        glLinkProgram(program);
+#if !defined(__EMSCRIPTEN__)
+            if (!binaryKey.empty()) {
+                glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+            }
+#endif
+            glLinkProgram(program);
 
-        glGetProgramiv(program, GL_LINK_STATUS, &status);
-        if (UTILS_UNLIKELY(status != GL_TRUE)) {
-            logProgramLinkError(slog.e, programBuilder.getName().c_str_safe(), program);
-            glDeleteProgram(program);
-            return;
+            glGetProgramiv(program, GL_LINK_STATUS, &status);
+            if (UTILS_UNLIKELY(status != GL_TRUE)) {
+                logProgramLinkError(slog.e, programBuilder.getName().c_str_safe(), program);
+                glDeleteProgram(program);
+                return;
+            }
+
+            if (!binaryKey.empty()) {
+                storeProgramBinary(gl->mPlatform, binaryKey, program);
+            }
         }
 
         this->gl.program = program;
@@ -0,0 +1,210 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <backend/FileBlobCache.h>
+
+#include <utils/Hash.h>
+#include <utils/Path.h>
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+using namespace filament::backend;
+using namespace utils;
+
+namespace {
+
+// blobs are stored with a 16 bytes header, followed by the key and the value
+constexpr size_t VALUE_SIZE = 100;
+constexpr size_t BLOB_SIZE = 16 + 4 + VALUE_SIZE;
+
+class FileBlobCacheTest : public testing::Test {
+protected:
+    void SetUp() override {
+        const testing::TestInfo* info = testing::UnitTest::GetInstance()->current_test_info();
+        mDirectory = Path(testing::TempDir()).concat(
+                std::string("test_blob_cache_") + info->name());
+        clear();
+    }
+
+    void TearDown() override {
+        clear();
+    }
+
+    void clear() {
+        for (Path path : mDirectory.listContents()) {
+            path.unlinkFile();
+        }
+    }
+
+    // keys are 4 bytes long, e.g. "key0"
+    static std::string key(int i) {
+        return "key" + std::to_string(i);
+    }
+
+    static std::vector<uint8_t> value(int i) {
+        return std::vector<uint8_t>(VALUE_SIZE, uint8_t(i));
+    }
+
+    static void insert(FileBlobCache& cache, int i) {
+        const std::string k = key(i);
+        const std::vector<uint8_t> v = value(i);
+        cache.insert(k.data(), k.size(), v.data(), v.size());
+    }
+
+    // returns true if the blob is in the cache, with the expected value
+    static bool retrieve(FileBlobCache& cache, int i) {
+        const std::string k = key(i);
+        std::vector<uint8_t> v(VALUE_SIZE);
+        if (cache.retrieve(k.data(), k.size(), v.data(), v.size()) != VALUE_SIZE) {
+            return false;
+        }
+        return v == value(i);
+    }
+
+    Path getBlobPath(int i) const {
+        const std::string k = key(i);
+        char name[32];
+        snprintf(name, sizeof(name), "%016" PRIx64 ".blob", hash::fnv1a(k.data(), k.size()));
+        return mDirectory.concat(name);
+    }
+
+    Path mDirectory;
+};
+
+} // anonymous namespace
+
+TEST_F(FileBlobCacheTest, InsertRetrieve) {
+    FileBlobCache cache(mDirectory.c_str(), 10 * BLOB_SIZE);
+    EXPECT_EQ(0, cache.getSize());
+    EXPECT_FALSE(retrieve(cache, 0));
+
+    insert(cache, 0);
+    insert(cache, 1);
+    EXPECT_EQ(2 * BLOB_SIZE, cache.getSize());
+    EXPECT_TRUE(retrieve(cache, 0));
+    EXPECT_TRUE(retrieve(cache, 1));
+    EXPECT_FALSE(retrieve(cache, 2));
+
+    // the size of the value can be queried without retrieving it
+    const std::string k = key(0);
+    EXPECT_EQ(VALUE_SIZE, cache.retrieve(k.data(), k.size(), nullptr, 0));
+    uint8_t small[4] = {};
+    EXPECT_EQ(VALUE_SIZE, cache.retrieve(k.data(), k.size(), small, sizeof(small)));
+    EXPECT_EQ(0, small[0]);
+
+    // inserting the same key again replaces the blob
+    const std::vector<uint8_t> v(VALUE_SIZE, 42);
+    cache.insert(k.data(), k.size(), v.data(), v.size());
+    EXPECT_EQ(2 * BLOB_SIZE, cache.getSize());
+    std::vector<uint8_t> retrieved(VALUE_SIZE);
+    EXPECT_EQ(VALUE_SIZE, cache.retrieve(k.data(), k.size(), retrieved.data(), retrieved.size()));
+    EXPECT_EQ(v, retrieved);
+
+    // blobs larger than the cache are ignored
+    const std::vector<uint8_t> large(10 * BLOB_SIZE);
+    cache.insert(k.data(), k.size(), large.data(), large.size());
+    EXPECT_EQ(VALUE_SIZE, cache.retrieve(k.data(), k.size(), nullptr, 0));
+}
+
+TEST_F(FileBlobCacheTest, LeastRecentlyUsedEviction) {
+    FileBlobCache cache(mDirectory.c_str(), 3 * BLOB_SIZE);
+    insert(cache, 0);
+    insert(cache, 1);
+    insert(cache, 2);
+    EXPECT_EQ(3 * BLOB_SIZE, cache.getSize());
+
+    // using blob 0 makes blob 1 the least recently used one
+    EXPECT_TRUE(retrieve(cache, 0));
+    insert(cache, 3);
+    EXPECT_EQ(3 * BLOB_SIZE, cache.getSize());
+    EXPECT_FALSE(retrieve(cache, 1));
+    EXPECT_FALSE(getBlobPath(1).exists());
+    EXPECT_TRUE(retrieve(cache, 2));
+    EXPECT_TRUE(retrieve(cache, 0));
+    EXPECT_TRUE(retrieve(cache, 3));
+
+    // blob 2 is now the least recently used one
+    insert(cache, 4);
+    EXPECT_FALSE(retrieve(cache, 2));
+    EXPECT_TRUE(retrieve(cache, 0));
+    EXPECT_TRUE(retrieve(cache, 3));
+    EXPECT_TRUE(retrieve(cache, 4));
+}
+
+TEST_F(FileBlobCacheTest, KeyCollision) {
+    {
+        FileBlobCache cache(mDirectory.c_str(), 10 * BLOB_SIZE);
+        insert(cache, 0);
+    }
+
+    // Simulate a hash collision: the file that blob 1 would use holds blob 0, whose key differs.
+    ASSERT_EQ(0, rename(getBlobPath(0).c_str(), getBlobPath(1).c_str()));
+
+    FileBlobCache cache(mDirectory.c_str(), 10 * BLOB_SIZE);
+    EXPECT_FALSE(retrieve(cache, 1));
+    EXPECT_FALSE(retrieve(cache, 0));
+
+    // the colliding blob is replaced by the next insertion
+    insert(cache, 1);
+    EXPECT_TRUE(retrieve(cache, 1));
+    EXPECT_EQ(BLOB_SIZE, cache.getSize());
+}
+
+TEST_F(FileBlobCacheTest, IndexPersistence) {
+    {
+        FileBlobCache cache(mDirectory.c_str(), 3 * BLOB_SIZE);
+        insert(cache, 0);
+        insert(cache, 1);
+        insert(cache, 2);
+        // from the most to the least recently used: 1, 2, 0
+        EXPECT_TRUE(retrieve(cache, 0));
+        EXPECT_TRUE(retrieve(cache, 2));
+        EXPECT_TRUE(retrieve(cache, 1));
+    }
+
+    {
+        // the blobs and their order of use carry over to the next instance
+        FileBlobCache cache(mDirectory.c_str(), 3 * BLOB_SIZE);
+        EXPECT_EQ(3 * BLOB_SIZE, cache.getSize());
+        insert(cache, 3);
+        EXPECT_FALSE(retrieve(cache, 0));
+        EXPECT_TRUE(retrieve(cache, 2));
+        EXPECT_TRUE(retrieve(cache, 1));
+        EXPECT_TRUE(retrieve(cache, 3));
+        // from the most to the least recently used: 3, 1, 2
+    }
+
+    {
+        // a smaller cache evicts the least recently used blobs when it is loaded
+        FileBlobCache cache(mDirectory.c_str(), 2 * BLOB_SIZE);
+        EXPECT_EQ(2 * BLOB_SIZE, cache.getSize());
+        EXPECT_FALSE(retrieve(cache, 2));
+        EXPECT_TRUE(retrieve(cache, 1));
+        EXPECT_TRUE(retrieve(cache, 3));
+    }
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -112,7 +112,7 @@ TEST_F(BackendTest, RenderExternalImageWithoutSet) {
 
     // Render a triangle.
     getDriverApi().beginRenderPass(defaultRenderTarget, params);
-    getDriverApi().draw(state, triangle.getRenderPrimitive());
+    getDriverApi().draw(state, triangle.getRenderPrimitive(), 1);
     getDriverApi().endRenderPass();
 
     getDriverApi().flush();
@@ -228,7 +228,7 @@ TEST_F(BackendTest, RenderExternalImage) {
 
     // Render a triangle.
     getDriverApi().beginRenderPass(defaultRenderTarget, params);
-    getDriverApi().draw(state, triangle.getRenderPrimitive());
+    getDriverApi().draw(state, triangle.getRenderPrimitive(), 1);
     getDriverApi().endRenderPass();
 
     getDriverApi().flush();
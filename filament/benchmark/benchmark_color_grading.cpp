@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PerformanceCounters.h"
+
+#include <benchmark/benchmark.h>
+
+#include <filament/ColorGrading.h>
+#include <filament/Engine.h>
+#include <filament/ToneMapper.h>
+
+#include <math/vec3.h>
+
+using namespace filament;
+using namespace filament::math;
+
+// These benchmarks measure the generation of the color grading LUT, which evaluates the grading
+// one row of the LUT at a time. The LUT cache is defeated by changing the tone mapper every
+// iteration. state.range(0) is the dimension of the LUT, state.range(1) enables the adjustments
+// (white balance, channel mixer, curves...) on top of tone mapping.
+class ColorGradingFixture : public benchmark::Fixture {
+protected:
+    Engine* engine = nullptr;
+
+public:
+    void SetUp(benchmark::State&) override {
+        engine = Engine::create(Engine::Backend::NOOP);
+    }
+
+    void TearDown(benchmark::State&) override {
+        Engine::destroy(&engine);
+    }
+
+    void build(benchmark::State& state, bool cached) {
+        const size_t dimension = size_t(state.range(0));
+        const bool adjustments = state.range(1) != 0;
+        float contrast = 1.5f;
+        {
+            PerformanceCounters pc(state);
+            for (auto _ : state) {
+                GenericToneMapper toneMapper(contrast);
+                if (!cached) {
+                    contrast = contrast < 2.0f ? contrast + 1e-4f : 1.5f;
+                }
+                ColorGrading::Builder builder;
+                builder.dimensions(uint8_t(dimension))
+                        .format(ColorGrading::LutFormat::FLOAT)
+                        .toneMapper(&toneMapper);
+                if (adjustments) {
+                    builder.whiteBalance(0.1f, 0.05f)
+                            .channelMixer({ 0.9f, 0.1f, 0.0f }, { 0.0f, 1.0f, 0.0f },
+                                    { 0.0f, 0.1f, 0.9f })
+                            .contrast(1.1f)
+                            .saturation(1.2f)
+                            .curves(float3{ 1.1f }, float3{ 1.0f }, float3{ 0.9f });
+                }
+                ColorGrading* colorGrading = builder.build(*engine);
+                engine->destroy(colorGrading);
+                benchmark::ClobberMemory();
+            }
+            pc.stop();
+            state.SetItemsProcessed(int64_t(state.iterations() * dimension * dimension * dimension));
+        }
+        // keep the command buffers from growing
+        engine->flushAndWait();
+    }
+};
+
+BENCHMARK_DEFINE_F(ColorGradingFixture, generateLut)(benchmark::State& state) {
+    build(state, false);
+}
+
+BENCHMARK_DEFINE_F(ColorGradingFixture, cachedLut)(benchmark::State& state) {
+    build(state, true);
+}
+
+BENCHMARK_REGISTER_F(ColorGradingFixture, generateLut)
+        ->Ranges({ { 16, 64 }, { 0, 1 } });
+BENCHMARK_REGISTER_F(ColorGradingFixture, cachedLut)
+        ->Ranges({ { 32, 32 }, { 0, 1 } });
@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PerformanceCounters.h"
+
+#include <benchmark/benchmark.h>
+
+#include <filament/Engine.h>
+#include <filament/Material.h>
+#include <filament/MaterialInstance.h>
+
+#include <filamat/MaterialBuilder.h>
+
+#include <math/vec4.h>
+
+#include <string>
+#include <vector>
+
+using namespace filament;
+using namespace filament::math;
+using namespace filamat;
+using namespace utils;
+
+// These benchmarks compare the ways MaterialInstance can update its parameters: by name, through a
+// ParameterHandle and with the bulk MaterialInstance::setParameters(). They run on a Material
+// built with filamat and the NOOP backend, so only the CPU side of these calls is measured.
+class MaterialParametersFixture : public benchmark::Fixture {
+protected:
+    static constexpr size_t INSTANCE_COUNT = 1024;
+    static constexpr size_t PARAMETER_COUNT = 8;
+
+    Engine* engine = nullptr;
+    Material* material = nullptr;
+    std::vector<std::string> names;
+    std::vector<MaterialInstance::ParameterHandle<float4>> handles;
+    std::vector<MaterialInstance*> instances;
+    std::vector<float4> values;
+
+public:
+    void SetUp(benchmark::State&) override {
+        engine = Engine::create(Engine::Backend::NOOP);
+
+        MaterialBuilder::init();
+        MaterialBuilder builder;
+        builder.name("parameters")
+                .material("void material(inout MaterialInputs material) {\n"
+                          "    prepareMaterial(material);\n"
+                          "    material.baseColor = materialParams.parameter0;\n"
+                          "}\n")
+                .shading(MaterialBuilder::Shading::UNLIT);
+        names.clear();
+        for (size_t i = 0; i < PARAMETER_COUNT; i++) {
+            names.push_back("parameter" + std::to_string(i));
+            builder.parameter(MaterialBuilder::UniformType::FLOAT4, names.back().c_str());
+        }
+        Package pkg = builder.build(engine->getJobSystem());
+        material = Material::Builder().package(pkg.getData(), pkg.getSize()).build(*engine);
+
+        handles.clear();
+        for (std::string const& name : names) {
+            handles.push_back(material->getParameterHandle<float4>(name.c_str()));
+        }
+
+        instances.clear();
+        for (size_t i = 0; i < INSTANCE_COUNT; i++) {
+            instances.push_back(material->createInstance());
+        }
+
+        values.resize(INSTANCE_COUNT * PARAMETER_COUNT);
+        for (size_t i = 0; i < values.size(); i++) {
+            values[i] = float4(float(i));
+        }
+    }
+
+    void TearDown(benchmark::State&) override {
+        for (MaterialInstance* mi : instances) {
+            engine->destroy(mi);
+        }
+        engine->destroy(material);
+        Engine::destroy(&engine);
+        MaterialBuilder::shutdown();
+    }
+};
+
+BENCHMARK_F(MaterialParametersFixture, setParameterByName)(benchmark::State& state) {
+    {
+        PerformanceCounters pc(state);
+        for (auto _ : state) {
+            float4 const* value = values.data();
+            for (MaterialInstance* mi : instances) {
+                for (std::string const& name : names) {
+                    mi->setParameter(name.c_str(), *value);
+                    value++;
+                }
+            }
+            benchmark::ClobberMemory();
+        }
+        pc.stop();
+        state.SetItemsProcessed(state.iterations() * INSTANCE_COUNT * PARAMETER_COUNT);
+    }
+}
+
+BENCHMARK_F(MaterialParametersFixture, setParameterByHandle)(benchmark::State& state) {
+    {
+        PerformanceCounters pc(state);
+        for (auto _ : state) {
+            float4 const* value = values.data();
+            for (MaterialInstance* mi : instances) {
+                for (auto handle : handles) {
+                    mi->setParameter(handle, *value);
+                    value++;
+                }
+            }
+            benchmark::ClobberMemory();
+        }
+        pc.stop();
+        state.SetItemsProcessed(state.iterations() * INSTANCE_COUNT * PARAMETER_COUNT);
+    }
+}
+
+BENCHMARK_F(MaterialParametersFixture, setParametersBulk)(benchmark::State& state) {
+    {
+        PerformanceCounters pc(state);
+        for (auto _ : state) {
+            MaterialInstance::setParameters(instances.data(), instances.size(),
+                    handles.data(), handles.size(), values.data());
+            benchmark::ClobberMemory();
+        }
+        pc.stop();
+        state.SetItemsProcessed(state.iterations() * INSTANCE_COUNT * PARAMETER_COUNT);
+    }
+}
@@ -517,6 +517,29 @@ public:
      */
     Platform* getPlatform() const noexcept;
 
+    /**
+     * Prepares the built-in materials used by the post-processing effects that are currently
+     * enabled on the given View, so that enabling or rendering the View later doesn't need to
+     * load them. The materials are loaded by the Renderer over the following frames, one per
+     * frame, and their shader programs are then prepared in the background, see
+     * Material::compile().
+     *
+     * Without this call, each post-processing material is only loaded the first time it is used.
+     *
+     * @param view The View whose post-processing options are used.
+     */
+    void preparePostProcessing(View const* view) noexcept;
+
+    /**
+     * Sets how many frames the built-in post-processing materials are kept after they were last
+     * used. Older materials are destroyed, which frees their memory and shader programs, and are
+     * loaded again if they are needed later.
+     *
+     * @param frameCount Number of frames, 0 (the default) keeps all the materials until the
+     *                   Engine is destroyed.
+     */
+    void setPostProcessingMaterialTimeout(uint32_t frameCount) noexcept;
+
     /**
      * Allocate a small amount of memory directly in the command stream. The allocated memory is
      * guaranteed to be preserved until the current command buffer is executed
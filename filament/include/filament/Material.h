@@ -133,6 +133,25 @@ public:
      */
     MaterialInstance* createInstance(const char* name = nullptr) const noexcept;
 
+    /**
+     * Prepares the shader programs of this material ahead of time, so that they don't need to be
+     * created the first time an object using them is drawn, which can cause a visible hitch.
+     *
+     * All the variants of this material that only use the features in \p variants are prepared,
+     * e.g. if the scene has no dynamic lights and no skinned objects, DYNAMIC_LIGHTING and
+     * SKINNING can be omitted. The shaders are reconstructed asynchronously on JobSystem threads,
+     * the programs are then handed to the backend by the Renderer as they become ready, on the
+     * following frames. Programs that are needed before they are ready are created immediately,
+     * as usual.
+     *
+     * Calling compile() again while a previous call is still in progress waits for it to
+     * complete.
+     *
+     * @param variants Bit mask of UserVariantFilterBit selecting the features to prepare.
+     */
+    void compile(UserVariantFilterMask variants =
+            UserVariantFilterMask(UserVariantFilterBit::ALL)) noexcept;
+
     //! Returns the name of this material as a null-terminated string.
     const char* getName() const noexcept;
 
@@ -222,6 +241,28 @@ public:
     //! Indicates whether an existing parameter is a sampler or not.
     bool isSampler(const char* name) const noexcept;
 
+    /**
+     * Resolves a uniform parameter once, to set it efficiently on the instances of this material.
+     *
+     * The type \p T must match the type of the parameter, bool parameters use uint32_t handles
+     * (e.g. math::uint3 for a bool3).
+     *
+     * @param name  The name of the material parameter.
+     * @return A handle to the parameter, invalid if the parameter doesn't exist or if its type
+     *         isn't \p T.
+     * @see MaterialInstance::setParameter(ParameterHandle<T>, T const&)
+     */
+    template<typename T, typename = MaterialInstance::is_supported_handle_parameter_t<T>>
+    MaterialInstance::ParameterHandle<T> getParameterHandle(const char* name) const noexcept;
+
+    /**
+     * Resolves a sampler parameter once, to set it efficiently on the instances of this material.
+     *
+     * @param name  The name of the material texture parameter.
+     * @return A handle to the parameter, invalid if the parameter doesn't exist.
+     */
+    MaterialInstance::SamplerHandle getSamplerHandle(const char* name) const noexcept;
+
     /**
      * Sets the value of the given parameter on this material's default instance.
      *
@@ -30,6 +30,7 @@
 
 namespace filament {
 
+class FMaterialInstance;
 class Material;
 class Texture;
 class TextureSampler;
@@ -64,6 +65,75 @@ public:
             std::is_same<math::mat3f, T>::value
     >::type;
 
+    // types that can be set through a ParameterHandle, bool parameters are set with uint32_t
+    template<typename T>
+    using is_supported_handle_parameter_t = typename std::enable_if<
+            std::is_same<float, T>::value ||
+            std::is_same<int32_t, T>::value ||
+            std::is_same<uint32_t, T>::value ||
+            std::is_same<math::int2, T>::value ||
+            std::is_same<math::int3, T>::value ||
+            std::is_same<math::int4, T>::value ||
+            std::is_same<math::uint2, T>::value ||
+            std::is_same<math::uint3, T>::value ||
+            std::is_same<math::uint4, T>::value ||
+            std::is_same<math::float2, T>::value ||
+            std::is_same<math::float3, T>::value ||
+            std::is_same<math::float4, T>::value ||
+            std::is_same<math::mat3f, T>::value ||
+            std::is_same<math::mat4f, T>::value
+    >::type;
+
+    /**
+     * A uniform parameter of a Material, resolved ahead of time with
+     * Material::getParameterHandle().
+     *
+     * Setting a parameter by name looks the name up on every call, setting it through a handle
+     * doesn't. A handle can be used with any instance of the Material it was obtained from, and
+     * only with those.
+     */
+    template<typename T>
+    class ParameterHandle {
+    public:
+        using value_type = T;
+
+        ParameterHandle() noexcept = default;
+
+        //! Returns false if the parameter this handle was obtained for doesn't exist.
+        bool isValid() const noexcept { return mMaterial != nullptr; }
+
+    private:
+        friend class Material;
+        friend class FMaterialInstance;
+        ParameterHandle(Material const* material, uint32_t offset, uint32_t count) noexcept
+                : mMaterial(material), mOffset(offset), mCount(count) {}
+        Material const* mMaterial = nullptr;
+        uint32_t mOffset = 0;   // in bytes
+        uint32_t mCount = 0;    // size of the array, 1 if not an array
+    };
+
+    /**
+     * A sampler parameter of a Material, resolved ahead of time with
+     * Material::getSamplerHandle().
+     *
+     * @see ParameterHandle
+     */
+    class SamplerHandle {
+    public:
+        SamplerHandle() noexcept = default;
+
+        //! Returns false if the parameter this handle was obtained for doesn't exist.
+        bool isValid() const noexcept { return mMaterial != nullptr; }
+
+    private:
+        friend class Material;
+        friend class FMaterialInstance;
+        SamplerHandle(Material const* material, uint32_t index) noexcept
+                : mMaterial(material), mIndex(index) {}
+        Material const* mMaterial = nullptr;
+        uint32_t mIndex = 0;
+    };
+
     /**
      * Creates a new MaterialInstance using another MaterialInstance as a template for initialization.
      * The new MaterialInstance is an instance of the same Material of the template instance and
@@ -139,6 +209,60 @@ public:
      */
     void setParameter(const char* name, RgbaType type, math::float4 color) noexcept;
 
+    /**
+     * Set a uniform through a handle, this is faster than setting it by name.
+     *
+     * @param handle    Handle obtained from this instance's Material. No-op if invalid.
+     * @param value     Value of the parameter to set.
+     * @see Material::getParameterHandle()
+     */
+    template<typename T>
+    void setParameter(ParameterHandle<T> handle,
+            typename ParameterHandle<T>::value_type const& value) noexcept;
+
+    /**
+     * Set a uniform array through a handle, this is faster than setting it by name.
+     *
+     * @param handle    Handle obtained from this instance's Material. No-op if invalid.
+     * @param values    Array of values to set to the parameter array.
+     * @param count     Size of the array to set, at most the size of the parameter array.
+     * @see Material::getParameterHandle()
+     */
+    template<typename T>
+    void setParameter(ParameterHandle<T> handle,
+            typename ParameterHandle<T>::value_type const* values, size_t count) noexcept;
+
+    /**
+     * Set a texture through a handle, this is faster than setting it by name.
+     *
+     * @param handle    Handle obtained from this instance's Material. No-op if invalid.
+     * @param texture   Non nullptr Texture object pointer.
+     * @param sampler   Sampler parameters.
+     * @see Material::getSamplerHandle()
+     */
+    void setParameter(SamplerHandle handle,
+            Texture const* texture, TextureSampler const& sampler) noexcept;
+
+    /**
+     * Sets several parameters of the same type on several instances of the same Material, in one
+     * call.
+     *
+     * This is the fastest way to update many instances: each instance is only marked as modified
+     * once, instead of once per parameter.
+     *
+     * @param instances     Instances to update, they must all be instances of the Material the
+     *                      handles were obtained from.
+     * @param instanceCount Number of instances.
+     * @param handles       Handles of the parameters to set, invalid handles are skipped.
+     * @param handleCount   Number of handles.
+     * @param values        instanceCount * handleCount values, all the values of the first
+     *                      instance come first, in the order of the handles.
+     */
+    template<typename T>
+    static void setParameters(MaterialInstance* const* instances, size_t instanceCount,
+            ParameterHandle<T> const* handles, size_t handleCount,
+            typename ParameterHandle<T>::value_type const* values) noexcept;
+
     /**
      * Set up a custom scissor rectangle; by default this encompasses the View.
      *
@@ -328,6 +328,42 @@ public:
          */
         Builder& blendOrder(size_t primitiveIndex, uint16_t order) noexcept;
 
+        /**
+         * Groups a range of primitives into a level of detail (LOD).
+         *
+         * Each frame, a single level is drawn, selected from the screen coverage of the
+         * renderable, i.e. the fraction of the viewport area covered by its projected bounding
+         * sphere (as defined by the MSFT_lod glTF extension). The selected level is the first one
+         * whose \p screenCoverage is reached, if none is, the renderable is not drawn. Level 0 is
+         * the most detailed level and the coverage thresholds must decrease with the level, use a
+         * threshold of 0 for the last level to never cull the renderable.
+         *
+         * The selection is made independently for each View. The same level is used for the
+         * renderable's shadows. By default, i.e. when no level of detail is specified, all
+         * primitives are drawn.
+         *
+         * Primitive indices used in this class always span all the levels, i.e. they are the
+         * indices passed to geometry() and material().
+         *
+         * @param level zero-based index of the level, levels must be contiguous
+         * @param first index of the first primitive of this level
+         * @param count number of primitives in this level
+         * @param screenCoverage minimum screen coverage at which this level is used, in [0, 1]
+         */
+        Builder& levelOfDetail(uint8_t level, size_t first, size_t count,
+                float screenCoverage) noexcept;
+
+        /**
+         * Sets the hysteresis of the level of detail selection, 0 by default.
+         *
+         * The renderable only switches to another level once its screen coverage is past the
+         * threshold between the two levels by this fraction of the threshold, which avoids
+         * switching back and forth around a threshold.
+         *
+         * @param hysteresis fraction of the coverage threshold, e.g. 0.1 for 10%
+         */
+        Builder& levelOfDetailHysteresis(float hysteresis) noexcept;
+
         /**
          * Adds the Renderable component to an entity.
          *
@@ -481,6 +517,9 @@ public:
 
     /**
      * Associates a MorphTargetBuffer to the given primitive.
+     *
+     * Unlike other methods of this class, \p primitiveIndex is relative to the first primitive of
+     * the given level of detail, see Builder::levelOfDetail().
      */
     void setMorphTargetBufferAt(Instance instance, uint8_t level, size_t primitiveIndex,
             MorphTargetBuffer* morphTargetBuffer, size_t offset, size_t count);
@@ -511,7 +550,8 @@ public:
     uint8_t getLayerMask(Instance instance) const noexcept;
 
     /**
-     * Gets the immutable number of primitives in the given renderable.
+     * Gets the immutable number of primitives in the given renderable, across all its levels of
+     * detail.
      */
     size_t getPrimitiveCount(Instance instance) const noexcept;
 
@@ -42,6 +42,14 @@ namespace backend {
 class PixelBufferDescriptor;
 } // namespace backend
 
+} // namespace filament
+
+namespace utils::io {
+class ostream;
+} // namespace utils::io
+
+namespace filament {
+
 /**
  * A Renderer instance represents an operating system's window.
  *
@@ -135,6 +143,65 @@ public:
         bool discard = true;
     };
 
+    /**
+     * Timings and resource usage of a frame, recorded when FrameTelemetryOptions::enabled is set.
+     *
+     * All times are in milliseconds. The CPU phases are summed over all the Views rendered
+     * during the frame, Views rendered with renderStandaloneView() are not accounted for.
+     *
+     * @see setFrameTelemetryOptions(), getFrameTelemetry()
+     */
+    struct FrameTelemetry {
+        uint32_t frameId = 0;                   //!< id of the frame, incremented by beginFrame()
+        /**
+         * Whether beginFrame() returned false because the GPU was running behind, the frame may
+         * still have been rendered if the application ignored it.
+         */
+        bool skipped = false;
+        float cpuFrameTime = 0.0f;              //!< from beginFrame() to the end of endFrame()
+        float cpuEnginePrepareTime = 0.0f;      //!< commit of the material instances' uniforms
+        float cpuScenePrepareTime = 0.0f;       //!< gathering of the renderables and lights
+        float cpuCullingTime = 0.0f;            //!< culling of renderables, lights and casters
+        /** froxelization runs in parallel with command generation and frame graph compilation */
+        float cpuFroxelizationTime = 0.0f;
+        float cpuCommandGenerationTime = 0.0f;  //!< generation and sorting of the color pass
+        float cpuFrameGraphCompileTime = 0.0f;
+        float cpuFrameGraphExecuteTime = 0.0f;  //!< includes the other passes' command generation
+        /**
+         * GPU time of the most recent frame measured, 0 if not available. GPU times are only
+         * known a few frames later, so this is not the GPU time of this frame.
+         */
+        float gpuFrameTime = 0.0f;
+        float gpuFrameTimeDenoised = 0.0f;      //!< median of the recent GPU frame times
+        uint32_t commandBufferSize = 0;         //!< bytes of backend commands issued this frame
+        uint32_t commandBufferCapacity = 0;     //!< bytes available to commands between flushes
+    };
+
+    /**
+     * Format of the records written to FrameTelemetryOptions::sink.
+     */
+    enum class FrameTelemetryFormat : uint8_t {
+        CSV,    //!< a header line, followed by a line of comma-separated values per frame
+        JSON    //!< a JSON object per line
+    };
+
+    /**
+     * FrameTelemetryOptions control the recording of FrameTelemetry.
+     */
+    struct FrameTelemetryOptions {
+        /** Whether the telemetry of each frame is recorded. Off by default. */
+        bool enabled = false;
+        /** Number of frames kept in the history returned by getFrameTelemetry() */
+        uint16_t historySize = 120;
+        /**
+         * Optional stream to which the telemetry of each frame is written by endFrame(). The
+         * stream must outlive the Renderer or be reset with setFrameTelemetryOptions().
+         */
+        utils::io::ostream* sink = nullptr;
+        /** Format of the records written to sink. */
+        FrameTelemetryFormat sinkFormat = FrameTelemetryFormat::CSV;
+    };
+
     /**
      * Information about the display this Renderer is associated to. This information is needed
      * to accurately compute dynamic-resolution scaling and for frame-pacing.
@@ -152,6 +219,21 @@ public:
      */
     void setClearOptions(const ClearOptions& options);
 
+    /**
+     * Set options controlling the recording of FrameTelemetry. Changing the history size clears
+     * the history.
+     */
+    void setFrameTelemetryOptions(FrameTelemetryOptions const& options);
+
+    /**
+     * Copies the telemetry of the most recent frames, most recent first.
+     *
+     * @param out   Array of at least count FrameTelemetry.
+     * @param count Maximum number of frames to copy.
+     * @return The number of frames copied, at most FrameTelemetryOptions::historySize.
+     */
+    size_t getFrameTelemetry(FrameTelemetry* out, size_t count) const noexcept;
+
     /**
      * Get the Engine that created this Renderer.
      *
@@ -477,6 +559,38 @@ public:
      */
     void renderStandaloneView(View const* view);
 
+    /**
+     * Render several standalone Views into their associated RenderTarget in a single frame.
+     *
+     * This is equivalent to calling renderStandaloneView() for each View, but the per-frame work
+     * is only done once, and the intermediate buffers used by post-processing are recycled from
+     * one View to the next.
+     *
+     * Consecutive Views that share a Scene also share the gathering of its renderables, as long
+     * as their cameras are at the same position: renderables are transformed relative to the
+     * camera, so a View whose camera is elsewhere (e.g. the frames of a turntable) gathers them
+     * again. Culling depends on the camera and is always done for each View.
+     *
+     * To render many small images, e.g. thumbnails, the Views can share a single RenderTarget
+     * and each use a different viewport of it. All the images can then be read back with a
+     * single call to readPixels() on that RenderTarget. In that case, the ClearOptions of the
+     * Renderer only clear the color buffer once, before the first View.
+     *
+     * @param views An array of pointers to the Views to render, in order. Each View must have a
+     *              RenderTarget associated to it.
+     * @param count The number of Views in the array.
+     *
+     * @attention
+     * renderStandaloneViews() must be called outside of beginFrame() / endFrame().
+     *
+     * @note
+     * renderStandaloneViews() must be called from the Engine's main thread
+     * (or external synchronization must be provided).
+     *
+     * @see renderStandaloneView()
+     */
+    void renderStandaloneViews(View const* const* views, size_t count);
+
 
     /**
      * Returns the time in second of the last call to beginFrame(). This value is constant for all
@@ -21,6 +21,8 @@
 
 #include <math/mathfwd.h>
 
+#include <stdint.h>
+
 namespace filament {
 
 /**
@@ -64,6 +66,23 @@ struct UTILS_PUBLIC ToneMapper {
      *         function applied ("linear")
      */
     virtual math::float3 operator()(math::float3 c) const noexcept = 0;
+
+private:
+    friend class FColorGrading;
+    friend struct LinearToneMapper;
+    friend struct ACESToneMapper;
+    friend struct ACESLegacyToneMapper;
+    friend struct FilmicToneMapper;
+    friend struct GenericToneMapper;
+    friend struct DisplayRangeToneMapper;
+
+    // Identifies the tone mappers provided by Filament, so that the LUTs built with them can be
+    // cached. Custom tone mappers are never cached.
+    enum class Builtin : uint8_t {
+        CUSTOM, LINEAR, ACES, ACES_LEGACY, FILMIC, GENERIC, DISPLAY_RANGE
+    };
+    explicit ToneMapper(Builtin builtin) noexcept;
+    Builtin mBuiltin = Builtin::CUSTOM;
 };
 
 /**
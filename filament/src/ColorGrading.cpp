@@ -28,11 +28,14 @@
 #include <math/vec4.h>
 
 #include <utils/JobSystem.h>
-#include <utils/SpinLock.h>
 #include <utils/Systrace.h>
 
+#include <algorithm>
+#include <iterator>
+
 #include <math.h>
 #include <stdlib.h>
+#include <string.h>
 
 namespace filament {
 
@@ -605,6 +608,98 @@ static float3 selectColorGradingLuminance(ColorGrading::ToneMapping toneMapping)
 }
 #pragma clang diagnostic pop
 
+//------------------------------------------------------------------------------
+// LUT cache
+//------------------------------------------------------------------------------
+
+// Identifies a tone mapper provided by Filament and its parameters. Custom tone mappers can't be
+// compared, so the LUTs that use them are never cached.
+struct FColorGrading::ToneMapperKey {
+    ToneMapper::Builtin builtin;
+    float parameters[4];
+    bool operator==(ToneMapperKey const& rhs) const noexcept {
+        return builtin == rhs.builtin &&
+                std::equal(std::begin(parameters), std::end(parameters), rhs.parameters);
+    }
+};
+
+FColorGrading::ToneMapperKey FColorGrading::getToneMapperKey(
+        const ToneMapper& toneMapper) noexcept {
+    ToneMapperKey key{ toneMapper.mBuiltin, {} };
+    if (key.builtin == ToneMapper::Builtin::GENERIC) {
+        auto const& generic = static_cast<const GenericToneMapper&>(toneMapper);
+        key.parameters[0] = generic.getContrast();
+        key.parameters[1] = generic.getMidGrayIn();
+        key.parameters[2] = generic.getMidGrayOut();
+        key.parameters[3] = generic.getHdrMax();
+    }
+    return key;
+}
+
+struct FColorGrading::LutCache::Entry {
+    Builder builder; // its tone mapper must not be used, see toneMapperKey
+    ToneMapperKey toneMapperKey;
+    size_t size;
+    std::unique_ptr<uint8_t[]> data;
+};
+
+FColorGrading::LutCache::LutCache() noexcept = default;
+
+FColorGrading::LutCache::~LutCache() noexcept = default;
+
+void const* FColorGrading::LutCache::get(const Builder& builder, size_t size) noexcept {
+    const ToneMapperKey toneMapperKey = getToneMapperKey(*builder->toneMapper);
+    if (toneMapperKey.builtin == ToneMapper::Builtin::CUSTOM) {
+        return nullptr;
+    }
+    auto pos = std::find_if(mEntries.begin(), mEntries.end(),
+            [&builder, &toneMapperKey](auto const& entry) {
+                return entry->toneMapperKey == toneMapperKey && isSameLut(entry->builder, builder);
+            });
+    if (pos == mEntries.end()) {
+        return nullptr;
+    }
+    assert_invariant((*pos)->size == size);
+    // keep the most recently used entries last
+    std::rotate(pos, pos + 1, mEntries.end());
+    return mEntries.back()->data.get();
+}
+
+void FColorGrading::LutCache::put(const Builder& builder, void const* data, size_t size) {
+    const ToneMapperKey toneMapperKey = getToneMapperKey(*builder->toneMapper);
+    if (toneMapperKey.builtin == ToneMapper::Builtin::CUSTOM || size > MAX_SIZE_IN_BYTES) {
+        return;
+    }
+
+    // evict the least recently used entries until the new one fits
+    auto last = mEntries.begin();
+    while (mSizeInBytes + size > MAX_SIZE_IN_BYTES) {
+        mSizeInBytes -= (*last)->size;
+        ++last;
+    }
+    mEntries.erase(mEntries.begin(), last);
+
+    std::unique_ptr<uint8_t[]> copy(new uint8_t[size]);
+    memcpy(copy.get(), data, size);
+    mEntries.push_back(std::unique_ptr<Entry>(new Entry{
+            builder, toneMapperKey, size, std::move(copy) }));
+    mSizeInBytes += size;
+}
+
+void FColorGrading::LutCache::clear() noexcept {
+    mEntries.clear();
+    mSizeInBytes = 0;
+}
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdeprecated-declarations"
+bool FColorGrading::isSameLut(const Builder& lhs, const Builder& rhs) noexcept {
+    // The deprecated tone mapping is not part of BuilderDetails' comparison, but it selects the
+    // color grading color space.
+    return *lhs.mImpl == *rhs.mImpl && lhs->toneMapping == rhs->toneMapping;
+}
+#pragma clang diagnostic pop
+
 //------------------------------------------------------------------------------
 // Color grading implementation
 //------------------------------------------------------------------------------
@@ -617,33 +712,43 @@ struct Config {
     float3 colorGradingLuminance;
 };
 
+static constexpr size_t MAX_LUT_DIMENSION = 64;
+
+// A row of the LUT, i.e. all the texels that have the same green and blue coordinates. The
+// channels are stored in separate arrays, so that each step of the color grading is evaluated over
+// the whole row at once: branches are taken once per row and the compiler can vectorize the steps
+// that are plain arithmetic (color space conversions, channel mixer, saturation...) to process
+// 4 or 8 texels at a time.
+struct LutRow {
+    float r[MAX_LUT_DIMENSION];
+    float g[MAX_LUT_DIMENSION];
+    float b[MAX_LUT_DIMENSION];
+};
+
+template<typename F>
+UTILS_ALWAYS_INLINE
+inline void apply(LutRow& UTILS_RESTRICT row, size_t count, F step) noexcept {
+    for (size_t i = 0; i < count; i++) {
+        const float3 v = step(float3{ row.r[i], row.g[i], row.b[i] });
+        row.r[i] = v.r;
+        row.g[i] = v.g;
+        row.b[i] = v.b;
+    }
+}
+
 // Inside the FColorGrading constructor, TSAN sporadically detects a data race on the config struct;
-// the Filament thread writes and the Job thread reads. In practice there should be no data race, so
-// we force TSAN off to silence the warning.
+// the Filament thread writes and the Job thread reads. In practice there should be no data race:
+// the config is initialized before the jobs are created and they only read it.
 UTILS_NO_SANITIZE_THREAD
 FColorGrading::FColorGrading(FEngine& engine, const Builder& builder) {
     SYSTRACE_CALL();
 
     DriverApi& driver = engine.getDriverApi();
 
-    Config c;
-    // This lock protects the data inside Config, which is written to by the Filament thread,
-    // and read from multiple Job threads.
-    utils::SpinLock configLock;
-    {
-        std::lock_guard<utils::SpinLock> lock(configLock);
-        c.lutDimension          = builder->dimension;
-        c.adaptationTransform   = adaptationTransform(builder->whiteBalance);
-        c.colorGradingIn        = selectColorGradingTransformIn(builder->toneMapping);
-        c.colorGradingOut       = selectColorGradingTransformOut(builder->toneMapping);
-        c.colorGradingLuminance = selectColorGradingLuminance(builder->toneMapping);
-    }
+    mDimension = builder->dimension;
+    assert_invariant(mDimension <= MAX_LUT_DIMENSION);
 
-    mDimension = c.lutDimension;
-
-    size_t lutElementCount = c.lutDimension * c.lutDimension * c.lutDimension;
-    size_t elementSize = sizeof(half4);
-    void* data = malloc(lutElementCount * elementSize);
+    size_t lutElementCount = mDimension * mDimension * mDimension;
 
     TextureFormat textureFormat;
     PixelDataFormat format;
@@ -651,10 +756,61 @@ FColorGrading::FColorGrading(FEngine& engine, const Builder& builder) {
     selectLutTextureParams(builder->format, textureFormat, format, type);
     assert_invariant(FTexture::validatePixelFormatAndType(textureFormat, format, type));
 
-    void* converted = nullptr;
-    if (type == PixelDataType::UINT_2_10_10_10_REV) {
-        // convert input to UINT_2_10_10_10_REV if needed
-        converted = malloc(lutElementCount * sizeof(uint32_t));
+    const bool packed = type == PixelDataType::UINT_2_10_10_10_REV;
+    const size_t lutSize = lutElementCount * (packed ? sizeof(uint32_t) : sizeof(half4));
+
+    // Gradings are often rebuilt with the same parameters, e.g. when animating them, in which
+    // case we reuse the LUT of a recent one.
+    LutCache& cache = engine.getColorGradingLutCache();
+    void* data = malloc(lutSize);
+    if (void const* cached = cache.get(builder, lutSize)) {
+        memcpy(data, cached, lutSize);
+    } else {
+        generateLut(engine.getJobSystem(), builder, data, packed);
+        cache.put(builder, data, lutSize);
+    }
+
+    mLutHandle = driver.createTexture(
+            SamplerType::SAMPLER_3D,
+            1,
+            textureFormat,
+            1,
+            mDimension,
+            mDimension,
+            mDimension,
+            TextureUsage::DEFAULT
+    );
+
+    driver.update3DImage(mLutHandle, 0,
+            0, 0, 0,
+            mDimension, mDimension, mDimension,
+            PixelBufferDescriptor{
+                    data, lutSize, format, type,
+                    [](void* buffer, size_t, void*) { free(buffer); }
+            }
+    );
+}
+
+void FColorGrading::generateLut(JobSystem& js, const Builder& builder, void* out, bool packed) {
+    SYSTRACE_CALL();
+
+    const Config c = {
+            builder->dimension,
+            adaptationTransform(builder->whiteBalance),
+            selectColorGradingTransformIn(builder->toneMapping),
+            selectColorGradingTransformOut(builder->toneMapping),
+            selectColorGradingLuminance(builder->toneMapping)
+    };
+
+    // LogC decoding and exposure apply to each channel independently, so we only evaluate them
+    // once per coordinate of the LUT.
+    float linear[MAX_LUT_DIMENSION];
+    const float exposure = builder->hasAdjustments ? std::exp2(builder->exposure) : 1.0f;
+    for (size_t i = 0; i < c.lutDimension; i++) {
+        // LogC encoding
+        float v = LogC_to_linear(float3{ float(i) * (1.0f / float(c.lutDimension - 1u)) }).x;
+        // Kill negative values near 0.0f due to imprecision in the log conversion
+        linear[i] = std::max(v, 0.0f) * exposure;
     }
 
     //auto now = std::chrono::steady_clock::now();
@@ -662,53 +818,51 @@ FColorGrading::FColorGrading(FEngine& engine, const Builder& builder) {
     // Multithreadedly generate the tone mapping 3D look-up table using 32 jobs
     // Slices are 8 KiB (128 cache lines) apart.
     // This takes about 3-6ms on Android in Release
-    JobSystem& js = engine.getJobSystem();
     auto *slices = js.createJob();
     for (size_t b = 0; b < c.lutDimension; b++) {
         auto *job = js.createJob(slices,
-                [data, converted, b, &c, &configLock, builder](JobSystem&, JobSystem::Job*) {
-            Config config;
-            {
-                std::lock_guard<utils::SpinLock> lock(configLock);
-                config = c;
-            }
-            half4* UTILS_RESTRICT p = (half4*) data + b * config.lutDimension * config.lutDimension;
-            for (size_t g = 0; g < config.lutDimension; g++) {
-                for (size_t r = 0; r < config.lutDimension; r++) {
-                    float3 v = float3{r, g, b} * (1.0f / float(config.lutDimension - 1u));
-
-                    // LogC encoding
-                    v = LogC_to_linear(v);
-
-                    // Kill negative values near 0.0f due to imprecision in the log conversion
-                    v = max(v, 0.0f);
-
-                    if (builder->hasAdjustments) {
-                        // Exposure
-                        v = adjustExposure(v, builder->exposure);
+                [out, packed, b, &c, &builder, &linear](JobSystem&, JobSystem::Job*) {
+            const size_t n = c.lutDimension;
+            const bool hasAdjustments = builder->hasAdjustments;
+            LutRow row;
+            for (size_t g = 0; g < n; g++) {
+                for (size_t r = 0; r < n; r++) {
+                    row.r[r] = linear[r];
+                    row.g[r] = linear[g];
+                    row.b[r] = linear[b];
+                }
 
-                        // Purkinje shift ("low-light" vision)
-                        v = scotopicAdaptation(v, builder->nightAdaptation);
-                    }
+                if (hasAdjustments) {
+                    // Purkinje shift ("low-light" vision)
+                    apply(row, n, [&builder](float3 v) {
+                        return scotopicAdaptation(v, builder->nightAdaptation);
+                    });
+                }
 
-                    // Move to color grading color space
-                    v = c.colorGradingIn * v;
+                // Move to color grading color space
+                apply(row, n, [&c](float3 v) { return c.colorGradingIn * v; });
 
-                    if (builder->hasAdjustments) {
+                if (hasAdjustments) {
+                    apply(row, n, [&c, &builder](float3 v) {
                         // White balance
-                        v = chromaticAdaptation(v, config.adaptationTransform);
+                        v = chromaticAdaptation(v, c.adaptationTransform);
 
                         // Kill negative values before the next transforms
                         v = max(v, 0.0f);
 
                         // Channel mixer
-                        v = channelMixer(v, builder->outRed, builder->outGreen, builder->outBlue);
+                        return channelMixer(v,
+                                builder->outRed, builder->outGreen, builder->outBlue);
+                    });
 
-                        // Shadows/mid-tones/highlights
-                        v = tonalRanges(v, c.colorGradingLuminance,
+                    // Shadows/mid-tones/highlights
+                    apply(row, n, [&c, &builder](float3 v) {
+                        return tonalRanges(v, c.colorGradingLuminance,
                                 builder->shadows, builder->midtones, builder->highlights,
                                 builder->tonalRanges);
+                    });
 
+                    apply(row, n, [&builder](float3 v) {
                         // The adjustments below behave better in log space
                         v = linear_to_LogC(v);
 
@@ -719,8 +873,10 @@ FColorGrading::FColorGrading(FEngine& engine, const Builder& builder) {
                         v = contrast(v, builder->contrast);
 
                         // Back to linear space
-                        v = LogC_to_linear(v);
+                        return LogC_to_linear(v);
+                    });
 
+                    apply(row, n, [&c, &builder](float3 v) {
                         // Vibrance in linear space
                         v = vibrance(v, c.colorGradingLuminance, builder->vibrance);
 
@@ -728,97 +884,69 @@ FColorGrading::FColorGrading(FEngine& engine, const Builder& builder) {
                         v = saturation(v, c.colorGradingLuminance, builder->saturation);
 
                         // Kill negative values before curves
-                        v = max(v, 0.0f);
+                        return max(v, 0.0f);
+                    });
 
-                        // RGB curves
-                        v = curves(v,
+                    // RGB curves
+                    apply(row, n, [&builder](float3 v) {
+                        return curves(v,
                                 builder->shadowGamma, builder->midPoint, builder->highlightScale);
-                    }
+                    });
+                }
 
-                    // Tone mapping
-                    if (builder->luminanceScaling) {
-                        v = luminanceScaling(v, *builder->toneMapper, c.colorGradingLuminance);
-                    } else {
-                        v = (*builder->toneMapper)(v);
-                    }
+                // Tone mapping
+                const ToneMapper& toneMapper = *builder->toneMapper;
+                if (builder->luminanceScaling) {
+                    apply(row, n, [&c, &toneMapper](float3 v) {
+                        return luminanceScaling(v, toneMapper, c.colorGradingLuminance);
+                    });
+                } else {
+                    apply(row, n, [&toneMapper](float3 v) { return toneMapper(v); });
+                }
 
-                    // Go back to display color space
-                    v = c.colorGradingOut * v;
+                // Go back to display color space
+                apply(row, n, [&c](float3 v) { return c.colorGradingOut * v; });
 
-                    // Apply gamut mapping
-                    if (builder->gamutMapping) {
-                        // TODO: This should depend on the output color space
-                        v = gamutMapping_sRGB(v);
-                    }
+                // Apply gamut mapping
+                if (builder->gamutMapping) {
+                    // TODO: This should depend on the output color space
+                    apply(row, n, [](float3 v) { return gamutMapping_sRGB(v); });
+                }
 
-                    // TODO: We should convert to the output color space if we use a working
-                    //       color space that's not sRGB
-                    // TODO: Allow the user to customize the output color space
+                // TODO: We should convert to the output color space if we use a working
+                //       color space that's not sRGB
+                // TODO: Allow the user to customize the output color space
 
+                const size_t offset = (b * n + g) * n;
+                for (size_t r = 0; r < n; r++) {
                     // We need to clamp for the output transfer function
-                    v = saturate(v);
+                    float3 v = saturate(float3{ row.r[r], row.g[r], row.b[r] });
 
                     // Apply OETF
                     v = OETF_sRGB(v);
 
-                    *p++ = half4{v, 0.0f};
-                }
-            }
-
-            if (converted) {
-                uint32_t* const UTILS_RESTRICT dst = (uint32_t*) converted +
-                        b * config.lutDimension * config.lutDimension;
-                half4* UTILS_RESTRICT src = (half4*) data +
-                        b * config.lutDimension * config.lutDimension;
-                // we use a vectorize width of 8 because, on ARMv8 it allows the compiler to write eight
-                // 32-bits results in one go.
-                const size_t count = (config.lutDimension * config.lutDimension) & ~0x7u; // tell the compiler that we're a multiple of 8
-                #pragma clang loop vectorize_width(8)
-                for (size_t i = 0; i < count; ++i) {
-                    float4 v{src[i]};
-                    uint32_t pr = uint32_t(std::floor(v.x * 1023.0f + 0.5f));
-                    uint32_t pg = uint32_t(std::floor(v.y * 1023.0f + 0.5f));
-                    uint32_t pb = uint32_t(std::floor(v.z * 1023.0f + 0.5f));
-                    dst[i] = (pb << 20u) | (pg << 10u) | pr;
+                    const half4 h{v, 0.0f};
+                    if (packed) {
+                        // convert to UINT_2_10_10_10_REV from the half values, so that both
+                        // formats quantize the same colors
+                        float4 q{h};
+                        uint32_t pr = uint32_t(std::floor(q.x * 1023.0f + 0.5f));
+                        uint32_t pg = uint32_t(std::floor(q.y * 1023.0f + 0.5f));
+                        uint32_t pb = uint32_t(std::floor(q.z * 1023.0f + 0.5f));
+                        ((uint32_t*) out)[offset + r] = (pb << 20u) | (pg << 10u) | pr;
+                    } else {
+                        ((half4*) out)[offset + r] = h;
+                    }
                 }
             }
-
         });
         js.run(job);
     }
 
-    // TODO: Should we do a runAndRetain() and defer the wait() + texture creation until
-    //       getHwHandle() is invoked?
     js.runAndWait(slices);
 
     //std::chrono::duration<float, std::milli> duration = std::chrono::steady_clock::now() - now;
     //slog.d << "LUT generation time: " << duration.count() << " ms" << io::endl;
-
-    mLutHandle = driver.createTexture(
-            SamplerType::SAMPLER_3D,
-            1,
-            textureFormat,
-            1,
-            c.lutDimension,
-            c.lutDimension,
-            c.lutDimension,
-            TextureUsage::DEFAULT
-    );
-
-    if (converted) {
-        free(data);
-        data = converted;
-        elementSize = sizeof(uint32_t);
-    }
-
-    driver.update3DImage(mLutHandle, 0,
-            0, 0, 0,
-            c.lutDimension, c.lutDimension, c.lutDimension,
-            PixelBufferDescriptor{
-                    data, lutElementCount * elementSize,format, type,
-                    [](void* buffer, size_t, void*) { free(buffer); }
-            }
-    );
 }
 
 FColorGrading::~FColorGrading() noexcept = default;
@@ -341,6 +341,7 @@ void FEngine::shutdown() {
     cleanupResourceList(mScenes);
     cleanupResourceList(mSkyboxes);
     cleanupResourceList(mColorGradings);
+    mColorGradingLutCache.clear();
 
     // this must be done after Skyboxes and before materials
     destroy(mSkyboxMaterial);
@@ -408,19 +409,30 @@ void FEngine::prepare() {
         }
     }
 
-    // Commit default material instances.
+    // This can load or destroy post-processing materials, so it must run before the loop below.
+    mPostProcessManager.update();
+
+    // Commit default material instances and create the programs prepared by Material::compile().
     for (const auto& material : mMaterials) {
         material->getDefaultInstance()->commit(driver);
+        material->commitPendingPrograms();
     }
 }
 
 void FEngine::gc() {
     // Note: this runs in a Job
+    // Components of destroyed entities are reclaimed from the EntityManager's destroy journal, a
+    // small batch at a time, until all managers are caught up or we run out of time. Whatever is
+    // left is picked up next frame.
     auto& em = mEntityManager;
-    mRenderableManager.gc(em);
-    mLightManager.gc(em);
-    mTransformManager.gc(em);
-    mCameraManager.gc(em);
+    const auto deadline = std::chrono::steady_clock::now() + CONFIG_GC_TIME_BUDGET;
+    bool done;
+    do {
+        done  = mRenderableManager.gc(em, CONFIG_GC_BATCH_SIZE);
+        done &= mLightManager.gc(em, CONFIG_GC_BATCH_SIZE);
+        done &= mTransformManager.gc(em, CONFIG_GC_BATCH_SIZE);
+        done &= mCameraManager.gc(em, CONFIG_GC_BATCH_SIZE);
+    } while (!done && std::chrono::steady_clock::now() < deadline);
 }
 
 void FEngine::flush() {
@@ -942,6 +954,14 @@ Platform* Engine::getPlatform() const noexcept {
     return upcast(this)->getPlatform();
 }
 
+void Engine::preparePostProcessing(View const* view) noexcept {
+    upcast(this)->getPostProcessManager().prepareMaterials(*upcast(view));
+}
+
+void Engine::setPostProcessingMaterialTimeout(uint32_t frameCount) noexcept {
+    upcast(this)->getPostProcessManager().setMaterialTimeout(frameCount);
+}
+
 Renderer* Engine::createRenderer() noexcept {
     return upcast(this)->createRenderer();
 }
@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "FrameTelemetry.h"
+
+#include <utils/ostream.h>
+
+#include <algorithm>
+
+namespace filament {
+
+using namespace utils;
+
+using FrameTelemetry = FrameTelemetryManager::FrameTelemetry;
+
+// The times of a frame, in the order in which they are written to the sink.
+static constexpr struct {
+    const char* name;
+    float FrameTelemetry::* value;
+} TIMES[] = {
+        { "cpuFrameTime",               &FrameTelemetry::cpuFrameTime },
+        { "cpuEnginePrepareTime",       &FrameTelemetry::cpuEnginePrepareTime },
+        { "cpuScenePrepareTime",        &FrameTelemetry::cpuScenePrepareTime },
+        { "cpuCullingTime",             &FrameTelemetry::cpuCullingTime },
+        { "cpuFroxelizationTime",       &FrameTelemetry::cpuFroxelizationTime },
+        { "cpuCommandGenerationTime",   &FrameTelemetry::cpuCommandGenerationTime },
+        { "cpuFrameGraphCompileTime",   &FrameTelemetry::cpuFrameGraphCompileTime },
+        { "cpuFrameGraphExecuteTime",   &FrameTelemetry::cpuFrameGraphExecuteTime },
+        { "gpuFrameTime",               &FrameTelemetry::gpuFrameTime },
+        { "gpuFrameTimeDenoised",       &FrameTelemetry::gpuFrameTimeDenoised },
+};
+
+void FrameTelemetryManager::setOptions(Options const& options) {
+    if (options.historySize != mOptions.historySize) {
+        mHistory.clear();
+        mHistoryHead = 0;
+        mHistoryCount = 0;
+    }
+    if (options.sink != mOptions.sink || options.sinkFormat != mOptions.sinkFormat) {
+        mHeaderWritten = false;
+    }
+    if (!options.enabled) {
+        mInFrame = false;
+    }
+    mOptions = options;
+    // the history is kept when telemetry is disabled, so that it can still be read
+    if (mOptions.enabled && mHistory.size() != mOptions.historySize) {
+        mHistory.resize(mOptions.historySize);
+    }
+}
+
+void FrameTelemetryManager::beginFrame(uint32_t frameId, uint64_t commandBufferSize) noexcept {
+    if (!isEnabled()) {
+        return;
+    }
+    if (mInFrame) {
+        // the previous frame was skipped and endFrame() was not called
+        commit();
+    }
+    mInFrame = true;
+    mCurrent = {};
+    mCurrent.frameId = frameId;
+    mFrameStart = clock::now();
+    mCommandBufferSize = commandBufferSize;
+    mPhases.fill({});
+}
+
+void FrameTelemetryManager::endFrame(FrameInfo const& frameInfo, uint64_t commandBufferSize,
+        uint32_t commandBufferCapacity) noexcept {
+    if (!isEnabled() || !mInFrame) {
+        return;
+    }
+
+    using duration = std::chrono::duration<float, std::milli>;
+    FrameTelemetry& frame = mCurrent;
+    frame.cpuFrameTime = duration(clock::now() - mFrameStart).count();
+    frame.cpuEnginePrepareTime = duration(mPhases[size_t(Phase::ENGINE_PREPARE)]).count();
+    frame.cpuScenePrepareTime = duration(mPhases[size_t(Phase::SCENE_PREPARE)]).count();
+    frame.cpuCullingTime = duration(mPhases[size_t(Phase::CULLING)]).count();
+    frame.cpuFroxelizationTime = duration(mPhases[size_t(Phase::FROXELIZATION)]).count();
+    frame.cpuCommandGenerationTime = duration(mPhases[size_t(Phase::COMMAND_GENERATION)]).count();
+    frame.cpuFrameGraphCompileTime = duration(mPhases[size_t(Phase::FRAME_GRAPH_COMPILE)]).count();
+    frame.cpuFrameGraphExecuteTime = duration(mPhases[size_t(Phase::FRAME_GRAPH_EXECUTE)]).count();
+    if (frameInfo.valid) {
+        frame.gpuFrameTime = frameInfo.frameTime.count();
+        frame.gpuFrameTimeDenoised = frameInfo.denoisedFrameTime.count();
+    }
+    frame.commandBufferSize = uint32_t(commandBufferSize - mCommandBufferSize);
+    frame.commandBufferCapacity = commandBufferCapacity;
+
+    commit();
+}
+
+void FrameTelemetryManager::commit() noexcept {
+    mInFrame = false;
+    const size_t size = mHistory.size();
+    if (size) {
+        mHistory[mHistoryHead] = mCurrent;
+        mHistoryHead = (mHistoryHead + 1) % size;
+        mHistoryCount = std::min(mHistoryCount + 1, size);
+    }
+    if (mOptions.sink) {
+        write(mCurrent);
+    }
+}
+
+size_t FrameTelemetryManager::getHistory(FrameTelemetry* out, size_t count) const noexcept {
+    const size_t size = mHistory.size();
+    count = std::min(count, mHistoryCount);
+    for (size_t i = 0; i < count; i++) {
+        out[i] = mHistory[(mHistoryHead + size - 1 - i) % size];
+    }
+    return count;
+}
+
+void FrameTelemetryManager::write(FrameTelemetry const& frame) noexcept {
+    io::ostream& out = *mOptions.sink;
+    if (mOptions.sinkFormat == Renderer::FrameTelemetryFormat::CSV) {
+        if (!mHeaderWritten) {
+            out << "frameId,skipped";
+            for (auto const& time : TIMES) {
+                out << "," << time.name;
+            }
+            out << ",commandBufferSize,commandBufferCapacity" << io::endl;
+            mHeaderWritten = true;
+        }
+        out << frame.frameId << "," << (frame.skipped ? 1u : 0u);
+        for (auto const& time : TIMES) {
+            out << "," << frame.*time.value;
+        }
+        out << "," << frame.commandBufferSize << "," << frame.commandBufferCapacity << io::endl;
+    } else {
+        out << "{\"frameId\":" << frame.frameId
+            << ",\"skipped\":" << (frame.skipped ? "true" : "false");
+        for (auto const& time : TIMES) {
+            out << ",\"" << time.name << "\":" << frame.*time.value;
+        }
+        out << ",\"commandBufferSize\":" << frame.commandBufferSize
+            << ",\"commandBufferCapacity\":" << frame.commandBufferCapacity << "}" << io::endl;
+    }
+}
+
+} // namespace filament
@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TNT_FILAMENT_FRAMETELEMETRY_H
+#define TNT_FILAMENT_FRAMETELEMETRY_H
+
+#include "FrameInfo.h"
+
+#include <filament/Renderer.h>
+
+#include <utils/compiler.h>
+
+#include <array>
+#include <chrono>
+#include <vector>
+
+#include <stdint.h>
+
+namespace filament {
+
+/*
+ * Records the FrameTelemetry of each frame of a Renderer into a history, and optionally writes
+ * it to a sink. Does nothing until enabled with setOptions().
+ *
+ * CPU phases are measured with ScopedTimer and summed until the end of the frame. The phases are
+ * distinct, so a phase may be measured on a job thread while another one is measured on the
+ * Engine's thread.
+ */
+class FrameTelemetryManager {
+public:
+    using FrameTelemetry = Renderer::FrameTelemetry;
+    using Options = Renderer::FrameTelemetryOptions;
+    using clock = std::chrono::steady_clock;
+
+    enum class Phase : uint8_t {
+        ENGINE_PREPARE,
+        SCENE_PREPARE,
+        CULLING,
+        FROXELIZATION,
+        COMMAND_GENERATION,
+        FRAME_GRAPH_COMPILE,
+        FRAME_GRAPH_EXECUTE,
+    };
+    static constexpr size_t PHASE_COUNT = size_t(Phase::FRAME_GRAPH_EXECUTE) + 1;
+
+    // Adds the time elapsed between its construction and its destruction to a phase.
+    class ScopedTimer {
+    public:
+        ScopedTimer(FrameTelemetryManager& manager, Phase phase) noexcept
+                : mManager(manager.isEnabled() ? &manager : nullptr), mPhase(phase) {
+            if (mManager) {
+                mStart = clock::now();
+            }
+        }
+
+        ~ScopedTimer() noexcept {
+            if (mManager) {
+                mManager->add(mPhase, clock::now() - mStart);
+            }
+        }
+
+        ScopedTimer(ScopedTimer const&) = delete;
+        ScopedTimer& operator=(ScopedTimer const&) = delete;
+
+    private:
+        FrameTelemetryManager* const mManager;
+        const Phase mPhase;
+        clock::time_point mStart;
+    };
+
+    FrameTelemetryManager() noexcept = default;
+
+    void setOptions(Options const& options);
+
+    bool isEnabled() const noexcept { return mOptions.enabled; }
+
+    // commandBufferSize is the total size of the commands flushed so far.
+    void beginFrame(uint32_t frameId, uint64_t commandBufferSize) noexcept;
+
+    // call this when beginFrame() returns false
+    void skipFrame() noexcept { mCurrent.skipped = true; }
+
+    void endFrame(FrameInfo const& frameInfo, uint64_t commandBufferSize,
+            uint32_t commandBufferCapacity) noexcept;
+
+    void add(Phase phase, clock::duration duration) noexcept {
+        mPhases[size_t(phase)] += duration;
+    }
+
+    size_t getHistory(FrameTelemetry* out, size_t count) const noexcept;
+
+private:
+    void commit() noexcept;
+    void write(FrameTelemetry const& frame) noexcept;
+
+    Options mOptions;
+    FrameTelemetry mCurrent;
+    bool mInFrame = false;
+    bool mHeaderWritten = false;
+    clock::time_point mFrameStart;
+    uint64_t mCommandBufferSize = 0;
+    std::array<clock::duration, PHASE_COUNT> mPhases{};
+    std::vector<FrameTelemetry> mHistory; // circular buffer
+    size_t mHistoryHead = 0;              // index of the next frame
+    size_t mHistoryCount = 0;
+};
+
+} // namespace filament
+
+#endif // TNT_FILAMENT_FRAMETELEMETRY_H
@@ -35,7 +35,10 @@
 #include <backend/DriverEnums.h>
 
 #include <utils/CString.h>
+#include <utils/Hash.h>
+#include <utils/JobSystem.h>
 #include <utils/Panic.h>
+#include <utils/Systrace.h>
 
 using namespace utils;
 using namespace filaflat;
@@ -43,6 +46,7 @@ using namespace filaflat;
 namespace filament {
 
 using namespace backend;
+using namespace math;
 
 static MaterialParser* createParser(Backend backend, const void* data, size_t size) {
     MaterialParser* materialParser = new MaterialParser(backend, data, size);
@@ -157,6 +161,9 @@ FMaterial::FMaterial(FEngine& engine, const Material::Builder& builder)
     UTILS_UNUSED_IN_RELEASE bool nameOk = parser->getName(&mName);
     assert_invariant(nameOk);
 
+    // identifies the programs of this material in the platform's persistent cache
+    mCacheId = parser->computeHash();
+
     UTILS_UNUSED_IN_RELEASE bool sibOK = parser->getSIB(&mSamplerInterfaceBlock);
     assert_invariant(sibOK);
 
@@ -326,6 +333,7 @@ void FMaterial::terminate(FEngine& engine) {
     }
 #endif
 
+    cancelPendingPrograms();
     destroyPrograms(engine);
     mDefaultInstance.terminate(engine);
 }
@@ -360,6 +368,30 @@ Handle<HwProgram> FMaterial::getProgramSlow(Variant variant) const noexcept {
 }
 
 Handle<HwProgram> FMaterial::getSurfaceProgramSlow(Variant variant) const noexcept {
+    Program pb = getSurfaceProgramBuilder(variant,
+            mEngine.getVertexShaderBuilder(), mEngine.getFragmentShaderBuilder());
+    return createAndCacheProgram(std::move(pb), variant);
+}
+
+Handle<HwProgram> FMaterial::getPostProcessProgramSlow(Variant variant) const noexcept {
+    Program pb = getPostProcessProgramBuilder(variant,
+            mEngine.getVertexShaderBuilder(), mEngine.getFragmentShaderBuilder());
+    return createAndCacheProgram(std::move(pb), variant);
+}
+
+Program FMaterial::getProgramBuilder(Variant variant,
+        ShaderBuilder& vsBuilder, ShaderBuilder& fsBuilder) const noexcept {
+    switch (getMaterialDomain()) {
+        case MaterialDomain::SURFACE:
+            return getSurfaceProgramBuilder(variant, vsBuilder, fsBuilder);
+
+        case MaterialDomain::POST_PROCESS:
+            return getPostProcessProgramBuilder(variant, vsBuilder, fsBuilder);
+    }
+}
+
+Program FMaterial::getSurfaceProgramBuilder(Variant variant,
+        ShaderBuilder& vsBuilder, ShaderBuilder& fsBuilder) const noexcept {
     // filterVariant() has already been applied in generateCommands(), shouldn't be needed here
     // if we're unlit, we don't have any bits that correspond to lit materials
     assert_invariant(variant == Variant::filterVariant(variant, isVariantLit()) );
@@ -369,7 +401,8 @@ Handle<HwProgram> FMaterial::getSurfaceProgramSlow(Variant variant) const noexce
     Variant vertexVariant   = Variant::filterVariantVertex(variant);
     Variant fragmentVariant = Variant::filterVariantFragment(variant);
 
-    Program pb = getProgramBuilderWithVariants(variant, vertexVariant, fragmentVariant);
+    Program pb = getProgramBuilderWithVariants(variant, vertexVariant, fragmentVariant,
+            vsBuilder, fsBuilder);
     pb
         .setUniformBlock(BindingPoints::PER_VIEW, PerViewUib::_name)
         .setUniformBlock(BindingPoints::PER_RENDERABLE, PerRenderableUib::_name)
@@ -391,13 +424,13 @@ Handle<HwProgram> FMaterial::getSurfaceProgramSlow(Variant variant) const noexce
 
     // getSurfaceBindingIndexMap in GLSLPostProcessor.cpp also needs to update if sampler groups are added.
 
-    return createAndCacheProgram(std::move(pb), variant);
+    return pb;
 }
 
-Handle<HwProgram> FMaterial::getPostProcessProgramSlow(Variant variant)
-    const noexcept {
+Program FMaterial::getPostProcessProgramBuilder(Variant variant,
+        ShaderBuilder& vsBuilder, ShaderBuilder& fsBuilder) const noexcept {
 
-    Program pb = getProgramBuilderWithVariants(variant, variant, variant);
+    Program pb = getProgramBuilderWithVariants(variant, variant, variant, vsBuilder, fsBuilder);
     pb.setUniformBlock(BindingPoints::PER_VIEW, PerViewUib::_name)
       .setUniformBlock(BindingPoints::PER_MATERIAL_INSTANCE, mUniformInterfaceBlock.getName());
 
@@ -405,13 +438,15 @@ Handle<HwProgram> FMaterial::getPostProcessProgramSlow(Variant variant)
 
     // getPostProcessBindingIndexMap in GLSLPostProcessor.cpp also needs to update if sampler groups are added.
 
-    return createAndCacheProgram(std::move(pb), variant);
+    return pb;
 }
 
 Program FMaterial::getProgramBuilderWithVariants(
         Variant variant,
         Variant vertexVariant,
-        Variant fragmentVariant) const noexcept {
+        Variant fragmentVariant,
+        ShaderBuilder& vsBuilder,
+        ShaderBuilder& fsBuilder) const noexcept {
     const ShaderModel sm = mEngine.getDriver().getShaderModel();
     const bool isNoop = mEngine.getBackend() == Backend::NOOP;
 
@@ -419,8 +454,6 @@ Program FMaterial::getProgramBuilderWithVariants(
      * Vertex shader
      */
 
-    filaflat::ShaderBuilder& vsBuilder = mEngine.getVertexShaderBuilder();
-
     UTILS_UNUSED_IN_RELEASE bool vsOK = mMaterialParser->getShader(vsBuilder, sm,
             vertexVariant, ShaderType::VERTEX);
 
@@ -433,8 +466,6 @@ Program FMaterial::getProgramBuilderWithVariants(
      * Fragment shader
      */
 
-    filaflat::ShaderBuilder& fsBuilder = mEngine.getFragmentShaderBuilder();
-
     UTILS_UNUSED_IN_RELEASE bool fsOK = mMaterialParser->getShader(fsBuilder, sm,
             fragmentVariant, ShaderType::FRAGMENT);
 
@@ -445,6 +476,7 @@ Program FMaterial::getProgramBuilderWithVariants(
 
     Program pb;
     pb      .diagnostics(mName, variant)
+            .cacheId(utils::hash::fnv1a(&variant.key, sizeof(variant.key), mCacheId))
             .withVertexShader(vsBuilder.data(), vsBuilder.size())
             .withFragmentShader(fsBuilder.data(), fsBuilder.size());
     return pb;
@@ -458,6 +490,129 @@ Handle<HwProgram> FMaterial::createAndCacheProgram(Program&& p, Variant variant)
     return program;
 }
 
+bool FMaterial::hasVariant(Variant variant) const noexcept {
+    const ShaderModel sm = mEngine.getDriver().getShaderModel();
+    Variant vertexVariant = variant;
+    Variant fragmentVariant = variant;
+    if (mMaterialDomain == MaterialDomain::SURFACE) {
+        vertexVariant   = Variant::filterVariantVertex(variant);
+        fragmentVariant = Variant::filterVariantFragment(variant);
+    }
+    return mMaterialParser->hasShader(sm, vertexVariant, ShaderType::VERTEX) &&
+           mMaterialParser->hasShader(sm, fragmentVariant, ShaderType::FRAGMENT);
+}
+
+static Variant::type_t getVariantBits(UserVariantFilterMask variants) noexcept {
+    Variant::type_t bits = 0;
+    if (variants & uint32_t(UserVariantFilterBit::DIRECTIONAL_LIGHTING)) bits |= Variant::DIR;
+    if (variants & uint32_t(UserVariantFilterBit::DYNAMIC_LIGHTING))     bits |= Variant::DYN;
+    if (variants & uint32_t(UserVariantFilterBit::SHADOW_RECEIVER))      bits |= Variant::SRE;
+    if (variants & uint32_t(UserVariantFilterBit::SKINNING))             bits |= Variant::SKN;
+    if (variants & uint32_t(UserVariantFilterBit::FOG))                  bits |= Variant::FOG;
+    if (variants & uint32_t(UserVariantFilterBit::VSM))                  bits |= Variant::VSM;
+    return bits;
+}
+
+std::vector<Variant> FMaterial::getCompileVariants(UserVariantFilterMask variants) const noexcept {
+    const Variant::type_t features = getVariantBits(variants);
+    std::vector<Variant> selected;
+    for (Variant::type_t k = 0, n = VARIANT_COUNT; k < n; ++k) {
+        const Variant variant(k);
+        if (mCachedPrograms[k]) {
+            continue;
+        }
+        if (mMaterialDomain == MaterialDomain::SURFACE) {
+            if (Variant::isReserved(variant) ||
+                    Variant::filterVariant(variant, mIsVariantLit) != variant) {
+                continue;
+            }
+            if (Variant::isValidDepthVariant(variant)) {
+                // the picking bit aliases the fog bit, picking variants are never prepared
+                if (variant.hasPicking() || ((k & ~Variant::DEP) & ~features)) {
+                    continue;
+                }
+            } else if (k & ~features) {
+                continue;
+            }
+        }
+        if (hasVariant(variant)) {
+            selected.push_back(variant);
+        }
+    }
+    return selected;
+}
+
+void FMaterial::compile(UserVariantFilterMask variants) noexcept {
+    SYSTRACE_CALL();
+
+    if (mEngine.getBackend() == Backend::NOOP) {
+        return;
+    }
+
+    JobSystem& js = mEngine.getJobSystem();
+
+    // only one batch of programs is prepared at a time
+    if (mCompileJob) {
+        js.waitAndRelease(mCompileJob);
+        createPendingPrograms();
+    }
+
+    const std::vector<Variant> selected = getCompileVariants(variants);
+    if (selected.empty()) {
+        return;
+    }
+
+    // Reconstructing the shaders from the material's dictionaries is the expensive part, it's
+    // done on the JobSystem. Only the final createProgram() happens on this thread, in
+    // commitPendingPrograms().
+    mPendingProgramCount.store(uint32_t(selected.size()), std::memory_order_relaxed);
+    JobSystem::Job* parent = js.createJob();
+    js.setPriority(parent, JobSystem::JobPriority::BACKGROUND);
+    for (Variant variant : selected) {
+        js.run(jobs::createJob(js, parent, [this, variant]() {
+            // the engine's shader builders can only be used from the main thread
+            ShaderBuilder vsBuilder;
+            ShaderBuilder fsBuilder;
+            Program pb = getProgramBuilder(variant, vsBuilder, fsBuilder);
+            std::unique_lock<std::mutex> lock(mPendingProgramsLock);
+            mPendingPrograms.emplace_back(variant, std::move(pb));
+            lock.unlock();
+            mPendingProgramCount.fetch_sub(1, std::memory_order_release);
+        }));
+    }
+    mCompileJob = js.runAndRetain(parent);
+}
+
+void FMaterial::commitPendingProgramsSlow() noexcept {
+    // this must be read before taking the pending programs, so we can't miss the last ones
+    const bool done = mPendingProgramCount.load(std::memory_order_acquire) == 0;
+    createPendingPrograms();
+    if (done) {
+        mEngine.getJobSystem().waitAndRelease(mCompileJob);
+    }
+}
+
+void FMaterial::createPendingPrograms() noexcept {
+    std::vector<std::pair<Variant, Program>> programs;
+    std::unique_lock<std::mutex> lock(mPendingProgramsLock);
+    std::swap(programs, mPendingPrograms);
+    lock.unlock();
+    for (auto& [variant, program] : programs) {
+        // the program might have been needed, and created, before it was ready
+        if (!mCachedPrograms[variant.key]) {
+            createAndCacheProgram(std::move(program), variant);
+        }
+    }
+}
+
+void FMaterial::cancelPendingPrograms() noexcept {
+    if (mCompileJob) {
+        mEngine.getJobSystem().waitAndRelease(mCompileJob);
+        std::lock_guard<std::mutex> lock(mPendingProgramsLock);
+        mPendingPrograms.clear();
+    }
+}
+
 size_t FMaterial::getParameters(ParameterInfo* parameters, size_t count) const noexcept {
     count = std::min(count, getParameterCount());
 
@@ -509,6 +664,7 @@ size_t FMaterial::getParameters(ParameterInfo* parameters, size_t count) const n
 void FMaterial::applyPendingEdits() noexcept {
     const char* name = mName.c_str();
     slog.d << "Applying edits to " << (name ? name : "(untitled)") << io::endl;
+    cancelPendingPrograms();
     destroyPrograms(mEngine);
     for (auto& program : mCachedPrograms) {
         program.clear();
@@ -516,6 +672,7 @@ void FMaterial::applyPendingEdits() noexcept {
     delete mMaterialParser;
     mMaterialParser = mPendingEdits;
     mPendingEdits = nullptr;
+    mCacheId = mMaterialParser->computeHash();
 }
 
 /**
@@ -571,6 +728,10 @@ MaterialInstance* Material::createInstance(const char* name) const noexcept {
     return upcast(this)->createInstance(name);
 }
 
+void Material::compile(UserVariantFilterMask variants) noexcept {
+    upcast(this)->compile(variants);
+}
+
 const char* Material::getName() const noexcept {
     return upcast(this)->getName().c_str();
 }
@@ -671,6 +832,65 @@ bool Material::isSampler(const char* name) const noexcept {
     return upcast(this)->isSampler(name);
 }
 
+// Returns whether a ParameterHandle<T> can set a uniform of the given type, bool parameters are
+// stored as uint32_t.
+template<typename T>
+static constexpr bool isHandleCompatible(UniformType type) noexcept {
+    using Type = UniformType;
+    if constexpr (std::is_same_v<T, float>)     return type == Type::FLOAT;
+    if constexpr (std::is_same_v<T, int32_t>)   return type == Type::INT;
+    if constexpr (std::is_same_v<T, uint32_t>)  return type == Type::UINT  || type == Type::BOOL;
+    if constexpr (std::is_same_v<T, int2>)      return type == Type::INT2;
+    if constexpr (std::is_same_v<T, int3>)      return type == Type::INT3;
+    if constexpr (std::is_same_v<T, int4>)      return type == Type::INT4;
+    if constexpr (std::is_same_v<T, uint2>)     return type == Type::UINT2 || type == Type::BOOL2;
+    if constexpr (std::is_same_v<T, uint3>)     return type == Type::UINT3 || type == Type::BOOL3;
+    if constexpr (std::is_same_v<T, uint4>)     return type == Type::UINT4 || type == Type::BOOL4;
+    if constexpr (std::is_same_v<T, float2>)    return type == Type::FLOAT2;
+    if constexpr (std::is_same_v<T, float3>)    return type == Type::FLOAT3;
+    if constexpr (std::is_same_v<T, float4>)    return type == Type::FLOAT4;
+    if constexpr (std::is_same_v<T, mat3f>)     return type == Type::MAT3;
+    if constexpr (std::is_same_v<T, mat4f>)     return type == Type::MAT4;
+    return false;
+}
+
+template<typename T, typename>
+MaterialInstance::ParameterHandle<T> Material::getParameterHandle(const char* name) const noexcept {
+    auto const* info = upcast(this)->getUniformInterfaceBlock().getUniformInfo(name);
+    if (UTILS_UNLIKELY(!info)) {
+        return {};
+    }
+    if (!ASSERT_PRECONDITION_NON_FATAL(
+            isHandleCompatible<T>(info->type),
+            "parameter \"%s\" doesn't match the type of the handle", name)) {
+        return {};
+    }
+    return { this, uint32_t(info->getBufferOffset(0)), info->size };
+}
+
+template UTILS_PUBLIC MaterialInstance::ParameterHandle<float>    Material::getParameterHandle<float>   (const char* name) const noexcept;
+template UTILS_PUBLIC MaterialInstance::ParameterHandle<int32_t>  Material::getParameterHandle<int32_t> (const char* name) const noexcept;
+template UTILS_PUBLIC MaterialInstance::ParameterHandle<uint32_t> Material::getParameterHandle<uint32_t>(const char* name) const noexcept;
+template UTILS_PUBLIC MaterialInstance::ParameterHandle<int2>     Material::getParameterHandle<int2>    (const char* name) const noexcept;
+template UTILS_PUBLIC MaterialInstance::ParameterHandle<int3>     Material::getParameterHandle<int3>    (const char* name) const noexcept;
+template UTILS_PUBLIC MaterialInstance::ParameterHandle<int4>     Material::getParameterHandle<int4>    (const char* name) const noexcept;
+template UTILS_PUBLIC MaterialInstance::ParameterHandle<uint2>    Material::getParameterHandle<uint2>   (const char* name) const noexcept;
+template UTILS_PUBLIC MaterialInstance::ParameterHandle<uint3>    Material::getParameterHandle<uint3>   (const char* name) const noexcept;
+template UTILS_PUBLIC MaterialInstance::ParameterHandle<uint4>    Material::getParameterHandle<uint4>   (const char* name) const noexcept;
+template UTILS_PUBLIC MaterialInstance::ParameterHandle<float2>   Material::getParameterHandle<float2>  (const char* name) const noexcept;
+template UTILS_PUBLIC MaterialInstance::ParameterHandle<float3>   Material::getParameterHandle<float3>  (const char* name) const noexcept;
+template UTILS_PUBLIC MaterialInstance::ParameterHandle<float4>   Material::getParameterHandle<float4>  (const char* name) const noexcept;
+template UTILS_PUBLIC MaterialInstance::ParameterHandle<mat3f>    Material::getParameterHandle<mat3f>   (const char* name) const noexcept;
+template UTILS_PUBLIC MaterialInstance::ParameterHandle<mat4f>    Material::getParameterHandle<mat4f>   (const char* name) const noexcept;
+
+MaterialInstance::SamplerHandle Material::getSamplerHandle(const char* name) const noexcept {
+    auto const* info = upcast(this)->getSamplerInterfaceBlock().getSamplerInfo(name);
+    if (UTILS_UNLIKELY(!info)) {
+        return {};
+    }
+    return { this, uint32_t(info->offset) };
+}
+
 MaterialInstance* Material::getDefaultInstance() noexcept {
     return upcast(this)->getDefaultInstance();
 }
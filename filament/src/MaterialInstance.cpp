@@ -308,6 +308,32 @@ void FMaterialInstance::setParameterImpl(const char* name,
     setParameter(name, upcast(texture)->getHwHandle(), sampler.getSamplerParams());
 }
 
+void FMaterialInstance::setParameterImpl(SamplerHandle handle,
+        Texture const* texture, TextureSampler const& sampler) noexcept {
+    if (UTILS_LIKELY(handle.isValid())) {
+        assert_invariant(handle.mMaterial == mMaterial);
+        mSamplers.setSampler(handle.mIndex,
+                { upcast(texture)->getHwHandle(), sampler.getSamplerParams() });
+    }
+}
+
+template<typename T>
+void FMaterialInstance::setParameters(MaterialInstance* const* instances, size_t instanceCount,
+        ParameterHandle<T> const* handles, size_t handleCount, T const* values) noexcept {
+    for (size_t i = 0; i < instanceCount; i++, values += handleCount) {
+        FMaterialInstance* const mi = upcast(instances[i]);
+        // this marks the whole buffer as modified once, instead of once per parameter
+        void* const buffer = mi->mUniforms.invalidate();
+        for (size_t j = 0; j < handleCount; j++) {
+            ParameterHandle<T> const& handle = handles[j];
+            if (UTILS_LIKELY(handle.isValid())) {
+                assert_invariant(handle.mMaterial == mi->mMaterial);
+                UniformBuffer::setUniform(buffer, handle.mOffset, values[j]);
+            }
+        }
+    }
+}
+
 void FMaterialInstance::setMaskThreshold(float threshold) noexcept {
     setParameter("_maskThreshold", math::saturate(threshold));
 }
@@ -364,6 +390,56 @@ void MaterialInstance::setParameter(const char* name, Texture const* texture,
     return upcast(this)->setParameterImpl(name, texture, sampler);
 }
 
+void MaterialInstance::setParameter(SamplerHandle handle, Texture const* texture,
+        TextureSampler const& sampler) noexcept {
+    upcast(this)->setParameterImpl(handle, texture, sampler);
+}
+
+template<typename T>
+void MaterialInstance::setParameter(ParameterHandle<T> handle,
+        typename ParameterHandle<T>::value_type const& value) noexcept {
+    upcast(this)->setParameterImpl(handle, value);
+}
+
+template<typename T>
+void MaterialInstance::setParameter(ParameterHandle<T> handle,
+        typename ParameterHandle<T>::value_type const* values, size_t count) noexcept {
+    upcast(this)->setParameterImpl(handle, values, count);
+}
+
+template<typename T>
+void MaterialInstance::setParameters(MaterialInstance* const* instances, size_t instanceCount,
+        ParameterHandle<T> const* handles, size_t handleCount,
+        typename ParameterHandle<T>::value_type const* values) noexcept {
+    FMaterialInstance::setParameters(instances, instanceCount, handles, handleCount, values);
+}
+
+#define INSTANTIATE_HANDLE_SETTERS(T)                                                           \
+    template UTILS_PUBLIC void MaterialInstance::setParameter<T>(                               \
+            ParameterHandle<T> handle, T const& value) noexcept;                                \
+    template UTILS_PUBLIC void MaterialInstance::setParameter<T>(                               \
+            ParameterHandle<T> handle, T const* values, size_t count) noexcept;                 \
+    template UTILS_PUBLIC void MaterialInstance::setParameters<T>(                              \
+            MaterialInstance* const* instances, size_t instanceCount,                           \
+            ParameterHandle<T> const* handles, size_t handleCount, T const* values) noexcept;
+
+INSTANTIATE_HANDLE_SETTERS(float)
+INSTANTIATE_HANDLE_SETTERS(int32_t)
+INSTANTIATE_HANDLE_SETTERS(uint32_t)
+INSTANTIATE_HANDLE_SETTERS(int2)
+INSTANTIATE_HANDLE_SETTERS(int3)
+INSTANTIATE_HANDLE_SETTERS(int4)
+INSTANTIATE_HANDLE_SETTERS(uint2)
+INSTANTIATE_HANDLE_SETTERS(uint3)
+INSTANTIATE_HANDLE_SETTERS(uint4)
+INSTANTIATE_HANDLE_SETTERS(float2)
+INSTANTIATE_HANDLE_SETTERS(float3)
+INSTANTIATE_HANDLE_SETTERS(float4)
+INSTANTIATE_HANDLE_SETTERS(mat3f)
+INSTANTIATE_HANDLE_SETTERS(mat4f)
+
+#undef INSTANTIATE_HANDLE_SETTERS
+
 void MaterialInstance::setParameter(const char* name, RgbType type, float3 color) noexcept {
     upcast(this)->setParameterImpl<float3>(name, Color::toLinear(type, color));
 }
@@ -32,6 +32,7 @@
 #include <private/filament/Variant.h>
 
 #include <utils/CString.h>
+#include <utils/Hash.h>
 
 #include <stdlib.h>
 
@@ -102,7 +103,9 @@ MaterialParser::ParseResult MaterialParser::parse() noexcept {
         if (!cc.hasChunk(mImpl.mMaterialTag) || !cc.hasChunk(mImpl.mDictionaryTag)) {
             return ParseResult::ERROR_MISSING_BACKEND;
         }
-        if (!DictionaryReader::unflatten(cc, mImpl.mDictionaryTag, mImpl.mBlobDictionary)) {
+        // SPIR-V is only decoded when a program needs it, the package outlives the dictionary.
+        if (!DictionaryReader::unflatten(cc, mImpl.mDictionaryTag, mImpl.mBlobDictionary,
+                /* decodeSpirv = */ false)) {
             return ParseResult::ERROR_OTHER;
         }
         if (!mImpl.mMaterialChunk.readIndex(mImpl.mMaterialTag)) {
@@ -282,6 +285,15 @@ bool MaterialParser::getShader(ShaderBuilder& shader,
             mImpl.mBlobDictionary, (uint8_t)shaderModel, variant, stage);
 }
 
+bool MaterialParser::hasShader(ShaderModel shaderModel, Variant variant,
+        ShaderType stage) const noexcept {
+    return mImpl.mMaterialChunk.hasShader((uint8_t)shaderModel, variant, stage);
+}
+
+uint64_t MaterialParser::computeHash() const noexcept {
+    return utils::hash::fnv1a(mImpl.mManagedBuffer.data(), mImpl.mManagedBuffer.size());
+}
+
 // ------------------------------------------------------------------------------------------------
 
 
@@ -95,6 +95,12 @@ public:
     bool getShader(filaflat::ShaderBuilder& shader, backend::ShaderModel shaderModel,
             Variant variant, backend::ShaderType stage) noexcept;
 
+    bool hasShader(backend::ShaderModel shaderModel, Variant variant,
+            backend::ShaderType stage) const noexcept;
+
+    // returns a hash of the whole material package, which is stable across runs
+    uint64_t computeHash() const noexcept;
+
 private:
     struct MaterialParserDetails {
         MaterialParserDetails(backend::Backend backend, const void* data, size_t size);
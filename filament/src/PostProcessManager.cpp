@@ -37,6 +37,7 @@
 #include "details/Material.h"
 #include "details/MaterialInstance.h"
 #include "details/Texture.h"
+#include "details/View.h"
 
 #include "generated/resources/materials.h"
 
@@ -93,6 +94,7 @@ PostProcessManager::PostProcessMaterial::PostProcessMaterial(
     swap(mEngine, rhs.mEngine);
     swap(mData, rhs.mData);
     swap(mSize, rhs.mSize);
+    swap(mLastUse, rhs.mLastUse);
     swap(mHasMaterial, rhs.mHasMaterial);
 }
 
@@ -102,6 +104,8 @@ PostProcessManager::PostProcessMaterial& PostProcessManager::PostProcessMaterial
     swap(mEngine, rhs.mEngine);
     swap(mData, rhs.mData);
     swap(mSize, rhs.mSize);
+    swap(mLastUse, rhs.mLastUse);
+    swap(mHasMaterial, rhs.mHasMaterial);
     return *this;
 }
 
@@ -123,6 +127,13 @@ void PostProcessManager::PostProcessMaterial::terminate(FEngine& engine) noexcep
     }
 }
 
+void PostProcessManager::PostProcessMaterial::unload(FEngine& engine) noexcept {
+    assert_invariant(mHasMaterial);
+    engine.destroy(mMaterial);
+    mEngine = &engine;              // aliased to mMaterial
+    mHasMaterial = false;
+}
+
 UTILS_NOINLINE
 FMaterial* PostProcessManager::PostProcessMaterial::loadMaterial() const noexcept {
     // TODO: After all materials using this class have been converted to the post-process material
@@ -183,16 +194,6 @@ PostProcessManager::PostProcessManager(FEngine& engine) noexcept
 {
 }
 
-UTILS_NOINLINE
-void PostProcessManager::registerPostProcessMaterial(utils::StaticString name, uint8_t const* data, int size) {
-    mMaterialRegistry.try_emplace(name, mEngine, data, size);
-}
-
-PostProcessManager::PostProcessMaterial& PostProcessManager::getPostProcessMaterial(utils::StaticString name) noexcept {
-    assert_invariant(mMaterialRegistry.find(name) != mMaterialRegistry.end());
-    return mMaterialRegistry[name];
-}
-
 #define MATERIAL(n) MATERIALS_ ## n ## _DATA, MATERIALS_ ## n ## _SIZE
 
 struct MaterialInfo {
@@ -236,6 +237,15 @@ static const MaterialInfo sMaterialList[] = {
         { "fsr_rcas",                   MATERIAL(FSR_RCAS) },
 };
 
+PostProcessManager::PostProcessMaterial& PostProcessManager::getPostProcessMaterial(
+        utils::StaticString name) noexcept {
+    auto pos = mMaterialRegistry.find(name);
+    assert_invariant(pos != mMaterialRegistry.end());
+    PostProcessMaterial& material = pos.value();
+    material.setLastUse(mFrame);
+    return material;
+}
+
 void PostProcessManager::init() noexcept {
     auto& engine = mEngine;
     DriverApi& driver = engine.getDriverApi();
@@ -248,9 +258,11 @@ void PostProcessManager::init() noexcept {
 
     mWorkaroundSplitEasu = driver.isWorkaroundNeeded(Workaround::SPLIT_EASU);
 
-    #pragma nounroll
+    // Registering a material doesn't parse it, this happens the first time it is needed. Inserting
+    // into the registry can move its entries, so all the materials are registered up front.
+    mMaterialRegistry.reserve(sizeof(sMaterialList) / sizeof(sMaterialList[0]));
     for (auto const& info : sMaterialList) {
-        registerPostProcessMaterial(info.name, info.data, info.size);
+        mMaterialRegistry.try_emplace(info.name, mEngine, info.data, info.size);
     }
 
     mStarburstTexture = driver.createTexture(SamplerType::SAMPLER_2D, 1,
@@ -297,6 +309,75 @@ void PostProcessManager::terminate(DriverApi& driver) noexcept {
     }
 }
 
+void PostProcessManager::update() noexcept {
+    mFrame++;
+
+    if (!mMaterialsToPrepare.empty()) {
+        PostProcessMaterial& material = getPostProcessMaterial(mMaterialsToPrepare.back());
+        mMaterialsToPrepare.pop_back();
+        if (!material.isLoaded()) {
+            material.getMaterial()->compile(UserVariantFilterMask(UserVariantFilterBit::ALL));
+        }
+    }
+
+    if (mMaterialTimeout) {
+        for (auto it = mMaterialRegistry.begin(); it != mMaterialRegistry.end(); ++it) {
+            PostProcessMaterial& material = it.value();
+            if (material.isLoaded() && mFrame - material.getLastUse() > mMaterialTimeout) {
+                material.unload(mEngine);
+            }
+        }
+    }
+}
+
+void PostProcessManager::prepareMaterials(FView const& view) noexcept {
+    auto prepare = [this](utils::StaticString name) {
+        if (std::find(mMaterialsToPrepare.begin(), mMaterialsToPrepare.end(), name) ==
+                mMaterialsToPrepare.end()) {
+            mMaterialsToPrepare.push_back(name);
+        }
+    };
+
+    // This mirrors the passes set up by FRenderer, materials that are missed here are simply
+    // loaded when they are first used.
+    AmbientOcclusionOptions const& aoOptions = view.getAmbientOcclusionOptions();
+    if (aoOptions.enabled) {
+        prepare("mipmapDepth");
+        if (aoOptions.bentNormals) {
+            prepare("saoBentNormals");
+            prepare("bilateralBlurBentNormals");
+        } else {
+            prepare("sao");
+            prepare("bilateralBlur");
+        }
+    }
+    if (view.getTemporalAntiAliasingOptions().enabled) {
+        prepare("taa");
+    }
+    if (view.hasPostProcessPass()) {
+        if (view.getDepthOfFieldOptions().enabled) {
+            for (auto name : { "dofCoc", "dofDownsample", "dofMipmap", "dofTiles",
+                    "dofTilesSwizzle", "dofDilate", "dof", "dofMedian", "dofCombine" }) {
+                prepare(utils::StaticString::make(name));
+            }
+        }
+        BloomOptions const bloomOptions = view.getBloomOptions();
+        if (bloomOptions.enabled) {
+            prepare("bloomDownsample");
+            prepare("bloomUpsample");
+            if (bloomOptions.lensFlare) {
+                prepare("flare");
+            }
+        }
+        if (view.getColorGrading()) {
+            prepare("colorGrading");
+        }
+        if (view.getAntiAliasing() == AntiAliasing::FXAA) {
+            prepare("fxaa");
+        }
+    }
+}
+
 backend::Handle<backend::HwTexture> PostProcessManager::getOneTexture() const {
     return mEngine.getOneTexture();
 }
@@ -316,7 +397,7 @@ void PostProcessManager::commitAndRender(FrameGraphResources::RenderPassInfo con
     mi->commit(driver);
     mi->use(driver);
     driver.beginRenderPass(out.target, out.params);
-    driver.draw(material.getPipelineState(variant), mEngine.getFullScreenRenderPrimitive());
+    driver.draw(material.getPipelineState(variant), mEngine.getFullScreenRenderPrimitive(), 1);
     driver.endRenderPass();
 }
 
@@ -650,7 +731,7 @@ FrameGraphId<FrameGraphTexture> PostProcessManager::screenSpaceAmbientOcclusion(
                 pipeline.rasterState.depthFunc = RasterState::DepthFunc::L;
 
                 driver.beginRenderPass(ssao.target, ssao.params);
-                driver.draw(pipeline, fullScreenRenderPrimitive);
+                driver.draw(pipeline, fullScreenRenderPrimitive, 1);
                 driver.endRenderPass();
             });
 
@@ -766,7 +847,7 @@ FrameGraphId<FrameGraphTexture> PostProcessManager::bilateralBlurPass(
                 pipeline.rasterState.depthFunc = RasterState::DepthFunc::L;
 
                 driver.beginRenderPass(blurred.target, blurred.params);
-                driver.draw(pipeline, fullScreenRenderPrimitive);
+                driver.draw(pipeline, fullScreenRenderPrimitive, 1);
                 driver.endRenderPass();
             });
 
@@ -930,7 +1011,7 @@ FrameGraphId<FrameGraphTexture> PostProcessManager::gaussianBlurPass(FrameGraph&
                 // we don't need to call use() here, since it's the same material
 
                 driver.beginRenderPass(hwOutRT.target, hwOutRT.params);
-                driver.draw(separableGaussianBlur.getPipelineState(), fullScreenRenderPrimitive);
+                driver.draw(separableGaussianBlur.getPipelineState(), fullScreenRenderPrimitive, 1);
                 driver.endRenderPass();
             });
 
@@ -1176,7 +1257,7 @@ FrameGraphId<FrameGraphTexture> PostProcessManager::dof(FrameGraph& fg,
                     mi->setParameter("pixelSize", 1.0f / float2{w, h});
                     mi->commit(driver);
                     driver.beginRenderPass(out.target, out.params);
-                    driver.draw(pipeline, fullScreenRenderPrimitive);
+                    driver.draw(pipeline, fullScreenRenderPrimitive, 1);
                     driver.endRenderPass();
                 }
                 driver.setMinMaxLevels(inOutColor, 0, mipmapCount - 1u);
@@ -1594,7 +1675,7 @@ FrameGraphId<FrameGraphTexture> PostProcessManager::bloomPass(FrameGraph& fg,
                         hwOutRT.params.flags.discardStart = TargetBufferFlags::COLOR;
                         hwOutRT.params.flags.discardEnd = TargetBufferFlags::NONE;
                         driver.beginRenderPass(hwOutRT.target, hwOutRT.params);
-                        driver.draw(pipeline, fullScreenRenderPrimitive);
+                        driver.draw(pipeline, fullScreenRenderPrimitive, 1);
                         driver.endRenderPass();
 
                         // prepare the next level
@@ -1702,7 +1783,7 @@ FrameGraphId<FrameGraphTexture> PostProcessManager::bloomPass(FrameGraph& fg,
                         mi->commit(driver);
 
                         driver.beginRenderPass(hwDstRT.target, hwDstRT.params);
-                        driver.draw(pipeline, fullScreenRenderPrimitive);
+                        driver.draw(pipeline, fullScreenRenderPrimitive, 1);
                         driver.endRenderPass();
                     }
 
@@ -1787,7 +1868,7 @@ FrameGraphId<FrameGraphTexture> PostProcessManager::bloomPass(FrameGraph& fg,
                         hwDstRT.params.flags.discardStart = TargetBufferFlags::COLOR;
                         hwDstRT.params.flags.discardEnd = TargetBufferFlags::NONE;
                         driver.beginRenderPass(hwDstRT.target, hwDstRT.params);
-                        driver.draw(pipeline, fullScreenRenderPrimitive);
+                        driver.draw(pipeline, fullScreenRenderPrimitive, 1);
                         driver.endRenderPass();
 
                         // prepare the next level
@@ -1851,7 +1932,7 @@ FrameGraphId<FrameGraphTexture> PostProcessManager::bloomPass(FrameGraph& fg,
                         mi->commit(driver);
 
                         driver.beginRenderPass(hwDstRT.target, hwDstRT.params);
-                        driver.draw(pipeline, fullScreenRenderPrimitive);
+                        driver.draw(pipeline, fullScreenRenderPrimitive, 1);
                         driver.endRenderPass();
                     }
 
@@ -1944,7 +2025,7 @@ void PostProcessManager::colorGradingSubpass(DriverApi& driver,
             PostProcessVariant::TRANSLUCENT : PostProcessVariant::OPAQUE);
 
     driver.nextSubpass();
-    driver.draw(material.getPipelineState(variant), fullScreenRenderPrimitive);
+    driver.draw(material.getPipelineState(variant), fullScreenRenderPrimitive, 1);
 }
 
 
@@ -1963,7 +2044,7 @@ void PostProcessManager::customResolveSubpass(DriverApi& driver) noexcept {
     FMaterialInstance* mi = material.getMaterialInstance();
     mi->use(driver);
     driver.nextSubpass();
-    driver.draw(material.getPipelineState(), fullScreenRenderPrimitive);
+    driver.draw(material.getPipelineState(), fullScreenRenderPrimitive, 1);
 }
 
 FrameGraphId<FrameGraphTexture> PostProcessManager::customResolveUncompressPass(FrameGraph& fg,
@@ -2305,7 +2386,8 @@ FrameGraphId<FrameGraphTexture> PostProcessManager::taa(FrameGraph& fg,
                     out.params.subpassMask = 1;
                 }
                 driver.beginRenderPass(out.target, out.params);
-                driver.draw(material.getPipelineState(variant), mEngine.getFullScreenRenderPrimitive());
+                driver.draw(material.getPipelineState(variant),
+                        mEngine.getFullScreenRenderPrimitive(), 1);
                 if (colorGradingConfig.asSubpass) {
                     colorGradingSubpass(driver, colorGradingConfig);
                 }
@@ -2488,7 +2570,7 @@ FrameGraphId<FrameGraphTexture> PostProcessManager::blendBlit(
                     if (translucent) {
                         enableTranslucentBlending(pipeline);
                     }
-                    driver.draw(pipeline, fullScreenRenderPrimitive);
+                    driver.draw(pipeline, fullScreenRenderPrimitive, 1);
                 }
 
                 { // scope to not leak local variables
@@ -2502,7 +2584,7 @@ FrameGraphId<FrameGraphTexture> PostProcessManager::blendBlit(
                     if (twoPassesEASU) {
                         pipeline.rasterState.depthFunc = backend::SamplerCompareFunc::NE;
                     }
-                    driver.draw(pipeline, fullScreenRenderPrimitive);
+                    driver.draw(pipeline, fullScreenRenderPrimitive, 1);
                 }
 
                 driver.endRenderPass();
@@ -2543,7 +2625,7 @@ FrameGraphId<FrameGraphTexture> PostProcessManager::blendBlit(
 
                     PipelineState pipeline(material.getPipelineState(variant));
                     driver.beginRenderPass(out.target, out.params);
-                    driver.draw(pipeline, fullScreenRenderPrimitive);
+                    driver.draw(pipeline, fullScreenRenderPrimitive, 1);
                     driver.endRenderPass();
                 });
 
@@ -2681,7 +2763,7 @@ FrameGraphId<FrameGraphTexture> PostProcessManager::vsmMipmapPass(FrameGraph& fg
                 mi->use(driver);
 
                 driver.beginRenderPass(out.target, out.params);
-                driver.draw(pipeline, mEngine.getFullScreenRenderPrimitive());
+                driver.draw(pipeline, mEngine.getFullScreenRenderPrimitive(), 1);
                 driver.endRenderPass();
 
                 if (finalize) {
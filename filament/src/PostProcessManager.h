@@ -36,6 +36,7 @@
 #include <tsl/robin_map.h>
 
 #include <random>
+#include <vector>
 
 namespace filament {
 
@@ -69,6 +70,69 @@ public:
     void init() noexcept;
     void terminate(backend::DriverApi& driver) noexcept;
 
+    // Called once per frame before any post-processing pass is set up. Loads one of the materials
+    // queued by prepareMaterials() and destroys the ones that have not been used recently.
+    void update() noexcept;
+
+    // Queues the materials needed by the current options of the given view, they are then loaded
+    // by update(), one per frame, and their programs are prepared in the background.
+    void prepareMaterials(FView const& view) noexcept;
+
+    // Materials that have not been used for this many frames are destroyed, they are loaded again
+    // when needed. 0 keeps all the materials until terminate().
+    void setMaterialTimeout(uint32_t frameCount) noexcept { mMaterialTimeout = frameCount; }
+
+    class PostProcessMaterial {
+    public:
+        PostProcessMaterial() noexcept;
+        PostProcessMaterial(FEngine& engine, uint8_t const* data, int size) noexcept;
+
+        PostProcessMaterial(PostProcessMaterial const& rhs) = delete;
+        PostProcessMaterial& operator=(PostProcessMaterial const& rhs) = delete;
+
+        PostProcessMaterial(PostProcessMaterial&& rhs) noexcept;
+        PostProcessMaterial& operator=(PostProcessMaterial&& rhs) noexcept;
+
+        ~PostProcessMaterial();
+
+        void terminate(FEngine& engine) noexcept;
+
+        FMaterial* getMaterial() const;
+        FMaterialInstance* getMaterialInstance() const;
+
+        backend::PipelineState getPipelineState(Variant::type_t variantKey = 0u) const noexcept;
+
+        bool isLoaded() const noexcept { return mHasMaterial; }
+
+        // Destroys the material, it is loaded again by the next call that needs it.
+        void unload(FEngine& engine) noexcept;
+
+        uint32_t getLastUse() const noexcept { return mLastUse; }
+        void setLastUse(uint32_t frame) noexcept { mLastUse = frame; }
+
+    private:
+        FMaterial* assertMaterial() const noexcept;
+        FMaterial* loadMaterial() const noexcept;
+
+        union {
+            struct {
+                mutable FMaterial* mMaterial;
+            };
+            struct {
+                FEngine* mEngine;
+                uint8_t const* mData;
+            };
+        };
+        uint32_t mSize{};
+        uint32_t mLastUse{};
+        mutable bool mHasMaterial{};
+    };
+
+    // Returns the material with the given name, which must be one of the built-in post-process
+    // materials. The material is parsed the first time it is used, references to it stay valid
+    // until terminate().
+    PostProcessMaterial& getPostProcessMaterial(utils::StaticString name) noexcept;
+
     // methods below are ordered relative to their position in the pipeline (as much as possible)
 
     // structure (depth) pass
@@ -166,7 +230,6 @@ public:
 
 private:
     FEngine& mEngine;
-    class PostProcessMaterial;
 
     struct BilateralPassConfig {
         uint8_t kernelSize = 11;
@@ -192,47 +255,14 @@ private:
             PostProcessMaterial const& material,
             backend::DriverApi& driver) const noexcept;
 
-    class PostProcessMaterial {
-    public:
-        PostProcessMaterial() noexcept;
-        PostProcessMaterial(FEngine& engine, uint8_t const* data, int size) noexcept;
+    using MaterialRegistry = tsl::robin_map<utils::StaticString, PostProcessMaterial>;
 
-        PostProcessMaterial(PostProcessMaterial const& rhs) = delete;
-        PostProcessMaterial& operator=(PostProcessMaterial const& rhs) = delete;
-
-        PostProcessMaterial(PostProcessMaterial&& rhs) noexcept;
-        PostProcessMaterial& operator=(PostProcessMaterial&& rhs) noexcept;
-
-        ~PostProcessMaterial();
-
-        void terminate(FEngine& engine) noexcept;
-
-        FMaterial* getMaterial() const;
-        FMaterialInstance* getMaterialInstance() const;
-
-        backend::PipelineState getPipelineState(Variant::type_t variantKey = 0u) const noexcept;
-
-    private:
-        FMaterial* assertMaterial() const noexcept;
-        FMaterial* loadMaterial() const noexcept;
-
-        union {
-            struct {
-                mutable FMaterial* mMaterial;
-            };
-            struct {
-                FEngine* mEngine;
-                uint8_t const* mData;
-            };
-        };
-        uint32_t mSize{};
-        mutable bool mHasMaterial{};
-    };
-
-    tsl::robin_map<utils::StaticString, PostProcessMaterial> mMaterialRegistry;
-
-    void registerPostProcessMaterial(utils::StaticString name, uint8_t const* data, int size);
-    PostProcessMaterial& getPostProcessMaterial(utils::StaticString name) noexcept;
+    // All the materials are registered by init() and never added afterwards, which keeps
+    // references to them stable.
+    MaterialRegistry mMaterialRegistry;
+    std::vector<utils::StaticString> mMaterialsToPrepare;
+    uint32_t mFrame = 0;
+    uint32_t mMaterialTimeout = 0;
 
     backend::Handle<backend::HwTexture> mStarburstTexture;
 
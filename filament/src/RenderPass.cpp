@@ -28,6 +28,7 @@
 #include <private/filament/UibStructs.h>
 
 #include <utils/JobSystem.h>
+#include <utils/Log.h>
 #include <utils/Systrace.h>
 
 #include <utility>
@@ -117,7 +118,13 @@ void RenderPass::appendCommands(CommandTypeFlags const commandTypeFlags) noexcep
     auto work = [commandTypeFlags, curr, &soa, variant, renderFlags, visibilityMask, cameraPosition,
                  cameraForwardVector]
             (uint32_t startIndex, uint32_t indexCount) {
-        RenderPass::generateCommands(commandTypeFlags, curr,
+        // commands of the renderables before startIndex come first
+        uint32_t offset = FScene::getPrimitiveCount(soa, startIndex);
+        // double the color pass for transparent objects that need to render twice
+        const bool colorPass  = bool(commandTypeFlags & CommandTypeFlags::COLOR);
+        const bool depthPass  = bool(commandTypeFlags & CommandTypeFlags::DEPTH);
+        offset *= uint32_t(colorPass * 2 + depthPass);
+        RenderPass::generateCommands(commandTypeFlags, curr + offset,
                 soa, { startIndex, startIndex + indexCount }, variant, renderFlags, visibilityMask,
                 cameraPosition, cameraForwardVector);
     };
@@ -153,18 +160,107 @@ void RenderPass::appendCustomCommand(Pass pass, CustomCommand custom, uint32_t o
     curr->key = cmd;
 }
 
+void RenderPass::reserveCommands(CommandTypeFlags const commandTypeFlags) noexcept {
+    assert_invariant(mRenderableSoa);
+    assert_invariant(mCommandBegin == nullptr);
+
+    utils::Range<uint32_t> vr = mVisibleRenderables;
+    if (UTILS_UNLIKELY(vr.empty())) {
+        return;
+    }
+
+    // Only the renderables selected by the visibility mask get storage, e.g. a spot light's
+    // shadow map only needs room for its own casters, not for the casters of all the lights.
+    // We can't use the summed primitive counts here, because they're only valid for the range
+    // they were last computed for, which can change while the commands are generated.
+    auto const* const UTILS_RESTRICT primitives = mRenderableSoa->data<FScene::PRIMITIVES>();
+    auto const* const UTILS_RESTRICT visibleMask = mRenderableSoa->data<FScene::VISIBLE_MASK>();
+    const FScene::VisibleMaskType visibilityMask = mVisibilityMask;
+    uint32_t commandCount = 0;
+    for (uint32_t i : vr) {
+        commandCount += (visibleMask[i] & visibilityMask) ? primitives[i].size() : 0;
+    }
+    if (UTILS_UNLIKELY(commandCount == 0)) {
+        return;
+    }
+    const bool colorPass  = bool(commandTypeFlags & CommandTypeFlags::COLOR);
+    const bool depthPass  = bool(commandTypeFlags & CommandTypeFlags::DEPTH);
+    commandCount *= uint32_t(colorPass * 2 + depthPass);
+    commandCount += 1; // for the sentinel
+
+    Command* const curr = mCommandArena.alloc<Command>(commandCount);
+    if (UTILS_UNLIKELY(!curr)) {
+        slog.e << "RenderPass: out of command storage, " << commandCount
+               << " commands dropped" << io::endl;
+        return;
+    }
+    mCommandBegin = curr;
+    mCommandEnd = curr + commandCount;
+    mReservedCommandTypeFlags = commandTypeFlags;
+}
+
+void RenderPass::generateReservedCommands() noexcept {
+    SYSTRACE_CALL();
+
+    if (UTILS_UNLIKELY(mCommandBegin == nullptr)) {
+        return;
+    }
+
+    // Parallelism comes from generating several passes at once, so the whole range is processed
+    // here, which is also what allows not to rely on the summed primitive counts.
+    // The renderables rejected by the visibility mask don't have storage, so the commands are
+    // generated for each run of selected renderables.
+    FScene::RenderableSoa const& soa = *mRenderableSoa;
+    auto const* const UTILS_RESTRICT visibleMask = soa.data<FScene::VISIBLE_MASK>();
+    const FScene::VisibleMaskType visibilityMask = mVisibilityMask;
+    const Range<uint32_t> vr = mVisibleRenderables;
+    CameraInfo const& camera = mCamera;
+    const float3 cameraPosition(camera.getPosition());
+    const float3 cameraForwardVector(camera.getForwardVector());
+
+    Command* curr = mCommandBegin;
+    uint32_t first = vr.first;
+    while (first < vr.last) {
+        while (first < vr.last && !(visibleMask[first] & visibilityMask)) {
+            first++;
+        }
+        uint32_t last = first;
+        while (last < vr.last && (visibleMask[last] & visibilityMask)) {
+            last++;
+        }
+        if (first < last) {
+            curr = RenderPass::generateCommands(mReservedCommandTypeFlags, curr,
+                    soa, { first, last }, mVariant, mFlags, visibilityMask,
+                    cameraPosition, cameraForwardVector);
+        }
+        first = last;
+    }
+
+    assert_invariant(curr == mCommandEnd - 1);
+    mCommandEnd[-1].key = uint64_t(Pass::SENTINEL);
+
+    // the commands trimmed by the sort stay allocated, since the Arena could be in use by
+    // another thread -- they're only the no-op commands, if any.
+    mCommandEnd = sortAndTrim(mCommandBegin, mCommandEnd);
+}
+
 void RenderPass::sortCommands() noexcept {
     SYSTRACE_NAME("sort and trim commands");
 
-    std::sort(mCommandBegin, mCommandEnd);
+    Command const* const last = sortAndTrim(mCommandBegin, mCommandEnd);
+
+    resize(uint32_t(last - mCommandBegin));
+}
+
+/* static */
+RenderPass::Command* RenderPass::sortAndTrim(Command* begin, Command* end) noexcept {
+    std::sort(begin, end);
 
     // find the last command
-    Command const* const last = std::partition_point(mCommandBegin, mCommandEnd,
+    return std::partition_point(begin, end,
             [](Command const& c) {
                 return c.key != uint64_t(Pass::SENTINEL);
             });
-
-    resize(uint32_t(last - mCommandBegin));
 }
 
 /* static */
@@ -211,7 +307,7 @@ void RenderPass::setupColorCommand(Command& cmdDraw,
 
 /* static */
 UTILS_NOINLINE
-void RenderPass::generateCommands(uint32_t commandTypeFlags, Command* const commands,
+RenderPass::Command* RenderPass::generateCommands(uint32_t commandTypeFlags, Command* const curr,
         FScene::RenderableSoa const& soa, Range<uint32_t> range,
         Variant variant, RenderFlags renderFlags,
         FScene::VisibleMaskType visibilityMask,
@@ -222,14 +318,6 @@ void RenderPass::generateCommands(uint32_t commandTypeFlags, Command* const comm
     // (in principle, we could have split this method into two, at the cost of going through
     // the list twice)
 
-    // compute how much maximum storage we need
-    uint32_t offset = FScene::getPrimitiveCount(soa, range.first);
-    // double the color pass for transparent objects that need to render twice
-    const bool colorPass  = bool(commandTypeFlags & CommandTypeFlags::COLOR);
-    const bool depthPass  = bool(commandTypeFlags & CommandTypeFlags::DEPTH);
-    offset *= uint32_t(colorPass * 2 + depthPass);
-    Command* const curr = commands + offset;
-
     /*
      * The switch {} below is to coerce the compiler into generating different versions of
      * "generateCommandsImpl" based on which pass we're processing.
@@ -241,23 +329,21 @@ void RenderPass::generateCommands(uint32_t commandTypeFlags, Command* const comm
 
     switch (commandTypeFlags & (CommandTypeFlags::COLOR | CommandTypeFlags::DEPTH)) {
         case CommandTypeFlags::COLOR:
-            generateCommandsImpl<CommandTypeFlags::COLOR>(commandTypeFlags, curr,
+            return generateCommandsImpl<CommandTypeFlags::COLOR>(commandTypeFlags, curr,
                     soa, range, variant, renderFlags, visibilityMask, cameraPosition, cameraForward);
-            break;
         case CommandTypeFlags::DEPTH:
-            generateCommandsImpl<CommandTypeFlags::DEPTH>(commandTypeFlags, curr,
+            return generateCommandsImpl<CommandTypeFlags::DEPTH>(commandTypeFlags, curr,
                     soa, range, variant, renderFlags, visibilityMask, cameraPosition, cameraForward);
-            break;
         default:
             // we should never end-up here
-            break;
+            return curr;
     }
 }
 
 /* static */
 template<uint32_t commandTypeFlags>
 UTILS_NOINLINE
-void RenderPass::generateCommandsImpl(uint32_t extraFlags,
+RenderPass::Command* RenderPass::generateCommandsImpl(uint32_t extraFlags,
         Command* UTILS_RESTRICT curr,
         FScene::RenderableSoa const& UTILS_RESTRICT soa, Range<uint32_t> range,
         Variant variant, RenderFlags renderFlags, FScene::VisibleMaskType visibilityMask,
@@ -492,6 +578,7 @@ void RenderPass::generateCommandsImpl(uint32_t extraFlags,
             }
         }
     }
+    return curr;
 }
 
 void RenderPass::updateSummedPrimitiveCounts(
@@ -520,16 +607,88 @@ void RenderPass::Executor::execute(const char* name,
     // FILAMENT_MIN_COMMAND_BUFFERS_SIZE_IN_MB bytes (1MiB by default).
     engine.flush();
 
+    // buffer updates are not allowed inside a render pass
+    Handle<HwBufferObject> instancedUbh = createInstancedUbo(engine, mBegin, mEnd, mRenderableSoa);
+
     driver.beginRenderPass(renderTarget, params);
-    recordDriverCommands(engine, driver, mBegin, mEnd, mRenderableSoa);
+    recordDriverCommands(engine, driver, mBegin, mEnd, mRenderableSoa, instancedUbh);
     driver.endRenderPass();
+
+    if (instancedUbh) {
+        driver.destroyBufferObject(instancedUbh);
+    }
+}
+
+size_t RenderPass::Executor::getInstanceCount(Command const* first, Command const* last,
+        FRenderableManager::SkinningBindingInfo const* soaSkinning) noexcept {
+    // Only non-custom commands without skinning or morphing can be instanced, because those
+    // bind per-renderable buffers of their own.
+    PrimitiveInfo const& info = first->primitive;
+    if ((first->key & CUSTOM_MASK) != uint64_t(CustomCommand::PASS) ||
+            soaSkinning[info.index].handle || info.morphWeightBuffer) {
+        return 1;
+    }
+    Command const* curr = first + 1;
+    last = std::min(last, first + CONFIG_MAX_INSTANCES);
+    while (curr != last &&
+            (curr->key & CUSTOM_MASK) == uint64_t(CustomCommand::PASS) &&
+            curr->primitive.primitiveHandle == info.primitiveHandle &&
+            curr->primitive.mi == info.mi &&
+            curr->primitive.materialVariant == info.materialVariant &&
+            curr->primitive.rasterState == info.rasterState &&
+            !soaSkinning[curr->primitive.index].handle &&
+            !curr->primitive.morphWeightBuffer) {
+        ++curr;
+    }
+    return curr - first;
+}
+
+Handle<HwBufferObject> RenderPass::Executor::createInstancedUbo(FEngine& engine,
+        const Command* first, const Command* last, FScene::RenderableSoa const& soa) noexcept {
+    SYSTRACE_CONTEXT();
+
+    DriverApi& driver = engine.getDriverApi();
+    FRenderableManager const& rcm = engine.getRenderableManager();
+    auto const* const UTILS_RESTRICT soaSkinning = soa.data<FScene::SKINNING_BUFFER>();
+
+    size_t count = 0;
+    for (Command const* curr = first; curr != last;) {
+        const size_t n = getInstanceCount(curr, last, soaSkinning);
+        count += n > 1 ? n : 0;
+        curr += n;
+    }
+    if (!count) {
+        return {};
+    }
+
+    SYSTRACE_VALUE32("instanceCount", count);
+
+    // the instanced data is laid out in the same order recordDriverCommands() consumes it
+    PerRenderableData* const UTILS_RESTRICT data = driver.allocatePod<PerRenderableData>(count);
+    size_t offset = 0;
+    for (Command const* curr = first; curr != last;) {
+        const size_t n = getInstanceCount(curr, last, soaSkinning);
+        if (n > 1) {
+            for (size_t i = 0; i < n; i++, offset += sizeof(PerRenderableData)) {
+                FScene::writeRenderableData(data, offset, soa, curr[i].primitive.index, rcm);
+            }
+        }
+        curr += n;
+    }
+
+    const size_t size = count * sizeof(PerRenderableData);
+    Handle<HwBufferObject> ubh = driver.createBufferObject(size + RENDERABLE_UBO_PADDING,
+            BufferObjectBinding::UNIFORM, BufferUsage::STREAM);
+    driver.updateBufferObject(ubh, { data, size }, 0);
+    return ubh;
 }
 
 UTILS_NOINLINE // no need to be inlined
 void RenderPass::Executor::recordDriverCommands(FEngine& engine,
         backend::DriverApi& driver,
         const Command* first, const Command* last,
-        FScene::RenderableSoa const& soa) const noexcept {
+        FScene::RenderableSoa const& soa,
+        Handle<HwBufferObject> instancedUbh) const noexcept {
     SYSTRACE_CALL();
 
     if (first != last) {
@@ -543,6 +702,7 @@ void RenderPass::Executor::recordDriverCommands(FEngine& engine,
                 mPolygonOffsetOverride ? &dummyPolyOffset : &pipeline.polygonOffset;
 
         Handle<HwBufferObject> uboHandle = mUboHandle;
+        size_t instanceOffset = 0;
         FMaterialInstance const* UTILS_RESTRICT mi = nullptr;
         FMaterial const* UTILS_RESTRICT ma = nullptr;
         auto const& customCommands = mCustomCommands;
@@ -572,7 +732,21 @@ void RenderPass::Executor::recordDriverCommands(FEngine& engine,
             }
 
             pipeline.program = ma->getProgram(info.materialVariant);
-            size_t offset = info.index * sizeof(PerRenderableUib);
+
+            // runs of identical draws are collapsed into a single instanced draw, their
+            // per-renderable data was gathered by createInstancedUbo() in the same order.
+            const size_t instanceCount = getInstanceCount(first, last, soaSkinning);
+            if (UTILS_UNLIKELY(instanceCount > 1)) {
+                driver.bindUniformBufferRange(BindingPoints::PER_RENDERABLE,
+                        instancedUbh, instanceOffset * sizeof(PerRenderableData),
+                        sizeof(PerRenderableUib));
+                driver.draw(pipeline, info.primitiveHandle, instanceCount);
+                instanceOffset += instanceCount;
+                first += instanceCount - 1;
+                continue;
+            }
+
+            size_t offset = info.index * sizeof(PerRenderableData);
             driver.bindUniformBufferRange(BindingPoints::PER_RENDERABLE,
                     uboHandle, offset, sizeof(PerRenderableUib));
 
@@ -603,7 +777,7 @@ void RenderPass::Executor::recordDriverCommands(FEngine& engine,
                 }
             }
 
-            driver.draw(pipeline, info.primitiveHandle);
+            driver.draw(pipeline, info.primitiveHandle, 1);
         }
     }
 }
@@ -24,6 +24,7 @@
 
 #include "private/backend/DriverApiForward.h"
 
+#include <private/filament/UibStructs.h>
 #include <private/filament/Variant.h>
 
 #include <backend/DriverEnums.h>
@@ -240,6 +241,12 @@ public:
     static constexpr RenderFlags HAS_SHADOWING           = 0x01;
     static constexpr RenderFlags HAS_INVERSE_FRONT_FACES = 0x02;
 
+    // Every draw binds a whole PerRenderableUib starting at the data of its first instance, since
+    // bound ranges must cover the whole uniform block. Per-renderable UBOs therefore need room
+    // for a whole block past the data of their last renderable.
+    static constexpr size_t RENDERABLE_UBO_PADDING =
+            sizeof(PerRenderableUib) - sizeof(PerRenderableData);
+
     // Arena used for commands
     using Arena = utils::Arena<
             utils::LinearAllocator,
@@ -296,6 +303,18 @@ public:
     // sorts commands, then trims sentinels
     void sortCommands() noexcept;
 
+    // Same as appendCommands() followed by sortCommands(), but in two steps so that several
+    // RenderPasses sharing the same Arena can generate their commands concurrently.
+    // reserveCommands() allocates the commands from the Arena and must be called from the thread
+    // owning the Arena. generateReservedCommands() can then be called from any thread, it
+    // doesn't use the Arena, and doesn't update the SOA -- in particular the primitives of the
+    // visible renderables must be up-to-date (see FView::updatePrimitivesLod()) and must not
+    // change until it returns. Only the renderables selected by the visibility mask get storage,
+    // which is what keeps the Arena usage in check when many shadow maps are rendered.
+    // If the Arena is exhausted, an error is logged and the pass stays empty.
+    void reserveCommands(CommandTypeFlags commandTypeFlags) noexcept;
+    void generateReservedCommands() noexcept;
+
     // Helper to execute all the commands generated by this RenderPass
     void execute(const char* name,
             backend::Handle<backend::HwRenderTarget> renderTarget,
@@ -332,12 +351,23 @@ public:
 
         void recordDriverCommands(FEngine& engine, backend::DriverApi& driver,
                 const Command* first, const Command* last,
-                FScene::RenderableSoa const& soa) const noexcept;
+                FScene::RenderableSoa const& soa,
+                backend::Handle<backend::HwBufferObject> instancedUbh) const noexcept;
+
+        // gathers the per-renderable data of all instanced draws into a new UBO, returns a null
+        // handle if there are no instanced draws.
+        static backend::Handle<backend::HwBufferObject> createInstancedUbo(FEngine& engine,
+                const Command* first, const Command* last,
+                FScene::RenderableSoa const& soa) noexcept;
 
     public:
         void execute(const char* name,
                 backend::Handle<backend::HwRenderTarget> renderTarget,
                 backend::RenderPassParams params) const noexcept;
+
+        // returns how many commands starting at first can be drawn with a single instanced draw
+        static size_t getInstanceCount(Command const* first, Command const* last,
+                FRenderableManager::SkinningBindingInfo const* soaSkinning) noexcept;
     };
 
     // returns a new executor for this pass
@@ -356,6 +386,9 @@ private:
     Command* append(size_t count) noexcept;
     void resize(size_t count) noexcept;
 
+    // sorts the given commands and returns the first sentinel
+    static Command* sortAndTrim(Command* begin, Command* end) noexcept;
+
     // on 64-bits systems, we process batches of 256 (64 bytes) cache-lines, or 512 (32 bytes) commands
     // on 32-bits systems, we process batches of 512 (32 bytes) cache-lines, or 512 (32 bytes) commands
     static constexpr size_t JOBS_PARALLEL_FOR_COMMANDS_COUNT = 512;
@@ -365,14 +398,16 @@ private:
     static_assert(JOBS_PARALLEL_FOR_COMMANDS_SIZE % utils::CACHELINE_SIZE == 0,
             "Size of Commands jobs must be multiple of a cache-line size");
 
-    static inline void generateCommands(uint32_t commandTypeFlags, Command* commands,
+    // commands points to the storage of the first renderable of range, returns the end of the
+    // commands written
+    static inline Command* generateCommands(uint32_t commandTypeFlags, Command* commands,
             FScene::RenderableSoa const& soa, utils::Range<uint32_t> range,
             Variant variant, RenderFlags renderFlags,
             FScene::VisibleMaskType visibilityMask,
             math::float3 cameraPosition, math::float3 cameraForward) noexcept;
 
     template<uint32_t commandTypeFlags>
-    static inline void generateCommandsImpl(uint32_t, Command* commands,
+    static inline Command* generateCommandsImpl(uint32_t, Command* commands,
             FScene::RenderableSoa const& soa, utils::Range<uint32_t> range,
             Variant variant, RenderFlags renderFlags, FScene::VisibleMaskType visibilityMask,
             math::float3 cameraPosition, math::float3 cameraForward) noexcept;
@@ -426,6 +461,9 @@ private:
     // value of the override
     backend::PolygonOffset mPolygonOffset{};
 
+    // type of the commands allocated by reserveCommands()
+    CommandTypeFlags mReservedCommandTypeFlags{};
+
     // a vector for our custom commands
     mutable CustomCommandVector mCustomCommands;
 };
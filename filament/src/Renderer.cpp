@@ -182,6 +182,49 @@ void FRenderer::renderStandaloneView(FView const* view) {
     }
 }
 
+void FRenderer::renderStandaloneViews(View const* const* views, size_t count) {
+    SYSTRACE_CALL();
+
+    using namespace std::chrono;
+
+    for (size_t i = 0; i < count; i++) {
+        ASSERT_PRECONDITION(upcast(views[i])->getRenderTarget(),
+                "View \"%s\" must have a RenderTarget associated", upcast(views[i])->getName());
+    }
+
+    mPreviousRenderTargets.clear();
+    mFrameId++;
+
+    // ask the engine to do what it needs to (e.g. updates light buffer, materials...)
+    FEngine& engine = getEngine();
+    engine.prepare();
+
+    FEngine::DriverApi& driver = engine.getDriverApi();
+    driver.beginFrame(steady_clock::now().time_since_epoch().count(), mFrameId);
+
+    // Nothing can modify the scenes until we're done, so the views that share a scene also share
+    // the gathering of its renderables.
+    auto setRenderablesShared = [views, count](bool shared) {
+        for (size_t i = 0; i < count; i++) {
+            FScene* const scene = const_cast<FView*>(upcast(views[i]))->getScene();
+            if (scene) {
+                scene->setRenderablesShared(shared);
+            }
+        }
+    };
+
+    setRenderablesShared(true);
+    for (size_t i = 0; i < count; i++) {
+        FView const* const view = upcast(views[i]);
+        if (UTILS_LIKELY(view->getScene())) {
+            renderInternal(view);
+        }
+    }
+    setRenderablesShared(false);
+
+    driver.endFrame(mFrameId);
+}
+
 void FRenderer::render(FView const* view) {
     SYSTRACE_CALL();
 
@@ -261,7 +304,7 @@ void FRenderer::renderJob(ArenaScope& arena, FView& view) {
         return;
     }
 
-    view.prepare(engine, driver, arena, svp, getShaderUserTime());
+    view.prepare(engine, driver, arena, svp, getShaderUserTime(), mFrameTelemetryManager);
 
     view.prepareUpscaler(scale);
 
@@ -269,7 +312,11 @@ void FRenderer::renderJob(ArenaScope& arena, FView& view) {
     JobSystem::Job* jobFroxelize = nullptr;
     if (view.hasDynamicLighting()) {
         jobFroxelize = js.runAndRetain(js.createJob(nullptr,
-                [&engine, &view](JobSystem&, JobSystem::Job*) { view.froxelize(engine); }));
+                [&engine, &view, &telemetry = mFrameTelemetryManager](JobSystem&, JobSystem::Job*) {
+                    FrameTelemetryManager::ScopedTimer timer(telemetry,
+                            FrameTelemetryManager::Phase::FROXELIZATION);
+                    view.froxelize(engine);
+                }));
     }
 
     /*
@@ -302,6 +349,12 @@ void FRenderer::renderJob(ArenaScope& arena, FView& view) {
 
     FrameGraph fg(engine.getResourceAllocator());
 
+    // updatePrimitivesLod must be run before appendCommands and once for each set
+    // of RenderPass::setCamera / RenderPass::setGeometry calls. This must also happen before the
+    // shadow passes, whose commands are generated concurrently with the rest of this method.
+    view.updatePrimitivesLod(engine, view.getCameraInfo(),
+            scene.getRenderableData(), view.getVisibleRenderables());
+
     /*
      * Shadow pass
      */
@@ -411,11 +464,6 @@ void FRenderer::renderJob(ArenaScope& arena, FView& view) {
 
     CameraInfo cameraInfo = view.getCameraInfo();
 
-    // updatePrimitivesLod must be run before appendCommands and once for each set
-    // of RenderPass::setCamera / RenderPass::setGeometry calls.
-    view.updatePrimitivesLod(engine, cameraInfo,
-            scene.getRenderableData(), view.getVisibleRenderables());
-
     pass.setCamera(cameraInfo);
     pass.setGeometry(scene.getRenderableData(), view.getVisibleRenderables(), scene.getRenderableUBO());
 
@@ -502,8 +550,12 @@ void FRenderer::renderJob(ArenaScope& arena, FView& view) {
     // (i.e. it won't be culled, unless everything is culled), so no need to complexify things.
     pass.setRenderFlags(renderFlags);
     pass.setVariant(variant);
-    pass.appendCommands(RenderPass::COLOR);
-    pass.sortCommands();
+    {
+        FrameTelemetryManager::ScopedTimer timer(mFrameTelemetryManager,
+                FrameTelemetryManager::Phase::COMMAND_GENERATION);
+        pass.appendCommands(RenderPass::COLOR);
+        pass.sortCommands();
+    }
 
     FrameGraphTexture::Descriptor desc = {
             .width = config.svp.width,
@@ -694,11 +746,19 @@ void FRenderer::renderJob(ArenaScope& arena, FView& view) {
 
     fg.present(fgViewRenderTarget);
 
-    fg.compile();
+    {
+        FrameTelemetryManager::ScopedTimer timer(mFrameTelemetryManager,
+                FrameTelemetryManager::Phase::FRAME_GRAPH_COMPILE);
+        fg.compile();
+    }
 
     //fg.export_graphviz(slog.d, view.getName());
 
-    fg.execute(driver);
+    {
+        FrameTelemetryManager::ScopedTimer timer(mFrameTelemetryManager,
+                FrameTelemetryManager::Phase::FRAME_GRAPH_EXECUTE);
+        fg.execute(driver);
+    }
 
     // save the current history entry and destroy the oldest entry
     view.commitFrameHistory(engine);
@@ -1091,6 +1151,8 @@ bool FRenderer::beginFrame(FSwapChain* swapChain, uint64_t vsyncSteadyClockTimeN
     FEngine& engine = getEngine();
     FEngine::DriverApi& driver = engine.getDriverApi();
 
+    mFrameTelemetryManager.beginFrame(mFrameId, engine.getFlushedCommandsSize());
+
     // start a frame capture, if requested.
     if (UTILS_UNLIKELY(engine.debug.renderer.doFrameCapture)) {
         driver.startCapture();
@@ -1166,6 +1228,8 @@ bool FRenderer::beginFrame(FSwapChain* swapChain, uint64_t vsyncSteadyClockTimeN
         }
 
         // ask the engine to do what it needs to (e.g. updates light buffer, materials...)
+        FrameTelemetryManager::ScopedTimer timer(mFrameTelemetryManager,
+                FrameTelemetryManager::Phase::ENGINE_PREPARE);
         engine.prepare();
     };
 
@@ -1179,6 +1243,7 @@ bool FRenderer::beginFrame(FSwapChain* swapChain, uint64_t vsyncSteadyClockTimeN
     // however, if we return false, the user is allowed to ignore us and render a frame anyways,
     // so we need to delay this work until that happens.
     mBeginFrameInternal = beginFrameInternal;
+    mFrameTelemetryManager.skipFrame();
 
     // we need to flush in this case, to make sure the tick() call is executed at some point
     engine.flush();
@@ -1235,6 +1300,9 @@ void FRenderer::endFrame() {
 
     // make sure we're done with the gcs
     js.waitAndRelease(job);
+
+    mFrameTelemetryManager.endFrame(mFrameInfoManager.getLastFrameInfo(),
+            engine.getFlushedCommandsSize(), FEngine::CONFIG_MIN_COMMAND_BUFFERS_SIZE);
 }
 
 void FRenderer::readPixels(uint32_t xoffset, uint32_t yoffset, uint32_t width, uint32_t height,
@@ -1412,8 +1480,20 @@ void Renderer::setClearOptions(const ClearOptions& options) {
     upcast(this)->setClearOptions(options);
 }
 
+void Renderer::setFrameTelemetryOptions(FrameTelemetryOptions const& options) {
+    upcast(this)->setFrameTelemetryOptions(options);
+}
+
+size_t Renderer::getFrameTelemetry(FrameTelemetry* out, size_t count) const noexcept {
+    return upcast(this)->getFrameTelemetry(out, count);
+}
+
 void Renderer::renderStandaloneView(View const* view) {
     upcast(this)->renderStandaloneView(upcast(view));
 }
 
+void Renderer::renderStandaloneViews(View const* const* views, size_t count) {
+    upcast(this)->renderStandaloneViews(views, count);
+}
+
 } // namespace filament
@@ -64,6 +64,20 @@ void FScene::prepare(const mat4& worldOriginTransform, bool shadowReceiversAreCa
     auto const& entities = mEntities;
 
 
+    // The views that share the renderables only reorder them and overwrite their per-view fields,
+    // the lights however are culled, so they are always gathered again.
+    const bool gatherRenderables = !mRenderablesShared || !mRenderablesPrepared ||
+            mPreparedWorldOrigin[0] != worldOriginTransform[0] ||
+            mPreparedWorldOrigin[1] != worldOriginTransform[1] ||
+            mPreparedWorldOrigin[2] != worldOriginTransform[2] ||
+            mPreparedWorldOrigin[3] != worldOriginTransform[3] ||
+            mPreparedReceiversAreCasters != shadowReceiversAreCasters;
+    if (mRenderablesShared) {
+        mRenderablesPrepared = true;
+        mPreparedWorldOrigin = worldOriginTransform;
+        mPreparedReceiversAreCasters = shadowReceiversAreCasters;
+    }
+
     // NOTE: we can't know in advance how many entities are renderable or lights because the corresponding
     // component can be added after the entity is added to the scene.
 
@@ -73,9 +87,11 @@ void FScene::prepare(const mat4& worldOriginTransform, bool shadowReceiversAreCa
     // we need 1 extra entry at the end for the summed primitive count
     renderableDataCapacity = renderableDataCapacity + 1;
 
-    sceneData.clear();
-    if (sceneData.capacity() < renderableDataCapacity) {
-        sceneData.setCapacity(renderableDataCapacity);
+    if (gatherRenderables) {
+        sceneData.clear();
+        if (sceneData.capacity() < renderableDataCapacity) {
+            sceneData.setCapacity(renderableDataCapacity);
+        }
     }
 
     // The light data list will always contain at least one entry for the
@@ -102,7 +118,7 @@ void FScene::prepare(const mat4& worldOriginTransform, bool shadowReceiversAreCa
 
         // getInstance() always returns null if the entity is the Null entity
         // so we don't need to check for that, but we need to check it's alive
-        auto ri = rcm.getInstance(e);
+        auto ri = gatherRenderables ? rcm.getInstance(e) : FRenderableManager::Instance{};
         auto li = lcm.getInstance(e);
         if (!ri & !li) {
             continue;
@@ -142,6 +158,7 @@ void FScene::prepare(const mat4& worldOriginTransform, bool shadowReceiversAreCa
                     worldAABB.center,               // WORLD_AABB_CENTER
                     0,                              // VISIBLE_MASK
                     rcm.getChannels(ri),            // CHANNELS
+                    0,                              // LEVEL_OF_DETAIL
                     rcm.getLayerMask(ri),           // LAYERS
                     worldAABB.halfExtent,           // WORLD_AABB_EXTENT
                     {},                             // PRIMITIVES
@@ -187,7 +204,7 @@ void FScene::prepare(const mat4& worldOriginTransform, bool shadowReceiversAreCa
 
     // Purely for the benefit of MSAN, we can avoid uninitialized reads by zeroing out the
     // unused scene elements between the end of the array and the rounded-up count.
-    if (UTILS_HAS_SANITIZE_MEMORY) {
+    if (UTILS_HAS_SANITIZE_MEMORY && gatherRenderables) {
         for (size_t i = sceneData.size(), e = renderableDataCapacity; i < e; i++) {
             sceneData.data<LAYERS>()[i] = 0;
             sceneData.data<VISIBLE_MASK>()[i] = 0;
@@ -196,79 +213,88 @@ void FScene::prepare(const mat4& worldOriginTransform, bool shadowReceiversAreCa
     }
 }
 
-void FScene::updateUBOs(utils::Range<uint32_t> visibleRenderables, backend::Handle<backend::HwBufferObject> renderableUbh) noexcept {
-    FEngine::DriverApi& driver = mEngine.getDriverApi();
-    FRenderableManager& rcm = mEngine.getRenderableManager();
+void FScene::setRenderablesShared(bool shared) noexcept {
+    mRenderablesShared = shared;
+    mRenderablesPrepared = false;
+}
 
-    const size_t size = visibleRenderables.size() * sizeof(PerRenderableUib);
+void FScene::writeRenderableData(void* buffer, size_t offset, RenderableSoa const& soa,
+        size_t i, FRenderableManager const& rcm) noexcept {
+    mat4f const& model = soa.elementAt<WORLD_TRANSFORM>(i);
+    FRenderableManager::Visibility visibility = soa.elementAt<VISIBILITY_STATE>(i);
+    auto ri = soa.elementAt<RENDERABLE_INSTANCE>(i);
+
+    UniformBuffer::setUniform(buffer,
+            offset + offsetof(PerRenderableData, worldFromModelMatrix), model);
+
+    // Using mat3f::getTransformForNormals handles non-uniform scaling, but DOESN'T guarantee that
+    // the transformed normals will have unit-length, therefore they need to be normalized
+    // in the shader (that's already the case anyways, since normalization is needed after
+    // interpolation).
+    //
+    // We pre-scale normals by the inverse of the largest scale factor to avoid
+    // large post-transform magnitudes in the shader, especially in the fragment shader, where
+    // we use medium precision.
+    //
+    // Note: if the model matrix is known to be a rigid-transform, we could just use it directly.
+
+    mat3f m = mat3f::getTransformForNormals(model.upperLeft());
+    m *= mat3f(1.0f / std::sqrt(max(float3{length2(m[0]), length2(m[1]), length2(m[2])})));
+
+    // The shading normal must be flipped for mirror transformations.
+    // Basically we're shading the other side of the polygon and therefore need to negate the
+    // normal, similar to what we already do to support double-sided lighting.
+    if (visibility.reversedWindingOrder) {
+        m = -m;
+    }
 
-    // allocate space into the command stream directly
-    void* const buffer = driver.allocatePod<PerRenderableUib>(visibleRenderables.size());
+    UniformBuffer::setUniform(buffer,
+            offset + offsetof(PerRenderableData, worldFromModelNormalMatrix), m);
 
-    bool hasContactShadows = false;
-    auto& sceneData = mRenderableData;
-    for (uint32_t i : visibleRenderables) {
-        mat4f const& model = sceneData.elementAt<WORLD_TRANSFORM>(i);
-        FRenderableManager::Visibility visibility = sceneData.elementAt<VISIBILITY_STATE>(i);
-        auto ri = sceneData.elementAt<RENDERABLE_INSTANCE>(i);
-
-        const size_t offset = i * sizeof(PerRenderableUib);
-
-        UniformBuffer::setUniform(buffer,
-                offset + offsetof(PerRenderableUib, worldFromModelMatrix), model);
-
-        // Using mat3f::getTransformForNormals handles non-uniform scaling, but DOESN'T guarantee that
-        // the transformed normals will have unit-length, therefore they need to be normalized
-        // in the shader (that's already the case anyways, since normalization is needed after
-        // interpolation).
-        //
-        // We pre-scale normals by the inverse of the largest scale factor to avoid
-        // large post-transform magnitudes in the shader, especially in the fragment shader, where
-        // we use medium precision.
-        //
-        // Note: if the model matrix is known to be a rigid-transform, we could just use it directly.
-
-        mat3f m = mat3f::getTransformForNormals(model.upperLeft());
-        m *= mat3f(1.0f / std::sqrt(max(float3{length2(m[0]), length2(m[1]), length2(m[2])})));
-
-        // The shading normal must be flipped for mirror transformations.
-        // Basically we're shading the other side of the polygon and therefore need to negate the
-        // normal, similar to what we already do to support double-sided lighting.
-        if (visibility.reversedWindingOrder) {
-            m = -m;
-        }
+    // Note that we cast bool to uint32_t. Booleans are byte-sized in C++, but we need to
+    // initialize all 32 bits in the UBO field.
 
-        UniformBuffer::setUniform(buffer,
-                offset + offsetof(PerRenderableUib, worldFromModelNormalMatrix), m);
+    UniformBuffer::setUniform(buffer,
+            offset + offsetof(PerRenderableData, flags),
+            PerRenderableData::packFlags(
+                    visibility.skinning,
+                    visibility.morphing,
+                    visibility.screenSpaceContactShadows));
 
-        // Note that we cast bool to uint32_t. Booleans are byte-sized in C++, but we need to
-        // initialize all 32 bits in the UBO field.
+    UniformBuffer::setUniform(buffer,
+            offset + offsetof(PerRenderableData, morphTargetCount),
+            soa.elementAt<MORPHING_BUFFER>(i).count);
 
-        hasContactShadows = hasContactShadows || visibility.screenSpaceContactShadows;
+    UniformBuffer::setUniform(buffer,
+            offset + offsetof(PerRenderableData, channels),
+            (uint32_t)soa.elementAt<CHANNELS>(i));
 
-        UniformBuffer::setUniform(buffer,
-                offset + offsetof(PerRenderableUib, flags),
-                PerRenderableUib::packFlags(
-                        visibility.skinning,
-                        visibility.morphing,
-                        visibility.screenSpaceContactShadows));
+    UniformBuffer::setUniform(buffer,
+            offset + offsetof(PerRenderableData, objectId),
+            rcm.getEntity(ri).getId()); // we could also store the entity in sceneData
 
-        UniformBuffer::setUniform(buffer,
-                offset + offsetof(PerRenderableUib, morphTargetCount),
-                sceneData.elementAt<MORPHING_BUFFER>(i).count);
+    // TODO: We need to find a better way to provide the scale information per object
+    UniformBuffer::setUniform(buffer,
+            offset + offsetof(PerRenderableData, userData),
+            soa.elementAt<USER_DATA>(i));
+}
 
-        UniformBuffer::setUniform(buffer,
-                offset + offsetof(PerRenderableUib, channels),
-                (uint32_t)sceneData.elementAt<CHANNELS>(i));
+void FScene::updateUBOs(utils::Range<uint32_t> visibleRenderables, backend::Handle<backend::HwBufferObject> renderableUbh) noexcept {
+    FEngine::DriverApi& driver = mEngine.getDriverApi();
+    FRenderableManager const& rcm = mEngine.getRenderableManager();
 
-        UniformBuffer::setUniform(buffer,
-                offset + offsetof(PerRenderableUib, objectId),
-                rcm.getEntity(ri).getId()); // we could also store the entity in sceneData
+    const size_t size = visibleRenderables.size() * sizeof(PerRenderableData);
 
-        // TODO: We need to find a better way to provide the scale information per object
-        UniformBuffer::setUniform(buffer,
-                offset + offsetof(PerRenderableUib, userData),
-                sceneData.elementAt<USER_DATA>(i));
+    // allocate space into the command stream directly
+    void* const buffer = driver.allocatePod<PerRenderableData>(visibleRenderables.size());
+
+    bool hasContactShadows = false;
+    auto const& sceneData = mRenderableData;
+    for (uint32_t i : visibleRenderables) {
+        const size_t offset = i * sizeof(PerRenderableData);
+        writeRenderableData(buffer, offset, sceneData, i, rcm);
+        hasContactShadows = hasContactShadows ||
+                sceneData.elementAt<VISIBILITY_STATE>(i).screenSpaceContactShadows;
     }
 
     // TODO: handle static objects separately
@@ -69,15 +69,14 @@ ShadowMap::~ShadowMap() {
     engine.getEntityManager().destroy(sizeof(entities) / sizeof(Entity), entities);
 }
 
-void ShadowMap::render(FScene const& scene, utils::Range<uint32_t> range,
+void ShadowMap::prepareRenderPass(FScene const& scene, utils::Range<uint32_t> range,
         FScene::VisibleMaskType visibilityMask, filament::CameraInfo const& cameraInfo,
         RenderPass* const pass) noexcept {
     pass->setCamera(cameraInfo);
     pass->setVisibilityMask(visibilityMask);
     pass->setGeometry(scene.getRenderableData(), range, scene.getRenderableUBO());
     pass->overridePolygonOffset(&mShadowMapInfo.polygonOffset);
-    pass->appendCommands(RenderPass::SHADOW);
-    pass->sortCommands();
+    pass->reserveCommands(RenderPass::SHADOW);
 }
 
 mat4f ShadowMap::getDirectionalLightViewMatrix(float3 direction, float3 position) noexcept {
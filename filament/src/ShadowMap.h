@@ -104,7 +104,9 @@ public:
             const ShadowMapInfo& shadowMapInfo, FScene const& scene,
             SceneInfo& sceneInfo) noexcept;
 
-    void render(FScene const& scene, utils::Range<uint32_t> range,
+    // Sets up the pass for rendering this shadow map and reserves its commands, which are then
+    // generated by RenderPass::generateReservedCommands().
+    void prepareRenderPass(FScene const& scene, utils::Range<uint32_t> range,
             FScene::VisibleMaskType visibilityMask, filament::CameraInfo const& cameraInfo,
             RenderPass* pass) noexcept;
 
@@ -28,6 +28,7 @@
 
 #include <utils/debug.h>
 #include <utils/FixedCapacityVector.h>
+#include <utils/JobSystem.h>
 
 namespace filament {
 
@@ -152,6 +153,42 @@ void ShadowMapManager::render(FrameGraph& fg, FEngine& engine, backend::DriverAp
 
     // -------------------------------------------------------------------------------------------
 
+    // Set up a RenderPass for each shadow map and allocate its commands, this uses the Arena of
+    // pass and therefore happens on this thread.
+    mShadowPasses.clear();
+    utils::Range<uint32_t> lodRange{};
+    for (auto const& entry : passList) {
+        ShadowMap& shadowMap = entry.shadowMapEntry->getShadowMap();
+        const CameraInfo cameraInfo(shadowMap.getCamera());
+
+        // updatePrimitivesLod must be run before RenderPass::reserveCommands, it only needs to
+        // run once for all the shadow maps sharing the same range.
+        if (entry.range.first != lodRange.first || entry.range.last != lodRange.last) {
+            lodRange = entry.range;
+            view.updatePrimitivesLod(engine, cameraInfo, scene->getRenderableData(), lodRange);
+        }
+
+        RenderPass& entryPass = mShadowPasses.emplace_back(pass);
+        shadowMap.prepareRenderPass(*scene, entry.range, entry.visibilityMask, cameraInfo,
+                &entryPass);
+    }
+
+    // Then generate and sort the commands of all the shadow maps concurrently, while the rest
+    // of the frame graph is set up. Only the execution of the commands remains in the passes.
+    utils::JobSystem& js = engine.getJobSystem();
+    utils::JobSystem::Job* jobCommands = nullptr;
+    if (!mShadowPasses.empty()) {
+        jobCommands = js.createJob();
+        for (RenderPass& entryPass : mShadowPasses) {
+            js.run(utils::jobs::createJob(js, jobCommands, [&entryPass]() {
+                entryPass.generateReservedCommands();
+            }));
+        }
+        jobCommands = js.runAndRetain(jobCommands);
+    }
+
+    // -------------------------------------------------------------------------------------------
+
     struct PrepareShadowPassData {
         FrameGraphId<FrameGraphTexture> shadows;        // the actual shadowmap
     };
@@ -185,7 +222,16 @@ void ShadowMapManager::render(FrameGraph& fg, FEngine& engine, backend::DriverAp
 
     auto& ppm = engine.getPostProcessManager();
 
-    for (auto const& entry : passList) {
+    if (jobCommands) {
+        // this pass is never culled, so we always wait for the commands before returning
+        fg.addTrivialSideEffectPass("Wait Shadow Commands", [&js, jobCommands](DriverApi&) {
+            utils::JobSystem::Job* job = jobCommands;
+            js.waitAndRelease(job);
+        });
+    }
+
+    for (size_t i = 0, c = passList.size(); i < c; i++) {
+        auto const& entry = passList[i];
         const auto layer = entry.shadowMapEntry->getLayer();
         const auto* options = entry.shadowMapEntry->getShadowOptions();
 
@@ -256,19 +302,13 @@ void ShadowMapManager::render(FrameGraph& fg, FEngine& engine, backend::DriverAp
                     // finally, create the shadowmap render target -- one per layer.
                     data.shadowRt = builder.declareRenderPass("Shadow RT", renderTargetDesc);
                 },
-                [=, &engine, &view](FrameGraphResources const& resources,
+                [=, &view, &entryPass = mShadowPasses[i]](FrameGraphResources const& resources,
                         auto const& data, DriverApi& driver) {
 
                     ShadowMap& shadowMap = entry.shadowMapEntry->getShadowMap();
                     const CameraInfo cameraInfo(shadowMap.getCamera());
 
-                    // updatePrimitivesLod must be run before RenderPass::appendCommands.
-                    view.updatePrimitivesLod(engine, cameraInfo, scene->getRenderableData(), entry.range);
-
-                    // generate and sort the commands for rendering the shadow map
-                    RenderPass entryPass(pass);
-                    shadowMap.render(*scene, entry.range, entry.visibilityMask, cameraInfo, &entryPass);
-
+                    // the commands have been generated by jobCommands
                     const auto& executor = entryPass.getExecutor();
                     const bool blur = view.hasVSM() && options->vsm.blurWidth > 0.0f;
 
@@ -19,6 +19,7 @@
 
 #include <filament/Viewport.h>
 
+#include "RenderPass.h"
 #include "ShadowMap.h"
 #include "TypedUniformBuffer.h"
 
@@ -86,7 +87,9 @@ public:
             TypedUniformBuffer<ShadowUib>& shadowUb,
             FScene::RenderableSoa& renderableData, FScene::LightSoa& lightData) noexcept;
 
-    // Renders all of the shadow maps.
+    // Renders all of the shadow maps. The commands of the shadow maps are generated on the
+    // JobSystem right away, only their execution is deferred to the frame graph.
+    // The arena of pass must remain valid until the frame graph has executed.
     void render(FrameGraph& fg, FEngine& engine, backend::DriverApi& driver,
             RenderPass const& pass, FView& view) noexcept;
 
@@ -215,6 +218,12 @@ private:
             utils::FixedCapacityVector<ShadowMapEntry>::with_capacity(
                     CONFIG_MAX_SHADOW_CASTING_SPOTS) };
 
+    // RenderPasses of the shadow maps rendered in the current frame, their commands are generated
+    // concurrently during the frame graph setup, see render().
+    utils::FixedCapacityVector<RenderPass> mShadowPasses{
+            utils::FixedCapacityVector<RenderPass>::with_capacity(
+                    CONFIG_MAX_SHADOW_CASCADES + CONFIG_MAX_SHADOW_CASTING_SPOTS) };
+
     // inline storage for all our ShadowMap objects, we can't easily use a std::array<> directly.
     // because ShadowMap doesn't have a default ctor, and we avoid out-of-line allocations.
     // Each ShadowMap is currently 128 bytes.
@@ -186,17 +186,19 @@ float3 ACES(float3 color, float brightness) noexcept {
 // Tone mappers
 //------------------------------------------------------------------------------
 
-#define DEFAULT_CONSTRUCTORS(A) \
-        A::A() noexcept = default; \
+#define DEFAULT_CONSTRUCTORS(A, BUILTIN) \
+        A::A() noexcept : ToneMapper(BUILTIN) {} \
         A::~A() noexcept = default;
 
-DEFAULT_CONSTRUCTORS(ToneMapper)
+ToneMapper::ToneMapper() noexcept = default;
+ToneMapper::ToneMapper(Builtin builtin) noexcept : mBuiltin(builtin) {}
+ToneMapper::~ToneMapper() noexcept = default;
 
 //------------------------------------------------------------------------------
 // Linear tone mapper
 //------------------------------------------------------------------------------
 
-DEFAULT_CONSTRUCTORS(LinearToneMapper)
+DEFAULT_CONSTRUCTORS(LinearToneMapper, Builtin::LINEAR)
 
 float3 LinearToneMapper::operator()(float3 v) const noexcept {
     return saturate(v);
@@ -206,19 +208,19 @@ float3 LinearToneMapper::operator()(float3 v) const noexcept {
 // ACES tone mappers
 //------------------------------------------------------------------------------
 
-DEFAULT_CONSTRUCTORS(ACESToneMapper)
+DEFAULT_CONSTRUCTORS(ACESToneMapper, Builtin::ACES)
 
 float3 ACESToneMapper::operator()(math::float3 c) const noexcept {
     return aces::ACES(c, 1.0f);
 }
 
-DEFAULT_CONSTRUCTORS(ACESLegacyToneMapper)
+DEFAULT_CONSTRUCTORS(ACESLegacyToneMapper, Builtin::ACES_LEGACY)
 
 float3 ACESLegacyToneMapper::operator()(math::float3 c) const noexcept {
     return aces::ACES(c, 1.0f / 0.6f);
 }
 
-DEFAULT_CONSTRUCTORS(FilmicToneMapper)
+DEFAULT_CONSTRUCTORS(FilmicToneMapper, Builtin::FILMIC)
 
 float3 FilmicToneMapper::operator()(math::float3 x) const noexcept {
     // Narkowicz 2015, "ACES Filmic Tone Mapping Curve"
@@ -234,7 +236,7 @@ float3 FilmicToneMapper::operator()(math::float3 x) const noexcept {
 // Display range tone mapper
 //------------------------------------------------------------------------------
 
-DEFAULT_CONSTRUCTORS(DisplayRangeToneMapper)
+DEFAULT_CONSTRUCTORS(DisplayRangeToneMapper, Builtin::DISPLAY_RANGE)
 
 float3 DisplayRangeToneMapper::operator()(math::float3 c) const noexcept {
     // 16 debug colors + 1 duplicated at the end for easy indexing
@@ -315,7 +317,7 @@ GenericToneMapper::GenericToneMapper(
         float midGrayIn,
         float midGrayOut,
         float hdrMax
-) noexcept {
+) noexcept : ToneMapper(Builtin::GENERIC) {
     mOptions = new Options();
     mOptions->setParameters(contrast, midGrayIn, midGrayOut, hdrMax);
 }
@@ -324,7 +326,8 @@ GenericToneMapper::~GenericToneMapper() noexcept {
     delete mOptions;
 }
 
-GenericToneMapper::GenericToneMapper(GenericToneMapper&& rhs)  noexcept : mOptions(rhs.mOptions) {
+GenericToneMapper::GenericToneMapper(GenericToneMapper&& rhs)  noexcept
+        : ToneMapper(Builtin::GENERIC), mOptions(rhs.mOptions) {
     rhs.mOptions = nullptr;
 }
 
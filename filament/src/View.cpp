@@ -407,7 +407,8 @@ void FView::prepareLighting(FEngine& engine, FEngine::DriverApi& driver, ArenaSc
 }
 
 void FView::prepare(FEngine& engine, DriverApi& driver, ArenaScope& arena,
-        filament::Viewport const& viewport, float4 const& userTime) noexcept {
+        filament::Viewport const& viewport, float4 const& userTime,
+        FrameTelemetryManager& telemetry) noexcept {
     JobSystem& js = engine.getJobSystem();
 
     /*
@@ -457,7 +458,11 @@ void FView::prepare(FEngine& engine, DriverApi& driver, ArenaScope& arena,
      * Gather all information needed to render this scene. Apply the world origin to all
      * objects in the scene.
      */
-    scene->prepare(worldOriginScene, hasVSM());
+    {
+        FrameTelemetryManager::ScopedTimer timer(telemetry,
+                FrameTelemetryManager::Phase::SCENE_PREPARE);
+        scene->prepare(worldOriginScene, hasVSM());
+    }
 
     /*
      * Light culling: runs in parallel with Renderable culling (below)
@@ -476,6 +481,7 @@ void FView::prepare(FEngine& engine, DriverApi& driver, ArenaScope& arena,
     FScene::RenderableSoa& renderableData = scene->getRenderableData();
 
     { // all the operations in this scope must happen sequentially
+        FrameTelemetryManager::ScopedTimer timer(telemetry, FrameTelemetryManager::Phase::CULLING);
 
         Slice<Culler::result_type> cullingMask = renderableData.slice<FScene::VISIBLE_MASK>();
         std::uninitialized_fill(cullingMask.begin(), cullingMask.end(), 0);
@@ -485,7 +491,8 @@ void FView::prepare(FEngine& engine, DriverApi& driver, ArenaScope& arena,
          * (this will set the VISIBLE_RENDERABLE bit)
          */
 
-        prepareVisibleRenderables(js, mCullingFrustum, renderableData);
+        prepareVisibleRenderables(js, engine.getRenderableManager(), mViewingCameraInfo,
+                mCullingFrustum, renderableData);
 
 
         /*
@@ -544,12 +551,13 @@ void FView::prepare(FEngine& engine, DriverApi& driver, ArenaScope& arena,
         merged = Range{ 0, iSpotLightCastersEnd };
 
         // update those UBOs
-        const size_t size = merged.size() * sizeof(PerRenderableUib);
+        const size_t size = merged.size() * sizeof(PerRenderableData);
         if (size) {
-            if (mRenderableUBOSize < size) {
+            if (mRenderableUBOSize < size + RenderPass::RENDERABLE_UBO_PADDING) {
                 // allocate 1/3 extra, with a minimum of 16 objects
                 const size_t count = std::max(size_t(16u), (4u * merged.size() + 2u) / 3u);
-                mRenderableUBOSize = uint32_t(count * sizeof(PerRenderableUib));
+                mRenderableUBOSize = uint32_t(
+                        count * sizeof(PerRenderableData) + RenderPass::RENDERABLE_UBO_PADDING);
                 driver.destroyBufferObject(mRenderableUbh);
                 mRenderableUbh = driver.createBufferObject(mRenderableUBOSize,
                         BufferObjectBinding::UNIFORM, BufferUsage::STREAM);
@@ -715,8 +723,9 @@ void FView::commitFroxels(DriverApi& driverApi) const noexcept {
 }
 
 UTILS_NOINLINE
-void FView::prepareVisibleRenderables(JobSystem& js,
-        Frustum const& frustum, FScene::RenderableSoa& renderableData) const noexcept {
+void FView::prepareVisibleRenderables(JobSystem& js, FRenderableManager const& rcm,
+        CameraInfo const& camera, Frustum const& frustum,
+        FScene::RenderableSoa& renderableData) noexcept {
     SYSTRACE_CALL();
     if (UTILS_LIKELY(isFrustumCullingEnabled())) {
         FView::cullRenderables(js, renderableData, frustum, VISIBLE_RENDERABLE_BIT);
@@ -724,6 +733,57 @@ void FView::prepareVisibleRenderables(JobSystem& js,
         std::uninitialized_fill(renderableData.begin<FScene::VISIBLE_MASK>(),
                   renderableData.end<FScene::VISIBLE_MASK>(), VISIBLE_RENDERABLE);
     }
+    // the level of detail is also needed by shadow casters that are not visible
+    selectLevelsOfDetail(rcm, camera, renderableData);
+}
+
+float FView::computeScreenCoverage(mat4f const& projection, float distance,
+        float radius) noexcept {
+    // The screen coverage is the fraction of the viewport area covered by the projected bounding
+    // sphere of the renderable. In clip space its radius is r * p[0][0] / d horizontally and
+    // r * p[1][1] / d vertically, while the viewport is 2 units wide and 2 units tall.
+    const bool perspective = projection[2][3] != 0.0f;
+    if (perspective && distance <= radius) {
+        return 1.0f;    // the camera is inside the bounding sphere
+    }
+    const float s = perspective ? radius / distance : radius;
+    const float coverage = float(F_PI_4) * s * s * std::abs(projection[0][0] * projection[1][1]);
+    return std::min(coverage, 1.0f);
+}
+
+void FView::selectLevelsOfDetail(FRenderableManager const& rcm, CameraInfo const& camera,
+        FScene::RenderableSoa& renderableData) noexcept {
+    SYSTRACE_CALL();
+
+    auto const* const UTILS_RESTRICT instances = renderableData.data<FScene::RENDERABLE_INSTANCE>();
+    float3 const* const UTILS_RESTRICT worldAABBCenter = renderableData.data<FScene::WORLD_AABB_CENTER>();
+    float3 const* const UTILS_RESTRICT worldAABBExtent = renderableData.data<FScene::WORLD_AABB_EXTENT>();
+    uint8_t* const UTILS_RESTRICT levels = renderableData.data<FScene::LEVEL_OF_DETAIL>();
+
+    // The hysteresis is relative to the level this view selected in the previous frame. Only the
+    // renderables seen this frame are kept, so that destroyed entities don't accumulate.
+    auto& previous = mLevelsOfDetail[0];
+    auto& current = mLevelsOfDetail[1];
+    current.clear();
+
+    for (size_t i = 0, c = renderableData.size(); i < c; i++) {
+        auto const ri = instances[i];
+        if (UTILS_LIKELY(!rcm.hasLevelsOfDetail(ri))) {
+            levels[i] = 0;
+            continue;
+        }
+        const float radius = length(worldAABBExtent[i]);
+        const float distance = length((camera.view * worldAABBCenter[i]).xyz);
+        const float coverage = computeScreenCoverage(camera.projection, distance, radius);
+
+        Entity const entity = rcm.getEntity(ri);
+        auto const pos = previous.find(entity);
+        const uint8_t last = pos != previous.end() ? pos->second : UINT8_MAX;
+        levels[i] = rcm.selectLevelOfDetail(ri, coverage, last);
+        current[entity] = levels[i];
+    }
+
+    std::swap(previous, current);
 }
 
 void FView::cullRenderables(JobSystem& js,
@@ -866,7 +926,8 @@ void FView::updatePrimitivesLod(FEngine& engine, const CameraInfo&,
         FScene::RenderableSoa& renderableData, Range visible) noexcept {
     FRenderableManager const& rcm = engine.getRenderableManager();
     for (uint32_t index : visible) {
-        uint8_t level = 0; // TODO: pick the proper level of detail
+        // the level was selected with the viewing camera, see selectLevelsOfDetail()
+        uint8_t level = renderableData.elementAt<FScene::LEVEL_OF_DETAIL>(index);
         auto ri = renderableData.elementAt<FScene::RENDERABLE_INSTANCE>(index);
         renderableData.elementAt<FScene::PRIMITIVES>(index) = rcm.getRenderPrimitives(ri, level);
     }
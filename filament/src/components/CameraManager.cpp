@@ -51,9 +51,9 @@ void FCameraManager::terminate() noexcept {
     }
 }
 
-void FCameraManager::gc(utils::EntityManager& em) noexcept {
+bool FCameraManager::gc(utils::EntityManager& em, size_t count) noexcept {
     auto& manager = mManager;
-    manager.gc(em, 4, [this](Entity e) {
+    return manager.gcJournal(em, count, [this](Entity e) {
         destroy(e);
     });
 }
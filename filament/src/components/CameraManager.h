@@ -46,7 +46,8 @@ public:
     // free-up all resources
     void terminate() noexcept;
 
-    void gc(utils::EntityManager& em) noexcept;
+    // returns true when all destroyed entities have been processed
+    bool gc(utils::EntityManager& em, size_t count) noexcept;
 
     /*
     * Component Manager APIs
@@ -78,6 +79,7 @@ private:
 
     struct CameraManagerImpl : public Base {
         using Base::gc;
+        using Base::gcJournal;
         using Base::swap;
         using Base::hasComponent;
     } mManager;
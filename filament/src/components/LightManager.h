@@ -66,8 +66,9 @@ public:
 
     void prepare(backend::DriverApi& driver) const noexcept;
 
-    void gc(utils::EntityManager& em) noexcept {
-        mManager.gc(em);
+    // returns true when all destroyed entities have been processed
+    bool gc(utils::EntityManager& em, size_t count) noexcept {
+        return mManager.gcJournal(em, count);
     }
 
     struct LightType {
@@ -265,6 +266,7 @@ private:
 
     struct Sim : public Base {
         using Base::gc;
+        using Base::gcJournal;
         using Base::swap;
 
         struct Proxy {
@@ -60,6 +60,8 @@ struct RenderableManager::BuilderDetails {
     mat4f const* mUserBoneMatrices = nullptr;
     FSkinningBuffer* mSkinningBuffer = nullptr;
     uint32_t mSkinningBufferOffset = 0;
+    std::vector<FRenderableManager::LevelOfDetail> mLevels;
+    float mLevelOfDetailHysteresis = 0.0f;
 
     explicit BuilderDetails(size_t count)
             : mEntries(count), mCulling(true), mCastShadows(false), mReceiveShadows(true),
@@ -204,6 +206,22 @@ RenderableManager::Builder& RenderableManager::Builder::blendOrder(size_t index,
     return *this;
 }
 
+RenderableManager::Builder& RenderableManager::Builder::levelOfDetail(uint8_t level,
+        size_t first, size_t count, float screenCoverage) noexcept {
+    auto& levels = mImpl->mLevels;
+    if (level >= levels.size()) {
+        levels.resize(level + 1, { 0, 0, 0.0f });
+    }
+    levels[level] = { uint32_t(first), uint32_t(count), screenCoverage };
+    return *this;
+}
+
+RenderableManager::Builder& RenderableManager::Builder::levelOfDetailHysteresis(
+        float hysteresis) noexcept {
+    mImpl->mLevelOfDetailHysteresis = std::max(0.0f, hysteresis);
+    return *this;
+}
+
 RenderableManager::Builder::Result RenderableManager::Builder::build(Engine& engine, Entity entity) {
     bool isEmpty = true;
 
@@ -212,6 +230,22 @@ RenderableManager::Builder::Result RenderableManager::Builder::build(Engine& eng
         return Error;
     }
 
+    auto const& levels = mImpl->mLevels;
+    for (size_t i = 0, c = levels.size(); i < c; i++) {
+        if (!ASSERT_PRECONDITION_NON_FATAL(
+                levels[i].first + levels[i].count <= mImpl->mEntries.size(),
+                "[entity=%u, level @ %u] first (%u) + count (%u) > primitive count (%u)",
+                entity.getId(), i, levels[i].first, levels[i].count, mImpl->mEntries.size())) {
+            return Error;
+        }
+        if (!ASSERT_PRECONDITION_NON_FATAL(i == 0 ||
+                levels[i].screenCoverage <= levels[i - 1].screenCoverage,
+                "[entity=%u, level @ %u] screen coverage must decrease with the level",
+                entity.getId(), i)) {
+            return Error;
+        }
+    }
+
     for (size_t i = 0, c = mImpl->mEntries.size(); i < c; i++) {
         auto& entry = mImpl->mEntries[i];
 
@@ -309,6 +343,16 @@ void FRenderableManager::create(
         }
         setPrimitives(ci, { rp, size_type(builder->mEntries.size()) });
 
+        auto const& levels = builder->mLevels;
+        if (UTILS_UNLIKELY(!levels.empty())) {
+            LevelOfDetail* lods = new LevelOfDetail[levels.size()];
+            std::copy(levels.begin(), levels.end(), lods);
+            mManager[ci].lods = LevelsOfDetail{
+                    .levels = lods,
+                    .count = uint8_t(levels.size()),
+                    .hysteresis = builder->mLevelOfDetailHysteresis };
+        }
+
         setAxisAlignedBoundingBox(ci, builder->mAABB);
         setLayerMask(ci, builder->mLayerMask);
         setPriority(ci, builder->mPriority);
@@ -428,6 +472,10 @@ void FRenderableManager::destroyComponent(Instance ci) noexcept {
     // See create(RenderableManager::Builder&, Entity)
     destroyComponentPrimitives(engine, manager[ci].primitives);
 
+    LevelsOfDetail& lods = manager[ci].lods;
+    delete[] lods.levels;
+    lods = {};
+
     // destroy the bones structures if any
     Bones const& bones = manager[ci].bones;
     if (bones.handle && !bones.skinningBufferMode) {
@@ -449,10 +497,57 @@ void FRenderableManager::destroyComponentPrimitives(
     delete[] primitives.data();
 }
 
-void FRenderableManager::setMaterialInstanceAt(Instance instance, uint8_t level,
+Slice<FRenderPrimitive> FRenderableManager::getRenderPrimitives(
+        Instance instance, uint8_t level) const noexcept {
+    Slice<FRenderPrimitive> const& primitives = getRenderPrimitives(instance);
+    LevelsOfDetail const& lods = mManager[instance].lods;
+    if (UTILS_LIKELY(!lods.count)) {
+        return level == 0 ? primitives : Slice<FRenderPrimitive>{};
+    }
+    if (level >= lods.count) {
+        return {};
+    }
+    LevelOfDetail const& lod = lods.levels[level];
+    return { primitives.data() + lod.first, lod.count };
+}
+
+uint8_t FRenderableManager::selectLevelOfDetail(Instance instance,
+        float screenCoverage, uint8_t previous) const noexcept {
+    LevelsOfDetail const& lods = mManager[instance].lods;
+    if (UTILS_LIKELY(!lods.count)) {
+        return 0;
+    }
+
+    // the first level whose threshold is reached, levels are sorted by decreasing coverage
+    LevelOfDetail const* const levels = lods.levels;
+    uint8_t level = 0;
+    while (level < lods.count && screenCoverage < levels[level].screenCoverage) {
+        level++;
+    }
+
+    // Only leave the previous level once the coverage is past its threshold by the hysteresis
+    // margin, this avoids popping back and forth at the threshold.
+    const float h = lods.hysteresis;
+    if (h > 0.0f && previous <= lods.count && level != previous) {
+        if (level > previous) {
+            // switching to a coarser level
+            if (screenCoverage >= levels[previous].screenCoverage * (1.0f - h)) {
+                level = previous;
+            }
+        } else {
+            // switching to a finer level
+            if (screenCoverage < levels[previous - 1].screenCoverage * (1.0f + h)) {
+                level = previous;
+            }
+        }
+    }
+    return level;
+}
+
+void FRenderableManager::setMaterialInstanceAt(Instance instance,
         size_t primitiveIndex, FMaterialInstance const* mi) noexcept {
     if (instance) {
-        Slice<FRenderPrimitive>& primitives = getRenderPrimitives(instance, level);
+        Slice<FRenderPrimitive>& primitives = getRenderPrimitives(instance);
         if (primitiveIndex < primitives.size()) {
             primitives[primitiveIndex].setMaterialInstance(upcast(mi));
             AttributeBitset required = mi->getMaterial()->getRequiredAttributes();
@@ -467,9 +562,9 @@ void FRenderableManager::setMaterialInstanceAt(Instance instance, uint8_t level,
 }
 
 MaterialInstance* FRenderableManager::getMaterialInstanceAt(
-        Instance instance, uint8_t level, size_t primitiveIndex) const noexcept {
+        Instance instance, size_t primitiveIndex) const noexcept {
     if (instance) {
-        const Slice<FRenderPrimitive>& primitives = getRenderPrimitives(instance, level);
+        const Slice<FRenderPrimitive>& primitives = getRenderPrimitives(instance);
         if (primitiveIndex < primitives.size()) {
             // We store the material instance as const because we don't want to change it internally
             // but when the user queries it, we want to allow them to call setParameter()
@@ -479,10 +574,10 @@ MaterialInstance* FRenderableManager::getMaterialInstanceAt(
     return nullptr;
 }
 
-void FRenderableManager::setBlendOrderAt(Instance instance, uint8_t level,
+void FRenderableManager::setBlendOrderAt(Instance instance,
         size_t primitiveIndex, uint16_t order) noexcept {
     if (instance) {
-        Slice<FRenderPrimitive>& primitives = getRenderPrimitives(instance, level);
+        Slice<FRenderPrimitive>& primitives = getRenderPrimitives(instance);
         if (primitiveIndex < primitives.size()) {
             primitives[primitiveIndex].setBlendOrder(order);
         }
@@ -490,9 +585,9 @@ void FRenderableManager::setBlendOrderAt(Instance instance, uint8_t level,
 }
 
 AttributeBitset FRenderableManager::getEnabledAttributesAt(
-        Instance instance, uint8_t level, size_t primitiveIndex) const noexcept {
+        Instance instance, size_t primitiveIndex) const noexcept {
     if (instance) {
-        Slice<FRenderPrimitive> const& primitives = getRenderPrimitives(instance, level);
+        Slice<FRenderPrimitive> const& primitives = getRenderPrimitives(instance);
         if (primitiveIndex < primitives.size()) {
             return primitives[primitiveIndex].getEnabledAttributes();
         }
@@ -500,11 +595,11 @@ AttributeBitset FRenderableManager::getEnabledAttributesAt(
     return AttributeBitset{};
 }
 
-void FRenderableManager::setGeometryAt(Instance instance, uint8_t level, size_t primitiveIndex,
+void FRenderableManager::setGeometryAt(Instance instance, size_t primitiveIndex,
         PrimitiveType type, FVertexBuffer* vertices, FIndexBuffer* indices,
         size_t offset, size_t count) noexcept {
     if (instance) {
-        Slice<FRenderPrimitive>& primitives = getRenderPrimitives(instance, level);
+        Slice<FRenderPrimitive>& primitives = getRenderPrimitives(instance);
         if (primitiveIndex < primitives.size()) {
             primitives[primitiveIndex].set(mEngine, type, vertices, indices, offset,
                     0, vertices->getVertexCount() - 1, count);
@@ -512,10 +607,10 @@ void FRenderableManager::setGeometryAt(Instance instance, uint8_t level, size_t
     }
 }
 
-void FRenderableManager::setGeometryAt(Instance instance, uint8_t level, size_t primitiveIndex,
+void FRenderableManager::setGeometryAt(Instance instance, size_t primitiveIndex,
         PrimitiveType type, size_t offset, size_t count) noexcept {
     if (instance) {
-        Slice<FRenderPrimitive>& primitives = getRenderPrimitives(instance, level);
+        Slice<FRenderPrimitive>& primitives = getRenderPrimitives(instance);
         if (primitiveIndex < primitives.size()) {
             primitives[primitiveIndex].set(mEngine, type, offset, 0, 0, count);
         }
@@ -621,7 +716,7 @@ void FRenderableManager::setMorphTargetBufferAt(Instance instance, uint8_t level
                 "Only %d morph targets can be set (count=%d)",
                 morphWeights.count, morphTargetBuffer->getCount());
 
-        Slice<FRenderPrimitive>& primitives = getRenderPrimitives(instance, level);
+        Slice<FRenderPrimitive> primitives = getRenderPrimitives(instance, level);
         if (primitiveIndex < primitives.size()) {
             primitives[primitiveIndex].set(morphTargetBuffer);
         }
@@ -718,37 +813,37 @@ uint8_t RenderableManager::getLayerMask(Instance instance) const noexcept {
 }
 
 size_t RenderableManager::getPrimitiveCount(Instance instance) const noexcept {
-    return upcast(this)->getPrimitiveCount(instance, 0);
+    return upcast(this)->getPrimitiveCount(instance);
 }
 
 void RenderableManager::setMaterialInstanceAt(Instance instance,
         size_t primitiveIndex, MaterialInstance const* materialInstance) noexcept {
-    upcast(this)->setMaterialInstanceAt(instance, 0, primitiveIndex, upcast(materialInstance));
+    upcast(this)->setMaterialInstanceAt(instance, primitiveIndex, upcast(materialInstance));
 }
 
 MaterialInstance* RenderableManager::getMaterialInstanceAt(
         Instance instance, size_t primitiveIndex) const noexcept {
-    return upcast(this)->getMaterialInstanceAt(instance, 0, primitiveIndex);
+    return upcast(this)->getMaterialInstanceAt(instance, primitiveIndex);
 }
 
 void RenderableManager::setBlendOrderAt(Instance instance, size_t primitiveIndex, uint16_t order) noexcept {
-    upcast(this)->setBlendOrderAt(instance, 0, primitiveIndex, order);
+    upcast(this)->setBlendOrderAt(instance, primitiveIndex, order);
 }
 
 AttributeBitset RenderableManager::getEnabledAttributesAt(Instance instance, size_t primitiveIndex) const noexcept {
-    return upcast(this)->getEnabledAttributesAt(instance, 0, primitiveIndex);
+    return upcast(this)->getEnabledAttributesAt(instance, primitiveIndex);
 }
 
 void RenderableManager::setGeometryAt(Instance instance, size_t primitiveIndex,
         PrimitiveType type, VertexBuffer* vertices, IndexBuffer* indices,
         size_t offset, size_t count) noexcept {
-    upcast(this)->setGeometryAt(instance, 0, primitiveIndex,
+    upcast(this)->setGeometryAt(instance, primitiveIndex,
             type, upcast(vertices), upcast(indices), offset, count);
 }
 
 void RenderableManager::setGeometryAt(RenderableManager::Instance instance, size_t primitiveIndex,
         RenderableManager::PrimitiveType type, size_t offset, size_t count) noexcept {
-    upcast(this)->setGeometryAt(instance, 0, primitiveIndex, type, offset, count);
+    upcast(this)->setGeometryAt(instance, primitiveIndex, type, offset, count);
 }
 
 void RenderableManager::setBones(Instance instance,
@@ -86,8 +86,9 @@ public:
 
     void destroy(utils::Entity e) noexcept;
 
-    void gc(utils::EntityManager& em) noexcept {
-        mManager.gc(em);
+    // returns true when all destroyed entities have been processed
+    bool gc(utils::EntityManager& em, size_t count) noexcept {
+        return mManager.gcJournal(em, count);
     }
 
     inline void setAxisAlignedBoundingBox(Instance instance, const Box& aabb) noexcept;
@@ -148,20 +149,40 @@ public:
         return mManager.getEntity(instance);
     }
 
-    inline size_t getLevelCount(Instance instance) const noexcept { return 1; }
-    inline size_t getPrimitiveCount(Instance instance, uint8_t level) const noexcept;
-    void setMaterialInstanceAt(Instance instance, uint8_t level,
+    // A level of detail is a range of the renderable's primitives
+    struct LevelOfDetail {
+        uint32_t first;
+        uint32_t count;
+        float screenCoverage;   // minimum screen coverage at which this level is used
+    };
+
+    // Primitive indices below span all levels of detail
+    inline bool hasLevelsOfDetail(Instance instance) const noexcept;
+    inline size_t getLevelCount(Instance instance) const noexcept;
+    inline size_t getPrimitiveCount(Instance instance) const noexcept;
+    void setMaterialInstanceAt(Instance instance,
             size_t primitiveIndex, FMaterialInstance const* materialInstance) noexcept;
-    MaterialInstance* getMaterialInstanceAt(Instance instance, uint8_t level, size_t primitiveIndex) const noexcept;
-    void setGeometryAt(Instance instance, uint8_t level, size_t primitiveIndex,
+    MaterialInstance* getMaterialInstanceAt(Instance instance, size_t primitiveIndex) const noexcept;
+    void setGeometryAt(Instance instance, size_t primitiveIndex,
             PrimitiveType type, FVertexBuffer* vertices, FIndexBuffer* indices,
             size_t offset, size_t count) noexcept;
-    void setGeometryAt(Instance instance, uint8_t level, size_t primitiveIndex,
+    void setGeometryAt(Instance instance, size_t primitiveIndex,
             PrimitiveType type, size_t offset, size_t count) noexcept;
-    void setBlendOrderAt(Instance instance, uint8_t level, size_t primitiveIndex, uint16_t blendOrder) noexcept;
-    AttributeBitset getEnabledAttributesAt(Instance instance, uint8_t level, size_t primitiveIndex) const noexcept;
-    inline utils::Slice<FRenderPrimitive> const& getRenderPrimitives(Instance instance, uint8_t level) const noexcept;
-    inline utils::Slice<FRenderPrimitive>& getRenderPrimitives(Instance instance, uint8_t level) noexcept;
+    void setBlendOrderAt(Instance instance, size_t primitiveIndex, uint16_t blendOrder) noexcept;
+    AttributeBitset getEnabledAttributesAt(Instance instance, size_t primitiveIndex) const noexcept;
+    inline utils::Slice<FRenderPrimitive> const& getRenderPrimitives(Instance instance) const noexcept;
+    inline utils::Slice<FRenderPrimitive>& getRenderPrimitives(Instance instance) noexcept;
+
+    // primitives of the given level of detail, or no primitives if the level doesn't exist
+    utils::Slice<FRenderPrimitive> getRenderPrimitives(Instance instance,
+            uint8_t level) const noexcept;
+
+    // Selects the level of detail for the given screen coverage, applying the renderable's
+    // hysteresis with respect to the level previously selected by the caller, if any (i.e. if
+    // previous <= getLevelCount()). Returns getLevelCount() when the renderable is too small to
+    // be drawn.
+    uint8_t selectLevelOfDetail(Instance instance, float screenCoverage,
+            uint8_t previous) const noexcept;
 
 private:
     void destroyComponent(Instance ci) noexcept;
@@ -182,6 +203,12 @@ private:
     };
     static_assert(sizeof(MorphWeights) == 8);
 
+    struct LevelsOfDetail {
+        LevelOfDetail const* levels = nullptr;  // owned, nullptr when there is a single level
+        uint8_t count = 0;
+        float hysteresis = 0.0f;
+    };
+
     enum {
         AABB,               // user data
         LAYERS,             // user data
@@ -190,6 +217,7 @@ private:
         VISIBILITY,         // user data
         PRIMITIVES,         // user data
         BONES,              // filament data, UBO storing a pointer to the bones information
+        LODS,               // user data
     };
 
     using Base = utils::SingleInstanceComponentManager<
@@ -199,11 +227,13 @@ private:
             uint8_t,                         // CHANNELS
             Visibility,                      // VISIBILITY
             utils::Slice<FRenderPrimitive>,  // PRIMITIVES
-            Bones                            // BONES
+            Bones,                           // BONES
+            LevelsOfDetail                   // LODS
     >;
 
     struct Sim : public Base {
         using Base::gc;
+        using Base::gcJournal;
         using Base::swap;
 
         struct Proxy {
@@ -221,6 +251,7 @@ private:
                 Field<VISIBILITY>   visibility;
                 Field<PRIMITIVES>   primitives;
                 Field<BONES>        bones;
+                Field<LODS>         lods;
             };
         };
 
@@ -365,17 +396,27 @@ FRenderableManager::getMorphingBufferInfo(Instance instance) const noexcept {
 }
 
 utils::Slice<FRenderPrimitive> const& FRenderableManager::getRenderPrimitives(
-        Instance instance, uint8_t level) const noexcept {
+        Instance instance) const noexcept {
     return mManager[instance].primitives;
 }
 
 utils::Slice<FRenderPrimitive>& FRenderableManager::getRenderPrimitives(
-        Instance instance, uint8_t level) noexcept {
+        Instance instance) noexcept {
     return mManager[instance].primitives;
 }
 
-size_t FRenderableManager::getPrimitiveCount(Instance instance, uint8_t level) const noexcept {
-    return getRenderPrimitives(instance, level).size();
+bool FRenderableManager::hasLevelsOfDetail(Instance instance) const noexcept {
+    LevelsOfDetail const& lods = mManager[instance].lods;
+    return lods.count != 0;
+}
+
+size_t FRenderableManager::getLevelCount(Instance instance) const noexcept {
+    LevelsOfDetail const& lods = mManager[instance].lods;
+    return lods.count ? lods.count : 1;
+}
+
+size_t FRenderableManager::getPrimitiveCount(Instance instance) const noexcept {
+    return getRenderPrimitives(instance).size();
 }
 
 } // namespace filament
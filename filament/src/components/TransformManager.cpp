@@ -465,9 +465,9 @@ void FTransformManager::validateNode(Instance i) noexcept {
 #endif
 }
 
-void FTransformManager::gc(utils::EntityManager& em) noexcept {
+bool FTransformManager::gc(utils::EntityManager& em, size_t count) noexcept {
     auto& manager = mManager;
-    manager.gc(em, 4, [this](Entity e) {
+    return manager.gcJournal(em, count, [this](Entity e) {
                 destroy(e);
             });
 }
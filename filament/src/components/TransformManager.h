@@ -83,7 +83,8 @@ public:
 
     void commitLocalTransformTransaction() noexcept;
 
-    void gc(utils::EntityManager& em) noexcept;
+    // returns true when all destroyed entities have been processed
+    bool gc(utils::EntityManager& em, size_t count) noexcept;
 
     utils::Slice<const math::mat4f> getWorldTransforms() const noexcept {
         return mManager.slice<WORLD>();
@@ -161,6 +162,7 @@ private:
 
     struct Sim : public Base {
         using Base::gc;
+        using Base::gcJournal;
         using Base::swap;
 
         typename Base::SoA& getSoA() { return mData; }
@@ -26,12 +26,52 @@
 
 #include <math/mathfwd.h>
 
+#include <utils/JobSystem.h>
+
+#include <memory>
+#include <vector>
+
 namespace filament {
 
 class FEngine;
 
 class FColorGrading : public ColorGrading {
 public:
+    /*
+     * Keeps the LUTs of the most recently created ColorGradings, so that creating a ColorGrading
+     * with the same parameters as a recent one skips the LUT generation. The cache holds at most
+     * MAX_SIZE_IN_BYTES of LUTs, least recently used ones are evicted first. Owned by FEngine, it
+     * must only be used from the Engine's thread.
+     */
+    class LutCache {
+    public:
+        // 4 LUTs of the default dimension and format, or 2 FLOAT LUTs of that dimension
+        static constexpr size_t MAX_SIZE_IN_BYTES = 512 * 1024;
+
+        LutCache() noexcept;
+        ~LutCache() noexcept;
+
+        LutCache(LutCache const&) = delete;
+        LutCache& operator=(LutCache const&) = delete;
+
+        // Returns the LUT generated for builder, or nullptr. A returned LUT becomes the most
+        // recently used one and stays valid until the next call to put() or clear().
+        void const* get(const Builder& builder, size_t size) noexcept;
+
+        // Keeps a copy of the LUT generated for builder, unless it's built with a custom tone
+        // mapper or is larger than MAX_SIZE_IN_BYTES.
+        void put(const Builder& builder, void const* data, size_t size);
+
+        void clear() noexcept;
+
+        size_t getSizeInBytes() const noexcept { return mSizeInBytes; }
+
+    private:
+        struct Entry;
+        std::vector<std::unique_ptr<Entry>> mEntries; // least recently used first
+        size_t mSizeInBytes = 0;
+    };
+
     FColorGrading(FEngine& engine, const Builder& builder);
     FColorGrading(const FColorGrading& rhs) = delete;
     FColorGrading& operator=(const FColorGrading& rhs) = delete;
@@ -45,7 +85,15 @@ public:
 
     uint32_t getDimension() const noexcept { return mDimension; }
 
+    // Writes the LUT as UINT_2_10_10_10_REV texels if packed, as half4 texels otherwise.
+    static void generateLut(utils::JobSystem& js, const Builder& builder, void* out, bool packed);
+
 private:
+    struct ToneMapperKey;
+    static ToneMapperKey getToneMapperKey(const ToneMapper& toneMapper) noexcept;
+
+    static bool isSameLut(const Builder& lhs, const Builder& rhs) noexcept;
+
     backend::TextureHandle mLutHandle;
     uint32_t mDimension;
 };
@@ -124,6 +124,8 @@ public:
     static constexpr float  CONFIG_Z_LIGHT_FAR             = 100;
     static constexpr size_t CONFIG_FROXEL_SLICE_COUNT      = 16;
     static constexpr bool   CONFIG_IBL_USE_IRRADIANCE_MAP  = false;
+    static constexpr size_t CONFIG_GC_BATCH_SIZE           = 128;
+    static constexpr std::chrono::microseconds CONFIG_GC_TIME_BUDGET{ 1000 };
 
     static constexpr size_t CONFIG_PER_RENDER_PASS_ARENA_SIZE   = filament::CONFIG_PER_RENDER_PASS_ARENA_SIZE;
     static constexpr size_t CONFIG_PER_FRAME_COMMANDS_SIZE      = filament::CONFIG_PER_FRAME_COMMANDS_SIZE;
@@ -163,6 +165,7 @@ public:
     const FIndirectLight* getDefaultIndirectLight() const noexcept { return mDefaultIbl; }
     const FTexture* getDummyCubemap() const noexcept { return mDefaultIblTexture; }
     const FColorGrading* getDefaultColorGrading() const noexcept { return mDefaultColorGrading; }
+    FColorGrading::LutCache& getColorGradingLutCache() noexcept { return mColorGradingLutCache; }
 
     backend::Handle<backend::HwRenderPrimitive> getFullScreenRenderPrimitive() const noexcept {
         return mFullScreenTriangleRph;
@@ -221,6 +224,11 @@ public:
         return *mResourceAllocator;
     }
 
+    // total size of the commands flushed so far
+    uint64_t getFlushedCommandsSize() const noexcept {
+        return mCommandBufferQueue.getFlushedSize();
+    }
+
     void* streamAlloc(size_t size, size_t alignment) noexcept;
 
     Epoch getEngineEpoch() const { return mEngineEpoch; }
@@ -391,6 +399,7 @@ private:
     ResourceList<FTexture> mTextures{ "Texture" };
     ResourceList<FSkybox> mSkyboxes{ "Skybox" };
     ResourceList<FColorGrading> mColorGradings{ "ColorGrading" };
+    FColorGrading::LutCache mColorGradingLutCache;
     ResourceList<FRenderTarget> mRenderTargets{ "RenderTarget" };
 
     mutable uint32_t mMaterialId = 0;
@@ -31,8 +31,12 @@
 #include <filaflat/ShaderBuilder.h>
 
 #include <utils/compiler.h>
+#include <utils/JobSystem.h>
 
 #include <atomic>
+#include <mutex>
+#include <utility>
+#include <vector>
 
 namespace filament {
 
@@ -88,10 +92,31 @@ public:
         return UTILS_LIKELY(entry) ? entry : getProgramSlow(variant);
     }
     backend::Program getProgramBuilderWithVariants(Variant variant, Variant vertexVariant,
-            Variant fragmentVariant) const noexcept;
+            Variant fragmentVariant, filaflat::ShaderBuilder& vsBuilder,
+            filaflat::ShaderBuilder& fsBuilder) const noexcept;
     backend::Handle<backend::HwProgram> createAndCacheProgram(backend::Program&& p,
             Variant variant) const noexcept;
 
+    // prepares the programs of the variants selected by the mask on the JobSystem
+    void compile(UserVariantFilterMask variants) noexcept;
+
+    // the variants that compile() prepares for the given mask, i.e. the variants this material
+    // has and that only use the selected features, minus the ones that already have a program
+    std::vector<Variant> getCompileVariants(UserVariantFilterMask variants) const noexcept;
+
+    bool isCompiling() const noexcept { return mCompileJob != nullptr; }
+
+    bool hasCachedProgram(Variant variant) const noexcept {
+        return bool(mCachedPrograms[variant.key]);
+    }
+
+    // creates the programs prepared by compile() so far, called once per frame
+    void commitPendingPrograms() noexcept {
+        if (UTILS_UNLIKELY(mCompileJob)) {
+            commitPendingProgramsSlow();
+        }
+    }
+
     bool isVariantLit() const noexcept { return mIsVariantLit; }
 
     const utils::CString& getName() const noexcept { return mName; }
@@ -168,6 +193,18 @@ private:
     backend::Handle<backend::HwProgram> getSurfaceProgramSlow(Variant variant) const noexcept;
     backend::Handle<backend::HwProgram> getPostProcessProgramSlow(Variant variant) const noexcept;
 
+    backend::Program getProgramBuilder(Variant variant, filaflat::ShaderBuilder& vsBuilder,
+            filaflat::ShaderBuilder& fsBuilder) const noexcept;
+    backend::Program getSurfaceProgramBuilder(Variant variant, filaflat::ShaderBuilder& vsBuilder,
+            filaflat::ShaderBuilder& fsBuilder) const noexcept;
+    backend::Program getPostProcessProgramBuilder(Variant variant,
+            filaflat::ShaderBuilder& vsBuilder, filaflat::ShaderBuilder& fsBuilder) const noexcept;
+    bool hasVariant(Variant variant) const noexcept;
+
+    void commitPendingProgramsSlow() noexcept;
+    void createPendingPrograms() noexcept;
+    void cancelPendingPrograms() noexcept;
+
     // try to order by frequency of use
     mutable std::array<backend::Handle<backend::HwProgram>, VARIANT_COUNT> mCachedPrograms;
 
@@ -216,9 +253,16 @@ private:
     utils::CString mName;
     FEngine& mEngine;
     const uint32_t mMaterialId;
+    uint64_t mCacheId = 0;
     mutable uint32_t mMaterialInstanceId = 0;
     MaterialParser* mMaterialParser = nullptr;
     std::atomic<MaterialParser*> mPendingEdits = {};
+
+    // programs being prepared by compile(), mCompileJob is only accessed from the main thread
+    utils::JobSystem::Job* mCompileJob = nullptr;
+    std::atomic<uint32_t> mPendingProgramCount = {};
+    std::mutex mPendingProgramsLock;
+    std::vector<std::pair<Variant, backend::Program>> mPendingPrograms;
 };
 
 
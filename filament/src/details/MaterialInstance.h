@@ -31,6 +31,8 @@
 
 #include <filament/MaterialInstance.h>
 
+#include <algorithm>
+
 namespace filament {
 
 class FMaterial;
@@ -127,6 +129,10 @@ public:
 
     using MaterialInstance::setParameter;
 
+    template<typename T>
+    static void setParameters(MaterialInstance* const* instances, size_t instanceCount,
+            ParameterHandle<T> const* handles, size_t handleCount, T const* values) noexcept;
+
 private:
     friend class FMaterial;
     friend class MaterialInstance;
@@ -146,6 +152,27 @@ private:
     void setParameterImpl(const char* name,
             Texture const* texture, TextureSampler const& sampler) noexcept;
 
+    template<typename T>
+    void setParameterImpl(ParameterHandle<T> handle, T const& value) noexcept {
+        if (UTILS_LIKELY(handle.isValid())) {
+            assert_invariant(handle.mMaterial == mMaterial);
+            mUniforms.setUniform(handle.mOffset, value);
+        }
+    }
+
+    template<typename T>
+    void setParameterImpl(ParameterHandle<T> handle, const T* values, size_t count) noexcept {
+        if (UTILS_LIKELY(handle.isValid())) {
+            assert_invariant(handle.mMaterial == mMaterial);
+            assert_invariant(count <= handle.mCount);
+            count = std::min(count, size_t(handle.mCount));
+            mUniforms.setUniformArray(handle.mOffset, values, count);
+        }
+    }
+
+    void setParameterImpl(SamplerHandle handle,
+            Texture const* texture, TextureSampler const& sampler) noexcept;
+
     FMaterialInstance() noexcept;
     void initDefaultInstance(FEngine& engine, FMaterial const* material);
 
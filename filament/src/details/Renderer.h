@@ -22,6 +22,7 @@
 #include "Allocators.h"
 #include "FrameInfo.h"
 #include "FrameSkipper.h"
+#include "FrameTelemetry.h"
 #include "PostProcessManager.h"
 #include "RenderPass.h"
 
@@ -93,6 +94,8 @@ public:
 
     void renderStandaloneView(FView const* view);
 
+    void renderStandaloneViews(View const* const* views, size_t count);
+
     void readPixels(FRenderTarget* renderTarget,
             uint32_t xoffset, uint32_t yoffset, uint32_t width, uint32_t height,
             backend::PixelBufferDescriptor&& buffer);
@@ -128,6 +131,14 @@ public:
         mClearOptions = options;
     }
 
+    void setFrameTelemetryOptions(FrameTelemetryOptions const& options) {
+        mFrameTelemetryManager.setOptions(options);
+    }
+
+    size_t getFrameTelemetry(FrameTelemetry* out, size_t count) const noexcept {
+        return mFrameTelemetryManager.getHistory(out, count);
+    }
+
 private:
     friend class Renderer;
     using Command = RenderPass::Command;
@@ -203,6 +214,7 @@ private:
     size_t mCommandsHighWatermark = 0;
     uint32_t mFrameId = 0;
     FrameInfoManager mFrameInfoManager;
+    FrameTelemetryManager mFrameTelemetryManager;
     backend::TextureFormat mHdrTranslucent{};
     backend::TextureFormat mHdrQualityMedium{};
     backend::TextureFormat mHdrQualityHigh{};
@@ -86,6 +86,11 @@ public:
     void terminate(FEngine& engine);
 
     void prepare(const math::mat4& worldOriginTransform, bool shadowReceiversAreCasters) noexcept;
+
+    // While enabled, prepare() only gathers the renderables the first time it is called with
+    // given parameters, later calls only gather the lights. This is used by
+    // FRenderer::renderStandaloneViews(), nothing can change the scene between its views.
+    void setRenderablesShared(bool shared) noexcept;
     void prepareDynamicLights(const CameraInfo& camera, ArenaScope& arena,
             backend::Handle<backend::HwBufferObject> lightUbh) noexcept;
 
@@ -109,6 +114,7 @@ public:
         WORLD_AABB_CENTER,      // 12 | world-space bounding box center of the renderable
         VISIBLE_MASK,           //  2 | each bit represents a visibility in a pass
         CHANNELS,               //  1 | currently light channels only
+        LEVEL_OF_DETAIL,        //  1 | level of detail selected for the viewing camera
 
         // These are not needed anymore after culling
         LAYERS,                 //  1 | layers
@@ -131,6 +137,7 @@ public:
             math::float3,                               // WORLD_AABB_CENTER
             VisibleMaskType,                            // VISIBLE_MASK
             uint8_t,                                    // CHANNELS
+            uint8_t,                                    // LEVEL_OF_DETAIL
             uint8_t,                                    // LAYERS
             math::float3,                               // WORLD_AABB_EXTENT
             utils::Slice<FRenderPrimitive>,             // PRIMITIVES
@@ -191,6 +198,11 @@ public:
 
     void updateUBOs(utils::Range<uint32_t> visibleRenderables, backend::Handle<backend::HwBufferObject> renderableUbh) noexcept;
 
+    // writes the PerRenderableData of the renderable at index i of the given SoA, at the given
+    // offset in buffer. Also used by RenderPass to gather the data of instanced draws.
+    static void writeRenderableData(void* buffer, size_t offset, RenderableSoa const& soa,
+            size_t i, FRenderableManager const& rcm) noexcept;
+
     bool hasContactShadows() const noexcept;
 
 private:
@@ -219,6 +231,12 @@ private:
     LightSoa mLightData;
     backend::Handle<backend::HwBufferObject> mRenderableViewUbh; // This is actually owned by the view.
     bool mHasContactShadows = false;
+
+    // see setRenderablesShared()
+    bool mRenderablesShared = false;
+    bool mRenderablesPrepared = false;
+    math::mat4 mPreparedWorldOrigin;
+    bool mPreparedReceiversAreCasters = false;
 };
 
 FILAMENT_UPCAST(Scene)
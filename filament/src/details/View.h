@@ -26,6 +26,7 @@
 #include "Allocators.h"
 #include "FrameHistory.h"
 #include "FrameInfo.h"
+#include "FrameTelemetry.h"
 #include "Froxelizer.h"
 #include "PerViewUniforms.h"
 #include "PIDController.h"
@@ -52,6 +53,8 @@
 
 #include <math/scalar.h>
 
+#include <tsl/robin_map.h>
+
 namespace utils {
 class JobSystem;
 } // namespace utils;
@@ -119,7 +122,8 @@ public:
     void terminate(FEngine& engine);
 
     void prepare(FEngine& engine, backend::DriverApi& driver, ArenaScope& arena,
-            Viewport const& viewport, math::float4 const& userTime) noexcept;
+            Viewport const& viewport, math::float4 const& userTime,
+            FrameTelemetryManager& telemetry) noexcept;
 
     void setScene(FScene* scene) { mScene = scene; }
     FScene const* getScene() const noexcept { return mScene; }
@@ -516,8 +520,19 @@ private:
         PickingQueryResult result;
     };
 
-    void prepareVisibleRenderables(utils::JobSystem& js,
-            Frustum const& frustum, FScene::RenderableSoa& renderableData) const noexcept;
+    void prepareVisibleRenderables(utils::JobSystem& js, FRenderableManager const& rcm,
+            CameraInfo const& camera, Frustum const& frustum,
+            FScene::RenderableSoa& renderableData) noexcept;
+
+public:
+    // Returns the fraction of the viewport covered by a sphere of the given radius at the given
+    // distance from the camera, as used for the level of detail selection.
+    static float computeScreenCoverage(math::mat4f const& projection, float distance,
+            float radius) noexcept;
+
+private:
+    void selectLevelsOfDetail(FRenderableManager const& rcm, CameraInfo const& camera,
+            FScene::RenderableSoa& renderableData) noexcept;
 
     static void prepareVisibleLights(FLightManager const& lcm, ArenaScope& rootArena,
             const CameraInfo& camera, Frustum const& frustum,
@@ -619,6 +634,9 @@ private:
 
     ShadowMapManager mShadowMapManager;
 
+    // levels of detail selected by this view, in the last and the current frame
+    std::array<tsl::robin_map<utils::Entity, uint8_t>, 2> mLevelsOfDetail;
+
 #ifndef NDEBUG
     std::array<DebugRegistry::FrameHistory, 5*60> mDebugFrameHistory;
 #endif
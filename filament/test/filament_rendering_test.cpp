@@ -16,18 +16,35 @@
 
 #include <gtest/gtest.h>
 
+#include <filament/Camera.h>
+#include <filament/ColorGrading.h>
 #include <filament/Engine.h>
+#include <filament/IndexBuffer.h>
+#include <filament/Material.h>
+#include <filament/MaterialInstance.h>
+#include <filament/RenderableManager.h>
+#include <filament/RenderTarget.h>
 #include <filament/Renderer.h>
-#include <filament/Skybox.h>
 #include <filament/Scene.h>
+#include <filament/Skybox.h>
+#include <filament/Texture.h>
+#include <filament/TransformManager.h>
+#include <filament/VertexBuffer.h>
 #include <filament/View.h>
 #include <filament/Viewport.h>
-#include <filament/ColorGrading.h>
 
 #include <utils/EntityManager.h>
 
 #include <backend/PixelBufferDescriptor.h>
 
+#include "Allocators.h"
+#include "RenderPass.h"
+#include "details/Engine.h"
+#include "details/Scene.h"
+
+#include <algorithm>
+#include <vector>
+
 using namespace filament;
 using namespace backend;
 
@@ -139,3 +156,282 @@ TEST_F(RenderingTest, ClearGreen) {
         EXPECT_EQ(rgba[3], 0xff);
     });
 }
+
+TEST_F(RenderingTest, InstancedDraws) {
+    // Four renderables share the same primitive and material instance, so they're drawn with a
+    // single instanced draw. Each one must still be drawn with its own transform.
+    static const math::float3 kVertices[] = {
+            { -0.5f, -0.5f, 0.0f }, { 0.5f, -0.5f, 0.0f }, { -0.5f, 0.5f, 0.0f }, { 0.5f, 0.5f, 0.0f }
+    };
+    static const uint16_t kIndices[] = { 0, 1, 2, 2, 1, 3 };
+
+    VertexBuffer* vb = VertexBuffer::Builder()
+            .vertexCount(4)
+            .bufferCount(1)
+            .attribute(VertexAttribute::POSITION, 0, VertexBuffer::AttributeType::FLOAT3)
+            .build(*mEngine);
+    vb->setBufferAt(*mEngine, 0, VertexBuffer::BufferDescriptor(kVertices, sizeof(kVertices)));
+    IndexBuffer* ib = IndexBuffer::Builder()
+            .indexCount(6)
+            .bufferType(IndexBuffer::IndexType::USHORT)
+            .build(*mEngine);
+    ib->setBuffer(*mEngine, IndexBuffer::BufferDescriptor(kIndices, sizeof(kIndices)));
+
+    MaterialInstance const* mi = mEngine->getDefaultMaterial()->getDefaultInstance();
+    auto& tcm = mEngine->getTransformManager();
+    utils::Entity renderables[4];
+    utils::EntityManager::get().create(4, renderables);
+    for (size_t i = 0; i < 4; i++) {
+        RenderableManager::Builder(1)
+                .boundingBox({{ -0.5f, -0.5f, 0.0f }, { 0.5f, 0.5f, 0.0f }})
+                .geometry(0, RenderableManager::PrimitiveType::TRIANGLES, vb, ib)
+                .material(0, mi)
+                .culling(false)
+                .castShadows(false)
+                .receiveShadows(false)
+                .build(*mEngine, renderables[i]);
+        // one renderable per quadrant of the view
+        const math::float3 position{ i & 1 ? 0.5f : -0.5f, i & 2 ? 0.5f : -0.5f, 0.0f };
+        tcm.setTransform(tcm.getInstance(renderables[i]), math::mat4f::translation(position));
+        mScene->addEntity(renderables[i]);
+    }
+
+    mCamera->setProjection(Camera::Projection::ORTHO, -1, 1, -1, 1, -1, 1);
+    mSkybox->setColor({ 2.0f, 0.0f, 0.0f, 1.0f });
+    mView->setDithering(View::Dithering::NONE);
+    runTest([](uint8_t const* rgba, uint32_t width, uint32_t height) {
+        // the center of each quadrant shows a gray quad rather than the red skybox
+        for (uint32_t y : { height / 4, 3 * height / 4 }) {
+            for (uint32_t x : { width / 4, 3 * width / 4 }) {
+                uint8_t const* p = rgba + (y * width + x) * 4;
+                EXPECT_EQ(p[0], p[1]);
+                EXPECT_GT(p[1], 0);
+            }
+        }
+    });
+
+    // the commands of the four renderables are drawn with a single instanced draw, the skybox
+    // is drawn on its own
+    FScene::RenderableSoa const& soa = upcast(mScene)->getRenderableData();
+    void* const arenaBegin = malloc(CONFIG_PER_FRAME_COMMANDS_SIZE);
+    void* const arenaEnd = utils::pointermath::add(arenaBegin, CONFIG_PER_FRAME_COMMANDS_SIZE);
+    {
+        RenderPass::Arena arena("Command Arena", { arenaBegin, arenaEnd });
+        RenderPass pass(*upcast(mEngine), arena);
+        pass.setGeometry(soa, { 0, uint32_t(soa.size()) }, {});
+        pass.appendCommands(RenderPass::COLOR);
+        pass.sortCommands();
+
+        size_t drawCount = 0;
+        size_t maxInstanceCount = 0;
+        auto const* const soaSkinning = soa.data<FScene::SKINNING_BUFFER>();
+        for (RenderPass::Command const* curr = pass.begin(); curr != pass.end();) {
+            const size_t instanceCount =
+                    RenderPass::Executor::getInstanceCount(curr, pass.end(), soaSkinning);
+            maxInstanceCount = std::max(maxInstanceCount, instanceCount);
+            curr += instanceCount;
+            drawCount++;
+        }
+        EXPECT_EQ(4, maxInstanceCount);
+        EXPECT_EQ(size_t(pass.end() - pass.begin()) - 3, drawCount);
+    }
+    free(arenaBegin);
+
+    for (utils::Entity e : renderables) {
+        mEngine->destroy(e);
+    }
+    utils::EntityManager::get().destroy(4, renderables);
+    mEngine->destroy(ib);
+    mEngine->destroy(vb);
+}
+
+TEST_F(RenderingTest, StandaloneViews) {
+    // Two views of two scenes with different clear colors, each into its own render target.
+    struct Target {
+        Scene* scene;
+        Skybox* skybox;
+        View* view;
+        Texture* texture;
+        RenderTarget* renderTarget;
+        std::vector<uint8_t> pixels;
+    };
+    const math::float4 colors[2] = {{ 2.0f, 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f, 2.0f, 1.0f }};
+    Target targets[2];
+    for (size_t i = 0; i < 2; i++) {
+        Target& t = targets[i];
+        t.skybox = Skybox::Builder().color(colors[i]).build(*mEngine);
+        t.scene = mEngine->createScene();
+        t.scene->setSkybox(t.skybox);
+        t.texture = Texture::Builder()
+                .width(16).height(16)
+                .format(Texture::InternalFormat::RGBA8)
+                .usage(Texture::Usage::COLOR_ATTACHMENT | Texture::Usage::SAMPLEABLE)
+                .build(*mEngine);
+        t.renderTarget = RenderTarget::Builder()
+                .texture(RenderTarget::AttachmentPoint::COLOR, t.texture)
+                .build(*mEngine);
+        t.view = mEngine->createView();
+        t.view->setViewport({ 0, 0, 16, 16 });
+        t.view->setScene(t.scene);
+        t.view->setCamera(mCamera);
+        t.view->setColorGrading(mColorGrading);
+        t.view->setDithering(View::Dithering::NONE);
+        t.view->setRenderTarget(t.renderTarget);
+    }
+
+    // Reads back both render targets, then returns the pixels of each.
+    auto readBack = [this, &targets]() {
+        std::vector<uint8_t> result[2];
+        for (size_t i = 0; i < 2; i++) {
+            const size_t size = 16 * 16 * 4;
+            PixelBufferDescriptor pd(malloc(size), size,
+                    PixelDataFormat::RGBA, PixelDataType::UBYTE,
+                    [](void* buffer, size_t size, void* user) {
+                        auto* pixels = (std::vector<uint8_t>*) user;
+                        auto* data = (uint8_t const*) buffer;
+                        pixels->assign(data, data + size);
+                        ::free(buffer);
+                    }, &result[i]);
+            mRenderer->readPixels(targets[i].renderTarget, 0, 0, 16, 16, std::move(pd));
+        }
+        mEngine->flushAndWait();
+        return std::make_pair(result[0], result[1]);
+    };
+
+    View const* views[2] = { targets[0].view, targets[1].view };
+    mRenderer->renderStandaloneViews(views, 2);
+    const auto together = readBack();
+
+    mRenderer->renderStandaloneView(views[0]);
+    mRenderer->renderStandaloneView(views[1]);
+    const auto separately = readBack();
+
+    ASSERT_EQ(16 * 16 * 4, together.first.size());
+    ASSERT_EQ(16 * 16 * 4, together.second.size());
+    EXPECT_EQ(separately.first, together.first);
+    EXPECT_EQ(separately.second, together.second);
+
+    // and each view shows its own scene
+    EXPECT_EQ(0xff, together.first[0]);
+    EXPECT_EQ(0, together.first[2]);
+    EXPECT_EQ(0, together.second[0]);
+    EXPECT_EQ(0xff, together.second[2]);
+
+    for (Target& t : targets) {
+        mEngine->destroy(t.view);
+        mEngine->destroy(t.renderTarget);
+        mEngine->destroy(t.texture);
+        mEngine->destroy(t.scene);
+        mEngine->destroy(t.skybox);
+    }
+}
+
+TEST_F(RenderingTest, StandaloneViewsSharedScene) {
+    // Two views of the same scene, whose renderables are therefore only gathered once. The quad
+    // is only visible in the second view, which must not see the per-view data of the first.
+    static const math::float3 kVertices[] = {
+            { -1.0f, -1.0f, 0.0f }, { 1.0f, -1.0f, 0.0f }, { -1.0f, 1.0f, 0.0f }, { 1.0f, 1.0f, 0.0f }
+    };
+    static const uint16_t kIndices[] = { 0, 1, 2, 2, 1, 3 };
+
+    VertexBuffer* vb = VertexBuffer::Builder()
+            .vertexCount(4)
+            .bufferCount(1)
+            .attribute(VertexAttribute::POSITION, 0, VertexBuffer::AttributeType::FLOAT3)
+            .build(*mEngine);
+    vb->setBufferAt(*mEngine, 0, VertexBuffer::BufferDescriptor(kVertices, sizeof(kVertices)));
+    IndexBuffer* ib = IndexBuffer::Builder()
+            .indexCount(6)
+            .bufferType(IndexBuffer::IndexType::USHORT)
+            .build(*mEngine);
+    ib->setBuffer(*mEngine, IndexBuffer::BufferDescriptor(kIndices, sizeof(kIndices)));
+
+    utils::Entity quad = utils::EntityManager::get().create();
+    RenderableManager::Builder(1)
+            .boundingBox({{ -1.0f, -1.0f, 0.0f }, { 1.0f, 1.0f, 0.0f }})
+            .geometry(0, RenderableManager::PrimitiveType::TRIANGLES, vb, ib)
+            .material(0, mEngine->getDefaultMaterial()->getDefaultInstance())
+            .layerMask(0xff, 0x2)
+            .castShadows(false)
+            .receiveShadows(false)
+            .build(*mEngine, quad);
+    mScene->addEntity(quad);
+
+    mCamera->setProjection(Camera::Projection::ORTHO, -1, 1, -1, 1, -1, 1);
+    mSkybox->setColor({ 2.0f, 0.0f, 0.0f, 1.0f });
+
+    struct Target {
+        View* view;
+        Texture* texture;
+        RenderTarget* renderTarget;
+    };
+    Target targets[2];
+    for (size_t i = 0; i < 2; i++) {
+        Target& t = targets[i];
+        t.texture = Texture::Builder()
+                .width(16).height(16)
+                .format(Texture::InternalFormat::RGBA8)
+                .usage(Texture::Usage::COLOR_ATTACHMENT | Texture::Usage::SAMPLEABLE)
+                .build(*mEngine);
+        t.renderTarget = RenderTarget::Builder()
+                .texture(RenderTarget::AttachmentPoint::COLOR, t.texture)
+                .build(*mEngine);
+        t.view = mEngine->createView();
+        t.view->setViewport({ 0, 0, 16, 16 });
+        t.view->setScene(mScene);
+        t.view->setCamera(mCamera);
+        t.view->setColorGrading(mColorGrading);
+        t.view->setDithering(View::Dithering::NONE);
+        t.view->setRenderTarget(t.renderTarget);
+    }
+    targets[1].view->setVisibleLayers(0x2, 0x2);
+
+    // Reads back both render targets, then returns the pixels of each.
+    auto readBack = [this, &targets]() {
+        std::vector<uint8_t> result[2];
+        for (size_t i = 0; i < 2; i++) {
+            const size_t size = 16 * 16 * 4;
+            PixelBufferDescriptor pd(malloc(size), size,
+                    PixelDataFormat::RGBA, PixelDataType::UBYTE,
+                    [](void* buffer, size_t size, void* user) {
+                        auto* pixels = (std::vector<uint8_t>*) user;
+                        auto* data = (uint8_t const*) buffer;
+                        pixels->assign(data, data + size);
+                        ::free(buffer);
+                    }, &result[i]);
+            mRenderer->readPixels(targets[i].renderTarget, 0, 0, 16, 16, std::move(pd));
+        }
+        mEngine->flushAndWait();
+        return std::make_pair(result[0], result[1]);
+    };
+
+    View const* views[2] = { targets[0].view, targets[1].view };
+    mRenderer->renderStandaloneViews(views, 2);
+    const auto together = readBack();
+
+    mRenderer->renderStandaloneView(views[0]);
+    mRenderer->renderStandaloneView(views[1]);
+    const auto separately = readBack();
+
+    ASSERT_EQ(16 * 16 * 4, together.first.size());
+    ASSERT_EQ(16 * 16 * 4, together.second.size());
+    EXPECT_EQ(separately.first, together.first);
+    EXPECT_EQ(separately.second, together.second);
+
+    // the first view only shows the red skybox, the second one shows the gray quad
+    const size_t center = (8 * 16 + 8) * 4;
+    EXPECT_EQ(0xff, together.first[center]);
+    EXPECT_EQ(0, together.first[center + 1]);
+    EXPECT_EQ(together.second[center], together.second[center + 1]);
+    EXPECT_GT(together.second[center + 1], 0);
+
+    for (Target& t : targets) {
+        mEngine->destroy(t.view);
+        mEngine->destroy(t.renderTarget);
+        mEngine->destroy(t.texture);
+    }
+    mEngine->destroy(quad);
+    utils::EntityManager::get().destroy(quad);
+    mEngine->destroy(ib);
+    mEngine->destroy(vb);
+}
@@ -28,23 +28,47 @@
 #include <filament/Box.h>
 #include <filament/Camera.h>
 #include <filament/Color.h>
+#include <filament/ColorGrading.h>
 #include <filament/Frustum.h>
+#include <filament/IndexBuffer.h>
 #include <filament/Material.h>
 #include <filament/Engine.h>
+#include <filament/MaterialInstance.h>
+#include <filament/ToneMapper.h>
+#include <filament/VertexBuffer.h>
+
+#include <filamat/MaterialBuilder.h>
 
 #include <private/filament/UniformInterfaceBlock.h>
 #include <private/filament/UibStructs.h>
 #include <private/backend/BackendUtils.h>
 
 #include "Allocators.h"
+#include "details/ColorGrading.h"
 #include "details/Material.h"
 #include "details/Camera.h"
 #include "Froxelizer.h"
+#include "PostProcessManager.h"
+#include "RenderPass.h"
+#include "RenderPrimitive.h"
 #include "details/Engine.h"
+#include "details/IndexBuffer.h"
+#include "details/VertexBuffer.h"
+#include "details/View.h"
 #include "components/RenderableManager.h"
 #include "components/TransformManager.h"
 #include "UniformBuffer.h"
 
+#include "generated/resources/materials.h"
+
+#include <utils/JobSystem.h>
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <string.h>
+
 using namespace filament;
 using namespace filament::math;
 using namespace utils;
@@ -727,6 +751,436 @@ TEST(FilamentTest, FroxelData) {
     Engine::destroy((Engine **)&engine);
 }
 
+TEST(FilamentTest, LevelOfDetail) {
+    using namespace filament;
+
+    // with a 90 degrees fov, a sphere of radius 1 at distance 1 spans the whole viewport height
+    mat4f p = mat4f::perspective(90, 1.0f, 0.1, 100, mat4f::Fov::VERTICAL);
+    EXPECT_FLOAT_EQ(1.0f, FView::computeScreenCoverage(p, 0.5f, 1.0f));
+    EXPECT_FLOAT_EQ(float(F_PI_4) / 4.0f, FView::computeScreenCoverage(p, 1.0f, 0.5f));
+    // the coverage is an area and decreases with the square of the distance
+    EXPECT_FLOAT_EQ(float(F_PI_4) / 16.0f, FView::computeScreenCoverage(p, 4.0f, 1.0f));
+    // the same sphere covers a smaller fraction of a wider viewport
+    mat4f wide = mat4f::perspective(90, 2.0f, 0.1, 100, mat4f::Fov::VERTICAL);
+    EXPECT_FLOAT_EQ(float(F_PI_4) / 32.0f, FView::computeScreenCoverage(wide, 4.0f, 1.0f));
+    // orthographic projections ignore the distance
+    mat4f o = mat4f::ortho(-4, 4, -4, 4, 0.1, 100);
+    EXPECT_FLOAT_EQ(float(F_PI_4) / 16.0f, FView::computeScreenCoverage(o, 1.0f, 1.0f));
+    EXPECT_FLOAT_EQ(float(F_PI_4) / 16.0f, FView::computeScreenCoverage(o, 10.0f, 1.0f));
+
+    FEngine* engine = FEngine::create();
+    FRenderableManager& rcm = engine->getRenderableManager();
+    Entity e = engine->getEntityManager().create();
+
+    // level 0: primitives 0-1, level 1: primitives 2-3, level 2: primitive 4
+    RenderableManager::Builder(5)
+            .culling(false)
+            .levelOfDetail(0, 0, 2, 0.5f)
+            .levelOfDetail(1, 2, 2, 0.1f)
+            .levelOfDetail(2, 4, 1, 0.01f)
+            .levelOfDetailHysteresis(0.2f)
+            .build(*engine, e);
+    auto ri = rcm.getInstance(e);
+
+    EXPECT_TRUE(rcm.hasLevelsOfDetail(ri));
+    EXPECT_EQ(3, rcm.getLevelCount(ri));
+    EXPECT_EQ(5, rcm.getPrimitiveCount(ri));
+    EXPECT_EQ(2, rcm.getRenderPrimitives(ri, 0).size());
+    EXPECT_EQ(rcm.getRenderPrimitives(ri).data() + 2, rcm.getRenderPrimitives(ri, 1).data());
+    EXPECT_EQ(1, rcm.getRenderPrimitives(ri, 2).size());
+    EXPECT_EQ(0, rcm.getRenderPrimitives(ri, 3).size());
+
+    // without a previous level, the first level whose threshold is reached is selected
+    constexpr uint8_t NONE = UINT8_MAX;
+    EXPECT_EQ(0, rcm.selectLevelOfDetail(ri, 1.0f, NONE));
+    EXPECT_EQ(0, rcm.selectLevelOfDetail(ri, 0.5f, NONE));
+    EXPECT_EQ(1, rcm.selectLevelOfDetail(ri, 0.45f, NONE));
+    EXPECT_EQ(2, rcm.selectLevelOfDetail(ri, 0.05f, NONE));
+    EXPECT_EQ(3, rcm.selectLevelOfDetail(ri, 0.001f, NONE));
+
+    // the previous level is kept within the hysteresis margin, in both directions
+    EXPECT_EQ(0, rcm.selectLevelOfDetail(ri, 0.45f, 0));
+    EXPECT_EQ(1, rcm.selectLevelOfDetail(ri, 0.35f, 0));
+    EXPECT_EQ(1, rcm.selectLevelOfDetail(ri, 0.55f, 1));
+    EXPECT_EQ(0, rcm.selectLevelOfDetail(ri, 0.65f, 1));
+    EXPECT_EQ(2, rcm.selectLevelOfDetail(ri, 0.0095f, 2));
+    EXPECT_EQ(3, rcm.selectLevelOfDetail(ri, 0.0075f, 2));
+    EXPECT_EQ(3, rcm.selectLevelOfDetail(ri, 0.0115f, 3));
+    EXPECT_EQ(2, rcm.selectLevelOfDetail(ri, 0.0125f, 3));
+
+    // the selection doesn't depend on other callers, i.e. it is stateless
+    EXPECT_EQ(1, rcm.selectLevelOfDetail(ri, 0.45f, NONE));
+    EXPECT_EQ(0, rcm.selectLevelOfDetail(ri, 0.45f, 0));
+
+    engine->destroy(e);
+    Engine::destroy((Engine **)&engine);
+}
+
+static FMaterial* createDefaultMaterial(FEngine& engine) {
+    return upcast(Material::Builder()
+            .package(MATERIALS_DEFAULTMATERIAL_DATA, MATERIALS_DEFAULTMATERIAL_SIZE)
+            .build(engine));
+}
+
+static void waitForPendingPrograms(FMaterial* material) {
+    while (material->isCompiling()) {
+        material->commitPendingPrograms();
+        std::this_thread::yield();
+    }
+}
+
+TEST(FilamentTest, MaterialCompileVariants) {
+    using namespace filament;
+
+    FEngine* engine = FEngine::create();
+    FMaterial* material = createDefaultMaterial(*engine);
+
+    // the default material is unlit, without any feature only the standard and depth variants
+    // are prepared
+    std::vector<Variant> none = material->getCompileVariants(0);
+    ASSERT_EQ(2, none.size());
+    EXPECT_EQ(Variant(0), none[0]);
+    EXPECT_EQ(Variant(Variant::DEP), none[1]);
+
+    // lighting features don't select anything in an unlit material
+    EXPECT_EQ(none, material->getCompileVariants(
+            UserVariantFilterMask(UserVariantFilterBit::DIRECTIONAL_LIGHTING) |
+            UserVariantFilterMask(UserVariantFilterBit::SHADOW_RECEIVER)));
+
+    // each selected variant only uses the selected features
+    const UserVariantFilterMask mask = UserVariantFilterMask(UserVariantFilterBit::SKINNING);
+    std::vector<Variant> skinning = material->getCompileVariants(mask);
+    EXPECT_GT(skinning.size(), none.size());
+    EXPECT_NE(std::find(skinning.begin(), skinning.end(), Variant(Variant::SKN)), skinning.end());
+    for (Variant variant : skinning) {
+        EXPECT_EQ(0, variant.key & ~(Variant::SKN | Variant::DEP));
+    }
+
+    // all the variants are a superset, and never include picking
+    std::vector<Variant> all = material->getCompileVariants(
+            UserVariantFilterMask(UserVariantFilterBit::ALL));
+    EXPECT_GT(all.size(), skinning.size());
+    for (Variant variant : skinning) {
+        EXPECT_NE(std::find(all.begin(), all.end(), variant), all.end());
+    }
+    for (Variant variant : all) {
+        EXPECT_FALSE(Variant::isValidDepthVariant(variant) && variant.hasPicking());
+    }
+
+    // variants that already have a program are skipped
+    material->getProgram(Variant(0));
+    std::vector<Variant> remaining = material->getCompileVariants(0);
+    ASSERT_EQ(1, remaining.size());
+    EXPECT_EQ(Variant(Variant::DEP), remaining[0]);
+
+    engine->destroy(material);
+    Engine::destroy((Engine **)&engine);
+}
+
+TEST(FilamentTest, MaterialCompilePendingPrograms) {
+    using namespace filament;
+
+    FEngine* engine = FEngine::create();
+    const UserVariantFilterMask mask = UserVariantFilterMask(UserVariantFilterBit::SKINNING);
+
+    {
+        // the programs are created as they are committed, and only those
+        FMaterial* material = createDefaultMaterial(*engine);
+        const std::vector<Variant> selected = material->getCompileVariants(mask);
+        material->compile(mask);
+        waitForPendingPrograms(material);
+        for (Variant::type_t k = 0; k < VARIANT_COUNT; k++) {
+            const bool isSelected =
+                    std::find(selected.begin(), selected.end(), Variant(k)) != selected.end();
+            EXPECT_EQ(isSelected, material->hasCachedProgram(Variant(k)));
+        }
+        EXPECT_TRUE(material->getCompileVariants(mask).empty());
+        engine->destroy(material);
+    }
+
+    {
+        // a program needed before it is ready is created immediately, the pending one is dropped
+        FMaterial* material = createDefaultMaterial(*engine);
+        material->compile(mask);
+        auto program = material->getProgram(Variant(Variant::SKN));
+        waitForPendingPrograms(material);
+        EXPECT_EQ(program, material->getProgram(Variant(Variant::SKN)));
+        engine->destroy(material);
+    }
+
+    {
+        // editing the material cancels the programs that are being prepared
+        FMaterial* material = createDefaultMaterial(*engine);
+        material->compile(mask);
+        FMaterial::onEditCallback(static_cast<Material*>(material), {},
+                MATERIALS_DEFAULTMATERIAL_DATA, MATERIALS_DEFAULTMATERIAL_SIZE);
+        material->applyPendingEdits();
+        EXPECT_FALSE(material->isCompiling());
+        material->commitPendingPrograms();
+        for (Variant::type_t k = 0; k < VARIANT_COUNT; k++) {
+            EXPECT_FALSE(material->hasCachedProgram(Variant(k)));
+        }
+        engine->destroy(material);
+    }
+
+    {
+        // destroying the material while its programs are being prepared waits for them
+        FMaterial* material = createDefaultMaterial(*engine);
+        material->compile(UserVariantFilterMask(UserVariantFilterBit::ALL));
+        engine->destroy(material);
+        engine->prepare();
+    }
+
+    Engine::destroy((Engine **)&engine);
+}
+
+TEST(FilamentTest, ShadowPassesWithManyLights) {
+    // 4 cascades and as many spot lights as possible, over more renderables than would fit in the command arena
+    // if every shadow map reserved commands for all of them.
+    constexpr size_t CASCADE_COUNT = 4;
+    constexpr size_t SPOT_COUNT = CONFIG_MAX_SHADOW_CASTING_SPOTS;
+    constexpr uint32_t RENDERABLE_COUNT = SPOT_COUNT * 256;
+    static_assert((CASCADE_COUNT + SPOT_COUNT) * (RENDERABLE_COUNT + 1) * sizeof(RenderPass::Command)
+            > CONFIG_PER_FRAME_COMMANDS_SIZE);
+
+    FEngine* engine = FEngine::create(Engine::Backend::NOOP);
+    FMaterial* material = createDefaultMaterial(*engine);
+    FRenderableManager& rcm = engine->getRenderableManager();
+    VertexBuffer* vb = VertexBuffer::Builder()
+            .vertexCount(3)
+            .bufferCount(1)
+            .attribute(VertexAttribute::POSITION, 0, VertexBuffer::AttributeType::FLOAT3)
+            .build(*engine);
+    IndexBuffer* ib = IndexBuffer::Builder()
+            .indexCount(3)
+            .bufferType(IndexBuffer::IndexType::USHORT)
+            .build(*engine);
+    Entity e = engine->getEntityManager().create();
+    RenderableManager::Builder(1)
+            .culling(false)
+            .geometry(0, RenderableManager::PrimitiveType::TRIANGLES, vb, ib)
+            .material(0, material->getDefaultInstance())
+            .build(*engine, e);
+    Slice<FRenderPrimitive> const& primitives = rcm.getRenderPrimitives(rcm.getInstance(e));
+
+    // every renderable is a caster of the directional light and of one of the spot lights
+    FScene::RenderableSoa soa;
+    soa.resize(RENDERABLE_COUNT);
+    for (uint32_t i = 0; i < RENDERABLE_COUNT; i++) {
+        soa.elementAt<FScene::PRIMITIVES>(i) = primitives;
+        soa.elementAt<FScene::VISIBLE_MASK>(i) =
+                VISIBLE_DIR_SHADOW_RENDERABLE | VISIBLE_SPOT_SHADOW_RENDERABLE_N(i % SPOT_COUNT);
+    }
+
+    void* const arenaBegin = malloc(CONFIG_PER_FRAME_COMMANDS_SIZE);
+    void* const arenaEnd = pointermath::add(arenaBegin, CONFIG_PER_FRAME_COMMANDS_SIZE);
+    {
+        RenderPass::Arena arena("Command Arena", { arenaBegin, arenaEnd });
+        RenderPass pass(*engine, arena);
+        pass.setGeometry(soa, { 0, RENDERABLE_COUNT }, {});
+
+        std::vector<FScene::VisibleMaskType> masks(CASCADE_COUNT, VISIBLE_DIR_SHADOW_RENDERABLE);
+        for (size_t i = 0; i < SPOT_COUNT; i++) {
+            masks.push_back(VISIBLE_SPOT_SHADOW_RENDERABLE_N(i));
+        }
+
+        std::vector<RenderPass> passes;
+        passes.reserve(masks.size());
+        for (FScene::VisibleMaskType mask : masks) {
+            RenderPass& entryPass = passes.emplace_back(pass);
+            entryPass.setVisibilityMask(mask);
+            entryPass.reserveCommands(RenderPass::SHADOW);
+        }
+
+        JobSystem& js = engine->getJobSystem();
+        JobSystem::Job* jobCommands = js.createJob();
+        for (RenderPass& entryPass : passes) {
+            js.run(jobs::createJob(js, jobCommands, [&entryPass]() {
+                entryPass.generateReservedCommands();
+            }));
+        }
+        js.runAndWait(jobCommands);
+
+        // each pass has exactly the commands of its own casters
+        for (size_t i = 0; i < passes.size(); i++) {
+            RenderPass const& entryPass = passes[i];
+            const size_t expected = i < CASCADE_COUNT ?
+                    RENDERABLE_COUNT : RENDERABLE_COUNT / SPOT_COUNT;
+            ASSERT_EQ(expected, size_t(entryPass.end() - entryPass.begin()));
+            for (RenderPass::Command const& command : entryPass) {
+                EXPECT_NE(uint64_t(RenderPass::Pass::SENTINEL), command.key);
+                EXPECT_TRUE(soa.elementAt<FScene::VISIBLE_MASK>(command.primitive.index)
+                        & masks[i]);
+            }
+        }
+    }
+    free(arenaBegin);
+
+    engine->destroy(e);
+    engine->destroy(upcast(ib));
+    engine->destroy(upcast(vb));
+    engine->destroy(material);
+    Engine::destroy((Engine **)&engine);
+}
+
+TEST(FilamentTest, MaterialParameterHandles) {
+    using namespace filamat;
+    using Type = MaterialBuilder::UniformType;
+
+    FEngine* engine = FEngine::create(Engine::Backend::NOOP);
+
+    MaterialBuilder::init();
+    Package pkg = MaterialBuilder()
+            .name("handles")
+            .material("void material(inout MaterialInputs material) {\n"
+                      "    prepareMaterial(material);\n"
+                      "    material.baseColor = materialParams.color;\n"
+                      "}\n")
+            .parameter(Type::FLOAT4, "color")
+            .parameter(Type::BOOL, "enabled")
+            .parameter(Type::FLOAT, 4, "weights")
+            .shading(MaterialBuilder::Shading::UNLIT)
+            .build(engine->getJobSystem());
+    MaterialBuilder::shutdown();
+    ASSERT_TRUE(pkg.isValid());
+
+    Material* material = Material::Builder().package(pkg.getData(), pkg.getSize()).build(*engine);
+    ASSERT_NE(nullptr, material);
+
+    // unknown names and types that don't match the parameter give an invalid handle
+    auto color = material->getParameterHandle<float4>("color");
+    auto enabled = material->getParameterHandle<uint32_t>("enabled");
+    auto weights = material->getParameterHandle<float>("weights");
+    EXPECT_TRUE(color.isValid());
+    EXPECT_TRUE(enabled.isValid());
+    EXPECT_TRUE(weights.isValid());
+    EXPECT_FALSE(material->getParameterHandle<float4>("unknown").isValid());
+    EXPECT_FALSE(material->getParameterHandle<float3>("color").isValid());
+    EXPECT_FALSE(material->getParameterHandle<mat4f>("color").isValid());
+    EXPECT_FALSE(material->getParameterHandle<float>("enabled").isValid());
+    EXPECT_FALSE(material->getParameterHandle<uint2>("enabled").isValid());
+    EXPECT_FALSE(material->getParameterHandle<int32_t>("weights").isValid());
+
+    UniformInterfaceBlock const& uib = upcast(material)->getUniformInterfaceBlock();
+    const size_t colorOffset = uib.getUniformOffset("color", 0);
+    const size_t enabledOffset = uib.getUniformOffset("enabled", 0);
+
+    // a handle writes the same data as the name
+    MaterialInstance* byName = material->createInstance();
+    MaterialInstance* byHandle = material->createInstance();
+    byName->setParameter("color", float4{ 1, 2, 3, 4 });
+    byName->setParameter("enabled", true);
+    byHandle->setParameter(color, float4{ 1, 2, 3, 4 });
+    byHandle->setParameter(enabled, 1u);
+    UniformBuffer const& expected = upcast(byName)->getUniformBuffer();
+    UniformBuffer const& actual = upcast(byHandle)->getUniformBuffer();
+    EXPECT_EQ(expected.getUniform<float4>(colorOffset), actual.getUniform<float4>(colorOffset));
+    EXPECT_EQ(expected.getUniform<uint32_t>(enabledOffset),
+            actual.getUniform<uint32_t>(enabledOffset));
+    EXPECT_TRUE(actual.isDirty());
+
+    // arrays are set element by element
+    const float values[] = { 1, 2, 3, 4 };
+    byHandle->setParameter(weights, values, 4);
+    for (size_t i = 0; i < 4; i++) {
+        EXPECT_EQ(values[i], actual.getUniform<float>(uib.getUniformOffset("weights", i)));
+    }
+
+    // setParameters() sets the values of each instance in order
+    MaterialInstance* instances[] = { byName, byHandle };
+    const float4 colors[] = { { 5, 6, 7, 8 }, { 9, 10, 11, 12 } };
+    MaterialInstance::setParameters(instances, 2, &color, 1, colors);
+    for (size_t i = 0; i < 2; i++) {
+        UniformBuffer const& ub = upcast(instances[i])->getUniformBuffer();
+        EXPECT_EQ(colors[i], ub.getUniform<float4>(colorOffset));
+        EXPECT_TRUE(ub.isDirty());
+    }
+
+    engine->destroy(byName);
+    engine->destroy(byHandle);
+    engine->destroy(material);
+    Engine::destroy((Engine **)&engine);
+}
+
+TEST(FilamentTest, PostProcessMaterialReferences) {
+    FEngine* engine = FEngine::create(Engine::Backend::NOOP);
+    PostProcessManager& ppm = engine->getPostProcessManager();
+
+    // a pass can hold a material while it requests another one, e.g. the split EASU pass
+    auto& easu = ppm.getPostProcessMaterial("fsr_easu_mobileF");
+    FMaterial* easuMaterial = easu.getMaterial();
+    auto& blit = ppm.getPostProcessMaterial("blitLow");
+    EXPECT_NE(nullptr, blit.getMaterial());
+    EXPECT_EQ(&easu, &ppm.getPostProcessMaterial("fsr_easu_mobileF"));
+    EXPECT_EQ(easuMaterial, easu.getMaterial());
+
+    // requesting every other material doesn't move the ones already requested
+    const char* names[] = { "bilateralBlur", "bloomDownsample", "colorGrading", "dof", "fxaa",
+            "mipmapDepth", "sao", "separableGaussianBlur1", "taa", "vsmMipmap", "fsr_rcas" };
+    std::vector<std::pair<const char*, void*>> requested;
+    for (const char* name : names) {
+        requested.emplace_back(name, &ppm.getPostProcessMaterial(utils::StaticString::make(name)));
+        for (auto const& [n, material] : requested) {
+            EXPECT_EQ(material, &ppm.getPostProcessMaterial(utils::StaticString::make(n)));
+        }
+    }
+    EXPECT_EQ(&easu, &ppm.getPostProcessMaterial("fsr_easu_mobileF"));
+    EXPECT_EQ(&blit, &ppm.getPostProcessMaterial("blitLow"));
+
+    Engine::destroy((Engine **)&engine);
+}
+
+TEST(FilamentTest, ColorGradingLutCache) {
+    FEngine* engine = FEngine::create(Engine::Backend::NOOP);
+    FColorGrading::LutCache& cache = engine->getColorGradingLutCache();
+    // the default LUT has 32^3 UINT_2_10_10_10_REV texels
+    constexpr size_t lutSize = 32 * 32 * 32 * sizeof(uint32_t);
+
+    GenericToneMapper toneMapper(1.5f);
+    ColorGrading::Builder builder;
+    builder.toneMapper(&toneMapper).saturation(1.2f);
+    engine->destroy(builder.build(*engine));
+    EXPECT_EQ(lutSize, cache.getSizeInBytes());
+
+    // a cache hit returns the same texels as a fresh generation
+    GenericToneMapper sameToneMapper(1.5f);
+    builder.toneMapper(&sameToneMapper);
+    void const* cached = cache.get(builder, lutSize);
+    ASSERT_NE(nullptr, cached);
+    std::unique_ptr<uint8_t[]> lut(new uint8_t[lutSize]);
+    FColorGrading::generateLut(engine->getJobSystem(), builder, lut.get(), true);
+    EXPECT_EQ(0, memcmp(cached, lut.get(), lutSize));
+
+    // a hit doesn't add an entry
+    engine->destroy(builder.build(*engine));
+    EXPECT_EQ(lutSize, cache.getSizeInBytes());
+
+    // a different tone mapper parameter misses
+    GenericToneMapper otherToneMapper(1.5f, 0.18f, 0.2f);
+    builder.toneMapper(&otherToneMapper);
+    EXPECT_EQ(nullptr, cache.get(builder, lutSize));
+    engine->destroy(builder.build(*engine));
+    EXPECT_EQ(2 * lutSize, cache.getSizeInBytes());
+
+    // the least recently used LUTs are evicted to stay within the budget
+    for (float contrast : { 1.1f, 1.2f, 1.3f, 1.4f }) {
+        GenericToneMapper t(contrast);
+        builder.toneMapper(&t);
+        engine->destroy(builder.build(*engine));
+    }
+    EXPECT_EQ(FColorGrading::LutCache::MAX_SIZE_IN_BYTES, cache.getSizeInBytes());
+    builder.toneMapper(&sameToneMapper);
+    EXPECT_EQ(nullptr, cache.get(builder, lutSize));
+
+    // LUTs larger than the budget aren't cached
+    cache.clear();
+    builder.dimensions(64).format(ColorGrading::LutFormat::FLOAT);
+    engine->destroy(builder.build(*engine));
+    EXPECT_EQ(0, cache.getSizeInBytes());
+
+    Engine::destroy((Engine **)&engine);
+}
+
 TEST(FilamentTest, GoogleLineDirective) {
     {
         char s[512] = "#line 10 \"foobar\"";
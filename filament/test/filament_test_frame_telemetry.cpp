@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "FrameTelemetry.h"
+
+#include <utils/sstream.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace filament;
+
+using FrameTelemetry = FrameTelemetryManager::FrameTelemetry;
+
+class FrameTelemetryTest : public ::testing::Test {
+protected:
+    void renderFrame(uint32_t frameId, uint64_t commandBufferSize = 0) {
+        manager.beginFrame(frameId, commandBufferSize);
+        manager.endFrame(frameInfo, commandBufferSize + 256, 1024);
+    }
+
+    // returns the frame ids of the history, most recent first
+    std::vector<uint32_t> getHistory() const {
+        FrameTelemetry frames[8];
+        const size_t count = manager.getHistory(frames, 8);
+        std::vector<uint32_t> ids;
+        for (size_t i = 0; i < count; i++) {
+            ids.push_back(frames[i].frameId);
+        }
+        return ids;
+    }
+
+    static std::vector<std::string> getLines(utils::io::sstream const& stream) {
+        std::vector<std::string> lines;
+        std::string const text = stream.c_str();
+        for (size_t begin = 0, end; (end = text.find('\n', begin)) != std::string::npos;
+                begin = end + 1) {
+            lines.push_back(text.substr(begin, end - begin));
+        }
+        return lines;
+    }
+
+    FrameTelemetryManager manager;
+    FrameInfo frameInfo;
+};
+
+TEST_F(FrameTelemetryTest, Disabled) {
+    renderFrame(1);
+    EXPECT_TRUE(getHistory().empty());
+}
+
+TEST_F(FrameTelemetryTest, HistoryIsNewestFirst) {
+    FrameTelemetryManager::Options options;
+    options.enabled = true;
+    options.historySize = 4;
+    manager.setOptions(options);
+
+    renderFrame(1);
+    renderFrame(2);
+    EXPECT_EQ(std::vector<uint32_t>({ 2, 1 }), getHistory());
+
+    // the history wraps around and only keeps the most recent frames
+    for (uint32_t i = 3; i <= 7; i++) {
+        renderFrame(i);
+    }
+    EXPECT_EQ(std::vector<uint32_t>({ 7, 6, 5, 4 }), getHistory());
+
+    // fewer frames can be copied
+    FrameTelemetry frames[2];
+    ASSERT_EQ(2, manager.getHistory(frames, 2));
+    EXPECT_EQ(7, frames[0].frameId);
+    EXPECT_EQ(6, frames[1].frameId);
+}
+
+TEST_F(FrameTelemetryTest, HistorySizeChangeClearsHistory) {
+    FrameTelemetryManager::Options options;
+    options.enabled = true;
+    options.historySize = 4;
+    manager.setOptions(options);
+    renderFrame(1);
+    renderFrame(2);
+
+    // the history is kept when telemetry is disabled
+    options.enabled = false;
+    manager.setOptions(options);
+    renderFrame(3);
+    EXPECT_EQ(std::vector<uint32_t>({ 2, 1 }), getHistory());
+
+    options.enabled = true;
+    options.historySize = 8;
+    manager.setOptions(options);
+    EXPECT_TRUE(getHistory().empty());
+    renderFrame(4);
+    EXPECT_EQ(std::vector<uint32_t>({ 4 }), getHistory());
+}
+
+TEST_F(FrameTelemetryTest, SkippedFrames) {
+    FrameTelemetryManager::Options options;
+    options.enabled = true;
+    options.historySize = 4;
+    manager.setOptions(options);
+
+    // a skipped frame without endFrame() is committed by the next beginFrame()
+    manager.beginFrame(1, 0);
+    manager.skipFrame();
+    EXPECT_TRUE(getHistory().empty());
+    renderFrame(2);
+
+    FrameTelemetry frames[4];
+    ASSERT_EQ(2, manager.getHistory(frames, 4));
+    EXPECT_EQ(2, frames[0].frameId);
+    EXPECT_FALSE(frames[0].skipped);
+    EXPECT_EQ(256, frames[0].commandBufferSize);
+    EXPECT_EQ(1024, frames[0].commandBufferCapacity);
+    EXPECT_EQ(1, frames[1].frameId);
+    EXPECT_TRUE(frames[1].skipped);
+}
+
+TEST_F(FrameTelemetryTest, CsvSink) {
+    utils::io::sstream stream;
+    FrameTelemetryManager::Options options;
+    options.enabled = true;
+    options.sink = &stream;
+    options.sinkFormat = Renderer::FrameTelemetryFormat::CSV;
+    manager.setOptions(options);
+
+    frameInfo.valid = true;
+    frameInfo.frameTime = FrameInfo::duration(16.5f);
+    renderFrame(1, 1000);
+    renderFrame(2, 2000);
+
+    auto const lines = getLines(stream);
+    ASSERT_EQ(3, lines.size());
+    EXPECT_EQ("frameId,skipped,cpuFrameTime,cpuEnginePrepareTime,cpuScenePrepareTime,"
+              "cpuCullingTime,cpuFroxelizationTime,cpuCommandGenerationTime,"
+              "cpuFrameGraphCompileTime,cpuFrameGraphExecuteTime,gpuFrameTime,"
+              "gpuFrameTimeDenoised,commandBufferSize,commandBufferCapacity", lines[0]);
+    for (size_t i = 1; i < 3; i++) {
+        std::string const& line = lines[i];
+        EXPECT_EQ(std::to_string(i) + ",0,", line.substr(0, 4));
+        EXPECT_EQ(13, std::count(line.begin(), line.end(), ','));
+        EXPECT_NE(std::string::npos, line.find(",16.500000,0.000000,256,1024"));
+    }
+}
+
+TEST_F(FrameTelemetryTest, JsonSink) {
+    utils::io::sstream stream;
+    FrameTelemetryManager::Options options;
+    options.enabled = true;
+    options.sink = &stream;
+    options.sinkFormat = Renderer::FrameTelemetryFormat::JSON;
+    manager.setOptions(options);
+
+    manager.beginFrame(1, 0);
+    manager.skipFrame();
+    renderFrame(2);
+
+    // one object per line, without a header
+    auto const lines = getLines(stream);
+    ASSERT_EQ(2, lines.size());
+    EXPECT_EQ("{\"frameId\":1,\"skipped\":true,", lines[0].substr(0, 28));
+    EXPECT_EQ("{\"frameId\":2,\"skipped\":false,", lines[1].substr(0, 29));
+    for (std::string const& line : lines) {
+        EXPECT_NE(std::string::npos, line.find(",\"cpuFrameTime\":"));
+        EXPECT_NE(std::string::npos, line.find(",\"gpuFrameTimeDenoised\":"));
+        EXPECT_EQ('}', line.back());
+    }
+    EXPECT_NE(std::string::npos,
+            lines[1].find(",\"commandBufferSize\":256,\"commandBufferCapacity\":1024}"));
+}
@@ -27,7 +27,7 @@
 namespace filament {
 
 // update this when a new version of filament wouldn't work with older materials
-static constexpr size_t MATERIAL_VERSION = 18;
+static constexpr size_t MATERIAL_VERSION = 19;
 
 /**
  * Supported shading models
@@ -195,6 +195,22 @@ enum class ReflectionMode : uint8_t {
     SCREEN_SPACE    = 1, //! reflections sample from screen space, and fallback to the scene's IBL
 };
 
+/**
+ * Features that select the variants of a material, see Material::compile()
+ */
+enum class UserVariantFilterBit : uint32_t {
+    DIRECTIONAL_LIGHTING    = 0x01, //!< a directional light is present
+    DYNAMIC_LIGHTING        = 0x02, //!< point, spot or area lights are present
+    SHADOW_RECEIVER         = 0x04, //!< renderables receive shadows
+    SKINNING                = 0x08, //!< renderables use skinning or morphing
+    FOG                     = 0x10, //!< fog is enabled
+    VSM                     = 0x20, //!< variance shadow maps are used
+    ALL                     = 0x3F,
+};
+
+//! bit mask of UserVariantFilterBit
+using UserVariantFilterMask = uint32_t;
+
 // can't really use std::underlying_type<AttributeIndex>::type because the driver takes a uint32_t
 using AttributeBitset = utils::bitset32;
 
@@ -67,6 +67,11 @@ constexpr size_t CONFIG_MAX_SHADOW_CASCADES = 4;
 // We store 64 bytes per bone.
 constexpr size_t CONFIG_MAX_BONE_COUNT = 256;
 
+// The maximum number of instances a single draw call can batch.
+// This value is limited by UBO size, ES3.0 only guarantees 16 KiB.
+// We store 256 bytes per instance.
+constexpr size_t CONFIG_MAX_INSTANCES = 64;
+
 // The maximum number of morph target count.
 // This value is limited by ES3.0, ES3.0 only guarantees 256 layers in an array texture.
 constexpr int CONFIG_MAX_MORPH_TARGET_COUNT = 256;
@@ -152,9 +152,9 @@ struct PerViewUib { // NOLINT(cppcoreguidelines-pro-type-member-init)
 static_assert(sizeof(PerViewUib) == sizeof(math::float4) * 128,
         "PerViewUib should be exactly 2KiB");
 
-// PerRenderableUib must have an alignment of 256 to be compatible with all versions of GLES.
-struct alignas(256) PerRenderableUib { // NOLINT(cppcoreguidelines-pro-type-member-init)
-    static constexpr utils::StaticString _name{ "ObjectUniforms" };
+// PerRenderableData must be 256 bytes to be compatible with all versions of GLES, as it is
+// also used as the bind offset granularity of the per-renderable UBO.
+struct PerRenderableData { // NOLINT(cppcoreguidelines-pro-type-member-init)
     math::mat4f worldFromModelMatrix;
     math::mat3f worldFromModelNormalMatrix;   // this gets expanded to 48 bytes during the copy to the UBO
     alignas(16) uint32_t morphTargetCount;
@@ -164,13 +164,24 @@ struct alignas(256) PerRenderableUib { // NOLINT(cppcoreguidelines-pro-type-memb
     // TODO: We need a better solution, this currently holds the average local scale for the renderable
     float userData;
 
+    // bring PerRenderableData to 256 bytes
+    alignas(16) math::float4 reserved[7];
+
     static uint32_t packFlags(bool skinning, bool morphing, bool contactShadows) noexcept {
         return (skinning ? 1 : 0) |
                (morphing ? 2 : 0) |
                (contactShadows ? 4 : 0);
     }
 };
-static_assert(sizeof(PerRenderableUib) % 256 == 0, "sizeof(Transform) should be a multiple of 256");
+static_assert(sizeof(PerRenderableData) == 256, "sizeof(PerRenderableData) must be 256 bytes");
+
+// The per-renderable UBO is an array of PerRenderableData, indexed by the instance index in the
+// shader. Non-instanced draws bind it with an offset so that their data is at index 0.
+struct PerRenderableUib { // NOLINT(cppcoreguidelines-pro-type-member-init)
+    static constexpr utils::StaticString _name{ "ObjectsUniforms" };
+    PerRenderableData data[CONFIG_MAX_INSTANCES];
+};
+static_assert(sizeof(PerRenderableUib) <= 16384, "PerRenderableUib exceed max UBO size");
 
 struct LightsUib { // NOLINT(cppcoreguidelines-pro-type-member-init)
     static constexpr utils::StaticString _name{ "LightsUniforms" };
@@ -25,6 +25,10 @@
 namespace filaflat {
 
 // Flat list of blobs that can be referenced by index.
+//
+// SPIR-V blobs can also be kept as they are encoded in the material package, which must then
+// outlive the dictionary. Such blobs are decoded by DictionaryReader::decodeSpirv() each time they
+// are needed, see DictionaryReader::unflatten().
 class BlobDictionary {
 public:
     BlobDictionary() = default;
@@ -32,6 +36,13 @@ public:
 
     using Blob = std::vector<uint8_t>;
 
+    struct EncodedBlob {
+        const char* data = nullptr;
+        size_t size = 0;
+        // size of the SMOL-V data once inflated, or 0 if the data is not deflated
+        size_t inflatedSize = 0;
+    };
+
     inline void addBlob(const char* blob, size_t len) noexcept {
         mBlobs.emplace_back(blob, blob + len);
     }
@@ -40,6 +51,27 @@ public:
         mBlobs.push_back(std::move(blob));
     }
 
+    inline void addEncodedBlob(EncodedBlob const& blob) noexcept {
+        mBlobs.emplace_back();
+        mEncodedBlobs.resize(mBlobs.size());
+        mEncodedBlobs.back() = blob;
+    }
+
+    // Returns null if the given blob is not encoded.
+    inline EncodedBlob const* getEncodedBlob(size_t index) const noexcept {
+        return index < mEncodedBlobs.size() && mEncodedBlobs[index].data ?
+                &mEncodedBlobs[index] : nullptr;
+    }
+
+    // The preset dictionary of the deflated blobs.
+    inline void setDeflateDictionary(const char* data, size_t size) noexcept {
+        mDeflateDictionary = { data, size };
+    }
+
+    inline EncodedBlob const& getDeflateDictionary() const noexcept {
+        return mDeflateDictionary;
+    }
+
     inline bool isEmpty() const noexcept {
         return mBlobs.empty();
     }
@@ -63,6 +95,8 @@ public:
 
 private:
     std::vector<Blob> mBlobs;
+    std::vector<EncodedBlob> mEncodedBlobs;
+    EncodedBlob mDeflateDictionary;
 };
 
 } // namespace filaflat
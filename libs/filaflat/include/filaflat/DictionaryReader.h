@@ -17,16 +17,21 @@
 #ifndef TNT_FILAFLAT_DICTIONARY_READER_H
 #define TNT_FILAFLAT_DICTIONARY_READER_H
 
+#include <filaflat/BlobDictionary.h>
 #include <filaflat/ChunkContainer.h>
 
 namespace filaflat {
 
-class BlobDictionary;
-
 struct DictionaryReader {
+    // When decodeSpirv is false, the blobs of a SPIR-V dictionary are kept encoded in the
+    // container and decodeSpirv() must be used to read them.
     static bool unflatten(ChunkContainer const& container,
             ChunkContainer::Type dictionaryTag,
-            BlobDictionary& dictionary);
+            BlobDictionary& dictionary, bool decodeSpirv = true);
+
+    // Decodes a SPIR-V blob that unflatten() kept encoded. This is thread safe.
+    static bool decodeSpirv(BlobDictionary const& dictionary,
+            BlobDictionary::EncodedBlob const& blob, BlobDictionary::Blob& spirv);
 };
 
 } // namespace filaflat
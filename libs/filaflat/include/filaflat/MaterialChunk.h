@@ -45,6 +45,9 @@ public:
             BlobDictionary const& dictionary,
             uint8_t shaderModel, filament::Variant variant, uint8_t stage);
 
+    // returns whether the given shader is present, without reading it. Thread safe.
+    bool hasShader(uint8_t shaderModel, filament::Variant variant, uint8_t stage) const noexcept;
+
 private:
     ChunkContainer const& mContainer;
     filamat::ChunkType mMaterialTag = filamat::ChunkType::Unknown;
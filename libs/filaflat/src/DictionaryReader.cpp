@@ -22,6 +22,7 @@
 #if defined (FILAMENT_DRIVER_SUPPORTS_VULKAN)
 #include <utils/Log.h>
 #include <smolv.h>
+#include <zlib.h>
 #endif
 
 #include <assert.h>
@@ -30,9 +31,61 @@ using namespace filamat;
 
 namespace filaflat {
 
+// The compression schemes of SPIR-V dictionaries.
+static constexpr uint32_t SPIRV_SMOLV = 1;          // SMOL-V
+static constexpr uint32_t SPIRV_SMOLV_DEFLATE = 2;  // SMOL-V, then deflate with a preset dictionary
+
+#if defined (FILAMENT_DRIVER_SUPPORTS_VULKAN)
+static bool inflateBlob(BlobDictionary::EncodedBlob const& dictionary,
+        BlobDictionary::EncodedBlob const& blob, std::vector<uint8_t>& inflated) {
+    inflated.resize(blob.inflatedSize);
+    z_stream stream = {};
+    if (inflateInit2(&stream, -MAX_WBITS) != Z_OK) {
+        return false;
+    }
+    bool success = inflateSetDictionary(&stream,
+            (const Bytef*) dictionary.data, uInt(dictionary.size)) == Z_OK;
+    if (success) {
+        stream.next_in = (Bytef*) blob.data;
+        stream.avail_in = uInt(blob.size);
+        stream.next_out = inflated.data();
+        stream.avail_out = uInt(inflated.size());
+        success = inflate(&stream, Z_FINISH) == Z_STREAM_END && stream.avail_out == 0;
+    }
+    inflateEnd(&stream);
+    return success;
+}
+#endif
+
+bool DictionaryReader::decodeSpirv(BlobDictionary const& dictionary,
+        BlobDictionary::EncodedBlob const& blob, BlobDictionary::Blob& spirv) {
+#if defined (FILAMENT_DRIVER_SUPPORTS_VULKAN)
+    const char* smolvData = blob.data;
+    size_t smolvSize = blob.size;
+    std::vector<uint8_t> inflated;
+    if (blob.inflatedSize) {
+        if (!inflateBlob(dictionary.getDeflateDictionary(), blob, inflated)) {
+            utils::slog.e << "Unable to inflate SPIR-V" << utils::io::endl;
+            return false;
+        }
+        smolvData = (const char*) inflated.data();
+        smolvSize = inflated.size();
+    }
+
+    size_t spirvSize = smolv::GetDecodedBufferSize(smolvData, smolvSize);
+    if (spirvSize == 0) {
+        return false;
+    }
+    spirv.resize(spirvSize);
+    return smolv::Decode(smolvData, smolvSize, spirv.data(), spirvSize);
+#else
+    return false;
+#endif
+}
+
 bool DictionaryReader::unflatten(ChunkContainer const& container,
         ChunkContainer::Type dictionaryTag,
-        BlobDictionary& dictionary) {
+        BlobDictionary& dictionary, bool decodeSpirv) {
 
     Unflattener unflattener(
             container.getChunkStart(dictionaryTag),
@@ -43,37 +96,48 @@ bool DictionaryReader::unflatten(ChunkContainer const& container,
         if (!unflattener.read(&compressionScheme)) {
             return false;
         }
-        // For now, 1 is the only acceptable compression scheme.
-        assert(compressionScheme == 1);
-
+        if (compressionScheme != SPIRV_SMOLV && compressionScheme != SPIRV_SMOLV_DEFLATE) {
+            return false;
+        }
 
         uint32_t blobCount;
         if (!unflattener.read(&blobCount)) {
             return false;
         }
 
+        if (compressionScheme == SPIRV_SMOLV_DEFLATE) {
+            const char* data;
+            size_t size;
+            if (!unflattener.read(&data, &size)) {
+                return false;
+            }
+            dictionary.setDeflateDictionary(data, size);
+        }
+
         dictionary.reserve(blobCount);
         for (uint32_t i = 0; i < blobCount; i++) {
-            const char* compressed;
-            size_t compressedSize;
-            if (!unflattener.read(&compressed, &compressedSize)) {
+            BlobDictionary::EncodedBlob blob;
+            if (compressionScheme == SPIRV_SMOLV_DEFLATE) {
+                uint32_t inflatedSize;
+                if (!unflattener.read(&inflatedSize) || inflatedSize == 0) {
+                    return false;
+                }
+                blob.inflatedSize = inflatedSize;
+            }
+            if (!unflattener.read(&blob.data, &blob.size)) {
                 return false;
             }
 
-#if defined (FILAMENT_DRIVER_SUPPORTS_VULKAN)
-            size_t spirvSize = smolv::GetDecodedBufferSize(compressed, compressedSize);
-            if (spirvSize == 0) {
-                return false;
+            if (!decodeSpirv) {
+                dictionary.addEncodedBlob(blob);
+                continue;
             }
-            BlobDictionary::Blob spirv(spirvSize);
-            if (!smolv::Decode(compressed, compressedSize, spirv.data(), spirvSize)) {
+
+            BlobDictionary::Blob spirv;
+            if (!DictionaryReader::decodeSpirv(dictionary, blob, spirv)) {
                 return false;
             }
             dictionary.addBlob(std::move(spirv));
-#else
-            return false;
-#endif
-
         }
         return true;
     } else if (dictionaryTag == ChunkType::DictionaryText) {
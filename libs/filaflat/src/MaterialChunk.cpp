@@ -17,6 +17,7 @@
 #include <filaflat/MaterialChunk.h>
 #include <filaflat/BlobDictionary.h>
 #include <filaflat/ChunkContainer.h>
+#include <filaflat/DictionaryReader.h>
 #include <filaflat/ShaderBuilder.h>
 
 #include <utils/Log.h>
@@ -153,8 +154,22 @@ bool MaterialChunk::getSpirvShader(BlobDictionary const& dictionary,
     }
 
     size_t index = pos->second;
+    if (index >= dictionary.size()) {
+        return false;
+    }
+
+    BlobDictionary::Blob spirv;
     size_t shaderSize;
-    const char* shaderContent = dictionary.getBlob(index, &shaderSize);
+    const char* shaderContent;
+    if (auto encoded = dictionary.getEncodedBlob(index)) {
+        if (!DictionaryReader::decodeSpirv(dictionary, *encoded, spirv)) {
+            return false;
+        }
+        shaderSize = spirv.size();
+        shaderContent = (const char*) spirv.data();
+    } else {
+        shaderContent = dictionary.getBlob(index, &shaderSize);
+    }
 
     shaderBuilder.reset();
     shaderBuilder.announce(shaderSize);
@@ -162,6 +177,19 @@ bool MaterialChunk::getSpirvShader(BlobDictionary const& dictionary,
     return true;
 }
 
+bool MaterialChunk::hasShader(uint8_t shaderModel, filament::Variant variant,
+        uint8_t stage) const noexcept {
+    if (mBase == nullptr) {
+        return false;
+    }
+    auto pos = mOffsets.find(makeKey(shaderModel, variant, stage));
+    if (pos == mOffsets.end()) {
+        return false;
+    }
+    // text shaders use an offset of 0 for missing shaders, SPIR-V shaders store a blob index
+    return mMaterialTag == filamat::ChunkType::MaterialSpirv || pos->second != 0;
+}
+
 bool MaterialChunk::getShader(ShaderBuilder& shaderBuilder,
         BlobDictionary const& dictionary, uint8_t shaderModel, filament::Variant variant, uint8_t stage) {
     switch (mMaterialTag) {
@@ -27,6 +27,7 @@
 #include <vector>
 
 #include <backend/DriverEnums.h>
+#include <backend/Platform.h>
 #include <backend/TargetBufferInfo.h>
 #include <filament/MaterialEnums.h>
 
@@ -104,6 +105,8 @@ protected:
     Optimization mOptimization = Optimization::PERFORMANCE;
     bool mPrintShaders = false;
     bool mGenerateDebugInfo = false;
+    bool mCompressSpirv = false;
+    filament::backend::Platform::BlobCache* mShaderCache = nullptr;
     utils::bitset32 mShaderModels;
     struct CodeGenParams {
         int shaderModel;
@@ -517,6 +520,22 @@ public:
     //! If true, will include debugging information in generated SPIRV.
     MaterialBuilder& generateDebugInfo(bool generateDebugInfo) noexcept;
 
+    /**
+     * If true, SPIRV shaders are further compressed with deflate and a dictionary shared by all the
+     * shaders of the material. This makes packages smaller at the cost of some decoding time when
+     * the shaders are first used. False by default. Ignored when linking against filamat_lite.
+     */
+    MaterialBuilder& compressSpirv(bool compressSpirv) noexcept;
+
+    /**
+     * Sets a cache for the compiled shaders, none by default. Variants that generate identical
+     * code are always compiled once per build(); with a persistent cache, such as
+     * backend::FileBlobCache, compiled shaders are also reused across builds and processes.
+     * The cache must be thread safe and must outlive the calls to build().
+     * Ignored when linking against filamat_lite.
+     */
+    MaterialBuilder& shaderCache(filament::backend::Platform::BlobCache* cache) noexcept;
+
     //! Specifies a list of variants that should be filtered out during code generation.
     MaterialBuilder& variantFilter(uint8_t variantFilter) noexcept;
 
@@ -407,6 +407,8 @@ void GLSLPostProcessor::fullOptimization(const TShader& tShader,
                 CompilerGLSL::Options::Precision::Mediump : CompilerGLSL::Options::Precision::Highp;
         glslOptions.fragment.default_int_precision = glslOptions.es ?
                 CompilerGLSL::Options::Precision::Mediump : CompilerGLSL::Options::Precision::Highp;
+        // the OpenGL backend never draws with a base instance
+        glslOptions.vertex.support_nonzero_base_instance = false;
 
         CompilerGLSL glslCompiler(move(spirv));
         glslCompiler.set_common_options(glslOptions);
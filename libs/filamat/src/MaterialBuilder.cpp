@@ -17,14 +17,18 @@
 #include "filamat/MaterialBuilder.h"
 
 #include <atomic>
+#include <string_view>
 #include <utility>
 #include <vector>
 
+#include <utils/Hash.h>
 #include <utils/JobSystem.h>
 #include <utils/Log.h>
 #include <utils/Mutex.h>
 #include <utils/Panic.h>
 
+#include <tsl/robin_map.h>
+
 #include <private/filament/UniformInterfaceBlock.h>
 #include <private/filament/SamplerInterfaceBlock.h>
 
@@ -404,6 +408,17 @@ MaterialBuilder& MaterialBuilder::generateDebugInfo(bool generateDebugInfo) noex
     return *this;
 }
 
+MaterialBuilder& MaterialBuilder::compressSpirv(bool compressSpirv) noexcept {
+    mCompressSpirv = compressSpirv;
+    return *this;
+}
+
+MaterialBuilder& MaterialBuilder::shaderCache(
+        filament::backend::Platform::BlobCache* cache) noexcept {
+    mShaderCache = cache;
+    return *this;
+}
+
 MaterialBuilder& MaterialBuilder::variantFilter(uint8_t variantFilter) noexcept {
     mVariantFilter = variantFilter;
     return *this;
@@ -620,6 +635,134 @@ static void showErrorMessage(const char* materialName, filament::Variant variant
             << shaderCode;
 }
 
+// Identifies the code generated for a variant, the code is owned by generateShaders().
+struct ShaderKey {
+    filament::backend::ShaderType stage;
+    std::string_view source;
+    bool operator==(ShaderKey const& rhs) const noexcept {
+        return stage == rhs.stage && source == rhs.source;
+    }
+    struct Hash {
+        size_t operator()(ShaderKey const& key) const noexcept {
+            return std::hash<std::string_view>{}(key.source) ^ size_t(key.stage);
+        }
+    };
+};
+
+#ifndef FILAMAT_LITE
+
+// Must be incremented whenever the output of GLSLPostProcessor changes for a given input, e.g. when
+// glslang or spirv-tools are updated, so that stale shaders are not retrieved from the cache.
+static constexpr uint32_t SHADER_CACHE_VERSION = 1;
+
+// The key of a compiled shader in MaterialBuilder's shader cache. All the fields, including the
+// padding, are initialized so that the key can be hashed and compared as raw bytes.
+struct ShaderCacheKey {
+    char tag[8];
+    uint32_t materialVersion;
+    uint32_t cacheVersion;
+    uint8_t targetApi;
+    uint8_t targetLanguage;
+    uint8_t shaderModel;
+    uint8_t stage;
+    uint8_t optimization;
+    uint8_t domain;
+    uint8_t hasFramebufferFetch;
+    uint8_t padding;
+    uint32_t flags;
+    uint32_t reserved;
+    uint64_t samplerHash;
+    uint64_t sourceSize;
+    uint64_t sourceHash;
+};
+
+static ShaderCacheKey getShaderCacheKey(MaterialBuilder::TargetApi targetApi,
+        MaterialBuilder::TargetLanguage targetLanguage, MaterialBuilder::Optimization optimization,
+        uint32_t flags, GLSLPostProcessor::Config const& config, std::string const& source) {
+    ShaderCacheKey key = {};
+    memcpy(key.tag, "filamat", sizeof(key.tag));
+    key.materialVersion = filament::MATERIAL_VERSION;
+    key.cacheVersion = SHADER_CACHE_VERSION;
+    key.targetApi = uint8_t(targetApi);
+    key.targetLanguage = uint8_t(targetLanguage);
+    key.shaderModel = uint8_t(config.shaderModel);
+    key.stage = uint8_t(config.shaderType);
+    key.optimization = uint8_t(optimization);
+    key.domain = uint8_t(config.domain);
+    key.hasFramebufferFetch = config.hasFramebufferFetch;
+    key.flags = flags;
+
+    // The binding of the material's samplers is derived from its sampler interface block, not
+    // from the source code.
+    filament::SamplerInterfaceBlock const& sib = config.materialInfo->sib;
+    const filament::backend::ShaderStageFlags stageFlags = sib.getStageFlags();
+    const uint8_t stages = uint8_t(stageFlags.vertex) | uint8_t(stageFlags.fragment) << 1u;
+    uint64_t samplerHash = hash::fnv1a(&stages, sizeof(stages));
+    samplerHash = hash::fnv1a(sib.getName().c_str_safe(), sib.getName().size(), samplerHash);
+    for (auto const& sampler : sib.getSamplerInfoList()) {
+        const uint8_t type = uint8_t(sampler.type);
+        samplerHash = hash::fnv1a(&type, sizeof(type), samplerHash);
+        samplerHash = hash::fnv1a(sampler.name.c_str_safe(), sampler.name.size() + 1, samplerHash);
+    }
+    key.samplerHash = samplerHash;
+
+    key.sourceSize = source.size();
+    key.sourceHash = hash::fnv1a(source.data(), source.size());
+    return key;
+}
+
+// Only the output needed by the target API is stored in the cache.
+static bool retrieveCompiledShader(filament::backend::Platform::BlobCache* cache,
+        ShaderCacheKey const& key, MaterialBuilder::TargetApi targetApi, std::string* glsl,
+        std::vector<uint32_t>* spirv, std::string* msl) {
+    if (!cache) {
+        return false;
+    }
+    const size_t size = cache->retrieve(&key, sizeof(key), nullptr, 0);
+    if (size == 0) {
+        return false;
+    }
+    switch (targetApi) {
+        case MaterialBuilder::TargetApi::OPENGL:
+            glsl->resize(size);
+            return cache->retrieve(&key, sizeof(key), glsl->data(), size) == size;
+        case MaterialBuilder::TargetApi::VULKAN:
+            if (size % sizeof(uint32_t)) {
+                return false;
+            }
+            spirv->resize(size / sizeof(uint32_t));
+            return cache->retrieve(&key, sizeof(key), spirv->data(), size) == size;
+        case MaterialBuilder::TargetApi::METAL:
+            msl->resize(size);
+            return cache->retrieve(&key, sizeof(key), msl->data(), size) == size;
+        default:
+            return false;
+    }
+}
+
+static void insertCompiledShader(filament::backend::Platform::BlobCache* cache,
+        ShaderCacheKey const& key, MaterialBuilder::TargetApi targetApi, std::string const& glsl,
+        std::vector<uint32_t> const& spirv, std::string const& msl) {
+    if (!cache) {
+        return;
+    }
+    switch (targetApi) {
+        case MaterialBuilder::TargetApi::OPENGL:
+            cache->insert(&key, sizeof(key), glsl.data(), glsl.size());
+            break;
+        case MaterialBuilder::TargetApi::VULKAN:
+            cache->insert(&key, sizeof(key), spirv.data(), spirv.size() * sizeof(uint32_t));
+            break;
+        case MaterialBuilder::TargetApi::METAL:
+            cache->insert(&key, sizeof(key), msl.data(), msl.size());
+            break;
+        default:
+            break;
+    }
+}
+
+#endif
+
 bool MaterialBuilder::generateShaders(JobSystem& jobSystem, const std::vector<Variant>& variants,
         ChunkContainer& container, const MaterialInfo& info) const noexcept {
     // Create a postprocessor to optimize / compile to Spir-V if necessary.
@@ -630,8 +773,6 @@ bool MaterialBuilder::generateShaders(JobSystem& jobSystem, const std::vector<Va
     GLSLPostProcessor postProcessor(mOptimization, flags);
 #endif
 
-    // Start: must be protected by lock
-    Mutex entriesLock;
     std::vector<TextEntry> glslEntries;
     std::vector<SpirvEntry> spirvEntries;
     std::vector<TextEntry> metalEntries;
@@ -639,7 +780,6 @@ bool MaterialBuilder::generateShaders(JobSystem& jobSystem, const std::vector<Va
 #ifndef FILAMAT_LITE
     BlobDictionary spirvDictionary;
 #endif
-    // End: must be protected by lock
 
     ShaderGenerator sg(
             mProperties, mVariables, mOutputs, mDefines, mMaterialFragmentCode.getResolved(),
@@ -668,61 +808,63 @@ bool MaterialBuilder::generateShaders(JobSystem& jobSystem, const std::vector<Va
         const bool targetApiNeedsMsl = targetApi == TargetApi::METAL;
         const bool targetApiNeedsGlsl = targetApi == TargetApi::OPENGL;
 
-        // Set when a job fails
+        // Generate the raw shader code of every variant.
+        // The quotes in Google-style line directives cause problems with certain drivers. These
+        // directives are optimized away when using the full filamat, so down below we
+        // explicitly remove them when using filamat lite.
+        std::vector<std::string> shaders(variants.size());
         JobSystem::Job* parent = jobSystem.createJob();
-
-        for (const auto& v : variants) {
-            JobSystem::Job* job = jobs::createJob(jobSystem, parent, [&]() {
-                if (cancelJobs.load()) {
-                    return;
-                }
-
-                // TODO: avoid allocations when not required
-                std::vector<uint32_t> spirv;
-                std::string msl;
-
-                std::vector<uint32_t>* pSpirv = targetApiNeedsSpirv ? &spirv : nullptr;
-                std::string* pMsl = targetApiNeedsMsl ? &msl : nullptr;
-
-                TextEntry glslEntry{0};
-                SpirvEntry spirvEntry{0};
-                TextEntry metalEntry{0};
-
-                glslEntry.shaderModel = static_cast<uint8_t>(params.shaderModel);
-                spirvEntry.shaderModel = static_cast<uint8_t>(params.shaderModel);
-                metalEntry.shaderModel = static_cast<uint8_t>(params.shaderModel);
-
-                glslEntry.variantKey  = v.variant.key;
-                spirvEntry.variantKey = v.variant.key;
-                metalEntry.variantKey = v.variant.key;
-
-                // Generate raw shader code.
-                // The quotes in Google-style line directives cause problems with certain drivers. These
-                // directives are optimized away when using the full filamat, so down below we
-                // explicitly remove them when using filamat lite.
-                std::string shader;
+        for (size_t i = 0; i < variants.size(); i++) {
+            jobSystem.run(jobs::createJob(jobSystem, parent, [&, i]() {
+                const auto& v = variants[i];
+                std::string& shader = shaders[i];
                 if (v.stage == filament::backend::ShaderType::VERTEX) {
                     shader = sg.createVertexProgram(
                             shaderModel, targetApi, targetLanguage, info, v.variant,
                             mInterpolation, mVertexDomain);
-#ifdef FILAMAT_LITE
-                    GLSLToolsLite glslTools;
-                    glslTools.removeGoogleLineDirectives(shader);
-#endif
                 } else if (v.stage == filament::backend::ShaderType::FRAGMENT) {
                     shader = sg.createFragmentProgram(
                             shaderModel, targetApi, targetLanguage, info, v.variant, mInterpolation);
+                }
 #ifdef FILAMAT_LITE
-                    GLSLToolsLite glslTools;
-                    glslTools.removeGoogleLineDirectives(shader);
+                GLSLToolsLite glslTools;
+                glslTools.removeGoogleLineDirectives(shader);
 #endif
-                }
+            }));
+        }
+        jobSystem.runAndWait(parent);
 
-                std::string* pGlsl = nullptr;
-                if (targetApiNeedsGlsl) {
-                    pGlsl = &shader;
+        // Many variants generate the same code, each unique shader is only compiled once.
+        struct CompiledShader {
+            size_t variantIndex; // the first variant that generates this shader
+            size_t lastVariantIndex = 0; // the last one, which can take the compiled code
+            std::string glsl;
+            std::vector<uint32_t> spirv;
+            std::string msl;
+        };
+        std::vector<CompiledShader> compiledShaders;
+        std::vector<size_t> compiledShaderIndices(variants.size());
+        tsl::robin_map<ShaderKey, size_t, ShaderKey::Hash> uniqueShaders;
+        for (size_t i = 0; i < variants.size(); i++) {
+            auto [iter, inserted] = uniqueShaders.try_emplace(
+                    ShaderKey{ variants[i].stage, shaders[i] }, compiledShaders.size());
+            if (inserted) {
+                compiledShaders.push_back({ i });
+            }
+            compiledShaderIndices[i] = iter->second;
+            compiledShaders[iter->second].lastVariantIndex = i;
+        }
+
+        parent = jobSystem.createJob();
+        for (CompiledShader& compiled : compiledShaders) {
+            JobSystem::Job* job = jobs::createJob(jobSystem, parent, [&]() {
+                if (cancelJobs.load()) {
+                    return;
                 }
 
+                const auto& v = variants[compiled.variantIndex];
+                std::string const& shader = shaders[compiled.variantIndex];
+
 #ifndef FILAMAT_LITE
                 GLSLPostProcessor::Config config{
                         .shaderType = v.stage,
@@ -738,8 +880,20 @@ bool MaterialBuilder::generateShaders(JobSystem& jobSystem, const std::vector<Va
                     config.glsl.subpassInputToColorLocation.emplace_back(0, 0);
                 }
 
+                const ShaderCacheKey cacheKey = getShaderCacheKey(targetApi, targetLanguage,
+                        mOptimization, flags, config, shader);
+                if (retrieveCompiledShader(mShaderCache, cacheKey, targetApi, &compiled.glsl,
+                        &compiled.spirv, &compiled.msl)) {
+                    return;
+                }
+
+                compiled.glsl = shader;
+                std::string* pGlsl = targetApiNeedsGlsl ? &compiled.glsl : nullptr;
+                std::vector<uint32_t>* pSpirv = targetApiNeedsSpirv ? &compiled.spirv : nullptr;
+                std::string* pMsl = targetApiNeedsMsl ? &compiled.msl : nullptr;
                 bool ok = postProcessor.process(shader, config, pGlsl, pSpirv, pMsl);
 #else
+                compiled.glsl = shader;
                 bool ok = true;
 #endif
                 if (!ok) {
@@ -750,38 +904,13 @@ bool MaterialBuilder::generateShaders(JobSystem& jobSystem, const std::vector<Va
 
                 if (targetApi == TargetApi::OPENGL) {
                     if (targetLanguage == TargetLanguage::SPIRV) {
-                        ShaderGenerator::fixupExternalSamplers(shaderModel, shader, info);
+                        ShaderGenerator::fixupExternalSamplers(shaderModel, compiled.glsl, info);
                     }
                 }
 
-                // NOTE: Everything below touches shared structures protected by a lock
-                // NOTE: do not execute expensive work from here on!
-                std::unique_lock<utils::Mutex> lock(entriesLock);
-
-                if (targetApi == TargetApi::OPENGL) {
-                    glslEntry.stage = v.stage;
-                    glslEntry.shader = shader;
-
-                    glslEntries.push_back(glslEntry);
-                }
-
 #ifndef FILAMAT_LITE
-                if (targetApi == TargetApi::VULKAN) {
-                    assert(!spirv.empty());
-                    spirvEntry.stage = v.stage;
-                    spirvEntry.spirv = std::move(spirv);
-
-                    spirvEntries.push_back(spirvEntry);
-                }
-
-                if (targetApi == TargetApi::METAL) {
-                    assert(!spirv.empty());
-                    assert(msl.length() > 0);
-                    metalEntry.stage = v.stage;
-                    metalEntry.shader = msl;
-
-                    metalEntries.push_back(metalEntry);
-                }
+                insertCompiledShader(mShaderCache, cacheKey, targetApi, compiled.glsl,
+                        compiled.spirv, compiled.msl);
 #endif
             });
 
@@ -797,6 +926,46 @@ bool MaterialBuilder::generateShaders(JobSystem& jobSystem, const std::vector<Va
         }
 
         jobSystem.runAndWait(parent);
+
+        if (cancelJobs.load()) {
+            return false;
+        }
+
+        // Finally, add an entry for every variant. The code is copied into the entries of all the
+        // variants that share it but the last, which takes it.
+        for (size_t i = 0; i < variants.size(); i++) {
+            const auto& v = variants[i];
+            CompiledShader& compiled = compiledShaders[compiledShaderIndices[i]];
+            const bool lastUse = compiled.lastVariantIndex == i;
+
+            if (targetApi == TargetApi::OPENGL) {
+                TextEntry& glslEntry = glslEntries.emplace_back();
+                glslEntry.shaderModel = static_cast<uint8_t>(params.shaderModel);
+                glslEntry.variantKey = v.variant.key;
+                glslEntry.stage = v.stage;
+                glslEntry.shader = lastUse ? std::move(compiled.glsl) : compiled.glsl;
+            }
+
+#ifndef FILAMAT_LITE
+            if (targetApi == TargetApi::VULKAN) {
+                assert(!compiled.spirv.empty());
+                SpirvEntry& spirvEntry = spirvEntries.emplace_back();
+                spirvEntry.shaderModel = static_cast<uint8_t>(params.shaderModel);
+                spirvEntry.variantKey = v.variant.key;
+                spirvEntry.stage = v.stage;
+                spirvEntry.spirv = lastUse ? std::move(compiled.spirv) : compiled.spirv;
+            }
+
+            if (targetApi == TargetApi::METAL) {
+                assert(compiled.msl.length() > 0);
+                TextEntry& metalEntry = metalEntries.emplace_back();
+                metalEntry.shaderModel = static_cast<uint8_t>(params.shaderModel);
+                metalEntry.variantKey = v.variant.key;
+                metalEntry.stage = v.stage;
+                metalEntry.shader = lastUse ? std::move(compiled.msl) : compiled.msl;
+            }
+#endif
+        }
     }
 
     if (cancelJobs.load()) {
@@ -816,18 +985,27 @@ bool MaterialBuilder::generateShaders(JobSystem& jobSystem, const std::vector<Va
     std::sort(metalEntries.begin(), metalEntries.end(), compare);
 
     // Generate the dictionaries.
+    std::vector<std::string_view> texts;
+    texts.reserve(glslEntries.size() + metalEntries.size());
     for (const auto& s : glslEntries) {
-        textDictionary.addText(s.shader);
+        texts.emplace_back(s.shader);
+    }
+    for (const auto& s : metalEntries) {
+        texts.emplace_back(s.shader);
     }
+    textDictionary.addTexts(jobSystem, texts);
 #ifndef FILAMAT_LITE
-    for (auto& s : spirvEntries) {
-        std::vector<uint32_t> spirv = std::move(s.spirv);
-        s.dictionaryIndex = spirvDictionary.addBlob(spirv);
+    std::vector<std::string_view> blobs;
+    blobs.reserve(spirvEntries.size());
+    for (const auto& s : spirvEntries) {
+        blobs.emplace_back((const char*) s.spirv.data(), s.spirv.size() * sizeof(uint32_t));
     }
-#endif
-    for (const auto& s : metalEntries) {
-        textDictionary.addText(s.shader);
+    std::vector<size_t> blobIndices = spirvDictionary.addBlobs(jobSystem, blobs);
+    for (size_t i = 0; i < spirvEntries.size(); i++) {
+        spirvEntries[i].dictionaryIndex = blobIndices[i];
+        spirvEntries[i].spirv = {};
     }
+#endif
 
     // Emit dictionary chunk (TextDictionaryReader and DictionaryTextChunk)
     const auto& dictionaryChunk = container.addChild<filamat::DictionaryTextChunk>(
@@ -843,7 +1021,8 @@ bool MaterialBuilder::generateShaders(JobSystem& jobSystem, const std::vector<Va
 #ifndef FILAMAT_LITE
     if (!spirvEntries.empty()) {
         const bool stripInfo = !mGenerateDebugInfo;
-        container.addChild<filamat::DictionarySpirvChunk>(std::move(spirvDictionary), stripInfo);
+        container.addChild<filamat::DictionarySpirvChunk>(std::move(spirvDictionary), stripInfo,
+                mCompressSpirv);
         container.addChild<MaterialSpirvChunk>(std::move(spirvEntries));
     }
 
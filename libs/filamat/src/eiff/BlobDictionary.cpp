@@ -16,12 +16,30 @@
 
 #include "BlobDictionary.h"
 
+#include "UniqueStrings.h"
+
+#include <utils/JobSystem.h>
+
 #include <assert.h>
 
 namespace filamat {
 
 size_t BlobDictionary::addBlob(const std::vector<uint32_t>& vblob) noexcept {
-    std::string blob((char*) vblob.data(), vblob.size() * 4);
+    return addBlob(std::string_view((const char*) vblob.data(), vblob.size() * 4));
+}
+
+std::vector<size_t> BlobDictionary::addBlobs(utils::JobSystem& js,
+        std::vector<std::string_view> const& blobs) noexcept {
+    std::vector<uint32_t> first = findFirstOccurrences(js, blobs);
+    std::vector<size_t> indices(blobs.size());
+    for (size_t i = 0; i < blobs.size(); i++) {
+        indices[i] = first[i] == i ? addBlob(blobs[i]) : indices[first[i]];
+    }
+    return indices;
+}
+
+size_t BlobDictionary::addBlob(std::string_view vblob) noexcept {
+    std::string blob(vblob);
     auto iter = mBlobIndices.find(blob);
     if (iter != mBlobIndices.end()) {
         return iter->second;
@@ -19,9 +19,14 @@
 
 #include <cassert>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
+namespace utils {
+class JobSystem;
+}
+
 namespace filamat {
 
 // Establish a blob <-> id mapping. Note that std::string may binary data with null characters.
@@ -35,6 +40,11 @@ public:
     // Adds a blob if it's not already a duplicate and returns its index.
     size_t addBlob(const std::vector<uint32_t>& blob) noexcept;
 
+    // Adds several blobs, which are deduplicated concurrently, and returns the index of each blob.
+    // The result is the same as calling addBlob() for each blob in order.
+    std::vector<size_t> addBlobs(utils::JobSystem& js,
+            std::vector<std::string_view> const& blobs) noexcept;
+
     size_t getBlobCount() const noexcept {
         return mBlobs.size();
     }
@@ -54,6 +64,8 @@ public:
     }
 
 private:
+    size_t addBlob(std::string_view blob) noexcept;
+
     std::unordered_map<std::string, size_t> mBlobIndices;
     std::vector<std::string> mBlobs;
     size_t mStorageSize;
@@ -16,33 +16,145 @@
 
 #include "DictionarySpirvChunk.h"
 
+#include <utils/Log.h>
+
+#include <tsl/robin_map.h>
+
 #include <smolv.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <string_view>
 
 namespace filamat {
 
-DictionarySpirvChunk::DictionarySpirvChunk(BlobDictionary&& dictionary, bool stripDebugInfo) :
-        Chunk(ChunkType::DictionarySpirv), mDictionary(dictionary), mStripDebugInfo(stripDebugInfo) {
+// The compression schemes of SPIR-V dictionaries, see filaflat's DictionaryReader.
+static constexpr uint32_t SPIRV_SMOLV = 1;
+static constexpr uint32_t SPIRV_SMOLV_DEFLATE = 2;
+
+// The preset dictionary is made of segments of this many bytes, sampled every SEGMENT_STEP bytes.
+static constexpr size_t SEGMENT_SIZE = 32;
+static constexpr size_t SEGMENT_STEP = 8;
+
+// Deflate cannot refer to data further back than its 32 KiB window.
+static constexpr size_t MAX_DEFLATE_DICTIONARY_SIZE = 32 * 1024;
+
+// Builds a preset dictionary out of the segments that occur in the largest number of blobs.
+// References to recent data are cheaper, so the most common segments end up last.
+static std::string trainDeflateDictionary(std::vector<std::vector<uint8_t>> const& blobs) {
+    struct Segment {
+        uint32_t blobCount = 0;
+        uint32_t lastBlob = 0;
+    };
+    tsl::robin_map<std::string_view, Segment> segments;
+    for (uint32_t i = 0; i < blobs.size(); i++) {
+        const std::vector<uint8_t>& blob = blobs[i];
+        for (size_t offset = 0; offset + SEGMENT_SIZE <= blob.size(); offset += SEGMENT_STEP) {
+            std::string_view key((const char*) blob.data() + offset, SEGMENT_SIZE);
+            Segment& segment = segments[key];
+            if (segment.blobCount == 0 || segment.lastBlob != i) {
+                segment.blobCount++;
+                segment.lastBlob = i;
+            }
+        }
+    }
+
+    std::vector<std::pair<uint32_t, std::string_view>> candidates;
+    for (auto const& [key, segment] : segments) {
+        if (segment.blobCount > 1) {
+            candidates.emplace_back(segment.blobCount, key);
+        }
+    }
+    // Ties are broken by content so that the output does not depend on the hash table.
+    std::sort(candidates.begin(), candidates.end(), [](auto const& lhs, auto const& rhs) {
+        return lhs.first != rhs.first ? lhs.first > rhs.first : lhs.second < rhs.second;
+    });
+    candidates.resize(std::min(candidates.size(), MAX_DEFLATE_DICTIONARY_SIZE / SEGMENT_SIZE));
+
+    std::string dictionary;
+    dictionary.reserve(candidates.size() * SEGMENT_SIZE);
+    for (auto it = candidates.rbegin(); it != candidates.rend(); ++it) {
+        dictionary.append(it->second);
+    }
+    return dictionary;
 }
 
-void DictionarySpirvChunk::flatten(Flattener& f) {
+static bool deflateBlob(std::string const& dictionary, std::vector<uint8_t> const& blob,
+        std::vector<uint8_t>& deflated) {
+    z_stream stream = {};
+    if (deflateInit2(&stream, Z_BEST_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 9,
+            Z_DEFAULT_STRATEGY) != Z_OK) {
+        return false;
+    }
+    bool success = deflateSetDictionary(&stream,
+            (const Bytef*) dictionary.data(), uInt(dictionary.size())) == Z_OK;
+    if (success) {
+        deflated.resize(deflateBound(&stream, uLong(blob.size())));
+        stream.next_in = (Bytef*) blob.data();
+        stream.avail_in = uInt(blob.size());
+        stream.next_out = deflated.data();
+        stream.avail_out = uInt(deflated.size());
+        success = deflate(&stream, Z_FINISH) == Z_STREAM_END;
+        deflated.resize(stream.total_out);
+    }
+    deflateEnd(&stream);
+    return success;
+}
 
-    // For now, 1 is the only acceptable compression scheme.
-    f.writeUint32(1);
+DictionarySpirvChunk::DictionarySpirvChunk(BlobDictionary&& dictionary, bool stripDebugInfo,
+        bool deflate) :
+        Chunk(ChunkType::DictionarySpirv), mDictionary(std::move(dictionary)),
+        mStripDebugInfo(stripDebugInfo), mDeflate(deflate) {
+}
 
+void DictionarySpirvChunk::encode() {
     uint32_t flags = 0;
     if (mStripDebugInfo) {
         flags |= smolv::kEncodeFlagStripDebugInfo;
     }
 
-    f.writeUint32(mDictionary.getBlobCount());
-    for (size_t i = 0 ; i < mDictionary.getBlobCount() ; i++) {
+    const size_t count = mDictionary.getBlobCount();
+    mEncodedBlobs.resize(count);
+    for (size_t i = 0 ; i < count ; i++) {
         const std::string& spirv = mDictionary.getBlob(i);
-        smolv::ByteArray compressed;
+        smolv::ByteArray& compressed = mEncodedBlobs[i];
         if (!smolv::Encode(spirv.data(), spirv.size(), compressed, flags)) {
             utils::slog.e << "Error with SPIRV compression" << utils::io::endl;
         }
+    }
 
-        f.writeBlob((const char*) compressed.data(), compressed.size());
+    if (!mDeflate) {
+        return;
+    }
+
+    mDeflateDictionary = trainDeflateDictionary(mEncodedBlobs);
+    mInflatedSizes.resize(count);
+    std::vector<uint8_t> deflated;
+    for (size_t i = 0 ; i < count ; i++) {
+        mInflatedSizes[i] = uint32_t(mEncodedBlobs[i].size());
+        if (!deflateBlob(mDeflateDictionary, mEncodedBlobs[i], deflated)) {
+            utils::slog.e << "Error with SPIRV deflate compression" << utils::io::endl;
+        }
+        std::swap(mEncodedBlobs[i], deflated);
+    }
+}
+
+void DictionarySpirvChunk::flatten(Flattener& f) {
+    if (!mEncoded) {
+        encode();
+        mEncoded = true;
+    }
+
+    f.writeUint32(mDeflate ? SPIRV_SMOLV_DEFLATE : SPIRV_SMOLV);
+    f.writeUint32(uint32_t(mEncodedBlobs.size()));
+    if (mDeflate) {
+        f.writeBlob(mDeflateDictionary.data(), mDeflateDictionary.size());
+    }
+    for (size_t i = 0 ; i < mEncodedBlobs.size() ; i++) {
+        if (mDeflate) {
+            f.writeUint32(mInflatedSizes[i]);
+        }
+        f.writeBlob((const char*) mEncodedBlobs[i].data(), mEncodedBlobs[i].size());
     }
 }
 
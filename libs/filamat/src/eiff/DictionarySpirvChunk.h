@@ -18,6 +18,8 @@
 #define TNT_FILAMAT_DIC_SPIRV_CHUNK_H
 
 #include <stdint.h>
+
+#include <string>
 #include <vector>
 
 #include "Chunk.h"
@@ -28,14 +30,24 @@ namespace filamat {
 
 class DictionarySpirvChunk final : public Chunk {
 public:
-    explicit DictionarySpirvChunk(BlobDictionary&& dictionary, bool stripDebugInfo);
+    // With deflate set, the SMOL-V encoded blobs are further compressed with a preset dictionary
+    // trained on all the blobs of the material.
+    DictionarySpirvChunk(BlobDictionary&& dictionary, bool stripDebugInfo, bool deflate = false);
     ~DictionarySpirvChunk() = default;
 
 private:
     void flatten(Flattener& f) override;
+    void encode();
 
     BlobDictionary mDictionary;
     bool mStripDebugInfo;
+    bool mDeflate;
+
+    // flatten() is called twice, the blobs are encoded the first time only.
+    bool mEncoded = false;
+    std::vector<std::vector<uint8_t>> mEncodedBlobs;
+    std::vector<uint32_t> mInflatedSizes;
+    std::string mDeflateDictionary;
 };
 
 } // namespace filamat
@@ -16,6 +16,10 @@
 
 #include "LineDictionary.h"
 
+#include "UniqueStrings.h"
+
+#include <utils/JobSystem.h>
+
 #include <assert.h>
 
 namespace filamat {
@@ -33,10 +37,11 @@ size_t LineDictionary::getLineCount() const {
 }
 
 size_t LineDictionary::getIndex(const std::string& s) const noexcept {
-    if (mLineIndices.find(s) == mLineIndices.end()) {
+    auto iter = mLineIndices.find(s);
+    if (iter == mLineIndices.end()) {
         return SIZE_MAX;
     }
-    return mLineIndices.at(s);
+    return iter->second;
 }
 
 void LineDictionary::addText(const std::string& line) noexcept {
@@ -61,6 +66,46 @@ void LineDictionary::addText(const std::string& line) noexcept {
     }
 }
 
+void LineDictionary::addTexts(utils::JobSystem& js,
+        std::vector<std::string_view> const& texts) noexcept {
+    std::vector<std::vector<std::string_view>> textLines(texts.size());
+    utils::JobSystem::Job* parent = js.createJob();
+    for (size_t i = 0; i < texts.size(); i++) {
+        js.run(utils::jobs::createJob(js, parent, [&texts, &textLines, i]() {
+            std::string_view text = texts[i];
+            std::vector<std::string_view>& lines = textLines[i];
+            for (size_t end = text.find('\n'); end != std::string_view::npos;
+                    end = text.find('\n')) {
+                lines.push_back(text.substr(0, end));
+                text.remove_prefix(end + 1);
+            }
+            if (!text.empty()) {
+                lines.push_back(text);
+            }
+        }));
+    }
+    js.runAndWait(parent);
+
+    size_t lineCount = 0;
+    for (auto const& lines : textLines) {
+        lineCount += lines.size();
+    }
+    std::vector<std::string_view> lines;
+    lines.reserve(lineCount);
+    for (auto const& l : textLines) {
+        lines.insert(lines.end(), l.begin(), l.end());
+    }
+
+    // Only the first occurrence of each line needs to be looked up in the dictionary, which
+    // preserves the order in which lines are added.
+    std::vector<uint32_t> first = findFirstOccurrences(js, lines);
+    for (size_t i = 0; i < lines.size(); i++) {
+        if (first[i] == i) {
+            addLine(std::string(lines[i]));
+        }
+    }
+}
+
 void LineDictionary::addLine(const std::string&& line) noexcept {
     // Never add a line twice.
     if (mLineIndices.find(line) != mLineIndices.end()) {
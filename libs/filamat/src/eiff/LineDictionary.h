@@ -18,9 +18,14 @@
 #define TNT_FILAMAT_LINEDICTIONARY_H
 
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
+namespace utils {
+class JobSystem;
+}
+
 namespace filamat {
 
 // Establish a line <-> id mapping. Use for shader compression when each shader is sliced in lines
@@ -31,6 +36,10 @@ public:
     ~LineDictionary() = default;
 
     void addText(const std::string& text) noexcept;
+
+    // Adds the lines of several texts, which are split and deduplicated concurrently. The result
+    // is the same as calling addText() for each text in order.
+    void addTexts(utils::JobSystem& js, std::vector<std::string_view> const& texts) noexcept;
     size_t getLineCount() const;
 
     constexpr size_t getSize() const noexcept {
@@ -18,8 +18,8 @@
 
 namespace filamat {
 
-MaterialSpirvChunk::MaterialSpirvChunk(const std::vector<SpirvEntry>&& entries) :
-        Chunk(ChunkType::MaterialSpirv), mEntries(entries) {}
+MaterialSpirvChunk::MaterialSpirvChunk(std::vector<SpirvEntry>&& entries) :
+        Chunk(ChunkType::MaterialSpirv), mEntries(std::move(entries)) {}
 
 void MaterialSpirvChunk::flatten(Flattener &f) {
     f.writeUint64(mEntries.size());
@@ -26,7 +26,7 @@ namespace filamat {
 
 class MaterialSpirvChunk final : public Chunk {
 public:
-    explicit MaterialSpirvChunk(const std::vector<SpirvEntry>&& entries);
+    explicit MaterialSpirvChunk(std::vector<SpirvEntry>&& entries);
     ~MaterialSpirvChunk() = default;
 
 private:
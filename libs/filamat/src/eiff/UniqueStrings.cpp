@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "UniqueStrings.h"
+
+#include <utils/JobSystem.h>
+
+#include <tsl/robin_set.h>
+
+#include <functional>
+
+using namespace utils;
+
+namespace filamat {
+
+static constexpr size_t SHARD_BITS = 5;
+static constexpr size_t SHARD_COUNT = 1u << SHARD_BITS;
+
+// Number of strings hashed by each job.
+static constexpr size_t HASH_BATCH_SIZE = 1024;
+
+std::vector<uint32_t> findFirstOccurrences(JobSystem& js,
+        std::vector<std::string_view> const& strings) {
+    const uint32_t count = uint32_t(strings.size());
+    std::vector<uint32_t> first(count);
+    if (count == 0) {
+        return first;
+    }
+    std::vector<size_t> hashes(count);
+
+    auto hashStrings = [&strings, &hashes](uint32_t start, uint32_t n) {
+        for (uint32_t i = start, end = start + n; i < end; i++) {
+            hashes[i] = std::hash<std::string_view>{}(strings[i]);
+        }
+    };
+    js.runAndWait(jobs::parallel_for(js, nullptr, 0, count, std::cref(hashStrings),
+            jobs::CountSplitter<HASH_BATCH_SIZE>()));
+
+    // The sets hold indices of strings, their hash is precomputed.
+    struct Hash {
+        const size_t* hashes;
+        size_t operator()(uint32_t i) const noexcept { return hashes[i]; }
+    };
+    struct Equal {
+        const std::string_view* strings;
+        bool operator()(uint32_t a, uint32_t b) const noexcept { return strings[a] == strings[b]; }
+    };
+
+    // The shard of a string is chosen with the high bits of its hash, since the sets use the low
+    // bits to find buckets. Each job only writes the results of its own shard.
+    constexpr size_t shardShift = sizeof(size_t) * 8 - SHARD_BITS;
+    JobSystem::Job* parent = js.createJob();
+    for (size_t shard = 0; shard < SHARD_COUNT; shard++) {
+        js.run(jobs::createJob(js, parent, [&, shard]() {
+            tsl::robin_set<uint32_t, Hash, Equal> seen(0,
+                    Hash{ hashes.data() }, Equal{ strings.data() });
+            for (uint32_t i = 0; i < count; i++) {
+                if ((hashes[i] >> shardShift) == shard) {
+                    first[i] = *seen.insert(i).first;
+                }
+            }
+        }));
+    }
+    js.runAndWait(parent);
+
+    return first;
+}
+
+} // namespace filamat
@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TNT_FILAMAT_UNIQUESTRINGS_H
+#define TNT_FILAMAT_UNIQUESTRINGS_H
+
+#include <stdint.h>
+
+#include <string_view>
+#include <vector>
+
+namespace utils {
+class JobSystem;
+}
+
+namespace filamat {
+
+// Finds the distinct strings of a sequence. Returns, for each string, the index of the first
+// string of the sequence that is equal to it, so a string is the first of its kind if this index
+// is its own.
+//
+// The strings are hashed concurrently, then split into shards by hash, and each shard is
+// deduplicated by its own job, which requires no locking. The result doesn't depend on the number
+// of threads.
+std::vector<uint32_t> findFirstOccurrences(utils::JobSystem& js,
+        std::vector<std::string_view> const& strings);
+
+} // namespace filamat
+
+#endif // TNT_FILAMAT_UNIQUESTRINGS_H
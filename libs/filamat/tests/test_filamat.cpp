@@ -16,6 +16,8 @@
 
 #include <gtest/gtest.h>
 
+#include "eiff/BlobDictionary.h"
+#include "eiff/LineDictionary.h"
 #include "sca/ASTHelpers.h"
 #include "shaders/ShaderGenerator.h"
 
@@ -23,10 +25,16 @@
 
 #include <filamat/Enums.h>
 
+#include <filaflat/BlobDictionary.h>
+#include <filaflat/ChunkContainer.h>
+#include <filaflat/DictionaryReader.h>
+
 #include <utils/JobSystem.h>
 
 #include <memory>
 
+#include <string.h>
+
 using namespace utils;
 using namespace ASTUtils;
 using namespace filament::backend;
@@ -768,6 +776,109 @@ TEST_F(MaterialCompiler, CustomSurfaceShadingHasFunction) {
     EXPECT_TRUE(result.isValid());
 }
 
+static bool readSpirvDictionary(filamat::Package const& package,
+        filaflat::BlobDictionary& dictionary) {
+    filaflat::ChunkContainer container(package.getData(), package.getSize());
+    return container.parse() &&
+            filaflat::DictionaryReader::unflatten(container, ChunkType::DictionarySpirv, dictionary);
+}
+
+TEST_F(MaterialCompiler, CompressedSpirv) {
+    auto build = [this](bool compressSpirv) {
+        filamat::MaterialBuilder builder;
+        builder.material(R"(
+            void material(inout MaterialInputs material) {
+                prepareMaterial(material);
+            }
+        )");
+        builder.targetApi(MaterialBuilder::TargetApi::VULKAN);
+        builder.compressSpirv(compressSpirv);
+        return builder.build(*jobSystem);
+    };
+    filamat::Package expected = build(false);
+    filamat::Package actual = build(true);
+    ASSERT_TRUE(expected.isValid());
+    ASSERT_TRUE(actual.isValid());
+
+    filaflat::BlobDictionary expectedDictionary;
+    filaflat::BlobDictionary actualDictionary;
+    ASSERT_TRUE(readSpirvDictionary(expected, expectedDictionary));
+    ASSERT_TRUE(readSpirvDictionary(actual, actualDictionary));
+
+    ASSERT_EQ(expectedDictionary.size(), actualDictionary.size());
+    for (size_t i = 0; i < expectedDictionary.size(); i++) {
+        size_t expectedSize, actualSize;
+        const char* expectedBlob = expectedDictionary.getBlob(i, &expectedSize);
+        const char* actualBlob = actualDictionary.getBlob(i, &actualSize);
+        ASSERT_EQ(expectedSize, actualSize);
+        EXPECT_EQ(0, memcmp(expectedBlob, actualBlob, expectedSize));
+    }
+    EXPECT_LT(actual.getSize(), expected.getSize());
+}
+
+TEST(Dictionaries, LineDictionaryAddTexts) {
+    JobSystem js;
+    js.adopt();
+
+    std::vector<std::string> texts;
+    for (size_t i = 0; i < 200; i++) {
+        std::string text;
+        for (size_t j = 0; j < 100; j++) {
+            text += "line " + std::to_string((i * 7 + j * 13) % 500) + "\n";
+        }
+        text += "\n";
+        texts.push_back(text);
+    }
+
+    filamat::LineDictionary expected;
+    for (const auto& text : texts) {
+        expected.addText(text);
+    }
+
+    filamat::LineDictionary actual;
+    actual.addTexts(js, { texts.begin(), texts.end() });
+
+    ASSERT_EQ(expected.getLineCount(), actual.getLineCount());
+    EXPECT_EQ(expected.getSize(), actual.getSize());
+    for (size_t i = 0; i < expected.getLineCount(); i++) {
+        EXPECT_EQ(expected.getString(i), actual.getString(i));
+    }
+
+    js.emancipate();
+}
+
+TEST(Dictionaries, BlobDictionaryAddBlobs) {
+    JobSystem js;
+    js.adopt();
+
+    std::vector<std::vector<uint32_t>> blobs;
+    for (uint32_t i = 0; i < 300; i++) {
+        blobs.push_back(std::vector<uint32_t>(10 + i % 17, i % 23));
+    }
+
+    filamat::BlobDictionary expected;
+    std::vector<size_t> expectedIndices;
+    for (const auto& blob : blobs) {
+        expectedIndices.push_back(expected.addBlob(blob));
+    }
+
+    std::vector<std::string_view> views;
+    for (const auto& blob : blobs) {
+        views.emplace_back((const char*) blob.data(), blob.size() * sizeof(uint32_t));
+    }
+    filamat::BlobDictionary actual;
+    std::vector<size_t> actualIndices = actual.addBlobs(js, views);
+
+    EXPECT_EQ(expectedIndices, actualIndices);
+    ASSERT_EQ(expected.getBlobCount(), actual.getBlobCount());
+    EXPECT_EQ(expected.getSize(), actual.getSize());
+    for (size_t i = 0; i < expected.getBlobCount(); i++) {
+        EXPECT_EQ(expected.getBlob(i), actual.getBlob(i));
+    }
+
+    js.emancipate();
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <geometry/SurfaceOrientation.h>
+
+#include <utils/JobSystem.h>
+
+#include <benchmark/benchmark.h>
+
+#include <math/vec2.h>
+#include <math/vec3.h>
+#include <math/vec4.h>
+
+#include <random>
+#include <vector>
+
+using namespace filament::geometry;
+using namespace filament::math;
+
+// A random mesh, the tangent frames of which are generated on the calling thread or with a
+// JobSystem. state.range(0) is the triangle count, there are about half as many vertices.
+class SurfaceOrientationFixture : public benchmark::Fixture {
+protected:
+    std::vector<float3> positions;
+    std::vector<float3> normals;
+    std::vector<float2> uvs;
+    std::vector<uint3> triangles;
+    std::vector<short4> quats;
+
+public:
+    void SetUp(const benchmark::State& state) override {
+        const size_t triangleCount = size_t(state.range(0));
+        const size_t vertexCount = triangleCount / 2;
+        std::mt19937 generator(1);
+        std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+        auto random = [&]() { return distribution(generator); };
+
+        positions.resize(vertexCount);
+        normals.resize(vertexCount);
+        uvs.resize(vertexCount);
+        for (size_t i = 0; i < vertexCount; i++) {
+            positions[i] = { random(), random(), random() };
+            normals[i] = normalize(float3{ random(), random(), random() });
+            uvs[i] = { random(), random() };
+        }
+        triangles.resize(triangleCount);
+        for (uint3& triangle : triangles) {
+            triangle = { generator() % vertexCount, generator() % vertexCount,
+                    generator() % vertexCount };
+        }
+        quats.resize(vertexCount);
+    }
+
+    void TearDown(const benchmark::State&) override {
+        positions.clear();
+        normals.clear();
+        uvs.clear();
+        triangles.clear();
+        quats.clear();
+    }
+
+    void build(benchmark::State& state, bool withUvs, utils::JobSystem* js) {
+        for (auto _ : state) {
+            SurfaceOrientation::Builder builder;
+            builder.vertexCount(normals.size())
+                    .normals(normals.data())
+                    .positions(positions.data())
+                    .triangleCount(triangles.size())
+                    .triangles(triangles.data())
+                    .jobSystem(js);
+            if (withUvs) {
+                builder.uvs(uvs.data());
+            }
+            SurfaceOrientation* helper = builder.build();
+            helper->getQuats(quats.data(), quats.size());
+            delete helper;
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(int64_t(state.iterations() * normals.size()));
+    }
+};
+
+BENCHMARK_DEFINE_F(SurfaceOrientationFixture, buildWithUvs)(benchmark::State& state) {
+    build(state, true, nullptr);
+}
+
+BENCHMARK_DEFINE_F(SurfaceOrientationFixture, buildWithUvsParallel)(benchmark::State& state) {
+    utils::JobSystem js;
+    js.adopt();
+    build(state, true, &js);
+    js.emancipate();
+}
+
+BENCHMARK_DEFINE_F(SurfaceOrientationFixture, buildWithNormalsOnly)(benchmark::State& state) {
+    build(state, false, nullptr);
+}
+
+BENCHMARK_DEFINE_F(SurfaceOrientationFixture, buildWithNormalsOnlyParallel)(benchmark::State& state) {
+    utils::JobSystem js;
+    js.adopt();
+    build(state, false, &js);
+    js.emancipate();
+}
+
+BENCHMARK_REGISTER_F(SurfaceOrientationFixture, buildWithUvs)->Range(1 << 12, 1 << 22);
+BENCHMARK_REGISTER_F(SurfaceOrientationFixture, buildWithUvsParallel)->Range(1 << 12, 1 << 22);
+BENCHMARK_REGISTER_F(SurfaceOrientationFixture, buildWithNormalsOnly)->Range(1 << 12, 1 << 22);
+BENCHMARK_REGISTER_F(SurfaceOrientationFixture, buildWithNormalsOnlyParallel)
+        ->Range(1 << 12, 1 << 22);
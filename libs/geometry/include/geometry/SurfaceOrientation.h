@@ -23,6 +23,10 @@
 
 #include <utils/compiler.h>
 
+namespace utils {
+class JobSystem;
+} // namespace utils
+
 namespace filament {
 
 /**
@@ -84,6 +88,14 @@ public:
         Builder& triangles(const filament::math::uint3*) noexcept;
         Builder& triangles(const filament::math::ushort3*) noexcept;
 
+        /**
+         * Optional JobSystem used to split large meshes into chunks that are processed
+         * concurrently. The generated quats do not depend on whether a JobSystem is used.
+         * build() must then be called from a thread that belongs to the JobSystem, e.g. from
+         * inside a job or from a thread that has been adopted.
+         */
+        Builder& jobSystem(utils::JobSystem* js) noexcept;
+
         /**
          * Generates quats or returns null if the submitted data is an incomplete combination.
          */
@@ -16,12 +16,15 @@
 
 #include <geometry/SurfaceOrientation.h>
 
+#include <utils/JobSystem.h>
 #include <utils/Panic.h>
 #include <utils/debug.h>
 
 #include <math/mat3.h>
 #include <math/norm.h>
 
+#include <algorithm>
+#include <limits>
 #include <vector>
 
 namespace filament {
@@ -30,6 +33,14 @@ namespace geometry {
 using namespace filament::math;
 using std::vector;
 using Builder = SurfaceOrientation::Builder;
+using utils::JobSystem;
+
+// Number of vertices or triangles below which a mesh is processed on the calling thread.
+static constexpr uint32_t PARALLEL_CHUNK_SIZE = 16384;
+
+// Maximum number of chunks whose tangents are accumulated separately by buildWithUvs(), this bounds
+// the memory used by the partial sums.
+static constexpr size_t MAX_TANGENT_CHUNK_COUNT = 8;
 
 struct OrientationBuilderImpl {
     size_t vertexCount = 0;
@@ -44,6 +55,7 @@ struct OrientationBuilderImpl {
     size_t uvStride = 0;
     size_t positionStride = 0;
     size_t triangleCount = 0;
+    JobSystem* jobSystem = nullptr;
     SurfaceOrientation* buildWithNormalsOnly();
     SurfaceOrientation* buildWithSuppliedTangents();
     SurfaceOrientation* buildWithUvs();
@@ -111,6 +123,11 @@ Builder& Builder::triangles(const ushort3* triangles) noexcept {
     return *this;
 }
 
+Builder& Builder::jobSystem(JobSystem* js) noexcept {
+    mImpl->jobSystem = js;
+    return *this;
+}
+
 SurfaceOrientation* Builder::build() {
     if (!ASSERT_PRECONDITION_NON_FATAL(mImpl->vertexCount > 0, "Vertex count must be non-zero.")) {
         return nullptr;
@@ -152,19 +169,36 @@ static float3 randomPerp(const float3& n) {
     return perp / sqrlen;
 }
 
+// Calls work(start, count) over [0, count), split in chunks that run concurrently when a JobSystem
+// is available and the range is large enough. Each chunk only writes to its own range of the
+// output, so the results are the same as when the whole range is processed at once.
+template<typename F>
+static void parallelFor(JobSystem* js, size_t count, F const& work) {
+    if (!js || count < PARALLEL_CHUNK_SIZE * 2) {
+        work(0, uint32_t(count));
+        return;
+    }
+    auto* job = utils::jobs::parallel_for(*js, nullptr, 0, uint32_t(count), std::cref(work),
+            utils::jobs::CountSplitter<PARALLEL_CHUNK_SIZE>());
+    js->runAndWait(job);
+}
+
 SurfaceOrientation* OrientationBuilderImpl::buildWithNormalsOnly() {
     vector<quatf> quats(vertexCount);
 
-    const float3* normal = this->normals;
+    const float3* normals = this->normals;
     size_t nstride = this->normalStride ? this->normalStride : sizeof(float3);
 
-    for (size_t qindex = 0; qindex < vertexCount; ++qindex) {
-        float3 n = *normal;
-        float3 b = randomPerp(n);
-        float3 t = cross(n, b);
-        quats[qindex] = mat3f::packTangentFrame({t, b, n});
-        normal = (const float3*) (((const uint8_t*) normal) + nstride);
-    }
+    parallelFor(jobSystem, vertexCount, [&quats, normals, nstride](uint32_t start, uint32_t count) {
+        const float3* normal = (const float3*) (((const uint8_t*) normals) + start * nstride);
+        for (size_t qindex = start, end = start + count; qindex < end; ++qindex) {
+            float3 n = *normal;
+            float3 b = randomPerp(n);
+            float3 t = cross(n, b);
+            quats[qindex] = mat3f::packTangentFrame({t, b, n});
+            normal = (const float3*) (((const uint8_t*) normal) + nstride);
+        }
+    });
 
     return new SurfaceOrientation(new OrientationImpl( { std::move(quats) } ));
 }
@@ -172,33 +206,76 @@ SurfaceOrientation* OrientationBuilderImpl::buildWithNormalsOnly() {
 SurfaceOrientation* OrientationBuilderImpl::buildWithSuppliedTangents() {
     vector<quatf> quats(vertexCount);
 
-    const float3* normal = this->normals;
+    const float3* normals = this->normals;
     size_t nstride = this->normalStride ? this->normalStride : sizeof(float3);
 
-    const float3* tanvec = (const float3*) this->tangents;
-    const float* tandir = &this->tangents->w;
+    const float4* tangents = this->tangents;
     size_t tstride = this->tangentStride ? this->tangentStride : sizeof(float4);
 
-    for (size_t qindex = 0; qindex < vertexCount; ++qindex) {
-        float3 n = *normal;
-        float3 t = *tanvec;
-        float3 b = *tandir > 0 ? cross(t, n) : cross(n, t);
-
-        // Some assets do not provide perfectly orthogonal tangents and normals, so we adjust the
-        // tangent to enforce orthonormality. We would rather honor the exact normal vector than
-        // the exact tangent vector since the latter is only used for bump mapping and anisotropic
-        // lighting.
-        t = *tandir > 0 ? cross(n, b) : cross(b, n);
-
-        quats[qindex] = mat3f::packTangentFrame({t, b, n});
-        normal = (const float3*) (((const uint8_t*) normal) + nstride);
-        tanvec = (const float3*) (((const uint8_t*) tanvec) + tstride);
-        tandir = (const float*) (((const uint8_t*) tandir) + tstride);
-    }
+    parallelFor(jobSystem, vertexCount,
+            [&quats, normals, nstride, tangents, tstride](uint32_t start, uint32_t count) {
+        const float3* normal = (const float3*) (((const uint8_t*) normals) + start * nstride);
+        const float4* tangent = (const float4*) (((const uint8_t*) tangents) + start * tstride);
+        for (size_t qindex = start, end = start + count; qindex < end; ++qindex) {
+            float3 n = *normal;
+            float3 t = tangent->xyz;
+            float tandir = tangent->w;
+            float3 b = tandir > 0 ? cross(t, n) : cross(n, t);
+
+            // Some assets do not provide perfectly orthogonal tangents and normals, so we adjust
+            // the tangent to enforce orthonormality. We would rather honor the exact normal vector
+            // than the exact tangent vector since the latter is only used for bump mapping and
+            // anisotropic lighting.
+            t = tandir > 0 ? cross(n, b) : cross(b, n);
+
+            quats[qindex] = mat3f::packTangentFrame({t, b, n});
+            normal = (const float3*) (((const uint8_t*) normal) + nstride);
+            tangent = (const float4*) (((const uint8_t*) tangent) + tstride);
+        }
+    });
 
     return new SurfaceOrientation(new OrientationImpl( { std::move(quats) } ));
 }
 
+// Computes the derivatives of the position of a triangle with respect to its uvs.
+UTILS_ALWAYS_INLINE
+static void computeTriangleTangents(const uint3& tri, const float3* positions, const float2* uvs,
+        const float3* normals, float3* outSdir, float3* outTdir) {
+    const float3& v1 = positions[tri.x];
+    const float3& v2 = positions[tri.y];
+    const float3& v3 = positions[tri.z];
+    const float2& w1 = uvs[tri.x];
+    const float2& w2 = uvs[tri.y];
+    const float2& w3 = uvs[tri.z];
+    float x1 = v2.x - v1.x;
+    float x2 = v3.x - v1.x;
+    float y1 = v2.y - v1.y;
+    float y2 = v3.y - v1.y;
+    float z1 = v2.z - v1.z;
+    float z2 = v3.z - v1.z;
+    float s1 = w2.x - w1.x;
+    float s2 = w3.x - w1.x;
+    float t1 = w2.y - w1.y;
+    float t2 = w3.y - w1.y;
+    float d = s1 * t2 - s2 * t1;
+    float3 sdir, tdir;
+    // In general we can't guarantee smooth tangents when the UV's are non-smooth, but let's at
+    // least avoid divide-by-zero and fall back to normals-only method.
+    if (d == 0.0) {
+        const float3& n1 = normals[tri.x];
+        sdir = randomPerp(n1);
+        tdir = cross(n1, sdir);
+    } else {
+        sdir = {t2 * x1 - t1 * x2, t2 * y1 - t1 * y2, t2 * z1 - t1 * z2};
+        tdir = {s1 * x2 - s2 * x1, s1 * y2 - s2 * y1, s1 * z2 - s2 * z1};
+        float r = 1.0f / d;
+        sdir *= r;
+        tdir *= r;
+    }
+    *outSdir = sdir;
+    *outTdir = tdir;
+}
+
 // This method is based on:
 //
 // Computing Tangent Space Basis Vectors for an Arbitrary Mesh (Lengyel’s Method)
@@ -221,67 +298,118 @@ SurfaceOrientation* OrientationBuilderImpl::buildWithUvs() {
     if (!ASSERT_PRECONDITION_NON_FATAL(this->positionStride == 0, "Non-zero positions stride not yet supported.")) {
         return nullptr;
     }
-    vector<float3> tan1(vertexCount);
-    vector<float3> tan2(vertexCount);
-    memset(tan1.data(), 0, sizeof(float3) * vertexCount);
-    memset(tan2.data(), 0, sizeof(float3) * vertexCount);
-    for (size_t a = 0; a < triangleCount; ++a) {
+    const float3* positions = this->positions;
+    const float3* normals = this->normals;
+    const float2* uvs = this->uvs;
+    const uint3* triangles32 = this->triangles32;
+    const ushort3* triangles16 = this->triangles16;
+    const size_t vertexCount = this->vertexCount;
+    auto getTriangle = [=](size_t a) {
         uint3 tri = triangles16 ? uint3(triangles16[a]) : triangles32[a];
         assert_invariant(tri.x < vertexCount && tri.y < vertexCount && tri.z < vertexCount);
-        const float3& v1 = positions[tri.x];
-        const float3& v2 = positions[tri.y];
-        const float3& v3 = positions[tri.z];
-        const float2& w1 = uvs[tri.x];
-        const float2& w2 = uvs[tri.y];
-        const float2& w3 = uvs[tri.z];
-        float x1 = v2.x - v1.x;
-        float x2 = v3.x - v1.x;
-        float y1 = v2.y - v1.y;
-        float y2 = v3.y - v1.y;
-        float z1 = v2.z - v1.z;
-        float z2 = v3.z - v1.z;
-        float s1 = w2.x - w1.x;
-        float s2 = w3.x - w1.x;
-        float t1 = w2.y - w1.y;
-        float t2 = w3.y - w1.y;
-        float d = s1 * t2 - s2 * t1;
-        float3 sdir, tdir;
-        // In general we can't guarantee smooth tangents when the UV's are non-smooth, but let's at
-        // least avoid divide-by-zero and fall back to normals-only method.
-        if (d == 0.0) {
-            const float3& n1 = normals[tri.x];
-            sdir = randomPerp(n1);
-            tdir = cross(n1, sdir);
-        } else {
-            sdir = {t2 * x1 - t1 * x2, t2 * y1 - t1 * y2, t2 * z1 - t1 * z2};
-            tdir = {s1 * x2 - s2 * x1, s1 * y2 - s2 * y1, s1 * z2 - s2 * z1};
-            float r = 1.0f / d;
-            sdir *= r;
-            tdir *= r;
+        return tri;
+    };
+
+    // The triangles are split into a number of chunks that only depends on the size of the mesh.
+    // Each chunk accumulates its triangles in order into partial sums over the vertices that it
+    // references, the first chunk into sums over all the vertices. The partial sums of the other
+    // chunks are then added to them in chunk order, so the result is the same with or without a
+    // JobSystem.
+    const size_t chunkCount = std::clamp(triangleCount / PARALLEL_CHUNK_SIZE,
+            size_t(1), MAX_TANGENT_CHUNK_COUNT);
+
+    struct PartialSums {
+        size_t first = 0; // index of the first vertex of tan1/tan2
+        vector<float3> tan1;
+        vector<float3> tan2;
+    };
+    vector<PartialSums> partials(chunkCount);
+    partials[0].tan1.resize(vertexCount, float3(0));
+    partials[0].tan2.resize(vertexCount, float3(0));
+
+    auto accumulate = [&](size_t chunk) {
+        const size_t begin = triangleCount * chunk / chunkCount;
+        const size_t end = triangleCount * (chunk + 1) / chunkCount;
+        PartialSums& sums = partials[chunk];
+        assert_invariant(begin < end);
+        if (chunk > 0) {
+            uint32_t first = std::numeric_limits<uint32_t>::max();
+            uint32_t last = 0;
+            for (size_t a = begin; a < end; ++a) {
+                uint3 tri = getTriangle(a);
+                first = std::min({ first, tri.x, tri.y, tri.z });
+                last = std::max({ last, tri.x, tri.y, tri.z });
+            }
+            sums.first = first;
+            sums.tan1.resize(last - first + 1, float3(0));
+            sums.tan2.resize(last - first + 1, float3(0));
+        }
+        float3* const tan1 = sums.tan1.data();
+        float3* const tan2 = sums.tan2.data();
+        const uint3 first = uint3(uint32_t(sums.first));
+        for (size_t a = begin; a < end; ++a) {
+            uint3 tri = getTriangle(a);
+            float3 sdir, tdir;
+            computeTriangleTangents(tri, positions, uvs, normals, &sdir, &tdir);
+            tri -= first;
+            tan1[tri.x] += sdir;
+            tan1[tri.y] += sdir;
+            tan1[tri.z] += sdir;
+            tan2[tri.x] += tdir;
+            tan2[tri.y] += tdir;
+            tan2[tri.z] += tdir;
+        }
+    };
+
+    if (jobSystem && chunkCount > 1) {
+        JobSystem& js = *jobSystem;
+        JobSystem::Job* parent = js.createJob();
+        for (size_t chunk = 0; chunk < chunkCount; ++chunk) {
+            js.run(utils::jobs::createJob(js, parent, [&accumulate, chunk] {
+                accumulate(chunk);
+            }));
         }
-        tan1[tri.x] += sdir;
-        tan1[tri.y] += sdir;
-        tan1[tri.z] += sdir;
-        tan2[tri.x] += tdir;
-        tan2[tri.y] += tdir;
-        tan2[tri.z] += tdir;
+        js.runAndWait(parent);
+    } else {
+        for (size_t chunk = 0; chunk < chunkCount; ++chunk) {
+            accumulate(chunk);
+        }
+    }
+
+    vector<float3>& tan1 = partials[0].tan1;
+    vector<float3>& tan2 = partials[0].tan2;
+    if (chunkCount > 1) {
+        parallelFor(jobSystem, vertexCount, [&](uint32_t start, uint32_t count) {
+            const size_t end = start + count;
+            for (size_t chunk = 1; chunk < chunkCount; ++chunk) {
+                PartialSums const& sums = partials[chunk];
+                const size_t first = std::max(size_t(start), sums.first);
+                const size_t last = std::min(end, sums.first + sums.tan1.size());
+                for (size_t v = first; v < last; ++v) {
+                    tan1[v] += sums.tan1[v - sums.first];
+                    tan2[v] += sums.tan2[v - sums.first];
+                }
+            }
+        });
     }
 
     vector<quatf> quats(vertexCount);
-    for (size_t a = 0; a < vertexCount; a++) {
-        const float3& n = normals[a];
-        const float3& t1 = tan1[a];
-        const float3& t2 = tan2[a];
+    parallelFor(jobSystem, vertexCount, [&](uint32_t start, uint32_t count) {
+        for (size_t a = start, end = start + count; a < end; a++) {
+            const float3& n = normals[a];
+            const float3& t1 = tan1[a];
+            const float3& t2 = tan2[a];
 
-        // Gram-Schmidt orthogonalize
-        float3 t = normalize(t1 - n * dot(n, t1));
+            // Gram-Schmidt orthogonalize
+            float3 t = normalize(t1 - n * dot(n, t1));
 
-        // Calculate handedness
-        float w = (dot(cross(n, t1), t2) < 0.0f) ? -1.0f : 1.0f;
+            // Calculate handedness
+            float w = (dot(cross(n, t1), t2) < 0.0f) ? -1.0f : 1.0f;
 
-        float3 b = w < 0 ? cross(t, n) : cross(n, t);
-        quats[a] = mat3f::packTangentFrame({t, b, n});
-    }
+            float3 b = w < 0 ? cross(t, n) : cross(n, t);
+            quats[a] = mat3f::packTangentFrame({t, b, n});
+        }
+    });
     return new SurfaceOrientation(new OrientationImpl( { std::move(quats) } ));
 }
 
@@ -312,10 +440,29 @@ void SurfaceOrientation::getQuats(quatf* out, size_t quatCount, size_t stride) c
     }
 }
 
+// Same as packSnorm16(), without std::round() and without branches so that it can be vectorized.
+// The fractional part is exact, so this rounds half away from zero exactly like std::round().
+UTILS_ALWAYS_INLINE
+static int16_t packSnorm16Fast(float v) noexcept {
+    const float x = clamp(v, -1.0f, 1.0f) * 32767.0f;
+    const int32_t i = int32_t(x);
+    const float f = x - float(i);
+    return int16_t(i + int32_t(f >= 0.5f) - int32_t(f <= -0.5f));
+}
+
 void SurfaceOrientation::getQuats(short4* out, size_t quatCount, size_t stride) const noexcept {
     const vector<quatf>& in = mImpl->quaternions;
     quatCount = std::min(quatCount, in.size());
     stride = stride ? stride : sizeof(decltype(*out));
+    if (stride == sizeof(short4)) {
+        // Tightly packed quats are converted as a flat array of components, which vectorizes.
+        const float* UTILS_RESTRICT src = &in.data()->x;
+        int16_t* UTILS_RESTRICT dst = &out->x;
+        for (size_t i = 0, n = quatCount * 4; i < n; ++i) {
+            dst[i] = packSnorm16Fast(src[i]);
+        }
+        return;
+    }
     for (size_t i = 0; i < quatCount; ++i) {
         *out = packSnorm16(in[i].xyzw);
         out = (decltype(out)) (((uint8_t*) out) + stride);
@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <geometry/SurfaceOrientation.h>
+
+#include <utils/JobSystem.h>
+
+#include <math/quat.h>
+#include <math/vec2.h>
+#include <math/vec3.h>
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+#include <string.h>
+
+using namespace filament::geometry;
+using namespace filament::math;
+
+// A random mesh, with triangles that reference vertices from anywhere in the mesh.
+struct Mesh {
+    std::vector<float3> positions;
+    std::vector<float3> normals;
+    std::vector<float2> uvs;
+    std::vector<uint3> triangles;
+
+    Mesh(size_t triangleCount, size_t vertexCount) {
+        std::mt19937 generator(1);
+        std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+        auto random = [&]() { return distribution(generator); };
+        positions.resize(vertexCount);
+        normals.resize(vertexCount);
+        uvs.resize(vertexCount);
+        for (size_t i = 0; i < vertexCount; i++) {
+            positions[i] = { random(), random(), random() };
+            normals[i] = normalize(float3{ random(), random(), random() });
+            uvs[i] = { random(), random() };
+        }
+        triangles.resize(triangleCount);
+        for (uint3& triangle : triangles) {
+            triangle = { generator() % vertexCount, generator() % vertexCount,
+                    generator() % vertexCount };
+        }
+    }
+
+    std::vector<quatf> build(utils::JobSystem* js) const {
+        SurfaceOrientation* orientation = SurfaceOrientation::Builder()
+                .vertexCount(normals.size())
+                .normals(normals.data())
+                .positions(positions.data())
+                .uvs(uvs.data())
+                .triangleCount(triangles.size())
+                .triangles(triangles.data())
+                .jobSystem(js)
+                .build();
+        std::vector<quatf> quats(normals.size());
+        orientation->getQuats(quats.data(), quats.size());
+        delete orientation;
+        return quats;
+    }
+};
+
+TEST(SurfaceOrientationTest, ParallelMatchesSerial) {
+    utils::JobSystem js;
+    js.adopt();
+
+    // large enough to be split into several chunks, and small enough to be on a single chunk
+    for (size_t triangleCount : { 100000, 1000 }) {
+        const Mesh mesh(triangleCount, triangleCount / 2);
+        const std::vector<quatf> serial = mesh.build(nullptr);
+        const std::vector<quatf> parallel = mesh.build(&js);
+        ASSERT_EQ(serial.size(), parallel.size());
+        // the sums are the same bit for bit, not just approximately (vertices that aren't part
+        // of any triangle are NaNs, hence memcmp)
+        EXPECT_EQ(0, memcmp(serial.data(), parallel.data(), serial.size() * sizeof(quatf)));
+    }
+
+    js.emancipate();
+}
+
+TEST(SurfaceOrientationTest, TangentFollowsUvs) {
+    // a quad in the xy plane, u increases with x and v with y
+    const float3 positions[] = { { 0, 0, 0 }, { 1, 0, 0 }, { 1, 1, 0 }, { 0, 1, 0 } };
+    const float3 normals[] = { { 0, 0, 1 }, { 0, 0, 1 }, { 0, 0, 1 }, { 0, 0, 1 } };
+    const float2 uvs[] = { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 1 } };
+    const uint3 triangles[] = { { 0, 1, 2 }, { 0, 2, 3 } };
+    SurfaceOrientation* orientation = SurfaceOrientation::Builder()
+            .vertexCount(4)
+            .normals(normals)
+            .positions(positions)
+            .uvs(uvs)
+            .triangleCount(2)
+            .triangles(triangles)
+            .build();
+    quatf quats[4];
+    orientation->getQuats(quats, 4);
+    delete orientation;
+    for (quatf const& q : quats) {
+        const float3 t = q * float3{ 1, 0, 0 };
+        const float3 n = q * float3{ 0, 0, 1 };
+        EXPECT_NEAR(1.0f, t.x, 1e-5f);
+        EXPECT_NEAR(1.0f, n.z, 1e-5f);
+    }
+}
@@ -60,6 +60,18 @@ struct AssetConfiguration {
 
     //! Optional default node name for anonymous nodes
     char* defaultNodeName = nullptr;
+
+    //! Shares the GPU buffers of vertex and index data across all the assets created by the loader.
+    //! ResourceLoader hashes the contents of each buffer and reuses an existing buffer that holds
+    //! identical data, even if it comes from another file. Shared buffers are destroyed along with
+    //! the last asset that uses them.
+    bool shareBuffers = false;
+
+    //! Packs the vertex and index data of small primitives into a few large buffers per asset, each
+    //! primitive using a range of them. Accessors whose data is at most this many bytes are packed,
+    //! except those that must be converted, decompressed, or that use sparse storage.
+    //! Zero disables packing.
+    uint32_t packingThreshold = 0;
 };
 
 /**
@@ -21,6 +21,8 @@
 #include <filament/Material.h>
 #include <filament/MaterialInstance.h>
 
+#include <backend/Platform.h>
+
 #include <utils/compiler.h>
 
 #include <array>
@@ -138,6 +140,22 @@ public:
     virtual filament::MaterialInstance* createMaterialInstance(MaterialKey* config, UvMap* uvmap,
             const char* label = "material", const char* extras = nullptr) = 0;
 
+    /**
+     * Gives a chance to get the materials required by an asset ready, before their instances are
+     * created.
+     *
+     * AssetLoader calls this with the keys of all the materials of an asset, prior to calling
+     * createMaterialInstance() for each primitive. This lets the provider build the materials that
+     * are not cached yet all at once, rather than one at a time. The default implementation does
+     * nothing.
+     *
+     * @param configs Requirements of the materials, before they are constrained.
+     * @param labels Optional tags of the materials, not a part of the cache key. Can be null.
+     * @param count Number of keys in configs.
+     */
+    virtual void prepareMaterials(const MaterialKey* configs, const char* const* labels,
+            size_t count) {}
+
     /**
      * Gets a weak reference to the array of cached materials.
      */
@@ -173,7 +191,13 @@ void processShaderString(std::string* shader, const UvMap& uvmap,
 /**
  * Creates a material provider that builds materials on the fly, composing GLSL at run time.
  *
+ * The materials required by an asset are built concurrently on the engine's JobSystem. When a
+ * blob cache is provided, the built material packages are stored in it, keyed by the material
+ * requirements, the material format version and the target API, so that subsequent runs can skip
+ * building them entirely. A backend::FileBlobCache can be used to persist them on disk.
+ *
  * @param optimizeShaders Optimizes shaders, but at significant cost to construction time.
+ * @param cache Optional cache for the material packages, must outlive the material provider.
  * @return New material provider that can build materials at run time.
  *
  * Requires \c libfilamat to be linked in. Not available in \c libgltfio_core.
@@ -181,7 +205,8 @@ void processShaderString(std::string* shader, const UvMap& uvmap,
  * @see createUbershaderLoader
  */
 UTILS_PUBLIC
-MaterialProvider* createMaterialGenerator(filament::Engine* engine, bool optimizeShaders = false);
+MaterialProvider* createMaterialGenerator(filament::Engine* engine, bool optimizeShaders = false,
+        filament::backend::Platform::BlobCache* cache = nullptr);
 
 /**
  * Creates a material provider that loads a small set of pre-built materials.
@@ -20,6 +20,7 @@
 #include <gltfio/FilamentAsset.h>
 
 #include <backend/BufferDescriptor.h>
+#include <backend/Platform.h>
 
 #include <utils/compiler.h>
 
@@ -31,6 +32,7 @@ namespace gltfio {
 
 struct FFilamentAsset;
 class AssetPool;
+class BakedData;
 
 /**
  * \struct ResourceConfiguration ResourceLoader.h gltfio/ResourceLoader.h
@@ -56,6 +58,13 @@ struct ResourceConfiguration {
     //! If true, ignore skinned primitives bind transform when compute bounding box. Implicitly true 
     //! for instanced asset. Only applicable when recomputeBoundingBoxes is set to true
     bool ignoreBindTransform;
+
+    //! Optional cache for the data that the loader derives from the source data of each asset:
+    //! decompressed meshes, tangent frames and recomputed bounding boxes. Subsequent loads of the
+    //! same asset (same JSON and same buffers) read this data from the cache instead of computing
+    //! it. To bake a set of assets ahead of time, load them once with a persistent cache such as
+    //! filament::backend::FileBlobCache, which is what the gltf-bake tool does.
+    filament::backend::Platform::BlobCache* cache = nullptr;
 };
 
 /**
@@ -155,7 +164,7 @@ private:
     bool loadResources(FFilamentAsset* asset, bool async);
     void applySparseData(FFilamentAsset* asset) const;
     void normalizeSkinningWeights(FFilamentAsset* asset) const;
-    void updateBoundingBoxes(FFilamentAsset* asset) const;
+    void updateBoundingBoxes(FFilamentAsset* asset, BakedData* baked) const;
     AssetPool* mPool;
     struct Impl;
     Impl* pImpl;
@@ -47,6 +47,7 @@
 #include <utils/Systrace.h>
 
 #include <tsl/robin_map.h>
+#include <tsl/robin_set.h>
 
 #define CGLTF_IMPLEMENTATION
 #include <cgltf.h>
@@ -87,6 +88,82 @@ static const char* getNodeName(const cgltf_node* node, const char* defaultNodeNa
     return defaultNodeName;
 }
 
+// Returns the array of numbers held by the given key of a JSON object, or an empty array if there
+// is no such key. This uses the jsmn tokenizer that comes with cgltf and is meant for the small
+// payloads that cgltf leaves unparsed, e.g. the MSFT_lod extension or the node extras.
+static std::vector<cgltf_float> parseNumberArray(const char* json, size_t size, const char* key) {
+    jsmn_parser parser;
+    jsmn_init(&parser);
+    const int count = jsmn_parse(&parser, json, size, nullptr, 0);
+    if (count <= 0) {
+        return {};
+    }
+
+    // As in cgltf_parse, the extra token is a sentinel for cgltf_skip_json.
+    std::vector<jsmntok_t> tokens(count + 1);
+    jsmn_init(&parser);
+    if (jsmn_parse(&parser, json, size, tokens.data(), count) != count ||
+            tokens[0].type != JSMN_OBJECT) {
+        return {};
+    }
+    tokens[count].type = JSMN_UNDEFINED;
+
+    const uint8_t* chunk = (const uint8_t*) json;
+    for (int i = 1, k = 0; i > 0 && i < count && k < tokens[0].size; ++k) {
+        const jsmntok_t& value = tokens[i + 1];
+        if (cgltf_json_strcmp(&tokens[i], chunk, key) == 0 && value.type == JSMN_ARRAY) {
+            std::vector<cgltf_float> result(value.size);
+            for (int j = 0; j < value.size; ++j) {
+                const jsmntok_t& element = tokens[i + 2 + j];
+                if (element.type != JSMN_PRIMITIVE) {
+                    return {};
+                }
+                result[j] = cgltf_json_to_float(&element, chunk);
+            }
+            return result;
+        }
+        i = cgltf_skip_json(tokens.data(), i + 1);
+    }
+    return {};
+}
+
+// Returns the nodes that hold the lower levels of detail of the given node, as specified by the
+// MSFT_lod extension, in order of decreasing detail.
+static std::vector<const cgltf_node*> getLodNodes(const cgltf_data* srcAsset,
+        const cgltf_node* node) {
+    std::vector<const cgltf_node*> lodNodes;
+    for (cgltf_size i = 0; i < node->extensions_count; ++i) {
+        const cgltf_extension& extension = node->extensions[i];
+        if (!extension.name || !extension.data || strcmp(extension.name, "MSFT_lod")) {
+            continue;
+        }
+        for (cgltf_float id : parseNumberArray(extension.data, strlen(extension.data), "ids")) {
+            if (id >= 0 && id < srcAsset->nodes_count) {
+                lodNodes.push_back(&srcAsset->nodes[size_t(id)]);
+            }
+        }
+    }
+    return lodNodes;
+}
+
+// The default glTF material.
+static const cgltf_material kDefaultMat = {
+    .name = (char*) "Default GLTF material",
+    .has_pbr_metallic_roughness = true,
+    .has_pbr_specular_glossiness = false,
+    .has_clearcoat = false,
+    .has_transmission = false,
+    .has_volume = false,
+    .has_ior = false,
+    .has_specular = false,
+    .has_sheen = false,
+    .pbr_metallic_roughness = {
+	        .base_color_factor = {1.0, 1.0, 1.0, 1.0},
+	        .metallic_factor = 1.0,
+	        .roughness_factor = 1.0,
+    },
+};
+
 struct FAssetLoader : public AssetLoader {
     FAssetLoader(const AssetConfiguration& config) :
             mEntityManager(config.entities ? *config.entities : EntityManager::get()),
@@ -95,7 +172,12 @@ struct FAssetLoader : public AssetLoader {
             mTransformManager(config.engine->getTransformManager()),
             mMaterials(config.materials),
             mEngine(config.engine),
-            mDefaultNodeName(config.defaultNodeName) {}
+            mDefaultNodeName(config.defaultNodeName),
+            mPackingThreshold(config.packingThreshold) {
+        if (config.shareBuffers) {
+            mBufferCache = std::make_shared<BufferCache>(config.engine);
+        }
+    }
 
     FFilamentAsset* createAssetFromJson(const uint8_t* bytes, uint32_t nbytes);
     FFilamentAsset* createAssetFromBinary(const uint8_t* bytes, uint32_t nbytes);
@@ -137,6 +219,12 @@ struct FAssetLoader : public AssetLoader {
     void createCamera(const cgltf_camera* camera, Entity entity);
     MaterialInstance* createMaterialInstance(const cgltf_data* srcAsset,
             const cgltf_material* inputMat, UvMap* uvmap, bool vertexColor);
+    MaterialKey getMaterialKey(const cgltf_material* inputMat, bool vertexColor,
+            cgltf_texture_view* baseColorTexture,
+            cgltf_texture_view* metallicRoughnessTexture) const;
+    void prepareMaterials(const cgltf_data* srcAsset);
+    void packAccessors(const cgltf_data* srcAsset);
+    bool isPackable(const cgltf_accessor* accessor) const;
     void addTextureBinding(MaterialInstance* materialInstance, const char* parameterName,
             const cgltf_texture* srcTexture, bool srgb);
     bool primitiveHasVertexColor(const cgltf_primitive* inPrim) const;
@@ -149,13 +237,18 @@ struct FAssetLoader : public AssetLoader {
     TransformManager& mTransformManager;
     MaterialProvider* mMaterials;
     Engine* mEngine;
+    std::shared_ptr<BufferCache> mBufferCache;
 
     // Transient state used only for the asset currently being loaded:
     FFilamentAsset* mResult;
     const char* mDefaultNodeName;
+    const uint32_t mPackingThreshold;
     bool mError = false;
     bool mDiagnosticsEnabled = false;
 
+    // Nodes that are only referenced as a lower level of detail by a MSFT_lod extension.
+    tsl::robin_set<const cgltf_node*> mLodNodes;
+
     // Weak reference to the largest dummy buffer so far in the current loading phase.
     BufferObject* mDummyBufferObject;
 };
@@ -269,8 +362,18 @@ void FAssetLoader::createAsset(const cgltf_data* srcAsset, size_t numInstances)
     #endif
 
     mResult = new FFilamentAsset(mEngine, mNameManager, &mEntityManager, srcAsset);
+    mResult->mBufferCache = mBufferCache;
     mDummyBufferObject = nullptr;
 
+    // The meshes of MSFT_lod nodes are merged into the renderable of the node that refers to them,
+    // so these nodes must not get a renderable of their own.
+    mLodNodes.clear();
+    for (cgltf_size i = 0, len = srcAsset->nodes_count; i < len; ++i) {
+        for (const cgltf_node* lodNode : getLodNodes(srcAsset, &srcAsset->nodes[i])) {
+            mLodNodes.insert(lodNode);
+        }
+    }
+
     // If there is no default scene specified, then the default is the first one.
     // It is not an error for a glTF file to have zero scenes.
     const cgltf_scene* scene = srcAsset->scene ? srcAsset->scene : srcAsset->scenes;
@@ -282,6 +385,9 @@ void FAssetLoader::createAsset(const cgltf_data* srcAsset, size_t numInstances)
     mResult->mRoot = mEntityManager.create();
     mTransformManager.create(mResult->mRoot);
 
+    prepareMaterials(srcAsset);
+    packAccessors(srcAsset);
+
     // Check if the asset has an extras string.
     const cgltf_asset& asset = srcAsset->asset;
     const cgltf_size extras_size = asset.extras.end_offset - asset.extras.start_offset;
@@ -404,7 +510,7 @@ void FAssetLoader::createEntity(const cgltf_data* srcAsset, const cgltf_node* no
     name = name ? name : "node";
 
     // If the node has a mesh, then create a renderable component.
-    if (node->mesh) {
+    if (node->mesh && mLodNodes.find(node) == mLodNodes.end()) {
         createRenderable(srcAsset, node, entity, name);
     }
 
@@ -429,66 +535,111 @@ void FAssetLoader::createRenderable(const cgltf_data* srcAsset, const cgltf_node
     auto thisTransform = mTransformManager.getInstance(entity);
     mat4f worldTransform = mTransformManager.getWorldTransform(thisTransform);
 
-    cgltf_size nprims = mesh->primitives_count;
-    RenderableManager::Builder builder(nprims);
+    // With MSFT_lod, the meshes of the lower levels of detail are appended after the primitives of
+    // this node's own mesh, each level of detail being a range of primitives in the renderable.
+    std::vector<const cgltf_mesh*> lodMeshes = { mesh };
+    for (const cgltf_node* lodNode : getLodNodes(srcAsset, node)) {
+        if (lodNode->mesh) {
+            lodMeshes.push_back(lodNode->mesh);
+        } else {
+            slog.w << "Ignoring level of detail without a mesh in " << name << io::endl;
+        }
+    }
+
+    if (lodMeshes.size() > 1) {
+        mResult->mLodMeshes[node] = lodMeshes;
+    }
 
-    // If the mesh is already loaded, obtain the list of Filament VertexBuffer / IndexBuffer objects
-    // that were already generated (one for each primitive), otherwise allocate a new list of
-    // pointers for the primitives.
-    auto iter = mResult->mMeshCache.find(mesh);
-    if (iter == mResult->mMeshCache.end()) {
-        mResult->mMeshCache[mesh].resize(nprims);
+    cgltf_size nprims = 0;
+    for (const cgltf_mesh* lodMesh : lodMeshes) {
+        nprims += lodMesh->primitives_count;
     }
-    Primitive* outputPrim = mResult->mMeshCache[mesh].data();
-    const cgltf_primitive* inputPrim = &mesh->primitives[0];
+    RenderableManager::Builder builder(nprims);
 
     Aabb aabb;
 
     cgltf_size numMorphTargets = 0;
 
-    // For each prim, create a Filament VertexBuffer, IndexBuffer, and MaterialInstance.
-    for (cgltf_size index = 0; index < nprims; ++index, ++outputPrim, ++inputPrim) {
-        RenderableManager::PrimitiveType primType;
-        if (!getPrimitiveType(inputPrim->type, &primType)) {
-            slog.e << "Unsupported primitive type in " << name << io::endl;
+    // The MSFT_screencoverage extras hold the minimum screen coverage of each level, when it is
+    // missing each level is used down to a quarter of the coverage of the previous one, i.e. half
+    // its size on screen.
+    std::vector<cgltf_float> screenCoverages;
+    const cgltf_size extras_size = node->extras.end_offset - node->extras.start_offset;
+    if (lodMeshes.size() > 1 && extras_size > 0) {
+        screenCoverages = parseNumberArray(srcAsset->json + node->extras.start_offset,
+                extras_size, "MSFT_screencoverage");
+    }
+
+    cgltf_size index = 0;
+    for (size_t level = 0; level < lodMeshes.size(); ++level) {
+        const cgltf_mesh* levelMesh = lodMeshes[level];
+        const cgltf_size levelPrims = levelMesh->primitives_count;
+
+        // If the mesh is already loaded, obtain the list of Filament VertexBuffer / IndexBuffer
+        // objects that were already generated (one for each primitive), otherwise allocate a new
+        // list of pointers for the primitives.
+        auto iter = mResult->mMeshCache.find(levelMesh);
+        if (iter == mResult->mMeshCache.end()) {
+            mResult->mMeshCache[levelMesh].resize(levelPrims);
         }
+        Primitive* outputPrim = mResult->mMeshCache[levelMesh].data();
+        const cgltf_primitive* inputPrim = &levelMesh->primitives[0];
+
+        // For each prim, create a Filament VertexBuffer, IndexBuffer, and MaterialInstance.
+        for (cgltf_size i = 0; i < levelPrims; ++i, ++index, ++outputPrim, ++inputPrim) {
+            RenderableManager::PrimitiveType primType;
+            if (!getPrimitiveType(inputPrim->type, &primType)) {
+                slog.e << "Unsupported primitive type in " << name << io::endl;
+            }
 
-        if (inputPrim->targets_count > 0) {
-            if (numMorphTargets > 0 && inputPrim->targets_count != numMorphTargets) {
-                slog.e << "Sister primitives must all have the same number of morph targets."
-                        << io::endl;
+            // All levels of detail share the morph weights of the renderable.
+            if (inputPrim->targets_count > 0) {
+                if (numMorphTargets > 0 && inputPrim->targets_count != numMorphTargets) {
+                    slog.e << "Sister primitives must all have the same number of morph targets."
+                            << io::endl;
+                }
+                numMorphTargets = inputPrim->targets_count;
             }
-            numMorphTargets = inputPrim->targets_count;
-        }
 
-        // Create a material instance for this primitive or fetch one from the cache.
-        UvMap uvmap {};
-        bool hasVertexColor = primitiveHasVertexColor(inputPrim);
-        MaterialInstance* mi = createMaterialInstance(srcAsset, inputPrim->material, &uvmap,
-                hasVertexColor);
-        if (!mi) {
-            mError = true;
-            continue;
-        }
+            // Create a material instance for this primitive or fetch one from the cache.
+            UvMap uvmap {};
+            bool hasVertexColor = primitiveHasVertexColor(inputPrim);
+            MaterialInstance* mi = createMaterialInstance(srcAsset, inputPrim->material, &uvmap,
+                    hasVertexColor);
+            if (!mi) {
+                mError = true;
+                continue;
+            }
 
-        mResult->mDependencyGraph.addEdge(entity, mi);
-        builder.material(index, mi);
+            mResult->mDependencyGraph.addEdge(entity, mi);
+            builder.material(index, mi);
 
-        // Create a Filament VertexBuffer and IndexBuffer for this prim if we haven't already.
-        if (!outputPrim->vertices && !createPrimitive(inputPrim, outputPrim, uvmap, name, mi)) {
-            mError = true;
-            continue;
-        }
+            // Create a Filament VertexBuffer and IndexBuffer for this prim if we haven't already.
+            if (!outputPrim->vertices && !createPrimitive(inputPrim, outputPrim, uvmap, name, mi)) {
+                mError = true;
+                continue;
+            }
+
+            // Expand the object-space bounding box.
+            aabb.min = min(outputPrim->aabb.min, aabb.min);
+            aabb.max = max(outputPrim->aabb.max, aabb.max);
 
-        // Expand the object-space bounding box.
-        aabb.min = min(outputPrim->aabb.min, aabb.min);
-        aabb.max = max(outputPrim->aabb.max, aabb.max);
+            // The glTF spec does not have facilities for the optional offset and count arguments
+            // of geometry(), they are only used to select the range of the packed index buffer.
+            builder.geometry(index, primType, outputPrim->vertices, outputPrim->indices,
+                    outputPrim->indexOffset, outputPrim->indexCount);
 
-        // We are not using the optional offset, minIndex, maxIndex, and count arguments when
-        // calling geometry() on the builder. It appears that the glTF spec does not have
-        // facilities for these parameters, which is not a huge loss since some of the buffer
-        // view and accessor features already have this functionality.
-        builder.geometry(index, primType, outputPrim->vertices, outputPrim->indices);
+            if (mBufferCache) {
+                mResult->mRenderablePrimitives.push_back(
+                        { entity, uint32_t(index), primType, outputPrim });
+            }
+        }
+
+        if (lodMeshes.size() > 1) {
+            builder.levelOfDetail(uint8_t(level), index - levelPrims, levelPrims,
+                    level < screenCoverages.size() ? screenCoverages[level] :
+                    level + 1 < lodMeshes.size() ? std::pow(0.25f, float(level + 1)) : 0.0f);
+        }
     }
 
     if (numMorphTargets > 0) {
@@ -551,7 +702,14 @@ bool FAssetLoader::createPrimitive(const cgltf_primitive* inPrim, Primitive* out
     // In glTF, each primitive may or may not have an index buffer.
     IndexBuffer* indices = nullptr;
     const cgltf_accessor* accessor = inPrim->indices;
-    if (accessor) {
+    auto packedIndices = accessor ? mResult->mPackedIndices.find(accessor) :
+            mResult->mPackedIndices.end();
+    if (packedIndices != mResult->mPackedIndices.end()) {
+        // The data is uploaded by ResourceLoader along with the rest of the packed index buffer.
+        indices = mResult->mPackedIndexBuffers[packedIndices->second.buffer];
+        outPrim->indexOffset = packedIndices->second.offset;
+        outPrim->indexCount = accessor->count;
+    } else if (accessor) {
         IndexBuffer::IndexType indexType;
         if (!getIndexType(accessor->component_type, &indexType)) {
             utils::slog.e << "Unrecognized index type in " << name << utils::io::endl;
@@ -562,6 +720,8 @@ bool FAssetLoader::createPrimitive(const cgltf_primitive* inPrim, Primitive* out
             .indexCount(accessor->count)
             .bufferType(indexType)
             .build(*mEngine);
+        mResult->mIndexBuffers.push_back(indices);
+        outPrim->indexCount = accessor->count;
 
         BufferSlot slot = { accessor };
         slot.indexBuffer = indices;
@@ -569,21 +729,37 @@ bool FAssetLoader::createPrimitive(const cgltf_primitive* inPrim, Primitive* out
     } else if (inPrim->attributes_count > 0) {
         // If a primitive does not have an index buffer, generate a trivial one now.
         const uint32_t vertexCount = inPrim->attributes[0].data->count;
-
-        indices = IndexBuffer::Builder()
-            .indexCount(vertexCount)
-            .bufferType(IndexBuffer::IndexType::UINT)
-            .build(*mEngine);
+        outPrim->indexCount = vertexCount;
 
         const size_t indexDataSize = vertexCount * sizeof(uint32_t);
         uint32_t* indexData = (uint32_t*) malloc(indexDataSize);
         for (size_t i = 0; i < vertexCount; ++i) {
             indexData[i] = i;
         }
-        IndexBuffer::BufferDescriptor bd(indexData, indexDataSize, FREE_CALLBACK);
-        indices->setBuffer(*mEngine, std::move(bd));
+
+        BufferCache::Key key{};
+        if (mBufferCache) {
+            key = BufferCache::getKey(indexData, indexDataSize, IndexBuffer::IndexType::UINT);
+            indices = mBufferCache->acquireIndexBuffer(key);
+        }
+        if (indices) {
+            free(indexData);
+            mResult->mSharedIndexBuffers.push_back(indices);
+        } else {
+            indices = IndexBuffer::Builder()
+                .indexCount(vertexCount)
+                .bufferType(IndexBuffer::IndexType::UINT)
+                .build(*mEngine);
+            IndexBuffer::BufferDescriptor bd(indexData, indexDataSize, FREE_CALLBACK);
+            indices->setBuffer(*mEngine, std::move(bd));
+            if (mBufferCache) {
+                mBufferCache->addIndexBuffer(key, indices);
+                mResult->mSharedIndexBuffers.push_back(indices);
+            } else {
+                mResult->mIndexBuffers.push_back(indices);
+            }
+        }
     }
-    mResult->mIndexBuffers.push_back(indices);
 
     VertexBuffer::Builder vbb;
     vbb.enableBufferObjects();
@@ -676,12 +852,18 @@ bool FAssetLoader::createPrimitive(const cgltf_primitive* inPrim, Primitive* out
         }
         const int stride = (fatype == actualType) ? accessor->stride : 0;
 
+        // Packed accessors live at some offset of the packed BufferObject, which is bound to this
+        // slot by ResourceLoader.
+        auto packed = mResult->mPackedVertices.find(accessor);
+        const bool isPacked = packed != mResult->mPackedVertices.end();
+        const uint32_t offset = isPacked ? packed->second : 0;
+
         // The cgltf library provides a stride value for all accessors, even though they do not
         // exist in the glTF file. It is computed from the type and the stride of the buffer view.
         // As a convenience, cgltf also replaces zero (default) stride with the actual stride.
-        vbb.attribute(semantic, slot, fatype, 0, stride);
+        vbb.attribute(semantic, slot, fatype, offset, stride);
         vbb.normalized(semantic, accessor->normalized);
-        addBufferSlot({accessor, atype, slot++});
+        addBufferSlot({accessor, atype, slot++, nullptr, nullptr, isPacked});
     }
 
     // If the model is lit but does not have normals, we'll need to generate flat normals.
@@ -883,34 +1065,9 @@ void FAssetLoader::createCamera(const cgltf_camera* camera, Entity entity) {
     mResult->mCameraEntities.push_back(entity);
 }
 
-MaterialInstance* FAssetLoader::createMaterialInstance(const cgltf_data* srcAsset,
-        const cgltf_material* inputMat, UvMap* uvmap, bool vertexColor) {
-    intptr_t key = ((intptr_t) inputMat) ^ (vertexColor ? 1 : 0);
-    auto iter = mResult->mMatInstanceCache.find(key);
-    if (iter != mResult->mMatInstanceCache.end()) {
-        *uvmap = iter->second.uvmap;
-        return iter->second.instance;
-    }
-
-    // The default glTF material.
-    static const cgltf_material kDefaultMat = {
-        .name = (char*) "Default GLTF material",
-        .has_pbr_metallic_roughness = true,
-        .has_pbr_specular_glossiness = false,
-        .has_clearcoat = false,
-        .has_transmission = false,
-        .has_volume = false,
-        .has_ior = false,
-        .has_specular = false,
-        .has_sheen = false,
-        .pbr_metallic_roughness = {
-	        .base_color_factor = {1.0, 1.0, 1.0, 1.0},
-	        .metallic_factor = 1.0,
-	        .roughness_factor = 1.0,
-        },
-    };
-    inputMat = inputMat ? inputMat : &kDefaultMat;
-
+MaterialKey FAssetLoader::getMaterialKey(const cgltf_material* inputMat, bool vertexColor,
+        cgltf_texture_view* outBaseColorTexture,
+        cgltf_texture_view* outMetallicRoughnessTexture) const {
     auto mrConfig = inputMat->pbr_metallic_roughness;
     auto sgConfig = inputMat->pbr_specular_glossiness;
     auto ccConfig = inputMat->clearcoat;
@@ -1000,6 +1157,130 @@ MaterialInstance* FAssetLoader::createMaterialInstance(const cgltf_data* srcAsse
             break;
     }
 
+    *outBaseColorTexture = baseColorTexture;
+    *outMetallicRoughnessTexture = metallicRoughnessTexture;
+    return matkey;
+}
+
+void FAssetLoader::prepareMaterials(const cgltf_data* srcAsset) {
+    // Gather the material of every primitive, so that the material provider can get all of them
+    // ready at once. This uses the same (material, vertex color) pairs as the instance cache.
+    tsl::robin_set<intptr_t> visited;
+    std::vector<MaterialKey> keys;
+    std::vector<const char*> labels;
+    for (cgltf_size i = 0, len = srcAsset->meshes_count; i < len; ++i) {
+        const cgltf_mesh& mesh = srcAsset->meshes[i];
+        for (cgltf_size j = 0, n = mesh.primitives_count; j < n; ++j) {
+            const cgltf_primitive* prim = &mesh.primitives[j];
+            const bool vertexColor = primitiveHasVertexColor(prim);
+            intptr_t key = ((intptr_t) prim->material) ^ (vertexColor ? 1 : 0);
+            if (!visited.insert(key).second) {
+                continue;
+            }
+            const cgltf_material* inputMat = prim->material ? prim->material : &kDefaultMat;
+            cgltf_texture_view baseColorTexture;
+            cgltf_texture_view metallicRoughnessTexture;
+            keys.push_back(getMaterialKey(inputMat, vertexColor, &baseColorTexture,
+                    &metallicRoughnessTexture));
+            labels.push_back(inputMat->name);
+        }
+    }
+    if (!keys.empty()) {
+        mMaterials->prepareMaterials(keys.data(), labels.data(), keys.size());
+    }
+}
+
+bool FAssetLoader::isPackable(const cgltf_accessor* accessor) const {
+    // Sparse and compressed data is produced by ResourceLoader into buffers of its own.
+    const cgltf_buffer_view* view = accessor->buffer_view;
+    return view && !view->has_meshopt_compression && !accessor->is_sparse && accessor->count > 0 &&
+            computeBindingSize(accessor) <= mPackingThreshold;
+}
+
+// Assigns a range of the packed buffers to each small accessor that the primitives of the asset
+// use, then creates the packed index buffers. Accessors shared by several primitives are packed
+// only once.
+void FAssetLoader::packAccessors(const cgltf_data* srcAsset) {
+    if (mPackingThreshold == 0) {
+        return;
+    }
+    uint32_t vertexSize = 0;
+    uint32_t indexCounts[2] = {};
+    for (cgltf_size i = 0, len = srcAsset->meshes_count; i < len; ++i) {
+        const cgltf_mesh& mesh = srcAsset->meshes[i];
+        for (cgltf_size j = 0, n = mesh.primitives_count; j < n; ++j) {
+            const cgltf_primitive& prim = mesh.primitives[j];
+            if (prim.has_draco_mesh_compression) {
+                continue;
+            }
+
+            // Byte indices are converted to USHORT, as they are for unpacked index buffers.
+            const cgltf_accessor* indices = prim.indices;
+            IndexBuffer::IndexType indexType;
+            if (indices && getIndexType(indices->component_type, &indexType) &&
+                    isPackable(indices) &&
+                    mResult->mPackedIndices.find(indices) == mResult->mPackedIndices.end()) {
+                const uint32_t buffer = indexType == IndexBuffer::IndexType::UINT ? 1 : 0;
+                mResult->mPackedIndices[indices] = { buffer, indexCounts[buffer] };
+                indexCounts[buffer] += indices->count;
+            }
+
+            // Normals and tangents are replaced by the quaternions that ResourceLoader generates.
+            for (cgltf_size k = 0; k < prim.attributes_count; ++k) {
+                const cgltf_attribute& attribute = prim.attributes[k];
+                const cgltf_accessor* accessor = attribute.data;
+                if (attribute.type == cgltf_attribute_type_normal ||
+                        attribute.type == cgltf_attribute_type_tangent ||
+                        requiresConversion(accessor->type, accessor->component_type) ||
+                        !isPackable(accessor) ||
+                        mResult->mPackedVertices.find(accessor) != mResult->mPackedVertices.end()) {
+                    continue;
+                }
+                vertexSize = (vertexSize + 3u) & ~3u;
+                mResult->mPackedVertices[accessor] = vertexSize;
+                vertexSize += computeBindingSize(accessor);
+            }
+        }
+    }
+    mResult->mPackedVertexSize = vertexSize;
+
+    constexpr IndexBuffer::IndexType indexTypes[2] = {
+            IndexBuffer::IndexType::USHORT, IndexBuffer::IndexType::UINT };
+    for (size_t i = 0; i < 2; ++i) {
+        if (indexCounts[i] > 0) {
+            IndexBuffer* indices = IndexBuffer::Builder()
+                .indexCount(indexCounts[i])
+                .bufferType(indexTypes[i])
+                .build(*mEngine);
+            mResult->mIndexBuffers.push_back(indices);
+            mResult->mPackedIndexBuffers[i] = indices;
+        }
+    }
+}
+
+MaterialInstance* FAssetLoader::createMaterialInstance(const cgltf_data* srcAsset,
+        const cgltf_material* inputMat, UvMap* uvmap, bool vertexColor) {
+    intptr_t key = ((intptr_t) inputMat) ^ (vertexColor ? 1 : 0);
+    auto iter = mResult->mMatInstanceCache.find(key);
+    if (iter != mResult->mMatInstanceCache.end()) {
+        *uvmap = iter->second.uvmap;
+        return iter->second.instance;
+    }
+
+    inputMat = inputMat ? inputMat : &kDefaultMat;
+
+    auto mrConfig = inputMat->pbr_metallic_roughness;
+    auto sgConfig = inputMat->pbr_specular_glossiness;
+    auto ccConfig = inputMat->clearcoat;
+    auto trConfig = inputMat->transmission;
+    auto shConfig = inputMat->sheen;
+    auto vlConfig = inputMat->volume;
+
+    cgltf_texture_view baseColorTexture;
+    cgltf_texture_view metallicRoughnessTexture;
+    MaterialKey matkey = getMaterialKey(inputMat, vertexColor, &baseColorTexture,
+            &metallicRoughnessTexture);
+
     // Check if this material has an extras string.
     CString extras;
     const cgltf_size extras_size = inputMat->extras.end_offset - inputMat->extras.start_offset;
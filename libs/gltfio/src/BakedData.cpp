@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "BakedData.h"
+
+#include <utils/Hash.h>
+#include <utils/Log.h>
+#include <utils/Systrace.h>
+
+#include <string.h>
+
+using namespace utils;
+
+namespace gltfio {
+
+// Must be incremented whenever the way the baked data is produced changes, e.g. if TangentsJob
+// starts generating different quaternions.
+static constexpr uint32_t BAKED_DATA_VERSION = 1;
+
+static constexpr uint32_t BLOB_MAGIC = 0x42544c47; // "GLTB"
+
+// The blob starts with a header, followed by a table of items, then by the data of each item.
+struct BlobHeader {
+    uint32_t magic;
+    uint32_t itemCount;
+};
+
+struct BlobItem {
+    uint32_t section;
+    uint32_t index;
+    uint32_t subindex;
+    uint32_t padding;
+    uint64_t offset;
+    uint64_t size;
+};
+
+static size_t align8(size_t size) {
+    return (size + 7u) & ~size_t(7u);
+}
+
+BakedData::BakedData(filament::backend::Platform::BlobCache* cache, const cgltf_data* gltf)
+        : mCache(cache) {
+    if (!mCache) {
+        return;
+    }
+    SYSTRACE_CALL();
+
+    memcpy(mKey.tag, "gltfbake", sizeof(mKey.tag));
+    mKey.version = BAKED_DATA_VERSION;
+    mKey.jsonSize = gltf->json_size;
+    mKey.jsonHash = hash::murmur64(gltf->json, gltf->json_size);
+    uint64_t bufferHash = hash::murmur64(&gltf->buffers_count, sizeof(gltf->buffers_count));
+    for (cgltf_size i = 0, len = gltf->buffers_count; i < len; ++i) {
+        const cgltf_buffer& buffer = gltf->buffers[i];
+        bufferHash = hash::murmur64(&buffer.size, sizeof(buffer.size), bufferHash);
+        if (buffer.data) {
+            bufferHash = hash::murmur64(buffer.data, buffer.size, bufferHash);
+        }
+    }
+    mKey.bufferHash = bufferHash;
+
+    for (cgltf_size i = 0, len = gltf->meshes_count; i < len; ++i) {
+        const cgltf_mesh& mesh = gltf->meshes[i];
+        for (cgltf_size j = 0, n = mesh.primitives_count; j < n; ++j) {
+            mPrimitiveIds[&mesh.primitives[j]] = { uint32_t(i), uint32_t(j) };
+        }
+    }
+
+    const size_t size = mCache->retrieve(&mKey, sizeof(mKey), nullptr, 0);
+    if (size > 0) {
+        mBlob.resize(size);
+        if (mCache->retrieve(&mKey, sizeof(mKey), mBlob.data(), size) == size) {
+            parse();
+        }
+    }
+}
+
+void BakedData::parse() {
+    const size_t size = mBlob.size();
+    BlobHeader header;
+    if (size < sizeof(header)) {
+        return;
+    }
+    memcpy(&header, mBlob.data(), sizeof(header));
+    if (header.magic != BLOB_MAGIC ||
+            (size - sizeof(header)) / sizeof(BlobItem) < header.itemCount) {
+        slog.w << "Ignoring corrupted baked glTF data." << io::endl;
+        return;
+    }
+    const uint8_t* table = mBlob.data() + sizeof(header);
+    for (uint32_t i = 0; i < header.itemCount; ++i) {
+        BlobItem item;
+        memcpy(&item, table + i * sizeof(item), sizeof(item));
+        if (item.offset > size || item.size > size - item.offset) {
+            slog.w << "Ignoring corrupted baked glTF data." << io::endl;
+            mItems.clear();
+            return;
+        }
+        mItems[{ Section(item.section), item.index, item.subindex }] =
+                { mBlob.data() + item.offset, size_t(item.size) };
+    }
+}
+
+const void* BakedData::find(Section section, uint32_t index, uint32_t subindex,
+        size_t* size) const noexcept {
+    auto iter = mItems.find({ section, index, subindex });
+    if (iter == mItems.end()) {
+        return nullptr;
+    }
+    *size = iter->second.size;
+    return iter->second.data;
+}
+
+void BakedData::add(Section section, uint32_t index, uint32_t subindex,
+        const void* data, size_t size) {
+    if (!mCache) {
+        return;
+    }
+    // The vector of each item keeps its storage when mAddedData grows, so items remain valid.
+    auto bytes = (const uint8_t*) data;
+    mAddedData.emplace_back(bytes, bytes + size);
+    mItems[{ section, index, subindex }] = { mAddedData.back().data(), size };
+    mModified = true;
+}
+
+BakedData::PrimitiveId BakedData::getPrimitiveId(const cgltf_primitive* prim) const noexcept {
+    auto iter = mPrimitiveIds.find(prim);
+    return iter == mPrimitiveIds.end() ? PrimitiveId{} : iter->second;
+}
+
+void BakedData::store() {
+    if (!mCache || !mModified) {
+        return;
+    }
+    SYSTRACE_CALL();
+
+    size_t size = align8(sizeof(BlobHeader) + mItems.size() * sizeof(BlobItem));
+    for (auto const& [key, item] : mItems) {
+        size += align8(item.size);
+    }
+
+    std::vector<uint8_t> blob(size);
+    const BlobHeader header = { BLOB_MAGIC, uint32_t(mItems.size()) };
+    memcpy(blob.data(), &header, sizeof(header));
+    uint8_t* table = blob.data() + sizeof(header);
+    size_t offset = align8(sizeof(BlobHeader) + mItems.size() * sizeof(BlobItem));
+    for (auto const& [key, item] : mItems) {
+        const BlobItem entry = { uint32_t(key.section), key.index, key.subindex, 0,
+                uint64_t(offset), uint64_t(item.size) };
+        memcpy(table, &entry, sizeof(entry));
+        table += sizeof(entry);
+        memcpy(blob.data() + offset, item.data, item.size);
+        offset += align8(item.size);
+    }
+
+    mCache->insert(&mKey, sizeof(mKey), blob.data(), blob.size());
+    mModified = false;
+}
+
+} // namespace gltfio
@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GLTFIO_BAKED_DATA_H
+#define GLTFIO_BAKED_DATA_H
+
+#include <backend/Platform.h>
+
+#include <utils/Hash.h>
+
+#include <cgltf.h>
+
+#include <tsl/robin_map.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+namespace gltfio {
+
+// Holds the data that ResourceLoader derives from the source data of an asset, so that subsequent
+// loads of the same asset can skip that work, see ResourceConfiguration::cache.
+//
+// All the data of an asset is stored as a single blob, keyed by a hash of its JSON and of all its
+// buffers. Each item in the blob is identified by a section and by the indices of the glTF object
+// that it belongs to. Items are looked up with find() and added with add() while the asset is being
+// loaded, then store() writes the blob back to the cache if anything was added.
+//
+// Without a cache, find() always fails and add() does nothing.
+class BakedData {
+public:
+    enum class Section : uint32_t {
+        MESHOPT_VIEW,   // decoded data of a buffer view, by buffer view index
+        DRACO_ACCESSOR, // decoded data of an accessor, by accessor index
+        TANGENTS,       // short4 quaternions of a primitive, by mesh and primitive index
+        BOUNDS,         // object-space Aabb of an unskinned primitive, by mesh and primitive index
+    };
+
+    // Identifies a primitive by the index of its mesh and its index in the mesh.
+    struct PrimitiveId {
+        uint32_t mesh;
+        uint32_t primitive;
+    };
+
+    // Loads the items of the given asset from the cache. The buffers of the asset must be loaded.
+    BakedData(filament::backend::Platform::BlobCache* cache, const cgltf_data* gltf);
+
+    BakedData(BakedData const&) = delete;
+    BakedData& operator=(BakedData const&) = delete;
+
+    // Returns the data of an item, or null if there is no such item.
+    const void* find(Section section, uint32_t index, uint32_t subindex,
+            size_t* size) const noexcept;
+
+    // Adds an item, its data is copied.
+    void add(Section section, uint32_t index, uint32_t subindex, const void* data, size_t size);
+
+    // Writes all the items back to the cache if some have been added.
+    void store();
+
+    PrimitiveId getPrimitiveId(const cgltf_primitive* prim) const noexcept;
+
+private:
+    struct ItemKey {
+        Section section;
+        uint32_t index;
+        uint32_t subindex;
+        bool operator==(ItemKey const& rhs) const noexcept {
+            return section == rhs.section && index == rhs.index && subindex == rhs.subindex;
+        }
+    };
+
+    struct ItemKeyHash {
+        size_t operator()(ItemKey const& key) const noexcept {
+            const uint32_t words[] = { uint32_t(key.section), key.index, key.subindex };
+            return size_t(utils::hash::murmur3(words, 3, 0));
+        }
+    };
+
+    struct Item {
+        const uint8_t* data;
+        size_t size;
+    };
+
+    // The key of the asset in the cache.
+    struct BlobKey {
+        char tag[8];
+        uint32_t version;
+        uint32_t padding;
+        uint64_t jsonSize;
+        uint64_t jsonHash;
+        uint64_t bufferHash;
+    };
+
+    void parse();
+
+    filament::backend::Platform::BlobCache* const mCache;
+    BlobKey mKey = {};
+    std::vector<uint8_t> mBlob;
+    std::vector<std::vector<uint8_t>> mAddedData;
+    tsl::robin_map<ItemKey, Item, ItemKeyHash> mItems;
+    tsl::robin_map<const cgltf_primitive*, PrimitiveId> mPrimitiveIds;
+    bool mModified = false;
+};
+
+} // namespace gltfio
+
+#endif // GLTFIO_BAKED_DATA_H
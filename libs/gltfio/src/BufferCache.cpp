@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "BufferCache.h"
+
+#include <utils/Hash.h>
+#include <utils/debug.h>
+
+#include <string.h>
+
+using namespace filament;
+
+namespace gltfio {
+
+static constexpr uint32_t KIND_BUFFER_OBJECT = 0;
+
+static uint32_t getIndexBufferKind(IndexBuffer::IndexType type) {
+    return 1 + uint32_t(type);
+}
+
+BufferCache::~BufferCache() noexcept {
+    // The assets that hold references keep the cache alive, so they have all been released.
+    assert_invariant(mEntries.empty());
+}
+
+BufferCache::Key BufferCache::getKey(const void* data, size_t size) noexcept {
+    return { utils::hash::murmur64(data, size), uint32_t(size), KIND_BUFFER_OBJECT };
+}
+
+BufferCache::Key BufferCache::getKey(const void* data, size_t size,
+        IndexBuffer::IndexType type) noexcept {
+    return { utils::hash::murmur64(data, size), uint32_t(size), getIndexBufferKind(type) };
+}
+
+BufferObject* BufferCache::acquireBufferObject(Key const& key, const void* data) noexcept {
+    assert_invariant(key.kind == KIND_BUFFER_OBJECT);
+    return (BufferObject*) acquire(key, data);
+}
+
+IndexBuffer* BufferCache::acquireIndexBuffer(Key const& key, const void* data) noexcept {
+    assert_invariant(key.kind != KIND_BUFFER_OBJECT);
+    return (IndexBuffer*) acquire(key, data);
+}
+
+bool BufferCache::addBufferObject(Key const& key, const void* data,
+        BufferObject* bufferObject) noexcept {
+    assert_invariant(key.kind == KIND_BUFFER_OBJECT);
+    return add(key, data, bufferObject);
+}
+
+bool BufferCache::addIndexBuffer(Key const& key, const void* data,
+        IndexBuffer* indexBuffer) noexcept {
+    assert_invariant(key.kind != KIND_BUFFER_OBJECT);
+    return add(key, data, indexBuffer);
+}
+
+void BufferCache::release(BufferObject* bufferObject) noexcept {
+    if (release((void*) bufferObject)) {
+        mEngine->destroy(bufferObject);
+    }
+}
+
+void BufferCache::release(IndexBuffer* indexBuffer) noexcept {
+    if (release((void*) indexBuffer)) {
+        mEngine->destroy(indexBuffer);
+    }
+}
+
+void* BufferCache::acquire(Key const& key, const void* data) noexcept {
+    auto iter = mEntries.find(key);
+    if (iter == mEntries.end()) {
+        return nullptr;
+    }
+    // The hash can collide, only identical data is shared.
+    if (memcmp(iter->second.data.get(), data, key.size) != 0) {
+        return nullptr;
+    }
+    iter.value().references++;
+    return iter->second.buffer;
+}
+
+bool BufferCache::add(Key const& key, const void* data, void* buffer) noexcept {
+    if (mEntries.find(key) != mEntries.end()) {
+        return false;
+    }
+    std::unique_ptr<uint8_t[]> copy(new uint8_t[key.size]);
+    memcpy(copy.get(), data, key.size);
+    mEntries[key] = { buffer, 1, std::move(copy) };
+    mKeys[buffer] = key;
+    return true;
+}
+
+bool BufferCache::release(void* buffer) noexcept {
+    auto keyIter = mKeys.find(buffer);
+    assert_invariant(keyIter != mKeys.end());
+    auto iter = mEntries.find(keyIter->second);
+    if (--iter.value().references > 0) {
+        return false;
+    }
+    mEntries.erase(iter);
+    mKeys.erase(keyIter);
+    return true;
+}
+
+} // namespace gltfio
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GLTFIO_BUFFER_CACHE_H
+#define GLTFIO_BUFFER_CACHE_H
+
+#include <filament/BufferObject.h>
+#include <filament/Engine.h>
+#include <filament/IndexBuffer.h>
+
+#include <tsl/robin_map.h>
+
+#include <memory>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace gltfio {
+
+// Shares the GPU buffers holding vertex and index data between the assets created by a given
+// AssetLoader, see AssetConfiguration::shareBuffers.
+//
+// Buffers are identified by a hash of their contents, so identical data is uploaded only once even
+// when it comes from separate files. The cache keeps a copy of the data of each buffer, which is
+// compared to the data being uploaded, so that a hash collision never shares different data.
+// Each asset holds one reference per buffer that it acquired or added, and releases them when it
+// is destroyed. The last release destroys the buffer.
+//
+// This is not thread safe, it must be used from the thread that owns the Engine.
+class BufferCache {
+public:
+    struct Key {
+        uint64_t hash;
+        uint32_t size;
+        uint32_t kind; // a BufferObject or an IndexBuffer of a given IndexType
+        bool operator==(Key const& rhs) const noexcept {
+            return hash == rhs.hash && size == rhs.size && kind == rhs.kind;
+        }
+    };
+
+    explicit BufferCache(filament::Engine* engine) noexcept : mEngine(engine) {}
+    ~BufferCache() noexcept;
+
+    BufferCache(BufferCache const&) = delete;
+    BufferCache& operator=(BufferCache const&) = delete;
+
+    static Key getKey(const void* data, size_t size) noexcept;
+    static Key getKey(const void* data, size_t size, filament::IndexBuffer::IndexType type) noexcept;
+
+    // Returns the buffer that holds the given data and adds a reference to it, or null if there
+    // is none. The key must have been computed from the data.
+    filament::BufferObject* acquireBufferObject(Key const& key, const void* data) noexcept;
+    filament::IndexBuffer* acquireIndexBuffer(Key const& key, const void* data) noexcept;
+
+    // Transfers the ownership of a buffer that holds the given data to the cache, the caller gets
+    // the first reference to it. Returns false if the cache already holds different data with the
+    // same key, in which case the buffer isn't shared and the caller keeps its ownership.
+    bool addBufferObject(Key const& key, const void* data,
+            filament::BufferObject* bufferObject) noexcept;
+    bool addIndexBuffer(Key const& key, const void* data,
+            filament::IndexBuffer* indexBuffer) noexcept;
+
+    void release(filament::BufferObject* bufferObject) noexcept;
+    void release(filament::IndexBuffer* indexBuffer) noexcept;
+
+    size_t getBufferCount() const noexcept { return mEntries.size(); }
+
+private:
+    struct KeyHash {
+        size_t operator()(Key const& key) const noexcept { return size_t(key.hash); }
+    };
+
+    struct Entry {
+        void* buffer;
+        uint32_t references;
+        std::unique_ptr<uint8_t[]> data; // copy of the contents of the buffer, key.size bytes
+    };
+
+    void* acquire(Key const& key, const void* data) noexcept;
+    bool add(Key const& key, const void* data, void* buffer) noexcept;
+    bool release(void* buffer) noexcept;
+
+    filament::Engine* const mEngine;
+    tsl::robin_map<Key, Entry, KeyHash> mEntries;
+    tsl::robin_map<const void*, Key> mKeys;
+};
+
+} // namespace gltfio
+
+#endif // GLTFIO_BUFFER_CACHE_H
@@ -32,6 +32,12 @@ using namespace utils;
 
 namespace gltfio {
 
+DracoCache::~DracoCache() {
+    for (auto& buffer : mBuffers) {
+        free(buffer->data);
+    }
+}
+
 DracoMesh* DracoCache::findOrCreateMesh(const cgltf_buffer_view* key) {
     auto iter = mCache.find(key);
     if (iter != mCache.end()) {
@@ -44,6 +50,25 @@ DracoMesh* DracoCache::findOrCreateMesh(const cgltf_buffer_view* key) {
     return mesh;
 }
 
+bool DracoCache::hasMesh(const cgltf_buffer_view* key) const {
+    return mCache.find(key) != mCache.end();
+}
+
+void DracoCache::addMesh(const cgltf_buffer_view* key, DracoMesh* mesh) {
+    mCache.emplace(key, mesh);
+}
+
+void DracoCache::attach(cgltf_accessor* accessor, void* data, size_t size) {
+    cgltf_buffer_view* view = new cgltf_buffer_view;
+    cgltf_buffer* buffer = new cgltf_buffer;
+    mViews.emplace_back(view);
+    mBuffers.emplace_back(buffer);
+    *buffer = { nullptr, size, nullptr, data };
+    *view = { nullptr, buffer, 0, size, 0, cgltf_buffer_view_type_invalid };
+    accessor->offset = 0;
+    accessor->buffer_view = view;
+}
+
 DracoMesh::DracoMesh(struct DracoMeshDetails* details) : mDetails(details) {}
 
 #if GLTFIO_DRACO_SUPPORTED
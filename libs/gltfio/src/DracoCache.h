@@ -22,6 +22,7 @@
 #include <tsl/robin_map.h>
 
 #include <memory>
+#include <vector>
 
 #ifndef GLTFIO_DRACO_SUPPORTED
 #define GLTFIO_DRACO_SUPPORTED 0
@@ -37,9 +38,25 @@ class DracoMesh;
 // avoid duplicated work when a single Draco mesh is referenced from multiple primitives.
 class DracoCache {
 public:
+    ~DracoCache();
+
     DracoMesh* findOrCreateMesh(const cgltf_buffer_view* key);
+
+    // Returns true if the mesh of the given buffer view has already been decoded (or has failed
+    // to decode).
+    bool hasMesh(const cgltf_buffer_view* key) const;
+
+    // Adds a mesh decoded with DracoMesh::decode (which can be null), and takes ownership of it.
+    // This allows meshes to be decoded concurrently, outside of the cache.
+    void addMesh(const cgltf_buffer_view* key, DracoMesh* mesh);
+
+    // Points the given accessor to data that has already been decoded, e.g. during a previous load
+    // of the asset, and takes ownership of the data, which must be allocated with malloc.
+    void attach(cgltf_accessor* accessor, void* data, size_t size);
 private:
     tsl::robin_map<const cgltf_buffer_view*, std::unique_ptr<DracoMesh>> mCache;
+    std::vector<std::unique_ptr<cgltf_buffer_view>> mViews;
+    std::vector<std::unique_ptr<cgltf_buffer>> mBuffers;
 };
 
 // Decodes a Draco mesh upon construction and retains the results.
@@ -39,13 +39,16 @@
 #include <cgltf.h>
 
 #include "upcast.h"
+#include "BufferCache.h"
 #include "DependencyGraph.h"
 #include "DracoCache.h"
+#include "MeshoptCache.h"
 #include "FFilamentInstance.h"
 
 #include <tsl/robin_map.h>
 #include <tsl/htrie_map.h>
 
+#include <memory>
 #include <vector>
 
 #ifdef NDEBUG
@@ -74,6 +77,7 @@ struct BufferSlot {
     int bufferIndex; // for vertex buffers only
     filament::VertexBuffer* vertexBuffer;
     filament::IndexBuffer* indexBuffer;
+    bool packed; // for vertex buffers only, the data goes to the packed BufferObject
 };
 
 // Encapsulates a connection between Texture and MaterialInstance.
@@ -95,11 +99,38 @@ struct TextureSlot {
 struct Primitive {
     filament::VertexBuffer* vertices = nullptr;
     filament::IndexBuffer* indices = nullptr;
+    uint32_t indexOffset = 0; // non-zero only if the indices are packed
+    uint32_t indexCount = 0;
     filament::Aabb aabb; // object-space bounding box
     UvMap uvmap; // mapping from each glTF UV set to either UV0 or UV1 (8 bytes)
 };
 using MeshCache = tsl::robin_map<const cgltf_mesh*, std::vector<Primitive>>;
 
+// Maps a node with the MSFT_lod extension to the meshes of all its levels of detail, starting with
+// its own mesh.
+using LodMeshes = tsl::robin_map<const cgltf_node*, std::vector<const cgltf_mesh*>>;
+
+// Identifies a primitive of a renderable. These are only recorded if the asset shares its buffers,
+// which allows ResourceLoader to switch renderables to a shared IndexBuffer.
+struct RenderablePrimitive {
+    utils::Entity entity;
+    uint32_t index;
+    filament::RenderableManager::PrimitiveType type;
+    const Primitive* primitive;
+};
+
+// Packed buffers
+// --------------
+// With AssetConfiguration::packingThreshold, the data of small accessors is packed into a single
+// vertex BufferObject and into one IndexBuffer per index type. These maps give the location of each
+// packed accessor, in bytes for vertex data and in indices for index data.
+struct PackedIndices {
+    uint32_t buffer; // 0 for USHORT, 1 for UINT
+    uint32_t offset;
+};
+using PackedVertexMap = tsl::robin_map<const cgltf_accessor*, uint32_t>;
+using PackedIndexMap = tsl::robin_map<const cgltf_accessor*, PackedIndices>;
+
 // MatInstanceCache
 // ----------------
 // Each glTF material definition corresponds to a single filament::MaterialInstance, which are
@@ -229,6 +260,9 @@ struct FFilamentAsset : public FilamentAsset {
         return mInstances.size() > 0;
     }
 
+    void shareIndexBuffers(
+            tsl::robin_map<filament::IndexBuffer*, filament::IndexBuffer*> const& sharedBuffers);
+
     filament::Engine* mEngine;
     utils::NameComponentManager* mNameManager;
     utils::EntityManager* mEntityManager;
@@ -240,6 +274,11 @@ struct FFilamentAsset : public FilamentAsset {
     std::vector<filament::BufferObject*> mBufferObjects;
     std::vector<filament::IndexBuffer*> mIndexBuffers;
     std::vector<filament::Texture*> mTextures;
+    std::shared_ptr<BufferCache> mBufferCache; // null unless buffers are shared
+    std::vector<filament::BufferObject*> mSharedBufferObjects;
+    std::vector<filament::IndexBuffer*> mSharedIndexBuffers;
+    filament::IndexBuffer* mPackedIndexBuffers[2] = {};
+    uint32_t mPackedVertexSize = 0;
     filament::Aabb mBoundingBox;
     utils::Entity mRoot;
     std::vector<FFilamentInstance*> mInstances;
@@ -263,6 +302,7 @@ struct FFilamentAsset : public FilamentAsset {
         ~SourceAsset() { cgltf_free(hierarchy); }
         cgltf_data* hierarchy;
         DracoCache dracoCache;
+        MeshoptCache meshoptCache;
         utils::FixedCapacityVector<uint8_t> glbData;
     };
 
@@ -280,6 +320,10 @@ struct FFilamentAsset : public FilamentAsset {
     std::vector<std::pair<const cgltf_primitive*, filament::VertexBuffer*> > mPrimitives;
     MatInstanceCache mMatInstanceCache;
     MeshCache mMeshCache;
+    LodMeshes mLodMeshes;
+    std::vector<RenderablePrimitive> mRenderablePrimitives;
+    PackedVertexMap mPackedVertices;
+    PackedIndexMap mPackedIndices;
 };
 
 FILAMENT_UPCAST(FilamentAsset)
@@ -72,6 +72,57 @@ FFilamentAsset::~FFilamentAsset() {
     for (auto tx : mTextures) {
         mEngine->destroy(tx);
     }
+    for (auto bo : mSharedBufferObjects) {
+        mBufferCache->release(bo);
+    }
+    for (auto ib : mSharedIndexBuffers) {
+        mBufferCache->release(ib);
+    }
+}
+
+// Switches the renderables from the index buffers of this asset to the shared index buffers that
+// replace them. The replaced buffers are destroyed, and the references to the shared ones are now
+// held by the asset. An index buffer that is replaced by itself has just been added to the cache.
+void FFilamentAsset::shareIndexBuffers(
+        tsl::robin_map<IndexBuffer*, IndexBuffer*> const& sharedBuffers) {
+    if (sharedBuffers.empty()) {
+        return;
+    }
+
+    RenderableManager& rm = mEngine->getRenderableManager();
+    for (RenderablePrimitive const& rp : mRenderablePrimitives) {
+        const Primitive* prim = rp.primitive;
+        auto iter = sharedBuffers.find(prim->indices);
+        if (iter != sharedBuffers.end() && iter->second != iter->first) {
+            rm.setGeometryAt(rm.getInstance(rp.entity), rp.index, rp.type, prim->vertices,
+                    iter->second, prim->indexOffset, prim->indexCount);
+        }
+    }
+
+    // Instances that are added later on get their geometry from the mesh cache.
+    for (auto iter = mMeshCache.begin(); iter != mMeshCache.end(); ++iter) {
+        for (Primitive& prim : iter.value()) {
+            auto shared = sharedBuffers.find(prim.indices);
+            if (shared != sharedBuffers.end()) {
+                prim.indices = shared->second;
+            }
+        }
+    }
+
+    std::vector<IndexBuffer*> indexBuffers;
+    for (IndexBuffer* ib : mIndexBuffers) {
+        auto iter = sharedBuffers.find(ib);
+        if (iter == sharedBuffers.end()) {
+            indexBuffers.push_back(ib);
+        } else if (iter->second != ib) {
+            mEngine->destroy(ib);
+        }
+    }
+    mIndexBuffers.swap(indexBuffers);
+
+    for (auto const& [ib, shared] : sharedBuffers) {
+        mSharedIndexBuffers.push_back(shared);
+    }
 }
 
 const char* FFilamentAsset::getExtras(utils::Entity entity) const noexcept {
@@ -118,11 +169,15 @@ void FFilamentAsset::releaseSourceData() noexcept {
     // operation that merely frees the storage for the items.
     mMatInstanceCache = {};
     mMeshCache = {};
+    mLodMeshes = {};
     mResourceUris = {};
     mNodeMap = {};
     mPrimitives = {};
     mBufferSlots = {};
     mTextureSlots = {};
+    mRenderablePrimitives = {};
+    mPackedVertices = {};
+    mPackedIndices = {};
     mSourceAsset.reset();
     for (FFilamentInstance* instance : mInstances) {
         instance->nodeMap = {};
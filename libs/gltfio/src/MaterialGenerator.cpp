@@ -18,27 +18,53 @@
 
 #include <filamat/MaterialBuilder.h>
 
+#include <filament/MaterialEnums.h>
+
 #include <utils/Hash.h>
+#include <utils/JobSystem.h>
 
 #include <tsl/robin_map.h>
 
+#include <string.h>
+
 #include <string>
+#include <vector>
 
 using namespace filamat;
 using namespace filament;
 using namespace gltfio;
 using namespace utils;
 
+using BlobCache = filament::backend::Platform::BlobCache;
+
 namespace {
 
+// Key of a material package in the blob cache. It includes the hash of the generated shader, so
+// that the cached packages are invalidated when the code generation changes.
+struct PackageKey {
+    char tag[8];
+    uint64_t shaderHash;
+    uint32_t materialVersion;
+    uint8_t targetApi;
+    bool optimizeShaders;
+    uint8_t padding[2];
+    MaterialKey config;
+    UvMap uvmap;
+};
+
+static constexpr char PACKAGE_KEY_TAG[8] = "gltfmat";
+
 class MaterialGenerator : public MaterialProvider {
 public:
-    explicit MaterialGenerator(Engine* engine, bool optimizeShaders);
+    explicit MaterialGenerator(Engine* engine, bool optimizeShaders, BlobCache* cache);
     ~MaterialGenerator() override;
 
     MaterialInstance* createMaterialInstance(MaterialKey* config, UvMap* uvmap,
             const char* label, const char* extras) override;
 
+    void prepareMaterials(const MaterialKey* configs, const char* const* labels,
+            size_t count) override;
+
     size_t getMaterialsCount() const noexcept override;
     const Material* const* getMaterials() const noexcept override;
     void destroyMaterials() override;
@@ -47,15 +73,30 @@ public:
         return false;
     }
 
+    bool getOptimizeShaders() const noexcept {
+#ifndef NDEBUG
+        return false;
+#else
+        return mOptimizeShaders;
+#endif
+    }
+
+    PackageKey getPackageKey(const MaterialKey& config, const UvMap& uvmap,
+            const std::string& shader) const noexcept;
+    Package retrievePackage(const PackageKey& key) const;
+    void insertPackage(const PackageKey& key, const Package& package) const;
+    Material* addMaterial(const MaterialKey& config, const Package& package);
+
     using HashFn = hash::MurmurHashFn<MaterialKey>;
     tsl::robin_map<MaterialKey, Material*, HashFn> mCache;
     std::vector<Material*> mMaterials;
     Engine* const mEngine;
+    BlobCache* const mBlobCache;
     const bool mOptimizeShaders;
 };
 
-MaterialGenerator::MaterialGenerator(Engine* engine, bool optimizeShaders) : mEngine(engine),
-        mOptimizeShaders(optimizeShaders) {
+MaterialGenerator::MaterialGenerator(Engine* engine, bool optimizeShaders, BlobCache* cache)
+        : mEngine(engine), mBlobCache(cache), mOptimizeShaders(optimizeShaders) {
     MaterialBuilder::init();
 }
 
@@ -309,10 +350,16 @@ std::string shaderFromKey(const MaterialKey& config) {
     return shader;
 }
 
-static Material* createMaterial(Engine* engine, const MaterialKey& config, const UvMap& uvmap,
-        const char* name, bool optimizeShaders) {
+static std::string createShader(const MaterialKey& config, const UvMap& uvmap) {
     std::string shader = shaderFromKey(config);
     processShaderString(&shader, uvmap, config);
+    return shader;
+}
+
+// This is thread safe, as long as the engine's JobSystem is used from the engine's thread or from
+// one of its jobs.
+static Package createPackage(Engine* engine, const MaterialKey& config, const UvMap& uvmap,
+        const std::string& shader, const char* name, bool optimizeShaders) {
     MaterialBuilder builder = MaterialBuilder()
             .name(name)
             .flipUV(false)
@@ -528,8 +575,52 @@ static Material* createMaterial(Engine* engine, const MaterialKey& config, const
         builder.shading(Shading::LIT);
     }
 
-    Package pkg = builder.build(engine->getJobSystem());
-    return Material::Builder().package(pkg.getData(), pkg.getSize()).build(*engine);
+    return builder.build(engine->getJobSystem());
+}
+
+PackageKey MaterialGenerator::getPackageKey(const MaterialKey& config, const UvMap& uvmap,
+        const std::string& shader) const noexcept {
+    PackageKey key;
+    // the key is hashed and compared as raw bytes, make sure the padding is cleared
+    memset(&key, 0, sizeof(key));
+    memcpy(key.tag, PACKAGE_KEY_TAG, sizeof(key.tag));
+    key.shaderHash = hash::fnv1a(shader.data(), shader.size());
+    key.materialVersion = uint32_t(MATERIAL_VERSION);
+    key.targetApi = uint8_t(filamat::targetApiFromBackend(mEngine->getBackend()));
+    key.optimizeShaders = getOptimizeShaders();
+    key.config = config;
+    key.uvmap = uvmap;
+    return key;
+}
+
+Package MaterialGenerator::retrievePackage(const PackageKey& key) const {
+    if (!mBlobCache) {
+        return Package::invalidPackage();
+    }
+    const size_t size = mBlobCache->retrieve(&key, sizeof(key), nullptr, 0);
+    if (!size) {
+        return Package::invalidPackage();
+    }
+    Package package(size);
+    if (mBlobCache->retrieve(&key, sizeof(key), package.getData(), size) != size) {
+        // the blob was evicted or replaced in the meantime
+        return Package::invalidPackage();
+    }
+    return package;
+}
+
+void MaterialGenerator::insertPackage(const PackageKey& key, const Package& package) const {
+    if (mBlobCache && package.isValid()) {
+        mBlobCache->insert(&key, sizeof(key), package.getData(), package.getSize());
+    }
+}
+
+Material* MaterialGenerator::addMaterial(const MaterialKey& config, const Package& package) {
+    Material* mat = Material::Builder().package(package.getData(), package.getSize())
+            .build(*mEngine);
+    mCache.emplace(std::make_pair(config, mat));
+    mMaterials.push_back(mat);
+    return mat;
 }
 
 MaterialInstance* MaterialGenerator::createMaterialInstance(MaterialKey* config, UvMap* uvmap,
@@ -537,26 +628,91 @@ MaterialInstance* MaterialGenerator::createMaterialInstance(MaterialKey* config,
     constrainMaterial(config, uvmap);
     auto iter = mCache.find(*config);
     if (iter == mCache.end()) {
-
-        bool optimizeShaders = mOptimizeShaders;
-#ifndef NDEBUG
-        optimizeShaders = false;
-#endif
-
-        Material* mat = createMaterial(mEngine, *config, *uvmap, label, optimizeShaders);
-        mCache.emplace(std::make_pair(*config, mat));
-        mMaterials.push_back(mat);
+        const std::string shader = createShader(*config, *uvmap);
+        const PackageKey key = getPackageKey(*config, *uvmap, shader);
+        Package package = retrievePackage(key);
+        if (!package.isValid()) {
+            package = createPackage(mEngine, *config, *uvmap, shader, label, getOptimizeShaders());
+            insertPackage(key, package);
+        }
+        Material* mat = addMaterial(*config, package);
         return mat->createInstance(label);
     }
     return iter->second->createInstance(label);
 }
 
+void MaterialGenerator::prepareMaterials(const MaterialKey* configs, const char* const* labels,
+        size_t count) {
+    struct PendingMaterial {
+        MaterialKey config;
+        UvMap uvmap;
+        const char* label;
+        std::string shader;
+        PackageKey key;
+        Package package;
+    };
+
+    // Gather the materials that are neither loaded nor in the blob cache. Note that the name of a
+    // material is the label it was first built with, the label is not part of the cache key.
+    std::vector<PendingMaterial> pending;
+    tsl::robin_map<MaterialKey, size_t, HashFn> pendingIndices;
+    for (size_t i = 0; i < count; i++) {
+        MaterialKey config = configs[i];
+        UvMap uvmap {};
+        constrainMaterial(&config, &uvmap);
+        if (mCache.find(config) != mCache.end() ||
+                pendingIndices.find(config) != pendingIndices.end()) {
+            continue;
+        }
+        std::string shader = createShader(config, uvmap);
+        const PackageKey key = getPackageKey(config, uvmap, shader);
+        Package package = retrievePackage(key);
+        if (package.isValid()) {
+            addMaterial(config, package);
+            continue;
+        }
+        const char* label = labels && labels[i] ? labels[i] : "material";
+        pendingIndices[config] = pending.size();
+        pending.push_back({ config, uvmap, label, std::move(shader), key });
+    }
+
+    if (pending.empty()) {
+        return;
+    }
+
+    // Building a package is where virtually all the time goes, so build them concurrently. Only
+    // the creation of the filament materials needs to happen on the engine's thread.
+    // glslang performs unguarded global operations on first use, so, like matc's batch mode, the
+    // first package is built on its own before the others start.
+    const bool optimizeShaders = getOptimizeShaders();
+    auto build = [this, optimizeShaders](PendingMaterial& material) {
+        material.package = createPackage(mEngine, material.config, material.uvmap,
+                material.shader, material.label, optimizeShaders);
+    };
+    build(pending[0]);
+    if (pending.size() > 1) {
+        JobSystem& js = mEngine->getJobSystem();
+        JobSystem::Job* parent = js.createJob();
+        for (size_t i = 1; i < pending.size(); i++) {
+            PendingMaterial& material = pending[i];
+            js.run(jobs::createJob(js, parent, [&build, &material]() { build(material); }));
+        }
+        js.runAndWait(parent);
+    }
+
+    for (PendingMaterial const& material : pending) {
+        insertPackage(material.key, material.package);
+        addMaterial(material.config, material.package);
+    }
+}
+
 } // anonymous namespace
 
 namespace gltfio {
 
-MaterialProvider* createMaterialGenerator(filament::Engine* engine, bool optimizeShaders) {
-    return new MaterialGenerator(engine, optimizeShaders);
+MaterialProvider* createMaterialGenerator(filament::Engine* engine, bool optimizeShaders,
+        BlobCache* cache) {
+    return new MaterialGenerator(engine, optimizeShaders, cache);
 }
 
 } // namespace gltfio
@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "MeshoptCache.h"
+
+#include <meshoptimizer.h>
+
+#include <utils/Log.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include <stdlib.h>
+#include <string.h>
+
+using namespace utils;
+
+namespace gltfio {
+
+// The filters below are applied after decoding attributes, they are specified by
+// EXT_meshopt_compression.
+
+// Each vertex holds 4 signed normalized components: the octahedral encoding of a unit vector
+// scaled by the third component, and a fourth component that is kept as is.
+template<typename T>
+static void decodeOctahedralFilter(T* data, size_t count) {
+    const float max = float((1 << (sizeof(T) * 8 - 1)) - 1);
+    for (size_t i = 0; i < count; i++, data += 4) {
+        const float one = data[2];
+        float x = float(data[0]) / one;
+        float y = float(data[1]) / one;
+        float z = 1.0f - std::abs(x) - std::abs(y);
+
+        // fix up the lower hemisphere
+        const float t = std::max(-z, 0.0f);
+        x -= (x >= 0.0f) ? t : -t;
+        y -= (y >= 0.0f) ? t : -t;
+
+        const float s = max / std::sqrt(x * x + y * y + z * z);
+        data[0] = T(std::round(x * s));
+        data[1] = T(std::round(y * s));
+        data[2] = T(std::round(z * s));
+    }
+}
+
+// Each vertex holds 3 components of a unit quaternion, the fourth one being recovered from them.
+// The last component holds the index of the recovered component in its 2 low bits, and the scale
+// of the other components in the remaining bits.
+static void decodeQuaternionFilter(int16_t* data, size_t count) {
+    const float range = 1.0f / std::sqrt(2.0f);
+    for (size_t i = 0; i < count; i++, data += 4) {
+        const float scale = range / float(data[3] | 3);
+        const float x = float(data[0]) * scale;
+        const float y = float(data[1]) * scale;
+        const float z = float(data[2]) * scale;
+        const float w = std::sqrt(std::max(1.0f - x * x - y * y - z * z, 0.0f));
+
+        const int qc = data[3] & 3;
+        const float s = 32767.0f;
+        data[(qc + 1) & 3] = int16_t(std::round(x * s));
+        data[(qc + 2) & 3] = int16_t(std::round(y * s));
+        data[(qc + 3) & 3] = int16_t(std::round(z * s));
+        data[qc] = int16_t(std::round(w * s));
+    }
+}
+
+// Each component is a 24-bit signed mantissa and an 8-bit signed exponent, decoded to a float.
+static void decodeExponentialFilter(int32_t* data, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        const int32_t v = data[i];
+        const int32_t e = v >> 24;
+        const int32_t m = int32_t(uint32_t(v) << 8) >> 8;
+        const float r = std::ldexp(float(m), e);
+        memcpy(&data[i], &r, sizeof(r));
+    }
+}
+
+void* MeshoptCache::decode(const cgltf_buffer_view* view) {
+    const cgltf_meshopt_compression& mc = view->meshopt_compression;
+    const cgltf_buffer* source = mc.buffer;
+    if (!source || !source->data || mc.offset + mc.size > source->size) {
+        slog.e << "Missing EXT_meshopt_compression data." << io::endl;
+        return nullptr;
+    }
+
+    const uint8_t* src = (const uint8_t*) source->data + mc.offset;
+    void* dst = malloc(mc.count * mc.stride);
+
+    int result = -1;
+    switch (mc.mode) {
+        case cgltf_meshopt_compression_mode_attributes:
+            result = meshopt_decodeVertexBuffer(dst, mc.count, mc.stride, src, mc.size);
+            break;
+        case cgltf_meshopt_compression_mode_triangles:
+            // The meshoptimizer in third_party predates version 1 of the index codec, which
+            // recent encoders use by default. The version is in the low bits of the header.
+            if (mc.size > 0 && (src[0] & 0x0f) > 0) {
+                slog.e << "Unsupported EXT_meshopt_compression index codec version "
+                        << int(src[0] & 0x0f) << "." << io::endl;
+                free(dst);
+                return nullptr;
+            }
+            result = meshopt_decodeIndexBuffer(dst, mc.count, mc.stride, src, mc.size);
+            break;
+        case cgltf_meshopt_compression_mode_indices:
+        case cgltf_meshopt_compression_mode_invalid:
+            slog.e << "Unsupported EXT_meshopt_compression mode." << io::endl;
+            free(dst);
+            return nullptr;
+    }
+
+    if (result != 0) {
+        slog.e << "Cannot decompress buffer, meshopt decoding error." << io::endl;
+        free(dst);
+        return nullptr;
+    }
+
+    switch (mc.filter) {
+        case cgltf_meshopt_compression_filter_none:
+            break;
+        case cgltf_meshopt_compression_filter_octahedral:
+            if (mc.stride == 4) {
+                decodeOctahedralFilter((int8_t*) dst, mc.count);
+            } else {
+                decodeOctahedralFilter((int16_t*) dst, mc.count);
+            }
+            break;
+        case cgltf_meshopt_compression_filter_quaternion:
+            decodeQuaternionFilter((int16_t*) dst, mc.count);
+            break;
+        case cgltf_meshopt_compression_filter_exponential:
+            decodeExponentialFilter((int32_t*) dst, mc.count * mc.stride / 4);
+            break;
+    }
+    return dst;
+}
+
+void MeshoptCache::attach(cgltf_buffer_view* view, void* data) {
+    // cgltf frees the data of buffer views, and reads it in lieu of the buffer's data.
+    view->data = data;
+
+    cgltf_buffer* buffer = new cgltf_buffer {};
+    buffer->size = view->size;
+    buffer->data = data;
+    mBuffers.emplace_back(buffer);
+
+    view->buffer = buffer;
+    view->offset = 0;
+    view->has_meshopt_compression = false;
+}
+
+} // namespace gltfio
@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GLTFIO_MESHOPT_CACHE_H
+#define GLTFIO_MESHOPT_CACHE_H
+
+#include <cgltf.h>
+
+#include <memory>
+#include <vector>
+
+namespace gltfio {
+
+// Manages the buffer views compressed with EXT_meshopt_compression.
+//
+// Decoding happens in two steps: decode() can be called concurrently for different buffer views,
+// then attach() redirects each buffer view to its decoded data. After that, the rest of the loader
+// can read the buffer view like any other, through its buffer.
+//
+// The decoded data is owned by the buffer view (cgltf frees it), this only owns the buffers that
+// wrap it.
+class MeshoptCache {
+public:
+    // Decodes the compressed data of the given buffer view and returns it, or null if an error
+    // occurs. The result is allocated with malloc. Thread safe.
+    static void* decode(const cgltf_buffer_view* view);
+
+    // Takes ownership of data returned by decode() and redirects the buffer view to it.
+    void attach(cgltf_buffer_view* view, void* data);
+
+private:
+    std::vector<std::unique_ptr<cgltf_buffer>> mBuffers;
+};
+
+} // namespace gltfio
+
+#endif // GLTFIO_MESHOPT_CACHE_H
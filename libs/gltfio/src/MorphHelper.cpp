@@ -49,13 +49,25 @@ static bool isSubsetOf(ubyte4 a, ubyte4 b) {
 MorphHelper::MorphHelper(FFilamentAsset* asset, FFilamentInstance* inst) : mAsset(asset),
         mInstance(inst) {
     NodeMap& sourceNodes = asset->isInstanced() ? asset->mInstances[0]->nodeMap : asset->mNodeMap;
+    auto& rcm = asset->mEngine->getRenderableManager();
     for (auto pair : sourceNodes) {
         cgltf_node const* node = pair.first;
         cgltf_mesh const* mesh = node->mesh;
-        if (mesh) {
-            cgltf_primitive const* prims = mesh->primitives;
-            for (cgltf_size pi = 0, count = mesh->primitives_count; pi < count; ++pi) {
-                addPrimitive(mesh, pi, pair.second);
+        // Nodes that are only a level of detail of another node don't have a renderable.
+        if (mesh && rcm.hasComponent(pair.second)) {
+            auto lods = asset->mLodMeshes.find(node);
+            if (lods == asset->mLodMeshes.end()) {
+                for (cgltf_size pi = 0, count = mesh->primitives_count; pi < count; ++pi) {
+                    addPrimitive(mesh, 0, pi, pair.second);
+                }
+            } else {
+                auto const& meshes = lods->second;
+                for (size_t level = 0; level < meshes.size(); ++level) {
+                    for (cgltf_size pi = 0, count = meshes[level]->primitives_count; pi < count;
+                            ++pi) {
+                        addPrimitive(meshes[level], level, pi, pair.second);
+                    }
+                }
             }
             addTargetNames(mesh, pair.second);
         }
@@ -85,7 +97,8 @@ const char* MorphHelper::getTargetNameAt(Entity entity, size_t targetIndex) cons
 
 // This method copies various morphing-related data from the FilamentAsset MeshCache primitive
 // (which lives in transient memory) into the MorphHelper primitive (which will stay resident).
-void MorphHelper::addPrimitive(cgltf_mesh const* mesh, int primitiveIndex, Entity entity){
+void MorphHelper::addPrimitive(cgltf_mesh const* mesh, uint8_t level, int primitiveIndex,
+        Entity entity) {
     auto& entry = mMorphTable[entity];
     auto& engine = *mAsset->mEngine;
     const cgltf_primitive& prim = mesh->primitives[primitiveIndex];
@@ -102,7 +115,7 @@ void MorphHelper::addPrimitive(cgltf_mesh const* mesh, int primitiveIndex, Entit
                 .build(engine);
 
         auto& rcm = engine.getRenderableManager();
-        rcm.setMorphTargetBufferAt(rcm.getInstance(entity), 0, primitiveIndex,
+        rcm.setMorphTargetBufferAt(rcm.getInstance(entity), level, primitiveIndex,
                 morphHelperPrim.targets, vertexBuffer->getVertexCount());
     }
 
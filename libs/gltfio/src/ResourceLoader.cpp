@@ -17,6 +17,7 @@
 #include <gltfio/ResourceLoader.h>
 #include <gltfio/Image.h>
 
+#include "BakedData.h"
 #include "GltfEnums.h"
 #include "FFilamentAsset.h"
 #include "TangentsJob.h"
@@ -43,6 +44,7 @@
 #include <math/vec4.h>
 
 #include <tsl/robin_map.h>
+#include <tsl/robin_set.h>
 
 #include <string>
 
@@ -88,9 +90,11 @@ struct ResourceLoader::Impl {
         mNormalizeSkinningWeights = config.normalizeSkinningWeights;
         mRecomputeBoundingBoxes = config.recomputeBoundingBoxes;
         mIgnoreBindTransform = config.ignoreBindTransform;
+        mCache = config.cache;
     }
 
     Engine* mEngine;
+    backend::Platform::BlobCache* mCache;
     bool mNormalizeSkinningWeights;
     bool mRecomputeBoundingBoxes;
     bool mIgnoreBindTransform;
@@ -115,7 +119,7 @@ struct ResourceLoader::Impl {
     JobSystem::Job* mDecoderRootJob = nullptr;
     FFilamentAsset* mCurrentAsset = nullptr;
 
-    void computeTangents(FFilamentAsset* asset);
+    void computeTangents(FFilamentAsset* asset, BakedData* baked);
     bool createTextures(bool async);
     void cancelTextureDecoding();
     void addTextureCacheEntry(const TextureSlot& tb);
@@ -198,6 +202,115 @@ static void convertBytesToShorts(uint16_t* dst, const uint8_t* src, size_t count
     }
 }
 
+using SharedIndexBuffers = tsl::robin_map<IndexBuffer*, IndexBuffer*>;
+
+// Creates a BufferObject that holds the given data. If the asset shares its buffers and one of them
+// already holds identical data, it is returned instead, and the data is released without being
+// uploaded.
+static BufferObject* createBufferObject(FFilamentAsset* asset,
+        BufferObject::BufferDescriptor&& data) {
+    Engine& engine = *asset->mEngine;
+    BufferCache* cache = asset->mBufferCache.get();
+    if (!cache) {
+        BufferObject* bo = BufferObject::Builder().size(data.size).build(engine);
+        asset->mBufferObjects.push_back(bo);
+        bo->setBuffer(engine, std::move(data));
+        return bo;
+    }
+    const BufferCache::Key key = BufferCache::getKey(data.buffer, data.size);
+    BufferObject* bo = cache->acquireBufferObject(key, data.buffer);
+    if (bo) {
+        asset->mSharedBufferObjects.push_back(bo);
+        return bo;
+    }
+    bo = BufferObject::Builder().size(data.size).build(engine);
+    if (cache->addBufferObject(key, data.buffer, bo)) {
+        asset->mSharedBufferObjects.push_back(bo);
+    } else {
+        asset->mBufferObjects.push_back(bo);
+    }
+    bo->setBuffer(engine, std::move(data));
+    return bo;
+}
+
+// Uploads the given data to an IndexBuffer of the asset. If the asset shares its buffers, the
+// IndexBuffer is either added to the cache or replaced by an identical one from the cache, which is
+// recorded in sharedBuffers and applied later by FFilamentAsset::shareIndexBuffers().
+static void setIndexData(FFilamentAsset* asset, IndexBuffer* ib, IndexBuffer::IndexType type,
+        IndexBuffer::BufferDescriptor&& data, SharedIndexBuffers* sharedBuffers) {
+    Engine& engine = *asset->mEngine;
+    BufferCache* cache = asset->mBufferCache.get();
+    if (!cache) {
+        ib->setBuffer(engine, std::move(data));
+        return;
+    }
+    const BufferCache::Key key = BufferCache::getKey(data.buffer, data.size, type);
+    IndexBuffer* shared = cache->acquireIndexBuffer(key, data.buffer);
+    if (!shared) {
+        const bool added = cache->addIndexBuffer(key, data.buffer, ib);
+        ib->setBuffer(engine, std::move(data));
+        if (!added) {
+            // different data has the same key, the buffer stays owned by the asset
+            return;
+        }
+        shared = ib;
+    }
+    (*sharedBuffers)[ib] = shared;
+}
+
+// Gathers the data of the packed accessors into the packed buffers and uploads them, see
+// AssetConfiguration::packingThreshold.
+static void uploadPackedBuffers(FFilamentAsset* asset, SharedIndexBuffers* sharedIndexBuffers) {
+    auto getData = [](const cgltf_accessor* accessor) {
+        auto bufferData = (const uint8_t*) accessor->buffer_view->buffer->data;
+        return bufferData ? computeBindingOffset(accessor) + bufferData : nullptr;
+    };
+
+    // The padding between accessors is zeroed, so that identical assets produce identical buffers.
+    if (asset->mPackedVertexSize > 0) {
+        const uint32_t size = asset->mPackedVertexSize;
+        uint8_t* packed = (uint8_t*) calloc(size, 1);
+        for (auto const& [accessor, offset] : asset->mPackedVertices) {
+            if (const uint8_t* data = getData(accessor)) {
+                memcpy(packed + offset, data, computeBindingSize(accessor));
+            }
+        }
+        BufferObject* bo = createBufferObject(asset,
+                BufferObject::BufferDescriptor(packed, size, FREE_CALLBACK));
+        for (auto slot : asset->mBufferSlots) {
+            if (slot.packed) {
+                slot.vertexBuffer->setBufferObjectAt(*asset->mEngine, slot.bufferIndex, bo);
+            }
+        }
+    }
+
+    constexpr IndexBuffer::IndexType indexTypes[2] = {
+            IndexBuffer::IndexType::USHORT, IndexBuffer::IndexType::UINT };
+    constexpr size_t indexSizes[2] = { sizeof(uint16_t), sizeof(uint32_t) };
+    for (uint32_t i = 0; i < 2; ++i) {
+        IndexBuffer* ib = asset->mPackedIndexBuffers[i];
+        if (!ib) {
+            continue;
+        }
+        const size_t size = ib->getIndexCount() * indexSizes[i];
+        uint8_t* packed = (uint8_t*) calloc(size, 1);
+        for (auto const& [accessor, location] : asset->mPackedIndices) {
+            const uint8_t* data = getData(accessor);
+            if (location.buffer != i || !data) {
+                continue;
+            }
+            uint8_t* dst = packed + location.offset * indexSizes[i];
+            if (accessor->component_type == cgltf_component_type_r_8u) {
+                convertBytesToShorts((uint16_t*) dst, data, accessor->count);
+            } else {
+                memcpy(dst, data, computeBindingSize(accessor));
+            }
+        }
+        setIndexData(asset, ib, indexTypes[i],
+                IndexBuffer::BufferDescriptor(packed, size, FREE_CALLBACK), sharedIndexBuffers);
+    }
+}
+
 static ComponentType getComponentType(const cgltf_accessor* accessor) {
     switch (accessor->component_type) {
         case cgltf_component_type_r_8: return ComponentType::BYTE;
@@ -225,20 +338,150 @@ static void convertToFloats(float* dest, const cgltf_accessor* accessor) {
     transcode(dest, source, accessor->count);
 }
 
-static void decodeDracoMeshes(FFilamentAsset* asset) {
+// For a given primitive and attribute, find the corresponding accessor.
+static cgltf_accessor* findAccessor(const cgltf_primitive* prim, cgltf_attribute_type type,
+        cgltf_int idx) {
+    for (cgltf_size i = 0; i < prim->attributes_count; i++) {
+        const cgltf_attribute& attr = prim->attributes[i];
+        if (attr.type == type && attr.index == idx) {
+            return attr.data;
+        }
+    }
+    return nullptr;
+}
+
+// Returns a copy of an item of the baked data, which must have the given size, or null.
+static void* findBakedData(const BakedData* baked, BakedData::Section section, uint32_t index,
+        uint32_t subindex, size_t size) {
+    size_t bakedSize = 0;
+    const void* bakedData = baked->find(section, index, subindex, &bakedSize);
+    if (!bakedData || bakedSize != size) {
+        return nullptr;
+    }
+    void* data = malloc(size);
+    memcpy(data, bakedData, size);
+    return data;
+}
+
+// Decodes the buffer views compressed with EXT_meshopt_compression and the Draco meshes, all of
+// them concurrently, then copies the decoded Draco data into the accessors of the primitives.
+// Data that has been baked by a previous load is used as is. Returns false if a meshopt buffer
+// view cannot be decoded.
+static bool decodeCompressedData(FFilamentAsset* asset, JobSystem& js, BakedData* baked) {
+    SYSTRACE_CALL();
+    const cgltf_data* gltf = asset->mSourceAsset->hierarchy;
     DracoCache* dracoCache = &asset->mSourceAsset->dracoCache;
+    MeshoptCache* meshoptCache = &asset->mSourceAsset->meshoptCache;
+
+    struct MeshoptView {
+        cgltf_buffer_view* view;
+        void* data;
+        bool baked;
+    };
+    std::vector<MeshoptView> meshoptViews;
+    for (cgltf_size i = 0, len = gltf->buffer_views_count; i < len; ++i) {
+        cgltf_buffer_view* view = &gltf->buffer_views[i];
+        if (view->has_meshopt_compression) {
+            void* data = findBakedData(baked, BakedData::Section::MESHOPT_VIEW, i, 0, view->size);
+            meshoptViews.push_back({ view, data, data != nullptr });
+        }
+    }
+
+    // The accessors that a Draco mesh decodes into are its indices and its attributes.
+    auto getDracoAccessors = [](const cgltf_primitive* prim) {
+        std::vector<cgltf_accessor*> accessors;
+        if (prim->indices) {
+            accessors.push_back(prim->indices);
+        }
+        const cgltf_draco_mesh_compression& draco = prim->draco_mesh_compression;
+        for (cgltf_size i = 0; i < draco.attributes_count; i++) {
+            const cgltf_attribute& attribute = draco.attributes[i];
+            if (cgltf_accessor* accessor = findAccessor(prim, attribute.type, attribute.index)) {
+                accessors.push_back(accessor);
+            }
+        }
+        return accessors;
+    };
 
-    // For a given primitive and attribute, find the corresponding accessor.
-    auto findAccessor = [](const cgltf_primitive* prim, cgltf_attribute_type type, cgltf_int idx) {
-        for (cgltf_size i = 0; i < prim->attributes_count; i++) {
-            const cgltf_attribute& attr = prim->attributes[i];
-            if (attr.type == type && attr.index == idx) {
-                return attr.data;
+    // A primitive is baked if all its accessors are, in which case its Draco mesh doesn't need to
+    // be decoded for it.
+    auto isBaked = [baked, gltf, &getDracoAccessors](const cgltf_primitive* prim) {
+        for (const cgltf_accessor* accessor : getDracoAccessors(prim)) {
+            size_t size;
+            if (!baked->find(BakedData::Section::DRACO_ACCESSOR,
+                    uint32_t(accessor - gltf->accessors), 0, &size)) {
+                return false;
             }
         }
-        return (cgltf_accessor*) nullptr;
+        return true;
     };
 
+    struct DracoView {
+        const cgltf_buffer_view* view;
+        DracoMesh* mesh;
+    };
+    std::vector<DracoView> dracoViews;
+    tsl::robin_set<const cgltf_buffer_view*> dracoViewSet;
+    tsl::robin_set<const cgltf_primitive*> bakedPrims;
+    for (auto const& pair : asset->mPrimitives) {
+        const cgltf_primitive* prim = pair.first;
+        if (!prim->has_draco_mesh_compression) {
+            continue;
+        }
+        if (isBaked(prim)) {
+            bakedPrims.insert(prim);
+            continue;
+        }
+        const cgltf_buffer_view* view = prim->draco_mesh_compression.buffer_view;
+        if (!dracoCache->hasMesh(view) && dracoViewSet.insert(view).second) {
+            dracoViews.push_back({ view, nullptr });
+        }
+    }
+
+    if (!meshoptViews.empty() || !dracoViews.empty()) {
+        JobSystem::Job* parent = js.createJob();
+        for (MeshoptView& item : meshoptViews) {
+            if (item.baked) {
+                continue;
+            }
+            js.run(jobs::createJob(js, parent, [&item] {
+                item.data = MeshoptCache::decode(item.view);
+            }));
+        }
+        for (DracoView& item : dracoViews) {
+            js.run(jobs::createJob(js, parent, [&item] {
+                const cgltf_buffer_view* view = item.view;
+                assert(view->buffer && view->buffer->data);
+                const uint8_t* compressedData = view->offset + (uint8_t*) view->buffer->data;
+                item.mesh = DracoMesh::decode(compressedData, view->size);
+            }));
+        }
+        js.runAndWait(parent);
+    }
+
+    bool meshoptDecoded = true;
+    for (MeshoptView const& item : meshoptViews) {
+        if (!item.data) {
+            meshoptDecoded = false;
+            continue;
+        }
+        if (!item.baked) {
+            baked->add(BakedData::Section::MESHOPT_VIEW, uint32_t(item.view - gltf->buffer_views),
+                    0, item.data, item.view->size);
+        }
+        meshoptCache->attach(item.view, item.data);
+    }
+    for (DracoView const& item : dracoViews) {
+        dracoCache->addMesh(item.view, item.mesh);
+    }
+
+    // The primitives that read a buffer view that cannot be decoded would be rendered with garbage,
+    // so the whole load fails instead.
+    if (!meshoptDecoded) {
+        slog.e << "Unable to decode EXT_meshopt_compression buffer views." << io::endl;
+        return false;
+    }
+
     // Go through every primitive and check if it has a Draco mesh.
     for (auto& pair : asset->mPrimitives) {
         const cgltf_primitive* prim = pair.first;
@@ -246,6 +489,21 @@ static void decodeDracoMeshes(FFilamentAsset* asset) {
             continue;
         }
 
+        // Accessors can be shared by several primitives, they're only attached once.
+        if (bakedPrims.find(prim) != bakedPrims.end()) {
+            for (cgltf_accessor* accessor : getDracoAccessors(prim)) {
+                size_t size = 0;
+                const void* data = baked->find(BakedData::Section::DRACO_ACCESSOR,
+                        uint32_t(accessor - gltf->accessors), 0, &size);
+                if (!accessor->buffer_view) {
+                    void* copy = malloc(size);
+                    memcpy(copy, data, size);
+                    dracoCache->attach(accessor, copy, size);
+                }
+            }
+            continue;
+        }
+
         const cgltf_draco_mesh_compression& draco = prim->draco_mesh_compression;
 
         // If an error occurs, we can simply set the primitive's associated VertexBuffer to null.
@@ -287,7 +545,17 @@ static void decodeDracoMeshes(FFilamentAsset* asset) {
                 break;
             }
         }
+
+        if (vertexBuffer) {
+            for (const cgltf_accessor* accessor : getDracoAccessors(prim)) {
+                const cgltf_buffer_view* view = accessor->buffer_view;
+                baked->add(BakedData::Section::DRACO_ACCESSOR,
+                        uint32_t(accessor - gltf->accessors), 0,
+                        (const uint8_t*) view->buffer->data + view->offset, view->size);
+            }
+        }
     }
+    return true;
 }
 
 // Parses a data URI and returns a blob that gets malloc'd in cgltf, which the caller must free.
@@ -443,9 +711,14 @@ bool ResourceLoader::loadResources(FFilamentAsset* asset, bool async) {
     }
     #endif
 
-    // Decompress Draco meshes early on, which allows us to exploit subsequent processing such as
-    // tangent generation.
-    decodeDracoMeshes(asset);
+    // Look up the data derived by a previous load of the same asset, if any.
+    BakedData baked(pImpl->mCache, gltf);
+
+    // Decompress meshopt buffers and Draco meshes early on, which allows us to exploit subsequent
+    // processing such as tangent generation.
+    if (!decodeCompressedData(asset, pImpl->mEngine->getJobSystem(), &baked)) {
+        return false;
+    }
 
     // Normalize skinning weights, then "import" each skin into the asset by building a mapping of
     // skins to their affected entities.
@@ -470,15 +743,16 @@ bool ResourceLoader::loadResources(FFilamentAsset* asset, bool async) {
             pImpl->mIgnoreBindTransform = asset->isInstanced();
         }
         pImpl->cgltfSkinBaseAddress = &gltf->skins[0];
-        updateBoundingBoxes(asset);
+        updateBoundingBoxes(asset, &baked);
     }
 
     Engine& engine = *pImpl->mEngine;
 
     // Upload VertexBuffer and IndexBuffer data to the GPU.
+    SharedIndexBuffers sharedIndexBuffers;
     for (auto slot : asset->mBufferSlots) {
         const cgltf_accessor* accessor = slot.accessor;
-        if (!accessor->buffer_view) {
+        if (!accessor->buffer_view || slot.packed) {
             continue;
         }
         auto bufferData = (const uint8_t*) accessor->buffer_view->buffer->data;
@@ -490,16 +764,13 @@ bool ResourceLoader::loadResources(FFilamentAsset* asset, bool async) {
                 const size_t floatsSize = accessor->count * sizeof(float) * dim;
                 float* floatsData = (float*) malloc(floatsSize);
                 convertToFloats(floatsData, accessor);
-                BufferObject* bo = BufferObject::Builder().size(floatsSize).build(engine);
-                asset->mBufferObjects.push_back(bo);
-                bo->setBuffer(engine, BufferDescriptor(floatsData, floatsSize, FREE_CALLBACK));
+                BufferObject* bo = createBufferObject(asset,
+                        BufferDescriptor(floatsData, floatsSize, FREE_CALLBACK));
                 slot.vertexBuffer->setBufferObjectAt(engine, slot.bufferIndex, bo);
                 continue;
             }
-            BufferObject* bo = BufferObject::Builder().size(size).build(engine);
-            asset->mBufferObjects.push_back(bo);
-            bo->setBuffer(engine, BufferDescriptor(data, size,
-                    uploadCallback, uploadUserdata(asset)));
+            BufferObject* bo = createBufferObject(asset,
+                    BufferDescriptor(data, size, uploadCallback, uploadUserdata(asset)));
             slot.vertexBuffer->setBufferObjectAt(engine, slot.bufferIndex, bo);
             continue;
         }
@@ -508,20 +779,31 @@ bool ResourceLoader::loadResources(FFilamentAsset* asset, bool async) {
             const size_t size16 = size * 2;
             uint16_t* data16 = (uint16_t*) malloc(size16);
             convertBytesToShorts(data16, data, size);
-            IndexBuffer::BufferDescriptor bd(data16, size16, FREE_CALLBACK);
-            slot.indexBuffer->setBuffer(engine, std::move(bd));
+            setIndexData(asset, slot.indexBuffer, IndexBuffer::IndexType::USHORT,
+                    IndexBuffer::BufferDescriptor(data16, size16, FREE_CALLBACK),
+                    &sharedIndexBuffers);
             continue;
         }
-        IndexBuffer::BufferDescriptor bd(data, size, uploadCallback, uploadUserdata(asset));
-        slot.indexBuffer->setBuffer(engine, std::move(bd));
+        const auto indexType = accessor->component_type == cgltf_component_type_r_32u ?
+                IndexBuffer::IndexType::UINT : IndexBuffer::IndexType::USHORT;
+        setIndexData(asset, slot.indexBuffer, indexType,
+                IndexBuffer::BufferDescriptor(data, size, uploadCallback, uploadUserdata(asset)),
+                &sharedIndexBuffers);
     }
 
+    // Upload the packed buffers, then switch renderables to the index buffers that are shared.
+    uploadPackedBuffers(asset, &sharedIndexBuffers);
+    asset->shareIndexBuffers(sharedIndexBuffers);
+
     // Apply sparse data modifications to base arrays, then upload the result.
     applySparseData(asset);
 
     // Compute surface orientation quaternions if necessary. This is similar to sparse data in that
     // we need to generate the contents of a GPU buffer by processing one or more CPU buffer(s).
-    pImpl->computeTangents(asset);
+    pImpl->computeTangents(asset, &baked);
+
+    // Store the data that has been derived by this load, if it wasn't cached already.
+    baked.store();
 
     // Non-textured renderables are now considered ready, so notify the dependency graph.
     asset->mDependencyGraph.finalize();
@@ -800,7 +1082,9 @@ bool ResourceLoader::Impl::createTextures(bool async) {
         return true;
     }
 
+    // Texture decoding is streaming work, it must not delay the frame's jobs.
     JobSystem::Job* parent = js->createJob();
+    js->setPriority(parent, JobSystem::JobPriority::BACKGROUND);
 
     // Create a copy of the shared_ptr to the source data to prevent it from being freed during
     // the texture decoding process.
@@ -865,7 +1149,7 @@ bool ResourceLoader::Impl::createTextures(bool async) {
     return true;
 }
 
-void ResourceLoader::Impl::computeTangents(FFilamentAsset* asset) {
+void ResourceLoader::Impl::computeTangents(FFilamentAsset* asset, BakedData* baked) {
     SYSTRACE_CALL();
 
     const cgltf_accessor* kGenerateTangents = &asset->mGenerateTangents;
@@ -880,7 +1164,9 @@ void ResourceLoader::Impl::computeTangents(FFilamentAsset* asset) {
         baseTangents[slot.vertexBuffer] = slot.bufferIndex;
     }
 
-    // Create a job description for each triangle-based primitive.
+    // Create a job description for each triangle-based primitive. Large primitives are split in
+    // several jobs.
+    JobSystem* js = &mEngine->getJobSystem();
     using Params = TangentsJob::Params;
     std::vector<Params> jobParams;
     for (auto pair : asset->mPrimitives) {
@@ -890,26 +1176,44 @@ void ResourceLoader::Impl::computeTangents(FFilamentAsset* asset) {
         VertexBuffer* vb = pair.second;
         auto iter = baseTangents.find(vb);
         if (iter != baseTangents.end()) {
-            jobParams.emplace_back(Params {{ pair.first }, {vb, iter->second }});
+            jobParams.emplace_back(Params {{ pair.first, TangentsJob::kMorphTargetUnused, js },
+                    { vb, iter->second }});
         }
     }
 
-    // Kick off jobs for computing tangent frames.
-    JobSystem* js = &mEngine->getJobSystem();
+    // Kick off jobs for computing tangent frames, unless they have been baked.
+    std::vector<bool> bakedParams(jobParams.size());
     JobSystem::Job* parent = js->createJob();
-    for (Params& params : jobParams) {
-        Params* pptr = &params;
+    js->setPriority(parent, JobSystem::JobPriority::BACKGROUND);
+    for (size_t i = 0; i < jobParams.size(); ++i) {
+        Params* pptr = &jobParams[i];
+        const BakedData::PrimitiveId id = baked->getPrimitiveId(pptr->in.prim);
+        size_t size = 0;
+        const void* data = baked->find(BakedData::Section::TANGENTS, id.mesh, id.primitive, &size);
+        if (data && size > 0 && size % sizeof(short4) == 0) {
+            pptr->out.vertexCount = size / sizeof(short4);
+            pptr->out.results = (short4*) malloc(size);
+            memcpy(pptr->out.results, data, size);
+            bakedParams[i] = true;
+            continue;
+        }
         js->run(jobs::createJob(*js, parent, [pptr] { TangentsJob::run(pptr); }));
     }
     js->runAndWait(parent);
 
+    for (size_t i = 0; i < jobParams.size(); ++i) {
+        const Params& params = jobParams[i];
+        if (!bakedParams[i] && params.out.results) {
+            const BakedData::PrimitiveId id = baked->getPrimitiveId(params.in.prim);
+            baked->add(BakedData::Section::TANGENTS, id.mesh, id.primitive, params.out.results,
+                    params.out.vertexCount * sizeof(short4));
+        }
+    }
+
     // Finally, upload quaternions to the GPU from the main thread.
     for (Params& params : jobParams) {
-        BufferObject* bo = BufferObject::Builder()
-                .size(params.out.vertexCount * sizeof(short4)).build(*mEngine);
-        asset->mBufferObjects.push_back(bo);
-        bo->setBuffer(*mEngine, BufferDescriptor(
-                params.out.results, bo->getByteCount(), FREE_CALLBACK));
+        BufferObject* bo = createBufferObject(asset, BufferDescriptor(params.out.results,
+                params.out.vertexCount * sizeof(short4), FREE_CALLBACK));
         params.context.vb->setBufferObjectAt(*mEngine, params.context.slot, bo);
     }
 
@@ -932,9 +1236,8 @@ void ResourceLoader::applySparseData(FFilamentAsset* asset) const {
         cgltf_size numBytes = sizeof(float) * numFloats;
         float* generated = (float*) malloc(numBytes);
         cgltf_accessor_unpack_floats(accessor, generated, numFloats);
-        BufferObject* bo = BufferObject::Builder().size(numBytes).build(*asset->mEngine);
-        asset->mBufferObjects.push_back(bo);
-        bo->setBuffer(*pImpl->mEngine, BufferDescriptor(generated, numBytes, FREE_CALLBACK));
+        BufferObject* bo = createBufferObject(asset,
+                BufferDescriptor(generated, numBytes, FREE_CALLBACK));
         slot.vertexBuffer->setBufferObjectAt(*pImpl->mEngine, slot.bufferIndex, bo);
     }
 }
@@ -971,7 +1274,7 @@ void ResourceLoader::normalizeSkinningWeights(FFilamentAsset* asset) const {
     }
 }
 
-void ResourceLoader::updateBoundingBoxes(FFilamentAsset* asset) const {
+void ResourceLoader::updateBoundingBoxes(FFilamentAsset* asset, BakedData* baked) const {
     SYSTRACE_CALL();
     auto& rm = pImpl->mEngine->getRenderableManager();
     auto& tm = pImpl->mEngine->getTransformManager();
@@ -1083,14 +1386,25 @@ void ResourceLoader::updateBoundingBoxes(FFilamentAsset* asset) const {
         }
     }
 
-    // Kick off a bounding box job for every primitive.
+    // Kick off a bounding box job for every primitive. The bounds of a primitive that is not
+    // skinned only depend on its source data, so they can be baked.
     std::vector<Aabb> bounds(primitives.size());
+    std::vector<bool> computed(primitives.size());
     JobSystem* js = &pImpl->mEngine->getJobSystem();
     JobSystem::Job* parent = js->createJob();
     for (size_t i = 0; i < primitives.size(); ++i) {
         Aabb* result = &bounds[i];
         if (pImpl->mIgnoreBindTransform || !primitives[i].second) {
             cgltf_primitive const* prim = primitives[i].first;
+            const BakedData::PrimitiveId id = baked->getPrimitiveId(prim);
+            size_t size = 0;
+            const void* data = baked->find(BakedData::Section::BOUNDS, id.mesh, id.primitive,
+                    &size);
+            if (data && size == sizeof(Aabb)) {
+                memcpy(result, data, sizeof(Aabb));
+                continue;
+            }
+            computed[i] = true;
             js->run(jobs::createJob(*js, parent, [prim, result, computeBoundingBox] {
                 computeBoundingBox(prim, result);
             }));
@@ -1103,6 +1417,14 @@ void ResourceLoader::updateBoundingBoxes(FFilamentAsset* asset) const {
     }
     js->runAndWait(parent);
 
+    for (size_t i = 0; i < primitives.size(); ++i) {
+        if (computed[i]) {
+            const BakedData::PrimitiveId id = baked->getPrimitiveId(primitives[i].first);
+            baked->add(BakedData::Section::BOUNDS, id.mesh, id.primitive, &bounds[i],
+                    sizeof(Aabb));
+        }
+    }
+
     // Compute the asset-level bounding box.
     size_t primIndex = 0;
     Aabb assetBounds;
@@ -19,6 +19,7 @@
 #include <math/vec4.h>
 
 namespace filament { class VertexBuffer; }
+namespace utils { class JobSystem; }
 
 namespace gltfio {
 
@@ -35,6 +36,9 @@ struct TangentsJob {
     struct InputParams {
         const cgltf_primitive* prim;
         const int morphTargetIndex = kMorphTargetUnused;
+        // Optional, used to split the primitive in chunks when it is large. run() must then be
+        // called from a thread that belongs to this JobSystem, e.g. from inside a job.
+        utils::JobSystem* const jobSystem = nullptr;
     };
 
     // The context of the procedure. These fields are not used by the procedure but are provided as
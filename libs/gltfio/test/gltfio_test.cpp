@@ -0,0 +1,234 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "src/BakedData.h"
+#include "src/BufferCache.h"
+
+#include <filament/BufferObject.h>
+#include <filament/Engine.h>
+#include <filament/IndexBuffer.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <string.h>
+
+using namespace filament;
+using namespace gltfio;
+
+class GltfioTest : public testing::Test {
+protected:
+    void SetUp() override {
+        engine = Engine::create(Engine::Backend::NOOP);
+    }
+
+    void TearDown() override {
+        Engine::destroy(&engine);
+    }
+
+    BufferObject* createBufferObject(std::vector<uint8_t> const& data) {
+        return BufferObject::Builder().size(data.size()).build(*engine);
+    }
+
+    Engine* engine = nullptr;
+};
+
+TEST_F(GltfioTest, BufferCacheSharesIdenticalData) {
+    BufferCache cache(engine);
+    const std::vector<uint8_t> a(100, 1);
+    const std::vector<uint8_t> b(a);
+    const std::vector<uint8_t> c(100, 2);
+
+    const BufferCache::Key keyA = BufferCache::getKey(a.data(), a.size());
+    EXPECT_EQ(nullptr, cache.acquireBufferObject(keyA, a.data()));
+    BufferObject* bo = createBufferObject(a);
+    EXPECT_TRUE(cache.addBufferObject(keyA, a.data(), bo));
+
+    // identical data from another buffer is shared
+    const BufferCache::Key keyB = BufferCache::getKey(b.data(), b.size());
+    EXPECT_EQ(keyA, keyB);
+    EXPECT_EQ(bo, cache.acquireBufferObject(keyB, b.data()));
+
+    // different data isn't, nor the same data used as indices
+    const BufferCache::Key keyC = BufferCache::getKey(c.data(), c.size());
+    EXPECT_EQ(nullptr, cache.acquireBufferObject(keyC, c.data()));
+    EXPECT_FALSE(keyA == BufferCache::getKey(a.data(), a.size(),
+            IndexBuffer::IndexType::USHORT));
+
+    // the last reference destroys the buffer
+    EXPECT_EQ(1, cache.getBufferCount());
+    cache.release(bo);
+    EXPECT_EQ(1, cache.getBufferCount());
+    cache.release(bo);
+    EXPECT_EQ(0, cache.getBufferCount());
+}
+
+TEST_F(GltfioTest, BufferCacheCollision) {
+    BufferCache cache(engine);
+    const std::vector<uint8_t> a(64, 1);
+    const std::vector<uint8_t> b(64, 2);
+
+    const BufferCache::Key key = BufferCache::getKey(a.data(), a.size());
+    BufferObject* bo = createBufferObject(a);
+    EXPECT_TRUE(cache.addBufferObject(key, a.data(), bo));
+
+    // a hash collision is simulated by looking up other data with the same key, the bytes are
+    // compared so it is never shared
+    EXPECT_EQ(nullptr, cache.acquireBufferObject(key, b.data()));
+
+    // and it cannot be added, the caller keeps its buffer
+    BufferObject* other = createBufferObject(b);
+    EXPECT_FALSE(cache.addBufferObject(key, b.data(), other));
+    EXPECT_EQ(1, cache.getBufferCount());
+    engine->destroy(other);
+
+    EXPECT_EQ(bo, cache.acquireBufferObject(key, a.data()));
+    cache.release(bo);
+    cache.release(bo);
+    EXPECT_EQ(0, cache.getBufferCount());
+}
+
+// A BlobCache that keeps its entries in memory.
+class MemoryBlobCache : public backend::Platform::BlobCache {
+public:
+    void insert(const void* key, size_t keySize,
+            const void* value, size_t valueSize) noexcept override {
+        auto k = (const char*) key;
+        auto v = (const uint8_t*) value;
+        mEntries[std::string(k, k + keySize)] = std::vector<uint8_t>(v, v + valueSize);
+    }
+
+    size_t retrieve(const void* key, size_t keySize,
+            void* value, size_t valueSize) noexcept override {
+        auto k = (const char*) key;
+        auto iter = mEntries.find(std::string(k, k + keySize));
+        if (iter == mEntries.end()) {
+            return 0;
+        }
+        std::vector<uint8_t> const& data = iter->second;
+        if (valueSize >= data.size()) {
+            memcpy(value, data.data(), data.size());
+        }
+        return data.size();
+    }
+
+    size_t getEntryCount() const noexcept { return mEntries.size(); }
+
+private:
+    std::map<std::string, std::vector<uint8_t>> mEntries;
+};
+
+// The parts of a loaded glTF asset that identify it in the cache.
+struct BakedAsset {
+    BakedAsset() : json(R"({"asset":{"version":"2.0"}})"), data(1000) {
+        for (size_t i = 0; i < data.size(); i++) {
+            data[i] = uint8_t(i);
+        }
+    }
+
+    cgltf_data* getData() {
+        buffer = {};
+        buffer.size = data.size();
+        buffer.data = data.data();
+        gltf = {};
+        gltf.json = json.c_str();
+        gltf.json_size = json.size();
+        gltf.buffers = &buffer;
+        gltf.buffers_count = 1;
+        return &gltf;
+    }
+
+    std::string json;
+    std::vector<uint8_t> data;
+    cgltf_buffer buffer;
+    cgltf_data gltf;
+};
+
+TEST(BakedDataTest, FindAddedItems) {
+    MemoryBlobCache cache;
+    BakedAsset asset;
+    const float bounds[6] = { -1, -2, -3, 1, 2, 3 };
+    {
+        BakedData baked(&cache, asset.getData());
+        size_t size = 0;
+        EXPECT_EQ(nullptr, baked.find(BakedData::Section::BOUNDS, 0, 1, &size));
+        baked.add(BakedData::Section::BOUNDS, 0, 1, bounds, sizeof(bounds));
+        const void* data = baked.find(BakedData::Section::BOUNDS, 0, 1, &size);
+        ASSERT_NE(nullptr, data);
+        EXPECT_EQ(sizeof(bounds), size);
+        baked.store();
+    }
+    EXPECT_EQ(1, cache.getEntryCount());
+
+    // a subsequent load of the same asset finds the items
+    BakedData baked(&cache, asset.getData());
+    size_t size = 0;
+    const void* data = baked.find(BakedData::Section::BOUNDS, 0, 1, &size);
+    ASSERT_NE(nullptr, data);
+    ASSERT_EQ(sizeof(bounds), size);
+    EXPECT_EQ(0, memcmp(bounds, data, size));
+    EXPECT_EQ(nullptr, baked.find(BakedData::Section::BOUNDS, 0, 0, &size));
+    EXPECT_EQ(nullptr, baked.find(BakedData::Section::TANGENTS, 0, 1, &size));
+}
+
+TEST(BakedDataTest, ModifiedAsset) {
+    MemoryBlobCache cache;
+    BakedAsset asset;
+    const uint32_t value = 42;
+    {
+        BakedData baked(&cache, asset.getData());
+        baked.add(BakedData::Section::MESHOPT_VIEW, 0, 0, &value, sizeof(value));
+        baked.store();
+    }
+
+    auto isBaked = [&cache](BakedAsset& asset) {
+        BakedData baked(&cache, asset.getData());
+        size_t size = 0;
+        return baked.find(BakedData::Section::MESHOPT_VIEW, 0, 0, &size) != nullptr;
+    };
+    EXPECT_TRUE(isBaked(asset));
+
+    // any change to the JSON or to the buffers, including in their last bytes, misses the cache
+    for (size_t i : { size_t(0), size_t(500), asset.data.size() - 1 }) {
+        BakedAsset modified;
+        modified.data[i]++;
+        EXPECT_FALSE(isBaked(modified));
+    }
+    BakedAsset shorter;
+    shorter.data.pop_back();
+    EXPECT_FALSE(isBaked(shorter));
+    BakedAsset json;
+    json.json.back() = ' ';
+    EXPECT_FALSE(isBaked(json));
+}
+
+TEST(BakedDataTest, NoCache) {
+    BakedAsset asset;
+    BakedData baked(nullptr, asset.getData());
+    const uint32_t value = 42;
+    baked.add(BakedData::Section::MESHOPT_VIEW, 0, 0, &value, sizeof(value));
+    size_t size = 0;
+    EXPECT_EQ(nullptr, baked.find(BakedData::Section::MESHOPT_VIEW, 0, 0, &size));
+    baked.store();
+}
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -17,6 +17,7 @@
 #ifndef IMAGE_IMAGESAMPLER_H
 #define IMAGE_IMAGESAMPLER_H
 
+#include <image/ImageStream.h>
 #include <image/LinearImage.h>
 
 #include <utils/compiler.h>
@@ -114,6 +115,22 @@ UTILS_PUBLIC
 LinearImage resampleImage(const LinearImage& source, uint32_t width, uint32_t height,
         Filter filter = Filter::DEFAULT);
 
+/**
+ * Streaming variant of resampleImage that pulls rows from the given source and pushes the resized
+ * rows to the given sink, top to bottom.
+ *
+ * Only a sliding window of horizontally resized rows is kept in memory; its height is the vertical
+ * footprint of the filter (a few rows for magnification, roughly "2 * source / target" rows for
+ * minification). Combined with a RowSource that decodes incrementally, this lets tools resize
+ * images that would not fit in memory as a LinearImage.
+ *
+ * As with the non-streaming variant, the sampler's boundaries must be EXCLUDE. Returns false if the
+ * source or the sink fail.
+ */
+UTILS_PUBLIC
+bool resampleImage(RowSource& source, RowSink& sink, uint32_t width, uint32_t height,
+        const ImageSampler& sampler);
+
 /**
  * Computes a single sample for the given texture coordinate and writes the resulting color
  * components into the given output holder.
@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef IMAGE_IMAGESTREAM_H
+#define IMAGE_IMAGESTREAM_H
+
+#include <image/LinearImage.h>
+
+#include <utils/compiler.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace image {
+
+/**
+ * Storage type of the pixels referenced by an ImageView.
+ */
+enum class PixelType : uint8_t {
+    UBYTE,  // 8-bit unsigned normalized, i.e. [0, 255] maps to [0, 1]
+    HALF,   // 16-bit IEEE half-float
+    FLOAT   // 32-bit IEEE float
+};
+
+/**
+ * ImageView is a non-owning, typed window onto row-major pixel storage.
+ *
+ * Unlike LinearImage, the pixels can be stored as UBYTE or HALF, which respectively use 4x and 2x
+ * less memory than floats. Rows are converted to and from floats one at a time, which lets the
+ * streaming algorithms below work without ever expanding the whole image.
+ *
+ * When rowStride is zero, rows are tightly packed, i.e. the stride is width * channels * the size
+ * of the pixel type.
+ */
+struct UTILS_PUBLIC ImageView {
+    void* data = nullptr;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t channels = 0;
+    PixelType type = PixelType::FLOAT;
+    size_t rowStride = 0;
+
+    /**
+     * Creates a view of the given LinearImage, sharing its pixels.
+     */
+    static ImageView of(LinearImage& image) noexcept;
+
+    size_t getRowStride() const noexcept;
+
+    /**
+     * Converts the given row to "width * channels" floats. (not bounds checked)
+     */
+    void loadRow(uint32_t row, float* dst) const noexcept;
+
+    /**
+     * Converts "width * channels" floats into the given row. UBYTE values are clamped to [0, 1].
+     * (not bounds checked)
+     */
+    void storeRow(uint32_t row, float const* src) const noexcept;
+};
+
+/**
+ * RowSource produces the rows of an image from top to bottom.
+ *
+ * This is the input of the streaming image algorithms, which only ever keep a small window of rows
+ * resident. Decoders that can produce rows incrementally (see ImageDecoder::createRowSource) can
+ * therefore feed large images through a resampler without allocating the full float image.
+ */
+class UTILS_PUBLIC RowSource {
+public:
+    virtual ~RowSource();
+
+    uint32_t getWidth() const noexcept { return mWidth; }
+    uint32_t getHeight() const noexcept { return mHeight; }
+    uint32_t getChannels() const noexcept { return mChannels; }
+
+    /**
+     * Writes the next row as "width * channels" linear floats into dst. Returns false if there
+     * are no more rows or if an error occurred.
+     */
+    virtual bool readRow(float* dst) = 0;
+
+protected:
+    RowSource(uint32_t width, uint32_t height, uint32_t channels) noexcept
+            : mWidth(width), mHeight(height), mChannels(channels) {}
+
+private:
+    uint32_t mWidth;
+    uint32_t mHeight;
+    uint32_t mChannels;
+};
+
+/**
+ * RowSink consumes the rows of an image from top to bottom.
+ */
+class UTILS_PUBLIC RowSink {
+public:
+    virtual ~RowSink();
+
+    /**
+     * Consumes the next row, given as "width * channels" floats. Returns false on error.
+     */
+    virtual bool writeRow(float const* src) = 0;
+};
+
+/**
+ * RowSource that reads from an ImageView without copying it.
+ */
+class UTILS_PUBLIC ViewRowSource : public RowSource {
+public:
+    explicit ViewRowSource(ImageView view) noexcept
+            : RowSource(view.width, view.height, view.channels), mView(view) {}
+    bool readRow(float* dst) override;
+private:
+    ImageView mView;
+    uint32_t mRow = 0;
+};
+
+/**
+ * RowSink that writes into an ImageView, converting to its pixel type.
+ */
+class UTILS_PUBLIC ViewRowSink : public RowSink {
+public:
+    explicit ViewRowSink(ImageView view) noexcept : mView(view) {}
+    bool writeRow(float const* src) override;
+private:
+    ImageView mView;
+    uint32_t mRow = 0;
+};
+
+} // namespace image
+
+#endif /* IMAGE_IMAGESTREAM_H */
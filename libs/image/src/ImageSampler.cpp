@@ -24,6 +24,8 @@
 #include <utils/Panic.h>
 #include <utils/CString.h>
 
+#include <algorithm>
+#include <limits>
 #include <memory>
 #include <vector>
 #include <unordered_map>
@@ -278,6 +280,38 @@ LinearImage resampleImage1D(const LinearImage& source, MadProgram* program,
     return result;
 }
 
+void normalizeRow(float* row, size_t count, uint32_t nchan) {
+    ASSERT_PRECONDITION(nchan == 3 || nchan == 4, "Must be a 3 or 4 channel image");
+    for (size_t i = 0; i < count; i += nchan) {
+        if (nchan == 3) {
+            auto& v = *reinterpret_cast<filament::math::float3*>(row + i);
+            v = normalize(v);
+        } else {
+            auto& v = *reinterpret_cast<filament::math::float4*>(row + i);
+            v = normalize(v);
+        }
+    }
+}
+
+// Executes a single-row MAD program, the streaming counterpart of resampleImage1D.
+void resampleRow(MadProgram const& program, Filter filter, uint32_t nchan,
+        float const* source, float* target, size_t count) {
+    if (filter == Filter::MINIMUM) {
+        std::fill_n(target, count, std::numeric_limits<float>::max());
+        for (auto mad : program) {
+            target[mad.targetIndex] = std::min(source[mad.sourceIndex], target[mad.targetIndex]);
+        }
+        return;
+    }
+    std::fill_n(target, count, 0.0f);
+    for (auto mad : program) {
+        target[mad.targetIndex] += source[mad.sourceIndex] * mad.weight;
+    }
+    if (filter == Filter::GAUSSIAN_NORMALS) {
+        normalizeRow(target, count, nchan);
+    }
+}
+
 } // anonymous namespace
 
 namespace image {
@@ -315,6 +349,111 @@ LinearImage resampleImage(const LinearImage& source, uint32_t width, uint32_t he
     });
 }
 
+bool resampleImage(RowSource& source, RowSink& sink, uint32_t width, uint32_t height,
+        const ImageSampler& sampler) {
+    ASSERT_PRECONDITION(
+        sampler.east.mode == Boundary::EXCLUDE &&
+        sampler.north.mode == Boundary::EXCLUDE &&
+        sampler.west.mode == Boundary::EXCLUDE &&
+        sampler.south.mode == Boundary::EXCLUDE, "Not yet implemented.");
+    const uint32_t swidth = source.getWidth();
+    const uint32_t sheight = source.getHeight();
+    const uint32_t nchan = source.getChannels();
+    const float radius = sampler.filterRadiusMultiplier;
+    const Region region = sampler.sourceRegion;
+
+    Filter hfilter = sampler.horizontalFilter;
+    Filter vfilter = sampler.verticalFilter;
+    if (hfilter == Filter::DEFAULT) hfilter = width > swidth ? Filter::MITCHELL : Filter::LANCZOS;
+    if (vfilter == Filter::DEFAULT) vfilter = height > sheight ? Filter::MITCHELL : Filter::LANCZOS;
+
+    // The horizontal program runs over every incoming row; the vertical program is kept in its
+    // single-channel form since each of its instructions applies to an entire row.
+    MadProgram hprogram;
+    generateMadProgram(width, swidth, region.left, region.right,
+            createFilterFunction(hfilter), radius, &hprogram);
+    expandMadProgram(nchan, &hprogram);
+
+    MadProgram vprogram;
+    generateMadProgram(height, sheight, region.top, region.bottom,
+            createFilterFunction(vfilter), radius, &vprogram);
+
+    // For each target row, find its range of MAD instructions and the last source row it reads.
+    struct TargetRow {
+        uint32_t begin = 0;
+        uint32_t end = 0;
+        int32_t lastSource = -1;
+        int32_t firstSource = std::numeric_limits<int32_t>::max();
+    };
+    std::vector<TargetRow> rows(height);
+    for (uint32_t i = 0, n = vprogram.size(); i < n; ++i) {
+        TargetRow& row = rows[vprogram[i].targetIndex];
+        if (row.begin == row.end) {
+            row.begin = i;
+        }
+        row.end = i + 1;
+        row.lastSource = std::max(row.lastSource, vprogram[i].sourceIndex);
+        row.firstSource = std::min(row.firstSource, vprogram[i].sourceIndex);
+    }
+
+    // Size the window of resident rows such that a source row is never evicted before the last
+    // target row that reads it.
+    int32_t window = 1;
+    int32_t firstNeeded = std::numeric_limits<int32_t>::max();
+    for (uint32_t t = height; t-- > 0;) {
+        firstNeeded = std::min(firstNeeded, rows[t].firstSource);
+        if (rows[t].lastSource >= 0) {
+            window = std::max(window, rows[t].lastSource - firstNeeded + 1);
+        }
+    }
+
+    const size_t scount = size_t(swidth) * nchan;
+    const size_t tcount = size_t(width) * nchan;
+    std::vector<float> sourceRow(scount);
+    std::vector<float> targetRow(tcount);
+    std::vector<float> ring(size_t(window) * tcount);
+
+    int32_t rowsRead = 0;
+    for (uint32_t t = 0; t < height; ++t) {
+        const TargetRow& row = rows[t];
+        for (; rowsRead <= row.lastSource; ++rowsRead) {
+            if (!source.readRow(sourceRow.data())) {
+                return false;
+            }
+            float* resized = ring.data() + (rowsRead % window) * tcount;
+            resampleRow(hprogram, hfilter, nchan, sourceRow.data(), resized, tcount);
+        }
+
+        float* dst = targetRow.data();
+        if (vfilter == Filter::MINIMUM) {
+            std::fill_n(dst, tcount, std::numeric_limits<float>::max());
+            for (uint32_t i = row.begin; i < row.end; ++i) {
+                float const* src = ring.data() + (vprogram[i].sourceIndex % window) * tcount;
+                for (size_t c = 0; c < tcount; ++c) {
+                    dst[c] = std::min(dst[c], src[c]);
+                }
+            }
+        } else {
+            std::fill_n(dst, tcount, 0.0f);
+            for (uint32_t i = row.begin; i < row.end; ++i) {
+                float const* src = ring.data() + (vprogram[i].sourceIndex % window) * tcount;
+                const float weight = vprogram[i].weight;
+                for (size_t c = 0; c < tcount; ++c) {
+                    dst[c] += src[c] * weight;
+                }
+            }
+            if (vfilter == Filter::GAUSSIAN_NORMALS) {
+                normalizeRow(dst, tcount, nchan);
+            }
+        }
+
+        if (!sink.writeRow(dst)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 void computeSingleSample(const LinearImage& source, float x, float y, SingleSample* result,
         Filter filter) {
     const float radius = 1.0f;
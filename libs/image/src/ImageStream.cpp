@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <image/ImageStream.h>
+
+#include <math/half.h>
+#include <math/scalar.h>
+
+#include <cstring>
+
+using filament::math::half;
+
+namespace image {
+
+ImageView ImageView::of(LinearImage& image) noexcept {
+    return {
+        .data = image.getPixelRef(),
+        .width = image.getWidth(),
+        .height = image.getHeight(),
+        .channels = image.getChannels(),
+        .type = PixelType::FLOAT
+    };
+}
+
+size_t ImageView::getRowStride() const noexcept {
+    if (rowStride) {
+        return rowStride;
+    }
+    const size_t n = size_t(width) * channels;
+    switch (type) {
+        case PixelType::UBYTE:  return n;
+        case PixelType::HALF:   return n * sizeof(half);
+        case PixelType::FLOAT:  return n * sizeof(float);
+    }
+    return 0;
+}
+
+void ImageView::loadRow(uint32_t row, float* dst) const noexcept {
+    const size_t n = size_t(width) * channels;
+    uint8_t const* src = static_cast<uint8_t const*>(data) + row * getRowStride();
+    switch (type) {
+        case PixelType::UBYTE:
+            for (size_t i = 0; i < n; i++) {
+                dst[i] = src[i] * (1.0f / 255.0f);
+            }
+            break;
+        case PixelType::HALF: {
+            half const* h = reinterpret_cast<half const*>(src);
+            for (size_t i = 0; i < n; i++) {
+                dst[i] = h[i];
+            }
+            break;
+        }
+        case PixelType::FLOAT:
+            memcpy(dst, src, n * sizeof(float));
+            break;
+    }
+}
+
+void ImageView::storeRow(uint32_t row, float const* src) const noexcept {
+    const size_t n = size_t(width) * channels;
+    uint8_t* dst = static_cast<uint8_t*>(data) + row * getRowStride();
+    switch (type) {
+        case PixelType::UBYTE:
+            for (size_t i = 0; i < n; i++) {
+                dst[i] = uint8_t(filament::math::saturate(src[i]) * 255.0f + 0.5f);
+            }
+            break;
+        case PixelType::HALF: {
+            half* h = reinterpret_cast<half*>(dst);
+            for (size_t i = 0; i < n; i++) {
+                h[i] = src[i];
+            }
+            break;
+        }
+        case PixelType::FLOAT:
+            memcpy(dst, src, n * sizeof(float));
+            break;
+    }
+}
+
+RowSource::~RowSource() = default;
+
+RowSink::~RowSink() = default;
+
+bool ViewRowSource::readRow(float* dst) {
+    if (mRow >= mView.height) {
+        return false;
+    }
+    mView.loadRow(mRow++, dst);
+    return true;
+}
+
+bool ViewRowSink::writeRow(float const* src) {
+    if (mRow >= mView.height) {
+        return false;
+    }
+    mView.storeRow(mRow++, src);
+    return true;
+}
+
+} // namespace image
@@ -18,6 +18,7 @@
 #include <image/KtxBundle.h>
 #include <image/ImageOps.h>
 #include <image/ImageSampler.h>
+#include <image/ImageStream.h>
 #include <image/LinearImage.h>
 
 #include <imageio/ImageDecoder.h>
@@ -362,6 +363,109 @@ TEST_F(ImageTest, Mipmaps) { // NOLINT
     }
 }
 
+TEST_F(ImageTest, StreamingResample) { // NOLINT
+    LinearImage src = createColorFromAscii(
+            "44444 41014 40704 41014 44444 44444 41014 40704 41014 44444");
+    src = resampleImage(src, 50, 100, Filter::NEAREST);
+
+    // Streaming through float views must match the in-memory resampler.
+    const Filter filters[] = { Filter::DEFAULT, Filter::BOX, Filter::HERMITE, Filter::MINIMUM };
+    const uint32_t sizes[][2] = { { 13, 31 }, { 50, 100 }, { 120, 7 } };
+    for (Filter filter : filters) {
+        for (auto size : sizes) {
+            LinearImage expected = resampleImage(src, size[0], size[1], filter);
+            LinearImage result(size[0], size[1], src.getChannels());
+            ViewRowSource source(ImageView::of(src));
+            ViewRowSink sink(ImageView::of(result));
+            ASSERT_TRUE(resampleImage(source, sink, size[0], size[1], ImageSampler {
+                .horizontalFilter = filter,
+                .verticalFilter = filter
+            }));
+            const uint32_t count = size[0] * size[1] * src.getChannels();
+            for (uint32_t i = 0; i < count; ++i) {
+                ASSERT_NEAR(result.getPixelRef()[i], expected.getPixelRef()[i], 1e-5f);
+            }
+        }
+    }
+
+    // Half and byte storage round-trip within their precision.
+    const uint32_t count = src.getWidth() * src.getHeight() * src.getChannels();
+    vector<uint16_t> halfs(count);
+    vector<uint8_t> bytes(count);
+    ImageView halfView = ImageView::of(src);
+    halfView.data = halfs.data();
+    halfView.type = PixelType::HALF;
+    ImageView byteView = ImageView::of(src);
+    byteView.data = bytes.data();
+    byteView.type = PixelType::UBYTE;
+    vector<float> row(src.getWidth() * src.getChannels());
+    for (uint32_t y = 0; y < src.getHeight(); ++y) {
+        halfView.storeRow(y, src.getPixelRef(0, y));
+        byteView.storeRow(y, src.getPixelRef(0, y));
+    }
+    for (uint32_t y = 0; y < src.getHeight(); ++y) {
+        halfView.loadRow(y, row.data());
+        for (uint32_t x = 0; x < row.size(); ++x) {
+            ASSERT_NEAR(row[x], src.getPixelRef(0, y)[x], 1e-3f);
+        }
+        byteView.loadRow(y, row.data());
+        for (uint32_t x = 0; x < row.size(); ++x) {
+            ASSERT_NEAR(row[x], src.getPixelRef(0, y)[x], 1.0f / 255.0f);
+        }
+    }
+}
+
+TEST_F(ImageTest, StreamingCodecs) { // NOLINT
+    LinearImage src = createColorFromAscii(
+            "44444 41014 40704 41014 44444 44444 41014 40704 41014 44444");
+    src = resampleImage(src, 37, 23, Filter::HERMITE);
+    const uint32_t width = src.getWidth();
+    const uint32_t height = src.getHeight();
+    const uint32_t channels = src.getChannels();
+
+    // Encoding rows one at a time must produce the same file as encoding the whole image.
+    using Format = ImageEncoder::Format;
+    const Format formats[] = { Format::PNG, Format::PNG_LINEAR, Format::PSD };
+    for (Format format : formats) {
+        std::ostringstream expected;
+        ASSERT_TRUE(ImageEncoder::encode(expected, format, src, "", "test"));
+        std::ostringstream result;
+        auto sink = ImageEncoder::createRowSink(result, format, width, height, channels, "",
+                "test");
+        ASSERT_NE(sink, nullptr);
+        for (uint32_t y = 0; y < height; ++y) {
+            ASSERT_TRUE(sink->writeRow(src.getPixelRef(0, y)));
+        }
+        ASSERT_FALSE(sink->writeRow(src.getPixelRef()));
+        EXPECT_EQ(result.str(), expected.str());
+    }
+
+    // Decoding rows one at a time must produce the same image as decoding the whole file.
+    const char* compressions[] = { "16", "32" };
+    for (const char* compression : compressions) {
+        std::stringstream psd;
+        ASSERT_TRUE(ImageEncoder::encode(psd, Format::PSD, src, compression, "test.psd"));
+        std::istringstream wholeStream(psd.str());
+        LinearImage expected = ImageDecoder::decode(wholeStream, "test.psd");
+        ASSERT_TRUE(expected.isValid());
+
+        std::istringstream rowStream(psd.str());
+        auto source = ImageDecoder::createRowSource(rowStream, "test.psd");
+        ASSERT_NE(source, nullptr);
+        ASSERT_EQ(source->getWidth(), width);
+        ASSERT_EQ(source->getHeight(), height);
+        ASSERT_EQ(source->getChannels(), 3u);
+        vector<float> row(width * 3);
+        for (uint32_t y = 0; y < height; ++y) {
+            ASSERT_TRUE(source->readRow(row.data()));
+            for (uint32_t x = 0; x < row.size(); ++x) {
+                ASSERT_EQ(row[x], expected.getPixelRef(0, y)[x]);
+            }
+        }
+        ASSERT_FALSE(source->readRow(row.data()));
+    }
+}
+
 TEST_F(ImageTest, Ktx) { // NOLINT
     uint8_t foo[] = {1, 2, 3};
     uint8_t* data;
@@ -18,8 +18,10 @@
 #define IMAGE_IMAGEDECODER_H_
 
 #include <iosfwd>
+#include <memory>
 #include <string>
 
+#include <image/ImageStream.h>
 #include <image/LinearImage.h>
 
 #include <utils/compiler.h>
@@ -37,6 +39,12 @@ public:
     static LinearImage decode(std::istream& stream, const std::string& sourceName,
             ColorSpace sourceSpace = ColorSpace::SRGB);
 
+    // Returns a source that produces linear floating-point rows, or nullptr if an error occured.
+    // Non-interlaced PNG files and PSD files are decoded one row at a time as the rows are read,
+    // other formats (EXR, HDR, ...) are decoded entirely up front.
+    static std::unique_ptr<RowSource> createRowSource(std::istream& stream,
+            const std::string& sourceName, ColorSpace sourceSpace = ColorSpace::SRGB);
+
     class Decoder {
     public:
         virtual LinearImage decode() = 0;
@@ -62,6 +70,10 @@ private:
         PSD,
         EXR
     };
+
+    static Format detectFormat(std::istream& stream);
+    static std::unique_ptr<Decoder> createDecoder(Format format, std::istream& stream,
+            const std::string& sourceName, ColorSpace sourceSpace);
 };
 
 } // namespace image
@@ -18,8 +18,10 @@
 #define IMAGE_IMAGEENCODER_H_
 
 #include <iosfwd>
+#include <memory>
 #include <string>
 
+#include <image/ImageStream.h>
 #include <image/LinearImage.h>
 
 #include <utils/compiler.h>
@@ -49,6 +51,13 @@ public:
     static bool encode(std::ostream& stream, Format format, const LinearImage& image,
             const std::string& compression, const std::string& destName);
 
+    // Returns a sink that encodes linear floating-point rows, or nullptr if an error occured.
+    // PNG files are encoded and written to the stream one row at a time as the rows are written,
+    // other formats are encoded once the last row has been written.
+    static std::unique_ptr<RowSink> createRowSink(std::ostream& stream, Format format,
+            uint32_t width, uint32_t height, uint32_t channels,
+            const std::string& compression, const std::string& destName);
+
     static Format chooseFormat(const std::string& name, bool forceLinear = false);
     static std::string chooseExtension(Format format);
 
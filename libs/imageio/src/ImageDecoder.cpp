@@ -56,13 +56,21 @@ public:
 
     PNGDecoder(const PNGDecoder&) = delete;
     PNGDecoder& operator=(const PNGDecoder&) = delete;
+    ~PNGDecoder() override;
+
+    // Incremental decoding. startRows() returns false and rewinds the stream if the file is
+    // interlaced or invalid, in which case it must be decoded with decode().
+    bool startRows(uint32_t* width, uint32_t* height, uint32_t* channels);
+    bool readRow(float* dst);
 
 private:
     explicit PNGDecoder(std::istream& stream);
-    ~PNGDecoder() override;
 
     void init();
 
+    // Reads the header and configures libpng to output 16-bit RGB or RGBA.
+    void readInfo();
+
     // ImageDecoder::Decoder interface
     LinearImage decode() override;
 
@@ -76,6 +84,9 @@ private:
     png_infop mInfo = nullptr;
     std::istream& mStream;
     std::streampos mStreamStartPos;
+    std::unique_ptr<uint8_t[]> mRowData;
+    uint32_t mRowWidth = 0;
+    uint32_t mRowChannels = 0;
 };
 
 // -----------------------------------------------------------------------------------------------
@@ -87,10 +98,18 @@ public:
 
     PSDDecoder(const PSDDecoder&) = delete;
     PSDDecoder& operator=(const PSDDecoder&) = delete;
+    ~PSDDecoder() override;
+
+    // Incremental decoding. Channels are stored one after the other, so each row is gathered
+    // from the three channel planes, which requires a seekable stream.
+    bool startRows(uint32_t* width, uint32_t* height);
+    bool readRow(float* dst);
 
 private:
     explicit PSDDecoder(std::istream& stream);
-    ~PSDDecoder() override;
+
+    // Reads the header and leaves the stream at the start of the pixel data.
+    void readHeader();
 
     // ImageDecoder::Decoder interface
     LinearImage decode() override;
@@ -98,6 +117,12 @@ private:
     static const char sig[];
     std::istream& mStream;
     std::streampos mStreamStartPos;
+    std::streampos mDataPos;
+    uint32_t mWidth = 0;
+    uint32_t mHeight = 0;
+    uint16_t mDepth = 0;
+    uint32_t mRow = 0;
+    std::vector<char> mRowData;
 };
 
 // -----------------------------------------------------------------------------------------------
@@ -125,9 +150,7 @@ private:
 
 // -----------------------------------------------------------------------------------------------
 
-LinearImage ImageDecoder::decode(std::istream& stream, const std::string& sourceName,
-        ColorSpace sourceSpace) {
-
+ImageDecoder::Format ImageDecoder::detectFormat(std::istream& stream) {
     Format format = Format::NONE;
 
     std::streampos pos = stream.tellg();
@@ -145,11 +168,15 @@ LinearImage ImageDecoder::decode(std::istream& stream, const std::string& source
     }
 
     stream.seekg(pos);
+    return format;
+}
 
+std::unique_ptr<ImageDecoder::Decoder> ImageDecoder::createDecoder(Format format,
+        std::istream& stream, const std::string& sourceName, ColorSpace sourceSpace) {
     std::unique_ptr<Decoder> decoder;
     switch (format) {
         case Format::NONE:
-            return LinearImage();
+            break;
         case Format::PNG:
             decoder.reset(PNGDecoder::create(stream));
             decoder->setColorSpace(sourceSpace);
@@ -167,8 +194,97 @@ LinearImage ImageDecoder::decode(std::istream& stream, const std::string& source
             decoder->setColorSpace(ColorSpace::LINEAR);
             break;
     }
+    return decoder;
+}
+
+LinearImage ImageDecoder::decode(std::istream& stream, const std::string& sourceName,
+        ColorSpace sourceSpace) {
+    std::unique_ptr<Decoder> decoder =
+            createDecoder(detectFormat(stream), stream, sourceName, sourceSpace);
+    return decoder ? decoder->decode() : LinearImage();
+}
+
+// RowSource that hands out the rows of a fully decoded image.
+class LinearImageRowSource : public RowSource {
+public:
+    explicit LinearImageRowSource(LinearImage image) noexcept
+            : RowSource(image.getWidth(), image.getHeight(), image.getChannels()),
+              mImage(std::move(image)) {}
+
+    bool readRow(float* dst) override {
+        if (mRow >= getHeight()) {
+            return false;
+        }
+        ImageView::of(mImage).loadRow(mRow++, dst);
+        return true;
+    }
+
+private:
+    LinearImage mImage;
+    uint32_t mRow = 0;
+};
+
+// RowSource that decodes a PNG file one row at a time.
+class PNGRowSource : public RowSource {
+public:
+    PNGRowSource(std::unique_ptr<PNGDecoder> decoder, uint32_t width, uint32_t height,
+            uint32_t channels) noexcept
+            : RowSource(width, height, channels), mDecoder(std::move(decoder)) {}
+
+    bool readRow(float* dst) override {
+        if (mRow >= getHeight()) {
+            return false;
+        }
+        mRow++;
+        return mDecoder->readRow(dst);
+    }
+
+private:
+    std::unique_ptr<PNGDecoder> mDecoder;
+    uint32_t mRow = 0;
+};
+
+// RowSource that decodes a PSD file one row at a time.
+class PSDRowSource : public RowSource {
+public:
+    PSDRowSource(std::unique_ptr<PSDDecoder> decoder, uint32_t width, uint32_t height) noexcept
+            : RowSource(width, height, 3), mDecoder(std::move(decoder)) {}
 
-    return decoder->decode();
+    bool readRow(float* dst) override {
+        return mDecoder->readRow(dst);
+    }
+
+private:
+    std::unique_ptr<PSDDecoder> mDecoder;
+};
+
+std::unique_ptr<RowSource> ImageDecoder::createRowSource(std::istream& stream,
+        const std::string& sourceName, ColorSpace sourceSpace) {
+    const Format format = detectFormat(stream);
+    if (format == Format::PNG) {
+        std::unique_ptr<PNGDecoder> decoder(PNGDecoder::create(stream));
+        decoder->setColorSpace(sourceSpace);
+        uint32_t width, height, channels;
+        if (decoder->startRows(&width, &height, &channels)) {
+            return std::make_unique<PNGRowSource>(std::move(decoder), width, height, channels);
+        }
+        // startRows() rewinds the stream when the file cannot be streamed (e.g. interlaced).
+    }
+    if (format == Format::PSD) {
+        std::unique_ptr<PSDDecoder> decoder(PSDDecoder::create(stream));
+        uint32_t width, height;
+        if (decoder->startRows(&width, &height)) {
+            return std::make_unique<PSDRowSource>(std::move(decoder), width, height);
+        }
+        return nullptr;
+    }
+    // the other decoders can only decode whole images
+    std::unique_ptr<Decoder> decoder = createDecoder(format, stream, sourceName, sourceSpace);
+    LinearImage image = decoder ? decoder->decode() : LinearImage();
+    if (!image.isValid()) {
+        return nullptr;
+    }
+    return std::make_unique<LinearImageRowSource>(std::move(image));
 }
 
 // -----------------------------------------------------------------------------------------------
@@ -212,45 +328,49 @@ PNGDecoder::~PNGDecoder() {
     png_destroy_read_struct(&mPNG, &mInfo, nullptr);
 }
 
-LinearImage PNGDecoder::decode() {
-    std::unique_ptr<uint8_t[]> imageData;
-    try {
-        mInfo = png_create_info_struct(mPNG);
-        png_read_info(mPNG, mInfo);
+void PNGDecoder::readInfo() {
+    mInfo = png_create_info_struct(mPNG);
+    png_read_info(mPNG, mInfo);
 
-        int colorType = png_get_color_type(mPNG, mInfo);
-        int bitDepth = png_get_bit_depth(mPNG, mInfo);
+    int colorType = png_get_color_type(mPNG, mInfo);
+    int bitDepth = png_get_bit_depth(mPNG, mInfo);
 
-        if (colorType == PNG_COLOR_TYPE_PALETTE) {
-            png_set_palette_to_rgb(mPNG);
-        }
-        if (colorType == PNG_COLOR_TYPE_GRAY || colorType == PNG_COLOR_TYPE_GRAY_ALPHA) {
-            if (bitDepth < 8) {
-                png_set_expand_gray_1_2_4_to_8(mPNG);
-            }
-            png_set_gray_to_rgb(mPNG);
-        }
-        if (png_get_valid(mPNG, mInfo, PNG_INFO_tRNS)) {
-            png_set_tRNS_to_alpha(mPNG);
-        }
-        if (getColorSpace() == ImageDecoder::ColorSpace::SRGB) {
-            double gamma = 1.0;
-            png_get_gAMA(mPNG, mInfo, &gamma);
-            if (gamma != 1.0) {
-                png_set_alpha_mode(mPNG, PNG_ALPHA_PNG, PNG_DEFAULT_sRGB);
-            }
-        } else {
-            png_set_gamma_fixed(mPNG, PNG_FP_1, PNG_FP_1);
-            png_set_alpha_mode(mPNG, PNG_ALPHA_PNG, PNG_GAMMA_LINEAR);
+    if (colorType == PNG_COLOR_TYPE_PALETTE) {
+        png_set_palette_to_rgb(mPNG);
+    }
+    if (colorType == PNG_COLOR_TYPE_GRAY || colorType == PNG_COLOR_TYPE_GRAY_ALPHA) {
+        if (bitDepth < 8) {
+            png_set_expand_gray_1_2_4_to_8(mPNG);
         }
-        if (bitDepth < 16) {
-            png_set_expand_16(mPNG);
+        png_set_gray_to_rgb(mPNG);
+    }
+    if (png_get_valid(mPNG, mInfo, PNG_INFO_tRNS)) {
+        png_set_tRNS_to_alpha(mPNG);
+    }
+    if (getColorSpace() == ImageDecoder::ColorSpace::SRGB) {
+        double gamma = 1.0;
+        png_get_gAMA(mPNG, mInfo, &gamma);
+        if (gamma != 1.0) {
+            png_set_alpha_mode(mPNG, PNG_ALPHA_PNG, PNG_DEFAULT_sRGB);
         }
+    } else {
+        png_set_gamma_fixed(mPNG, PNG_FP_1, PNG_FP_1);
+        png_set_alpha_mode(mPNG, PNG_ALPHA_PNG, PNG_GAMMA_LINEAR);
+    }
+    if (bitDepth < 16) {
+        png_set_expand_16(mPNG);
+    }
+
+    png_read_update_info(mPNG, mInfo);
+}
 
-        png_read_update_info(mPNG, mInfo);
+LinearImage PNGDecoder::decode() {
+    std::unique_ptr<uint8_t[]> imageData;
+    try {
+        readInfo();
 
         // Read updated color type since we may have asked for a conversion before
-        colorType = png_get_color_type(mPNG, mInfo);
+        int colorType = png_get_color_type(mPNG, mInfo);
 
         uint32_t width  = png_get_image_width(mPNG, mInfo);
         uint32_t height = png_get_image_height(mPNG, mInfo);
@@ -295,6 +415,58 @@ LinearImage PNGDecoder::decode() {
     return LinearImage();
 }
 
+bool PNGDecoder::startRows(uint32_t* width, uint32_t* height, uint32_t* channels) {
+    try {
+        readInfo();
+        if (png_get_interlace_type(mPNG, mInfo) != PNG_INTERLACE_NONE) {
+            mStream.seekg(mStreamStartPos);
+            return false;
+        }
+        const int colorType = png_get_color_type(mPNG, mInfo);
+        mRowWidth = png_get_image_width(mPNG, mInfo);
+        mRowChannels = colorType == PNG_COLOR_TYPE_RGBA ? 4 : 3;
+        mRowData = std::make_unique<uint8_t[]>(png_get_rowbytes(mPNG, mInfo));
+        *width = mRowWidth;
+        *height = png_get_image_height(mPNG, mInfo);
+        *channels = mRowChannels;
+        return true;
+    } catch(std::runtime_error& e) {
+        std::cerr << "Runtime error while decoding PNG: " << e.what() << std::endl;
+        mStream.seekg(mStreamStartPos);
+    }
+    return false;
+}
+
+bool PNGDecoder::readRow(float* dst) {
+    try {
+        png_read_row(mPNG, mRowData.get(), nullptr);
+    } catch(std::runtime_error& e) {
+        std::cerr << "Runtime error while decoding PNG: " << e.what() << std::endl;
+        return false;
+    }
+
+    // Same conversion as toLinear / toLinearWithAlpha, PNG 16 stores data in network order.
+    const bool sRGB = getColorSpace() == ImageDecoder::ColorSpace::SRGB;
+    uint16_t const* p = reinterpret_cast<uint16_t const*>(mRowData.get());
+    constexpr float scale = 1.0f / std::numeric_limits<uint16_t>::max();
+    if (mRowChannels == 4) {
+        auto* d = reinterpret_cast<filament::math::float4*>(dst);
+        for (uint32_t x = 0; x < mRowWidth; ++x, p += 4) {
+            filament::math::float4 c(ntohs(p[0]), ntohs(p[1]), ntohs(p[2]), ntohs(p[3]));
+            c *= scale;
+            *d++ = sRGB ? sRGBToLinear(c) : c;
+        }
+    } else {
+        auto* d = reinterpret_cast<filament::math::float3*>(dst);
+        for (uint32_t x = 0; x < mRowWidth; ++x, p += 3) {
+            filament::math::float3 c(ntohs(p[0]), ntohs(p[1]), ntohs(p[2]));
+            c *= scale;
+            *d++ = sRGB ? sRGBToLinear(c) : c;
+        }
+    }
+    return true;
+}
+
 void PNGDecoder::cb_stream(png_structp png, png_bytep buffer, png_size_t size) {
     PNGDecoder* that = static_cast<PNGDecoder*>(png_get_io_ptr(png));
     that->stream(buffer, size);
@@ -335,7 +507,7 @@ PSDDecoder::PSDDecoder(std::istream& stream)
 
 PSDDecoder::~PSDDecoder() = default;
 
-LinearImage PSDDecoder::decode() {
+void PSDDecoder::readHeader() {
     #pragma pack(push, 1)
     // IMPORTANT NOTE: PSD files use big endian storage
     struct Header {
@@ -353,50 +525,58 @@ LinearImage PSDDecoder::decode() {
     static const uint16_t kColorModeRGB = 3;
     static const uint16_t kCompressionRAW = 0;
 
-    try {
-        Header h = { };
-        mStream.read(reinterpret_cast<char*>(&h), sizeof(Header));
+    Header h = { };
+    mStream.read(reinterpret_cast<char*>(&h), sizeof(Header));
 
-        if (ntohs(h.channels) != 3) {
-            throw std::runtime_error("the image must have 3 channels only");
-        }
+    if (ntohs(h.channels) != 3) {
+        throw std::runtime_error("the image must have 3 channels only");
+    }
 
-        uint16_t depth = ntohs(h.depth);
-        if (depth != 16 && depth != 32) {
-            throw std::runtime_error("the image depth must be 16 or 32 bits per pixel");
-        }
+    mDepth = ntohs(h.depth);
+    if (mDepth != 16 && mDepth != 32) {
+        throw std::runtime_error("the image depth must be 16 or 32 bits per pixel");
+    }
 
-        if (ntohs(h.mode) != kColorModeRGB) {
-            throw std::runtime_error("the image must be RGB");
-        }
+    if (ntohs(h.mode) != kColorModeRGB) {
+        throw std::runtime_error("the image must be RGB");
+    }
 
-        uint32_t width = ntohl(h.width);
-        uint32_t height = ntohl(h.height);
+    mWidth = ntohl(h.width);
+    mHeight = ntohl(h.height);
 
-        uint32_t length;
+    uint32_t length;
 
-        // color mode data section
-        mStream.read(reinterpret_cast<char*>(&length), sizeof(uint32_t));
-        mStream.seekg(ntohl(length), std::istream::cur);
+    // color mode data section
+    mStream.read(reinterpret_cast<char*>(&length), sizeof(uint32_t));
+    mStream.seekg(ntohl(length), std::istream::cur);
 
-        // image resources
-        mStream.read(reinterpret_cast<char*>(&length), sizeof(uint32_t));
-        mStream.seekg(ntohl(length), std::istream::cur);
+    // image resources
+    mStream.read(reinterpret_cast<char*>(&length), sizeof(uint32_t));
+    mStream.seekg(ntohl(length), std::istream::cur);
 
-        // layer and mask info section
-        mStream.read(reinterpret_cast<char*>(&length), sizeof(uint32_t));
-        mStream.seekg(ntohl(length), std::istream::cur);
+    // layer and mask info section
+    mStream.read(reinterpret_cast<char*>(&length), sizeof(uint32_t));
+    mStream.seekg(ntohl(length), std::istream::cur);
 
-        // compression format
-        uint16_t compression;
-        mStream.read(reinterpret_cast<char*>(&compression), sizeof(uint16_t));
-        if (ntohs(compression) != kCompressionRAW) {
-            throw std::runtime_error("compressed images are not supported");
-        }
+    // compression format
+    uint16_t compression;
+    mStream.read(reinterpret_cast<char*>(&compression), sizeof(uint16_t));
+    if (ntohs(compression) != kCompressionRAW) {
+        throw std::runtime_error("compressed images are not supported");
+    }
 
+    mDataPos = mStream.tellg();
+}
+
+LinearImage PSDDecoder::decode() {
+    try {
+        readHeader();
+
+        const uint32_t width = mWidth;
+        const uint32_t height = mHeight;
         LinearImage image(width, height, 3);
 
-        if (depth == 32) {
+        if (mDepth == 32) {
             for (size_t i = 0; i < 3; i++) {
                 for (uint32_t y = 0; y < height; y++) {
                     for (uint32_t x = 0; x < width; x++) {
@@ -428,6 +608,54 @@ LinearImage PSDDecoder::decode() {
     return LinearImage();
 }
 
+bool PSDDecoder::startRows(uint32_t* width, uint32_t* height) {
+    try {
+        readHeader();
+        if (!mStream.good()) {
+            throw std::runtime_error("truncated header");
+        }
+        mRowData.resize(size_t(mWidth) * (mDepth / 8));
+        *width = mWidth;
+        *height = mHeight;
+        return true;
+    } catch(std::runtime_error& e) {
+        std::cerr << "Runtime error while decoding PSD: " << e.what() << std::endl;
+        mStream.seekg(mStreamStartPos);
+    }
+    return false;
+}
+
+bool PSDDecoder::readRow(float* dst) {
+    if (mRow >= mHeight) {
+        return false;
+    }
+    const size_t rowSize = mRowData.size();
+    for (uint32_t c = 0; c < 3; c++) {
+        mStream.seekg(mDataPos + std::streamoff((size_t(c) * mHeight + mRow) * rowSize));
+        mStream.read(mRowData.data(), rowSize);
+        if (!mStream.good()) {
+            std::cerr << "Runtime error while decoding PSD: truncated image" << std::endl;
+            return false;
+        }
+        // same conversions as read32() and read16()
+        if (mDepth == 32) {
+            uint32_t const* p = reinterpret_cast<uint32_t const*>(mRowData.data());
+            for (uint32_t x = 0; x < mWidth; x++) {
+                uint32_t data = ntohl(p[x]);
+                memcpy(&dst[x * 3 + c], &data, sizeof(float));
+            }
+        } else {
+            uint16_t const* p = reinterpret_cast<uint16_t const*>(mRowData.data());
+            for (uint32_t x = 0; x < mWidth; x++) {
+                dst[x * 3 + c] =
+                        static_cast<float>(ntohs(p[x])) / std::numeric_limits<uint16_t>::max();
+            }
+        }
+    }
+    mRow++;
+    return true;
+}
+
 // -----------------------------------------------------------------------------------------------
 
 const char EXRDecoder::sig[] = { 0x76, 0x2f, 0x31, 0x01 };
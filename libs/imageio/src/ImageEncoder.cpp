@@ -60,17 +60,25 @@ public:
 
     PNGEncoder(const PNGEncoder&) = delete;
     PNGEncoder& operator=(const PNGEncoder&) = delete;
+    ~PNGEncoder() override;
+
+    // Incremental encoding, each row is converted and written to the stream as it comes.
+    bool startRows(uint32_t width, uint32_t height, uint32_t channels);
+    bool writeRow(const LinearImage& row);
 
 private:
     PNGEncoder(std::ostream& stream, PixelFormat format);
-    ~PNGEncoder() override;
 
     void init();
 
     // ImageEncoder::Encoder interface
     bool encode(const LinearImage& image) override;
 
-    int chooseColorType(const LinearImage& image) const;
+    bool checkChannels(size_t channels) const;
+    void writeHeader(size_t width, size_t height, size_t channels);
+    std::unique_ptr<uint8_t[]> convert(const LinearImage& image) const;
+
+    int chooseColorType(size_t channels) const;
     uint32_t getChannelsCount(int colorType) const;
 
     static void cb_error(png_structp png, png_const_charp error);
@@ -85,6 +93,7 @@ private:
     std::streampos mStreamStartPos;
 
     PixelFormat mFormat;
+    uint32_t mRowsLeft = 0;
 };
 
 // ------------------------------------------------------------------------------------------------
@@ -223,6 +232,70 @@ bool ImageEncoder::encode(std::ostream& stream, Format format, const LinearImage
     return encoder->encode(image);
 }
 
+// RowSink that encodes a PNG file one row at a time.
+class PNGRowSink : public RowSink {
+public:
+    PNGRowSink(std::unique_ptr<PNGEncoder> encoder, uint32_t width, uint32_t channels)
+            : mEncoder(std::move(encoder)), mRow(width, 1, channels) {}
+
+    bool writeRow(float const* src) override {
+        memcpy(mRow.getPixelRef(), src,
+                size_t(mRow.getWidth()) * mRow.getChannels() * sizeof(float));
+        return mEncoder->writeRow(mRow);
+    }
+
+private:
+    std::unique_ptr<PNGEncoder> mEncoder;
+    LinearImage mRow;
+};
+
+// RowSink that accumulates the rows of an image, and encodes it after its last row.
+class LinearImageRowSink : public RowSink {
+public:
+    LinearImageRowSink(std::ostream& stream, ImageEncoder::Format format, LinearImage image,
+            std::string compression, std::string destName)
+            : mStream(stream), mFormat(format), mImage(std::move(image)),
+              mCompression(std::move(compression)), mDestName(std::move(destName)) {}
+
+    bool writeRow(float const* src) override {
+        if (mRow >= mImage.getHeight()) {
+            return false;
+        }
+        ImageView::of(mImage).storeRow(mRow++, src);
+        if (mRow == mImage.getHeight()) {
+            return ImageEncoder::encode(mStream, mFormat, mImage, mCompression, mDestName);
+        }
+        return true;
+    }
+
+private:
+    std::ostream& mStream;
+    ImageEncoder::Format mFormat;
+    LinearImage mImage;
+    std::string mCompression;
+    std::string mDestName;
+    uint32_t mRow = 0;
+};
+
+std::unique_ptr<RowSink> ImageEncoder::createRowSink(std::ostream& stream, Format format,
+        uint32_t width, uint32_t height, uint32_t channels,
+        const std::string& compression, const std::string& destName) {
+    if (width == 0 || height == 0) {
+        return nullptr;
+    }
+    if (format == Format::PNG || format == Format::PNG_LINEAR) {
+        std::unique_ptr<PNGEncoder> encoder(PNGEncoder::create(stream,
+                format == Format::PNG ? PNGEncoder::PixelFormat::sRGB :
+                        PNGEncoder::PixelFormat::LINEAR_RGB));
+        if (!encoder->startRows(width, height, channels)) {
+            return nullptr;
+        }
+        return std::make_unique<PNGRowSink>(std::move(encoder), width, channels);
+    }
+    return std::make_unique<LinearImageRowSink>(stream, format,
+            LinearImage(width, height, channels), compression, destName);
+}
+
 ImageEncoder::Format ImageEncoder::chooseFormat(const std::string& name, bool forceLinear) {
     std::string ext;
     size_t index = name.rfind('.');
@@ -293,8 +366,7 @@ void PNGEncoder::init() {
     png_set_write_fn(mPNG, this, cb_stream, nullptr);
 }
 
-int PNGEncoder::chooseColorType(const LinearImage& image) const {
-    size_t channels = image.getChannels();
+int PNGEncoder::chooseColorType(size_t channels) const {
     switch (channels) {
         case 1:
             return PNG_COLOR_TYPE_GRAY;
@@ -329,9 +401,7 @@ uint32_t PNGEncoder::getChannelsCount(int colorType) const {
     }
 }
 
-bool PNGEncoder::encode(const LinearImage& image) {
-    size_t srcChannels = image.getChannels();
-
+bool PNGEncoder::checkChannels(size_t srcChannels) const {
     switch (mFormat) {
         case PixelFormat::RGBM:
         case PixelFormat::RGB_10_11_11_REV:
@@ -347,59 +417,65 @@ bool PNGEncoder::encode(const LinearImage& image) {
             }
             break;
     }
+    return true;
+}
 
-    try {
-        mInfo = png_create_info_struct(mPNG);
+void PNGEncoder::writeHeader(size_t width, size_t height, size_t channels) {
+    mInfo = png_create_info_struct(mPNG);
 
-        // Write header (8 bit colour depth)
-        size_t width = image.getWidth();
-        size_t height = image.getHeight();
-        int colorType = chooseColorType(image);
+    // Write header (8 bit colour depth)
+    png_set_IHDR(mPNG, mInfo, width, height,
+                 8, chooseColorType(channels), PNG_INTERLACE_NONE,
+                 PNG_COMPRESSION_TYPE_BASE, PNG_FILTER_TYPE_BASE);
 
-        png_set_IHDR(mPNG, mInfo, width, height,
-                     8, colorType, PNG_INTERLACE_NONE,
-                     PNG_COMPRESSION_TYPE_BASE, PNG_FILTER_TYPE_BASE);
+    if (mFormat == PixelFormat::LINEAR_RGB || mFormat == PixelFormat::RGB_10_11_11_REV) {
+        png_set_gAMA(mPNG, mInfo, 1.0);
+    } else {
+        png_set_sRGB_gAMA_and_cHRM(mPNG, mInfo, PNG_sRGB_INTENT_PERCEPTUAL);
+    }
 
-        if (mFormat == PixelFormat::LINEAR_RGB || mFormat == PixelFormat::RGB_10_11_11_REV) {
-            png_set_gAMA(mPNG, mInfo, 1.0);
-        } else {
-            png_set_sRGB_gAMA_and_cHRM(mPNG, mInfo, PNG_sRGB_INTENT_PERCEPTUAL);
-        }
+    png_write_info(mPNG, mInfo);
+}
 
-        png_write_info(mPNG, mInfo);
+std::unique_ptr<uint8_t[]> PNGEncoder::convert(const LinearImage& image) const {
+    if (image.getChannels() == 1) {
+        return fromLinearToGrayscale<uint8_t>(image);
+    }
+    const uint32_t dstChannels = getChannelsCount(chooseColorType(image.getChannels()));
+    switch (mFormat) {
+        case PixelFormat::RGBM:
+            return fromLinearToRGBM<uint8_t>(image);
+        case PixelFormat::RGB_10_11_11_REV:
+            return fromLinearToRGB_10_11_11_REV(image);
+        case PixelFormat::sRGB:
+            if (dstChannels == 4) {
+                return fromLinearTosRGB<uint8_t, 4>(image);
+            }
+            return fromLinearTosRGB<uint8_t, 3>(image);
+        case PixelFormat::LINEAR_RGB:
+            if (dstChannels == 4) {
+                return fromLinearToRGB<uint8_t, 4>(image);
+            }
+            return fromLinearToRGB<uint8_t, 3>(image);
+    }
+    return nullptr;
+}
 
-        std::unique_ptr<png_bytep[]> row_pointers(new png_bytep[height]);
-        std::unique_ptr<uint8_t[]> data;
+bool PNGEncoder::encode(const LinearImage& image) {
+    size_t srcChannels = image.getChannels();
+    if (!checkChannels(srcChannels)) {
+        return false;
+    }
 
-        uint32_t dstChannels;
-        if (srcChannels == 1) {
-            dstChannels = 1;
-            data = fromLinearToGrayscale<uint8_t>(image);
-        } else {
-            dstChannels = getChannelsCount(colorType);
-            switch (mFormat) {
-                case PixelFormat::RGBM:
-                    data = fromLinearToRGBM<uint8_t>(image);
-                    break;
-                case PixelFormat::RGB_10_11_11_REV:
-                    data = fromLinearToRGB_10_11_11_REV(image);
-                    break;
-                case PixelFormat::sRGB:
-                    if (dstChannels == 4) {
-                        data = fromLinearTosRGB<uint8_t, 4>(image);
-                    } else {
-                        data = fromLinearTosRGB<uint8_t, 3>(image);
-                    }
-                    break;
-                case PixelFormat::LINEAR_RGB:
-                    if (dstChannels == 4) {
-                        data = fromLinearToRGB<uint8_t, 4>(image);
-                    } else {
-                        data = fromLinearToRGB<uint8_t, 3>(image);
-                    }
-                    break;
-            }
-        }
+    try {
+        size_t width = image.getWidth();
+        size_t height = image.getHeight();
+        writeHeader(width, height, srcChannels);
+
+        std::unique_ptr<png_bytep[]> row_pointers(new png_bytep[height]);
+        std::unique_ptr<uint8_t[]> data = convert(image);
+        uint32_t dstChannels = srcChannels == 1 ? 1 :
+                getChannelsCount(chooseColorType(srcChannels));
 
         for (size_t y = 0; y < height; y++) {
             row_pointers[y] = reinterpret_cast<png_bytep>
@@ -418,6 +494,42 @@ bool PNGEncoder::encode(const LinearImage& image) {
     return true;
 }
 
+bool PNGEncoder::startRows(uint32_t width, uint32_t height, uint32_t channels) {
+    if (!checkChannels(channels)) {
+        return false;
+    }
+    try {
+        writeHeader(width, height, channels);
+        mRowsLeft = height;
+    } catch (std::runtime_error& e) {
+        std::cerr << "Runtime error while encoding PNG: " << e.what() << std::endl;
+        mStream.seekp(mStreamStartPos);
+        return false;
+    }
+    return true;
+}
+
+bool PNGEncoder::writeRow(const LinearImage& row) {
+    if (mRowsLeft == 0) {
+        return false;
+    }
+    try {
+        // the conversions are per-pixel, so converting a single row is the same as converting
+        // the whole image
+        std::unique_ptr<uint8_t[]> data = convert(row);
+        png_write_row(mPNG, reinterpret_cast<png_bytep>(data.get()));
+        if (--mRowsLeft == 0) {
+            png_write_end(mPNG, mInfo);
+            mStream.flush();
+        }
+    } catch (std::runtime_error& e) {
+        std::cerr << "Runtime error while encoding PNG: " << e.what() << std::endl;
+        mRowsLeft = 0;
+        return false;
+    }
+    return true;
+}
+
 void PNGEncoder::cb_stream(png_structp png, png_bytep buffer, png_size_t size) {
     PNGEncoder* that = static_cast<PNGEncoder*>(png_get_io_ptr(png));
     that->stream(buffer, size);
@@ -210,6 +210,16 @@ bool ShaderReplacer::replaceSpirv(ShaderModel shaderModel, Variant variant,
 
     assert_invariant(mMaterialTag == ChunkType::MaterialSpirv);
 
+    // BlobIndex only handles SMOL-V blobs, not the compressed ones of matc --compress.
+    uint32_t compressionScheme = 0;
+    if (cc.getChunkEnd(mDictionaryTag) - cc.getChunkStart(mDictionaryTag) >= 4) {
+        memcpy(&compressionScheme, cc.getChunkStart(mDictionaryTag), 4);
+    }
+    if (compressionScheme != 1) {
+        slog.e << "ShaderReplacer cannot edit compressed SPIR-V." << io::endl;
+        return false;
+    }
+
     const EShLanguage shLang = stage == VERTEX ? EShLangVertex : EShLangFragment;
 
     std::string nullTerminated(source, sourceLength);
@@ -14,7 +14,9 @@
  * limitations under the License.
  */
 
+#include <filaflat/BlobDictionary.h>
 #include <filaflat/ChunkContainer.h>
+#include <filaflat/DictionaryReader.h>
 
 #include <filament/MaterialEnums.h>
 
@@ -333,6 +335,55 @@ static void printChunks(ostream& text, const ChunkContainer& container) {
     }
 }
 
+// Prints how much space the SPIR-V shaders take at each stage of their decoding.
+static bool printSpirvDictionary(ostream& text, const ChunkContainer& container) {
+    if (!container.hasChunk(ChunkType::DictionarySpirv)) {
+        return true;
+    }
+    BlobDictionary dictionary;
+    if (!DictionaryReader::unflatten(container, ChunkType::DictionarySpirv, dictionary,
+            /* decodeSpirv = */ false)) {
+        return false;
+    }
+
+    const BlobDictionary::EncodedBlob& deflateDictionary = dictionary.getDeflateDictionary();
+    size_t storedSize = 0;
+    size_t smolvSize = 0;
+    size_t spirvSize = 0;
+    bool decoded = true; // decoding requires Vulkan support in filaflat
+    for (size_t i = 0; i < dictionary.size(); i++) {
+        const BlobDictionary::EncodedBlob* blob = dictionary.getEncodedBlob(i);
+        if (!blob) {
+            return false;
+        }
+        BlobDictionary::Blob spirv;
+        decoded = decoded && DictionaryReader::decodeSpirv(dictionary, *blob, spirv);
+        storedSize += blob->size;
+        smolvSize += blob->inflatedSize ? blob->inflatedSize : blob->size;
+        spirvSize += spirv.size();
+    }
+
+    text << "SPIR-V dictionary:" << endl;
+    text << "    " << setw(alignment) << left << "Compression: ";
+    text << (deflateDictionary.data ? "SMOL-V, deflate" : "SMOL-V") << endl;
+    text << "    " << setw(alignment) << left << "Shaders: ";
+    text << dictionary.size() << endl;
+    if (deflateDictionary.data) {
+        text << "    " << setw(alignment) << left << "Deflate dictionary size: ";
+        text << deflateDictionary.size << endl;
+    }
+    text << "    " << setw(alignment) << left << "Stored size: ";
+    text << storedSize << endl;
+    text << "    " << setw(alignment) << left << "SMOL-V size: ";
+    text << smolvSize << endl;
+    if (decoded) {
+        text << "    " << setw(alignment) << left << "SPIR-V size: ";
+        text << spirvSize << endl;
+    }
+    text << endl;
+    return true;
+}
+
 static void printShaderInfo(ostream& text, const vector<ShaderInfo>& info,
         const ChunkContainer& container) {
     MaterialDomain domain = MaterialDomain::SURFACE;
@@ -406,6 +457,10 @@ bool TextWriter::writeMaterialInfo(const filaflat::ChunkContainer& container) {
         return false;
     }
 
+    if (!printSpirvDictionary(text, container)) {
+        return false;
+    }
+
     printChunks(text, container);
 
     text << endl;
@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PerformanceCounters.h"
+
+#include <utils/Entity.h>
+#include <utils/EntityManager.h>
+
+#include <benchmark/benchmark.h>
+
+using namespace utils;
+
+// Keeps the free-list populated so that we measure the steady-state of a streaming workload,
+// where indices are recycled rather than freshly allocated.
+static void warmup(EntityManager& em) {
+    static const bool sWarm = [&em]() {
+        Entity entities[4096];
+        em.create(4096, entities);
+        em.destroy(4096, entities);
+        return true;
+    }();
+    (void)sWarm;
+}
+
+static void BM_entity_create_destroy(benchmark::State& state) {
+    EntityManager& em = EntityManager::get();
+    warmup(em);
+    PerformanceCounters pc(state);
+    for (auto _ : state) {
+        Entity e = em.create();
+        benchmark::DoNotOptimize(e);
+        em.destroy(e);
+    }
+}
+
+static void BM_entity_create_destroy_batch(benchmark::State& state) {
+    EntityManager& em = EntityManager::get();
+    warmup(em);
+    Entity entities[64];
+    PerformanceCounters pc(state);
+    for (auto _ : state) {
+        em.create(64, entities);
+        benchmark::DoNotOptimize(entities);
+        em.destroy(64, entities);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * 64);
+}
+
+BENCHMARK(BM_entity_create_destroy)
+    ->Threads(1)
+    ->Threads(2)
+    ->Threads(8)
+    ->ThreadPerCpu();
+
+BENCHMARK(BM_entity_create_destroy_batch)
+    ->Threads(1)
+    ->Threads(2)
+    ->Threads(8)
+    ->ThreadPerCpu();
@@ -20,6 +20,8 @@
 #include <assert.h>
 #include <stdint.h>
 
+#include <atomic>
+
 #include <utils/Entity.h>
 #include <utils/compiler.h>
 
@@ -77,7 +79,7 @@ public:
     // Thread safe.
     bool isAlive(Entity e) const noexcept {
         assert(getIndex(e) < RAW_INDEX_COUNT);
-        return (!e.isNull()) && (getGeneration(e) == mGens[getIndex(e)]);
+        return (!e.isNull()) && (getGeneration(e) == mGens[getIndex(e)].load(std::memory_order_relaxed));
     }
 
     // registers a listener to be called when an entity is destroyed. thread safe.
@@ -87,12 +89,32 @@ public:
     // unregisters a listener.
     void unregisterListener(Listener* l) noexcept;
 
+    // Destroyed entities are recorded, in order, in a bounded journal. Each consumer (typically a
+    // component manager) keeps its own position in the journal and reads it incrementally, which
+    // lets it reclaim the components of dead entities deterministically.
+    // The journal only keeps the last getJournalCapacity() entries, a consumer that falls further
+    // behind is told so and must then sweep all its components instead.
+
+    // number of entries kept in the journal
+    static constexpr size_t getJournalCapacity() noexcept { return JOURNAL_CAPACITY; }
+
+    // position of the next journal entry to be written. Thread safe.
+    uint64_t getJournalPosition() const noexcept;
+
+    // Reads at most count destroyed entities from the journal, starting at *position, and
+    // advances *position past them. Returns the number of entities read.
+    // If entries were lost because *position is too far behind, *overflow is set to true, no
+    // entity is returned and *position is moved to the current position of the journal.
+    // Thread safe.
+    size_t readJournal(uint64_t* position, Entity* entities, size_t count,
+            bool* overflow) const noexcept;
+
 
     /* no user serviceable parts below */
 
     // current generation of the given index. Use for debugging and testing.
     uint8_t getGenerationForIndex(size_t index) const noexcept {
-        return mGens[index];
+        return mGens[index].load(std::memory_order_relaxed);
     }
     // singleton, can't be copied
     EntityManager(const EntityManager& rhs) = delete;
@@ -113,6 +135,7 @@ private:
     static constexpr const int GENERATION_SHIFT = 17;
     static constexpr const size_t RAW_INDEX_COUNT = (1 << GENERATION_SHIFT);
     static constexpr const Entity::Type INDEX_MASK = (1 << GENERATION_SHIFT) - 1u;
+    static constexpr const size_t JOURNAL_CAPACITY = 16384;
 
     static inline Entity::Type getGeneration(Entity e) noexcept {
         return e.getId() >> GENERATION_SHIFT;
@@ -124,8 +147,8 @@ private:
         return (g << GENERATION_SHIFT) | (i & INDEX_MASK);
     }
 
-    // stores the generation of each index.
-    uint8_t * const mGens;
+    // stores the generation of each index, destroy() increments it with a CAS.
+    std::atomic<uint8_t>* const mGens;
 };
 
 } // namespace utils
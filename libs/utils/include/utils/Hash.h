@@ -21,6 +21,7 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include <string.h>
 
 namespace utils {
 namespace hash {
@@ -46,6 +47,51 @@ inline uint32_t murmur3(const uint32_t* key, size_t wordCount, uint32_t seed) no
     return h;
 }
 
+// 64-bit FNV-1a of a buffer. Unlike std::hash, the result doesn't depend on the platform or the
+// standard library, which makes it suitable for keys that are persisted.
+inline uint64_t fnv1a(const void* data, size_t size,
+        uint64_t seed = 0xcbf29ce484222325ull) noexcept {
+    uint64_t h = seed;
+    const uint8_t* p = (const uint8_t*) data;
+    for (size_t i = 0; i < size; i++) {
+        h ^= p[i];
+        h *= 0x100000001b3ull;
+    }
+    return h;
+}
+
+// 64-bit MurmurHash64A of a buffer, it reads 8 bytes at a time and is much faster than fnv1a() on
+// large buffers. Like fnv1a(), the result doesn't depend on the alignment of the data nor on the
+// standard library, but it assumes a little-endian platform.
+inline uint64_t murmur64(const void* data, size_t size, uint64_t seed = 0) noexcept {
+    constexpr uint64_t m = 0xc6a4a7935bd1e995ull;
+    constexpr int r = 47;
+    uint64_t h = seed ^ (size * m);
+    const uint8_t* p = (const uint8_t*) data;
+    const uint8_t* const end = p + (size & ~size_t(7));
+    while (p != end) {
+        uint64_t k;
+        memcpy(&k, p, sizeof(k)); // unaligned load
+        p += sizeof(k);
+        k *= m;
+        k ^= k >> r;
+        k *= m;
+        h ^= k;
+        h *= m;
+    }
+    const size_t tail = size & 7;
+    if (tail) {
+        for (size_t i = 0; i < tail; i++) {
+            h ^= uint64_t(p[i]) << (8 * i);
+        }
+        h *= m;
+    }
+    h ^= h >> r;
+    h *= m;
+    h ^= h >> r;
+    return h;
+}
+
 template<typename T>
 struct MurmurHashFn {
     uint32_t operator()(const T& key) const noexcept {
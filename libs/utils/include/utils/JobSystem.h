@@ -48,6 +48,19 @@ public:
 
     using JobFunc = void(*)(void*, JobSystem&, Job*);
 
+    /*
+     * Scheduling class of a Job.
+     *
+     * NORMAL jobs are always picked before BACKGROUND jobs, by every thread. In addition,
+     * adopted threads (e.g. the render thread) never run BACKGROUND jobs while they're waiting on a
+     * NORMAL job, so long running work (e.g. texture decoding) can't delay them.
+     */
+    enum class JobPriority : uint8_t {
+        NORMAL,         // default, e.g. frame critical work
+        BACKGROUND      // e.g. asset streaming
+    };
+    static constexpr size_t JOB_PRIORITY_COUNT = 2;
+
     class alignas(CACHELINE_SIZE) Job {
     public:
         Job() noexcept {} /* = default; */ /* clang bug */ // NOLINT(modernize-use-equals-default,cppcoreguidelines-pro-type-member-init)
@@ -72,7 +85,8 @@ public:
         uint16_t parent;                                        //  2 |  2
         std::atomic<uint16_t> runningJobCount = { 1 };          //  2 |  2
         mutable std::atomic<uint16_t> refCount = { 1 };         //  2 |  2
-                                                                //  6 |  2 (padding)
+        JobPriority priority = JobPriority::NORMAL;             //  1 |  1
+                                                                //  5 |  1 (padding)
                                                                 // 64 | 64
     };
 
@@ -99,8 +113,18 @@ public:
     Job* setMasterJob(Job* job) noexcept { return setRootJob(job); }
 
 
+    // Jobs inherit the priority of their parent.
     Job* create(Job* parent, JobFunc func) noexcept;
 
+    /*
+     * Sets the scheduling class of a job that hasn't been run yet. Children created afterwards
+     * inherit it.
+     */
+    void setPriority(Job* job, JobPriority priority) noexcept {
+        assert(job);
+        job->priority = priority;
+    }
+
     // NOTE: All methods below must be called from the same thread and that thread must be
     // owned by JobSystem's thread pool.
 
@@ -299,6 +323,22 @@ public:
     static void setThreadPriority(Priority priority) noexcept;
     static void setThreadAffinityById(size_t id) noexcept;
 
+    enum class CoreGroup : uint8_t {
+        ALL,            // worker threads use all cores (default)
+        PERFORMANCE,    // only the fastest cores, e.g. the "big" cores of a big.LITTLE CPU
+        PACKAGE         // only the cores of the package (socket) the calling thread runs on
+    };
+
+    /*
+     * Restricts the worker threads of this JobSystem to a group of cores. Workers are pinned
+     * round-robin to the cores of the group the process is allowed to run on. This takes effect
+     * once each worker is done with the job it's currently running.
+     *
+     * Returns false if the group couldn't be determined on this platform, in which case the
+     * affinity of the workers is unchanged.
+     */
+    bool setCoreGroup(CoreGroup group) noexcept;
+
     size_t getParallelSplitCount() const noexcept {
         return mParallelSplitCount;
     }
@@ -319,14 +359,16 @@ private:
 
     struct alignas(CACHELINE_SIZE) ThreadState {    // this causes 40-bytes padding
         // make sure storage is cache-line aligned
-        WorkQueue workQueue;
+        // one queue per JobPriority
+        WorkQueue workQueues[JOB_PRIORITY_COUNT];
 
         // these are not accessed by the worker threads
-        alignas(CACHELINE_SIZE)     // this causes 56-bytes padding
+        alignas(CACHELINE_SIZE)     // this causes 52-bytes padding
         JobSystem* js;
         std::thread thread;
         default_random_engine rndGen;
         uint32_t id;
+        std::atomic<uint32_t> cpu;  // the core this worker is pinned to
     };
 
     static_assert(sizeof(ThreadState) % CACHELINE_SIZE == 0,
@@ -343,13 +385,18 @@ private:
 
     void requestExit() noexcept;
     bool exitRequested() const noexcept;
-    bool hasActiveJobs() const noexcept;
+    bool hasActiveJobs(JobPriority lowest = JobPriority::BACKGROUND) const noexcept;
 
     void loop(ThreadState* state) noexcept;
-    bool execute(JobSystem::ThreadState& state) noexcept;
-    Job* steal(JobSystem::ThreadState& state) noexcept;
+    bool execute(JobSystem::ThreadState& state,
+            JobPriority lowest = JobPriority::BACKGROUND) noexcept;
+    Job* steal(JobSystem::ThreadState& state, JobPriority priority) noexcept;
     void finish(Job* job) noexcept;
 
+    static WorkQueue& getWorkQueue(ThreadState& state, JobPriority priority) noexcept {
+        return state.workQueues[size_t(priority)];
+    }
+
     void put(WorkQueue& workQueue, Job* job) noexcept {
         assert(job);
         size_t index = job - mJobStorageBase;
@@ -377,7 +424,7 @@ private:
     utils::Mutex mWaiterLock;
     utils::Condition mWaiterCondition;
 
-    std::atomic<uint32_t> mActiveJobs = { 0 };
+    std::atomic<uint32_t> mActiveJobs[JOB_PRIORITY_COUNT] = {};     // per JobPriority
     utils::Arena<utils::ThreadSafeObjectPoolAllocator<Job>, LockingPolicy::NoLock> mJobPool;
 
     template <typename T>
@@ -103,6 +103,7 @@ public:
     size_t getComponentCount() const noexcept;
     Entity const* getEntities() const noexcept;
     void gc(const EntityManager& em, size_t ratio = 4) noexcept;
+    bool gcJournal(const EntityManager& em, size_t count = SIZE_MAX) noexcept;
     /*! \endcond */
 
     /**
@@ -28,6 +28,8 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <algorithm>
+
 namespace utils {
 
 class EntityManager;
@@ -132,6 +134,17 @@ public:
                 });
     }
 
+    // Reclaims the components of destroyed entities by consuming, at most 'count' entries of the
+    // EntityManager's destroy journal. Unlike gc() above, every dead component is eventually
+    // freed; this is intended to be called on a regular basis with a small count.
+    // If the journal overflowed, all components are checked instead, 'count' at a time.
+    // Returns true when the journal has been consumed entirely.
+    bool gcJournal(const EntityManager& em, size_t count = SIZE_MAX) noexcept {
+        return gcJournal(em, count, [this](Entity e) {
+                    removeComponent(e);
+                });
+    }
+
     // return the first instance
     Instance begin() const noexcept { return 1u; }
 
@@ -251,6 +264,67 @@ protected:
         }
     }
 
+    // removeComponent is only called for entities that have a component of this manager.
+    template<typename REMOVE>
+    bool gcJournal(const EntityManager& em, size_t count,
+            REMOVE removeComponent) noexcept {
+        if (UTILS_UNLIKELY(!getComponentCount())) {
+            // Without components there is nothing to reclaim, so skip whatever has been journaled
+            // so far. This also keeps a manager created late from overflowing on its first gc.
+            mJournalPosition = em.getJournalPosition();
+            mSweepCursor = 0;
+            return true;
+        }
+        Entity dead[64];
+        while (count) {
+            if (UTILS_UNLIKELY(mSweepCursor)) {
+                count -= sweep(em, count, removeComponent);
+                continue;
+            }
+            bool overflow;
+            const size_t n = em.readJournal(&mJournalPosition, dead,
+                    std::min(count, sizeof(dead) / sizeof(*dead)), &overflow);
+            if (UTILS_UNLIKELY(overflow)) {
+                // We've missed some entries, so we can't know which entities were destroyed.
+                // Fall back to checking all of our components, in batches like journal entries.
+                // The entities destroyed from now on are still read from the journal.
+                mSweepCursor = getComponentCount();
+                continue;
+            }
+            if (!n) {
+                // caught up
+                return true;
+            }
+            for (size_t i = 0; i < n; i++) {
+                if (hasComponent(dead[i])) {
+                    removeComponent(dead[i]);
+                }
+            }
+            count -= n;
+        }
+        return !mSweepCursor && mJournalPosition == em.getJournalPosition();
+    }
+
+    // Checks at most 'count' components below mSweepCursor and returns how many were checked.
+    // Components are checked backward, so that the component moved in place of a removed one has
+    // either been checked already, or is still below the cursor.
+    template<typename REMOVE>
+    size_t sweep(const EntityManager& em, size_t count, REMOVE removeComponent) noexcept {
+        Entity const* entities = getEntities();
+        // components may have been removed since the sweep started
+        const size_t begin = std::min(mSweepCursor, getComponentCount());
+        const size_t end = begin > count ? begin - count : 0;
+        for (size_t i = begin; i-- > end;) {
+            if (!em.isAlive(entities[i])) {
+                removeComponent(entities[i]);
+                // removing a component can reallocate the arrays
+                entities = getEntities();
+            }
+        }
+        mSweepCursor = end;
+        return begin - end;
+    }
+
 protected:
     SoA mData;
 
@@ -258,6 +332,10 @@ private:
     // maps an entity to an instance index
     tsl::robin_map<Entity, Instance> mInstanceMap;
     default_random_engine mRng;
+    // our position in the EntityManager's destroy journal
+    uint64_t mJournalPosition = 0;
+    // components below this index still need to be checked after a journal overflow
+    size_t mSweepCursor = 0;
 };
 
 // Keep these outside of the class because CLion has trouble parsing them
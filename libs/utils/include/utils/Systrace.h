@@ -24,7 +24,7 @@
 #define SYSTRACE_TAG_JOBSYSTEM      (1<<2)
 
 
-#if defined(__ANDROID__)
+#if defined(__ANDROID__) || (defined(__linux__) && !defined(__EMSCRIPTEN__))
 
 #include <atomic>
 
@@ -100,6 +100,20 @@
 #define SYSTRACE_VALUE64(name, val) \
         ___tracer.value(SYSTRACE_TAG, name, int64_t(val))
 
+/**
+ * Controls the in-process trace recorder, which is only available on Linux. SYSTRACE_DUMP writes
+ * the recorded events to the given path as Chrome trace JSON and evaluates to true on success.
+ */
+#if defined(__ANDROID__)
+#define SYSTRACE_START_RECORDING()
+#define SYSTRACE_STOP_RECORDING()
+#define SYSTRACE_DUMP(path) false
+#else
+#define SYSTRACE_START_RECORDING() ::utils::details::Systrace::startRecording()
+#define SYSTRACE_STOP_RECORDING() ::utils::details::Systrace::stopRecording()
+#define SYSTRACE_DUMP(path) ::utils::details::Systrace::dump(path)
+#endif
+
 // ------------------------------------------------------------------------------------------------
 // No user serviceable code below...
 // ------------------------------------------------------------------------------------------------
@@ -107,6 +121,8 @@
 namespace utils {
 namespace details {
 
+#if defined(__ANDROID__)
+
 class Systrace {
 public:
 
@@ -228,6 +244,104 @@ private:
     static void int64_body(int fd, int pid, const char* name, int64_t value) noexcept;
 };
 
+#else // !ANDROID
+
+/*
+ * On Linux, events are recorded in memory into lock-free per-thread ring buffers and written out
+ * as Chrome trace JSON, which can be opened with chrome://tracing or ui.perfetto.dev.
+ *
+ * Recording is off by default, in which case a trace scope costs a single relaxed atomic load.
+ * It is started either programmatically with startRecording(), or automatically if the
+ * FILAMENT_TRACE_FILE environment variable is set, in which case the trace is written to the
+ * file it names when the process exits.
+ */
+class Systrace {
+public:
+
+    enum tags {
+        NEVER       = SYSTRACE_TAG_NEVER,
+        ALWAYS      = SYSTRACE_TAG_ALWAYS,
+        FILAMENT    = SYSTRACE_TAG_FILAMENT,
+        JOBSYSTEM   = SYSTRACE_TAG_JOBSYSTEM
+        // we could define more TAGS here, as we need them.
+    };
+
+    Systrace(uint32_t tag) noexcept {
+        if (tag) init(tag);
+    }
+
+    static void enable(uint32_t tags) noexcept;
+    static void disable(uint32_t tags) noexcept;
+
+    // Starts or stops recording events for all threads. Already recorded events are kept.
+    static void startRecording() noexcept;
+    static void stopRecording() noexcept;
+
+    // Writes the events currently held in the ring buffers to the given file as Chrome trace
+    // JSON. This can be called while recording, in which case the oldest events of a busy thread
+    // may be dropped. Returns false if the file can't be written.
+    static bool dump(const char* path) noexcept;
+
+    inline void traceBegin(uint32_t tag, const char* name) noexcept {
+        if (tag && UTILS_UNLIKELY(mIsTracingEnabled)) {
+            record('B', name, 0);
+        }
+    }
+
+    inline void traceEnd(uint32_t tag) noexcept {
+        if (tag && UTILS_UNLIKELY(mIsTracingEnabled)) {
+            record('E', nullptr, 0);
+        }
+    }
+
+    inline void asyncBegin(uint32_t tag, const char* name, int32_t cookie) noexcept {
+        if (tag && UTILS_UNLIKELY(mIsTracingEnabled)) {
+            record('b', name, cookie);
+        }
+    }
+
+    inline void asyncEnd(uint32_t tag, const char* name, int32_t cookie) noexcept {
+        if (tag && UTILS_UNLIKELY(mIsTracingEnabled)) {
+            record('e', name, cookie);
+        }
+    }
+
+    inline void value(uint32_t tag, const char* name, int32_t value) noexcept {
+        if (tag && UTILS_UNLIKELY(mIsTracingEnabled)) {
+            record('C', name, value);
+        }
+    }
+
+    inline void value(uint32_t tag, const char* name, int64_t value) noexcept {
+        if (tag && UTILS_UNLIKELY(mIsTracingEnabled)) {
+            record('C', name, value);
+        }
+    }
+
+private:
+    friend class ScopedTrace;
+
+    struct GlobalState {
+        std::atomic<uint32_t> isTracingEnabled;
+        std::atomic<bool> isRecording;
+    };
+
+    static GlobalState sGlobalState;
+
+    void init(uint32_t tag) noexcept;
+
+    // cached value for faster access, no need to be initialized
+    bool mIsTracingEnabled;
+
+    static void setup() noexcept;
+    static void init_once() noexcept;
+    static bool isTracingEnabled(uint32_t tag) noexcept;
+
+    static void record(char phase, const char* name, int64_t value) noexcept;
+};
+
+#endif // ANDROID
+
 // ------------------------------------------------------------------------------------------------
 
 class ScopedTrace {
@@ -258,7 +372,7 @@ private:
 } // namespace utils
 
 // ------------------------------------------------------------------------------------------------
-#else // !ANDROID
+#else // !ANDROID && !LINUX
 // ------------------------------------------------------------------------------------------------
 
 #define SYSTRACE_ENABLE()
@@ -272,7 +386,10 @@ private:
 #define SYSTRACE_ASYNC_END(name, cookie)
 #define SYSTRACE_VALUE32(name, val)
 #define SYSTRACE_VALUE64(name, val)
+#define SYSTRACE_START_RECORDING()
+#define SYSTRACE_STOP_RECORDING()
+#define SYSTRACE_DUMP(path) false
 
-#endif // ANDROID
+#endif // ANDROID || LINUX
 
 #endif // TNT_UTILS_SYSTRACE_H
@@ -21,9 +21,11 @@
 namespace utils {
 
 EntityManager::EntityManager()
-        : mGens(new uint8_t[RAW_INDEX_COUNT]) {
+        : mGens(new std::atomic<uint8_t>[RAW_INDEX_COUNT]) {
     // initialize all the generations to 0
-    std::fill_n(mGens, RAW_INDEX_COUNT, 0);
+    for (size_t i = 0; i < RAW_INDEX_COUNT; i++) {
+        mGens[i].store(0, std::memory_order_relaxed);
+    }
 }
 
 EntityManager::~EntityManager() {
@@ -55,6 +57,16 @@ void EntityManager::unregisterListener(EntityManager::Listener* l) noexcept {
     static_cast<EntityManagerImpl *>(this)->unregisterListener(l);
 }
 
+uint64_t EntityManager::getJournalPosition() const noexcept {
+    return static_cast<EntityManagerImpl const *>(this)->getJournalPosition();
+}
+
+size_t EntityManager::readJournal(uint64_t* position, Entity* entities, size_t count,
+        bool* overflow) const noexcept {
+    return static_cast<EntityManagerImpl const *>(this)->readJournal(
+            position, entities, count, overflow);
+}
+
 #if FILAMENT_UTILS_TRACK_ENTITIES
 std::vector<Entity> EntityManager::getActiveEntities() const {
     return static_cast<EntityManagerImpl const *>(this)->getActiveEntities();
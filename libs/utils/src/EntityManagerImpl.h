@@ -19,6 +19,7 @@
 
 #include <utils/EntityManager.h>
 
+#include <utils/architecture.h>
 #include <utils/compiler.h>
 #include <utils/Entity.h>
 #include <utils/Mutex.h>
@@ -31,7 +32,9 @@
 #include <tsl/robin_map.h>
 #endif
 
-#include <deque>
+#include <algorithm>
+#include <atomic>
+#include <memory>
 #include <mutex> // for std::lock_guard
 #include <vector>
 
@@ -40,6 +43,89 @@ namespace utils {
 
 static constexpr const size_t MIN_FREE_INDICES = 1024;
 
+/*
+ * A lock-free, bounded, multi-producer/multi-consumer FIFO of freed indices (D. Vyukov's bounded
+ * MPMC queue). Each cell carries a sequence number which tells producers and consumers whether it
+ * is ready to be written or read, so only the head and tail positions are contended.
+ * The queue's capacity is the number of indices, so it can never be full.
+ * Indices are stored as uint32_t, i.e. Entity::Type.
+ */
+class FreeIndexQueue {
+public:
+    explicit FreeIndexQueue(size_t capacity)
+            : mCells(new Cell[capacity]), mMask(uint32_t(capacity - 1)) {
+        assert(capacity && !(capacity & (capacity - 1)));
+        for (size_t i = 0; i < capacity; i++) {
+            mCells[i].sequence.store(uint32_t(i), std::memory_order_relaxed);
+        }
+    }
+
+    // Returns the number of indices in the queue. This is only a hint when used concurrently.
+    size_t size() const noexcept {
+        // push() counts an index before publishing it, so the count can't go negative, but
+        // relaxed updates from different threads can still be observed out of order.
+        const int32_t size = mSize.load(std::memory_order_relaxed);
+        return size > 0 ? size_t(size) : 0;
+    }
+
+    void push(uint32_t index) noexcept {
+        Cell* cell;
+        uint32_t pos = mTail.load(std::memory_order_relaxed);
+        for (;;) {
+            cell = &mCells[pos & mMask];
+            const uint32_t seq = cell->sequence.load(std::memory_order_acquire);
+            const int32_t dif = int32_t(seq - pos);
+            if (dif == 0) {
+                if (mTail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else {
+                // dif < 0 would mean we're full, which can't happen by construction.
+                assert(dif > 0);
+                pos = mTail.load(std::memory_order_relaxed);
+            }
+        }
+        cell->index = index;
+        mSize.fetch_add(1, std::memory_order_relaxed);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+    }
+
+    bool pop(uint32_t* index) noexcept {
+        Cell* cell;
+        uint32_t pos = mHead.load(std::memory_order_relaxed);
+        for (;;) {
+            cell = &mCells[pos & mMask];
+            const uint32_t seq = cell->sequence.load(std::memory_order_acquire);
+            const int32_t dif = int32_t(seq - (pos + 1));
+            if (dif == 0) {
+                if (mHead.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (dif < 0) {
+                return false; // empty
+            } else {
+                pos = mHead.load(std::memory_order_relaxed);
+            }
+        }
+        *index = cell->index;
+        cell->sequence.store(pos + mMask + 1, std::memory_order_release);
+        mSize.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+private:
+    struct Cell {
+        std::atomic<uint32_t> sequence;
+        uint32_t index;
+    };
+    std::unique_ptr<Cell[]> mCells;
+    const uint32_t mMask;
+    // keep producers and consumers on separate cache lines
+    alignas(CACHELINE_SIZE) std::atomic<uint32_t> mTail = { 0 };
+    alignas(CACHELINE_SIZE) std::atomic<uint32_t> mHead = { 0 };
+    alignas(CACHELINE_SIZE) std::atomic<int32_t> mSize = { 0 };
+};
+
 class UTILS_PRIVATE EntityManagerImpl : public EntityManager {
 public:
     using EntityManager::getGeneration;
@@ -48,49 +134,66 @@ public:
     using EntityManager::create;
     using EntityManager::destroy;
 
+    EntityManagerImpl()
+            : mFreeList(RAW_INDEX_COUNT),
+              mJournal(new JournalEntry[JOURNAL_CAPACITY]) { }
+
     void create(size_t n, Entity* entities) {
-        Entity::Type index{};
-        auto& freeList = mFreeList;
-        uint8_t* const gens = mGens;
+        std::atomic<uint8_t>* const gens = mGens;
 
-        // this must be thread-safe, acquire the free-list mutex
-        std::lock_guard<Mutex> lock(mFreeListLock);
-        Entity::Type currentIndex = mCurrentIndex;
-        for (size_t i = 0; i < n; i++) {
+        // this must be thread-safe, but doesn't need a lock: fresh indices are reserved with a
+        // CAS on mCurrentIndex, and recycled ones come from the lock-free free-list.
+        size_t i = 0;
+        while (i < n) {
             // If we have more than a certain number of freed indices, get one from the list.
             // this is a trade-off between how often we recycle indices and how large the free list
             // can grow.
-            if (UTILS_UNLIKELY(currentIndex >= RAW_INDEX_COUNT || freeList.size() >= MIN_FREE_INDICES)) {
+            if (UTILS_LIKELY(mFreeList.size() < MIN_FREE_INDICES)) {
+                // In the common case, we just grab the next indices, as many as we can at once.
+                // This works only until all indices have been used once, at which point
+                // we're always in the slower case below. The idea is that we have enough indices
+                // that it doesn't happen in practice.
+                Entity::Type first;
+                const size_t count = reserveIndices(n - i, &first);
+                for (size_t j = 0; j < count; j++, i++) {
+                    const Entity::Type index = first + j;
+                    entities[i] = Entity{ makeIdentity(
+                            gens[index].load(std::memory_order_relaxed), index) };
+                }
+                if (count) {
+                    continue;
+                }
+            }
 
-                // this could only happen if we had gone through all the indices at least once
-                if (UTILS_UNLIKELY(freeList.empty())) {
+            Entity::Type index;
+            if (UTILS_UNLIKELY(!mFreeList.pop(&index))) {
+                // this could only happen if we had gone through all the indices at least once,
+                // or if other threads just emptied the list, in which case we retry a fresh index.
+                Entity::Type first;
+                if (!reserveIndices(1, &first)) {
                     // return the null entity
-                    entities[i] = {};
+                    entities[i++] = {};
                     continue;
                 }
-
-                index = freeList.front();
-                freeList.pop_front();
-            } else {
-                // In the common case, we just grab the next index.
-                // This works only until all indices have been used once, at which point
-                // we're always in the slower case above. The idea is that we have enough indices
-                // that it doesn't happen in practice.
-                index = currentIndex++;
+                index = first;
             }
-            entities[i] = Entity{ makeIdentity(gens[index], index) };
+            entities[i++] = Entity{ makeIdentity(
+                    gens[index].load(std::memory_order_relaxed), index) };
+        }
+
 #if FILAMENT_UTILS_TRACK_ENTITIES
-            mDebugActiveEntities.emplace(entities[i], CallStack::unwind(5));
-#endif
+        std::lock_guard<Mutex> lock(mDebugLock);
+        for (size_t j = 0; j < n; j++) {
+            if (entities[j]) {
+                mDebugActiveEntities.emplace(entities[j], CallStack::unwind(5));
+            }
         }
-        mCurrentIndex = currentIndex;
+#endif
     }
 
     void destroy(size_t n, Entity* entities) noexcept {
-        auto& freeList = mFreeList;
-        uint8_t* const gens = mGens;
+        std::atomic<uint8_t>* const gens = mGens;
 
-        std::unique_lock<Mutex> lock(mFreeListLock);
         for (size_t i = 0; i < n; i++) {
             if (!entities[i]) {
                 // behave like free(), ok to free null Entity.
@@ -103,38 +206,47 @@ public:
             // ... deleting a dead Entity will corrupt the internal state, so we protect ourselves
             // against it. We don't guarantee anything about external state -- e.g. the listeners
             // will be called.
-            if (isAlive(entities[i])) {
-                Entity::Type index = getIndex(entities[i]);
-                freeList.push_back(index);
-
-                // The generation update doesn't require the lock because it's only used for isAlive()
+            // The generation is bumped with a CAS, so that when several threads race to destroy
+            // the same Entity, only one of them recycles its index.
+            const Entity::Type index = getIndex(entities[i]);
+            uint8_t generation = uint8_t(getGeneration(entities[i]));
+            if (gens[index].compare_exchange_strong(generation, uint8_t(generation + 1),
+                    std::memory_order_relaxed)) {
+                // The generation update doesn't require a lock because it's only used for isAlive()
                 // and entities work as weak references -- it just means that isAlive() could return
                 // true a little longer than expected in some other threads.
-                // We do need a memory fence though, it is provided by the mFreeListLock.unlock() below.
-                gens[index]++;
+                // We do need a memory fence though, it is provided by the release in push() below,
+                // so that whoever recycles this index sees the new generation.
+                mFreeList.push(index);
+                appendToJournal(entities[i]);
 
 #if FILAMENT_UTILS_TRACK_ENTITIES
+                std::lock_guard<Mutex> lock(mDebugLock);
                 mDebugActiveEntities.erase(entities[i]);
 #endif
             }
         }
-        lock.unlock();
 
-        // notify our listeners that some entities are being destroyed
-        auto listeners = getListeners();
-        for (auto const& l : listeners) {
-            l->onEntitiesDestroyed(n, entities);
+        // notify our listeners that some entities are being destroyed, once for the whole batch.
+        // In the common case there are no listeners and we avoid the lock and the copy entirely.
+        if (mListenerCount.load(std::memory_order_acquire)) {
+            auto listeners = getListeners();
+            for (auto const& l : listeners) {
+                l->onEntitiesDestroyed(n, entities);
+            }
         }
     }
 
     void registerListener(EntityManager::Listener* l) noexcept {
         std::lock_guard<Mutex> lock(mListenerLock);
         mListeners.insert(l);
+        mListenerCount.store(uint32_t(mListeners.size()), std::memory_order_release);
     }
 
     void unregisterListener(EntityManager::Listener* l) noexcept {
         std::lock_guard<Mutex> lock(mListenerLock);
         mListeners.erase(l);
+        mListenerCount.store(uint32_t(mListeners.size()), std::memory_order_release);
     }
 
     utils::FixedCapacityVector<EntityManager::Listener*> getListeners() const noexcept {
@@ -146,6 +258,43 @@ public:
         return result; // the c++ standard guarantees a move
     }
 
+    uint64_t getJournalPosition() const noexcept {
+        return mJournalHead.load(std::memory_order_acquire);
+    }
+
+    size_t readJournal(uint64_t* position, Entity* entities, size_t count,
+            bool* overflow) const noexcept {
+        uint64_t pos = *position;
+        const uint64_t head = mJournalHead.load(std::memory_order_acquire);
+        *overflow = false;
+        if (UTILS_UNLIKELY(head - pos > JOURNAL_CAPACITY)) {
+            *overflow = true;
+            *position = head;
+            return 0;
+        }
+        size_t n = 0;
+        while (n < count && pos < head) {
+            JournalEntry const& entry = mJournal[pos & (JOURNAL_CAPACITY - 1)];
+            const uint64_t published = entry.position.load(std::memory_order_acquire);
+            if (published < pos + 1) {
+                // this entry is still being written, we'll get it next time
+                break;
+            }
+            const Entity::Type id = entry.id.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (UTILS_UNLIKELY(entry.position.load(std::memory_order_relaxed) != pos + 1)) {
+                // a writer lapped us while we were reading the entry
+                *overflow = true;
+                *position = mJournalHead.load(std::memory_order_acquire);
+                return 0;
+            }
+            entities[n++] = Entity::import(int32_t(id));
+            pos++;
+        }
+        *position = pos;
+        return n;
+    }
+
 #if FILAMENT_UTILS_TRACK_ENTITIES
     std::vector<Entity> getActiveEntities() const {
         std::vector<Entity> result(mDebugActiveEntities.size());
@@ -166,16 +315,51 @@ public:
 #endif
 
 private:
-    uint32_t mCurrentIndex = 1;
+    // Reserves up to n never used indices, returns how many were reserved.
+    size_t reserveIndices(size_t n, Entity::Type* first) noexcept {
+        uint32_t current = mCurrentIndex.load(std::memory_order_relaxed);
+        size_t count;
+        do {
+            if (current >= RAW_INDEX_COUNT) {
+                return 0;
+            }
+            count = std::min(n, RAW_INDEX_COUNT - current);
+        } while (!mCurrentIndex.compare_exchange_weak(current, uint32_t(current + count),
+                std::memory_order_relaxed));
+        *first = current;
+        return count;
+    }
+
+    void appendToJournal(Entity e) noexcept {
+        const uint64_t pos = mJournalHead.fetch_add(1, std::memory_order_acq_rel);
+        JournalEntry& entry = mJournal[pos & (JOURNAL_CAPACITY - 1)];
+        // invalidate the entry first, so that a reader that is more than a lap behind can't
+        // mistake the new id for the old one
+        entry.position.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        entry.id.store(e.getId(), std::memory_order_relaxed);
+        entry.position.store(pos + 1, std::memory_order_release);
+    }
+
+    std::atomic<uint32_t> mCurrentIndex = { 1 };
 
     // stores indices that got freed
-    mutable Mutex mFreeListLock;
-    std::deque<Entity::Type> mFreeList;
+    FreeIndexQueue mFreeList;
 
     mutable Mutex mListenerLock;
     tsl::robin_set<Listener*> mListeners;
+    std::atomic<uint32_t> mListenerCount = { 0 };
+
+    // journal of destroyed entities, see EntityManager::readJournal()
+    struct JournalEntry {
+        std::atomic<uint64_t> position = { 0 };   // position + 1 once published, 0 otherwise
+        std::atomic<Entity::Type> id = { 0 };
+    };
+    std::unique_ptr<JournalEntry[]> mJournal;
+    alignas(CACHELINE_SIZE) std::atomic<uint64_t> mJournalHead = { 0 };
 
 #if FILAMENT_UTILS_TRACK_ENTITIES
+    mutable Mutex mDebugLock;
     tsl::robin_map<Entity, CallStack> mDebugActiveEntities;
 #endif
 };
@@ -31,9 +31,12 @@ static constexpr bool DEBUG_FINISH_HANGS = false;
 #include <utils/Panic.h>
 #include <utils/Systrace.h>
 
+#include <algorithm>
 #include <random>
+#include <vector>
 
 #include <math.h>
+#include <stdio.h>
 
 #if !defined(WIN32)
 #    include <pthread.h>
@@ -58,6 +61,10 @@ static constexpr bool DEBUG_FINISH_HANGS = false;
 #    define gettid() syscall(SYS_gettid)
 #endif
 
+#if defined(__linux__)
+#    include <sched.h>
+#endif
+
 #if HEAVY_SYSTRACE
 #   define HEAVY_SYSTRACE_CALL()            SYSTRACE_CALL()
 #   define HEAVY_SYSTRACE_NAME(name)        SYSTRACE_NAME(name)
@@ -107,6 +114,87 @@ void JobSystem::setThreadAffinityById(size_t id) noexcept {
 #endif
 }
 
+#if defined(__linux__)
+// reads a single integer from a sysfs file, returns -1 if unavailable
+static long readCpuProperty(size_t cpu, const char* property) noexcept {
+    char path[128];
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%zu/%s", cpu, property);
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        return -1;
+    }
+    long value = -1;
+    if (fscanf(file, "%ld", &value) != 1) {
+        value = -1;
+    }
+    fclose(file);
+    return value;
+}
+#endif
+
+// Returns the ids of the cpus the process may run on, which are not necessarily contiguous
+// (e.g. offline cores, cpusets or taskset).
+static std::vector<uint32_t> getAvailableCpus() noexcept {
+    std::vector<uint32_t> cpus;
+#if defined(__linux__)
+    // the main thread's mask, the calling thread may have been pinned already
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(getpid(), sizeof(set), &set) == 0) {
+        for (size_t i = 0; i < CPU_SETSIZE; i++) {
+            if (CPU_ISSET(i, &set)) {
+                cpus.push_back(uint32_t(i));
+            }
+        }
+        return cpus;
+    }
+#endif
+    const size_t cpuCount = std::thread::hardware_concurrency();
+    for (size_t i = 0; i < cpuCount; i++) {
+        cpus.push_back(uint32_t(i));
+    }
+    return cpus;
+}
+
+static std::vector<uint32_t> getCoreGroupCpus(JobSystem::CoreGroup group) noexcept {
+    std::vector<uint32_t> cpus = getAvailableCpus();
+    if (group == JobSystem::CoreGroup::ALL) {
+        return cpus;
+    }
+    std::vector<uint32_t> selectedCpus;
+#if defined(__linux__)
+    // the properties of the available cpus, -1 if unknown
+    const char* property = group == JobSystem::CoreGroup::PERFORMANCE ?
+            "cpufreq/cpuinfo_max_freq" : "topology/physical_package_id";
+    std::vector<long> values(cpus.size());
+    for (size_t i = 0; i < cpus.size(); i++) {
+        values[i] = readCpuProperty(cpus[i], property);
+    }
+
+    long selected = -1;
+    if (group == JobSystem::CoreGroup::PERFORMANCE) {
+        // the fastest cores are the ones with the highest maximum frequency
+        if (!values.empty()) {
+            selected = *std::max_element(values.begin(), values.end());
+        }
+    } else {
+        const int cpu = sched_getcpu();
+        if (cpu >= 0) {
+            selected = readCpuProperty(size_t(cpu), property);
+        }
+    }
+
+    if (selected >= 0) {
+        for (size_t i = 0; i < cpus.size(); i++) {
+            if (values[i] == selected) {
+                selectedCpus.push_back(cpus[i]);
+            }
+        }
+    }
+#endif
+    return selectedCpus;
+}
+
 JobSystem::JobSystem(const size_t userThreadCount, const size_t adoptableThreadsCount) noexcept
     : mJobPool("JobSystem Job pool", MAX_JOB_COUNT * sizeof(Job)),
       mJobStorageBase(static_cast<Job *>(mJobPool.getAllocator().getCurrent()))
@@ -147,6 +235,7 @@ JobSystem::JobSystem(const size_t userThreadCount, const size_t adoptableThreads
         auto& state = states[i];
         state.rndGen = default_random_engine(rd());
         state.id = (uint32_t)i;
+        state.cpu.store(uint32_t(i), std::memory_order_relaxed);
         state.js = this;
         if (i < hardwareThreadCount) {
             // don't start a thread of adoptable thread slots
@@ -203,8 +292,13 @@ inline bool JobSystem::exitRequested() const noexcept {
     return mExitRequested.load(std::memory_order_relaxed);
 }
 
-inline bool JobSystem::hasActiveJobs() const noexcept {
-    return mActiveJobs.load(std::memory_order_relaxed) > 0;
+inline bool JobSystem::hasActiveJobs(JobPriority lowest) const noexcept {
+    for (size_t i = 0; i <= size_t(lowest); i++) {
+        if (mActiveJobs[i].load(std::memory_order_relaxed) > 0) {
+            return true;
+        }
+    }
+    return false;
 }
 
 inline bool JobSystem::hasJobCompleted(JobSystem::Job const* job) noexcept {
@@ -231,7 +325,7 @@ void JobSystem::wait(std::unique_lock<Mutex>& lock, Job* job) noexcept {
             // confidence that we're in an incorrect state.
 
             auto id = getState().id;
-            auto activeJobs = mActiveJobs.load();
+            auto activeJobs = mActiveJobs[0].load() + mActiveJobs[1].load();
 
             if (job) {
                 auto runningJobCount = job->runningJobCount.load();
@@ -297,34 +391,39 @@ inline JobSystem::ThreadState* JobSystem::getStateToStealFrom(JobSystem::ThreadS
     return stateToStealFrom;
 }
 
-JobSystem::Job* JobSystem::steal(JobSystem::ThreadState& state) noexcept {
+JobSystem::Job* JobSystem::steal(JobSystem::ThreadState& state, JobPriority priority) noexcept {
     HEAVY_SYSTRACE_CALL();
     Job* job = nullptr;
     do {
         ThreadState* const stateToStealFrom = getStateToStealFrom(state);
         if (UTILS_LIKELY(stateToStealFrom)) {
-            job = steal(stateToStealFrom->workQueue);
+            job = steal(getWorkQueue(*stateToStealFrom, priority));
         }
-        // nullptr -> nothing to steal in that queue either, if there are active jobs,
-        // continue to try stealing one.
-    } while (!job && hasActiveJobs());
+        // nullptr -> nothing to steal in that queue either, if there are active jobs of this
+        // priority, continue to try stealing one.
+    } while (!job && mActiveJobs[size_t(priority)].load(std::memory_order_relaxed) > 0);
     return job;
 }
 
-bool JobSystem::execute(JobSystem::ThreadState& state) noexcept {
+bool JobSystem::execute(JobSystem::ThreadState& state, JobPriority lowest) noexcept {
     HEAVY_SYSTRACE_CALL();
 
-    Job* job = pop(state.workQueue);
-    if (UTILS_UNLIKELY(job == nullptr)) {
-        // our queue is empty, try to steal a job
-        job = steal(state);
+    // higher priority jobs are always picked first, whether they're in our queue or not
+    Job* job = nullptr;
+    for (size_t i = 0; i <= size_t(lowest) && !job; i++) {
+        job = pop(state.workQueues[i]);
+        if (UTILS_UNLIKELY(job == nullptr)) {
+            // our queue is empty, try to steal a job
+            job = steal(state, JobPriority(i));
+        }
     }
 
     if (job) {
         assert(job->runningJobCount.load(std::memory_order_relaxed) >= 1);
 
         UTILS_UNUSED_IN_RELEASE
-        uint32_t activeJobs = mActiveJobs.fetch_sub(1, std::memory_order_relaxed);
+        uint32_t activeJobs = mActiveJobs[size_t(job->priority)].fetch_sub(1,
+                std::memory_order_relaxed);
         assert(activeJobs); // whoops, we were already at 0
         HEAVY_SYSTRACE_VALUE32("JobSystem::activeJobs", activeJobs - 1);
 
@@ -343,7 +442,7 @@ void JobSystem::loop(ThreadState* state) noexcept {
 
     // set a CPU affinity on each of our JobSystem thread to prevent them from jumping from core
     // to core. On Android, it looks like the affinity needs to be reset from time to time.
-    setThreadAffinityById(state->id);
+    setThreadAffinityById(state->cpu.load(std::memory_order_relaxed));
 
     // record our work queue
     mThreadMapLock.lock();
@@ -352,13 +451,19 @@ void JobSystem::loop(ThreadState* state) noexcept {
     ASSERT_PRECONDITION(inserted, "This thread is already in a loop.");
 
     // run our main loop...
+    uint32_t cpu = state->cpu.load(std::memory_order_relaxed);
     do {
         if (!execute(*state)) {
             std::unique_lock<Mutex> lock(mWaiterLock);
             while (!exitRequested() && !hasActiveJobs()) {
                 wait(lock);
-                setThreadAffinityById(state->id);
+                cpu = state->cpu.load(std::memory_order_relaxed);
+                setThreadAffinityById(cpu);
             }
+        } else if (UTILS_UNLIKELY(cpu != state->cpu.load(std::memory_order_relaxed))) {
+            // setCoreGroup() was called while we were busy
+            cpu = state->cpu.load(std::memory_order_relaxed);
+            setThreadAffinityById(cpu);
         }
     } while (!exitRequested());
 }
@@ -417,6 +522,7 @@ JobSystem::Job* JobSystem::create(JobSystem::Job* parent, JobFunc func) noexcept
         }
         job->function = func;
         job->parent = uint16_t(index);
+        job->priority = parent ? parent->priority : JobPriority::NORMAL;
     }
     return job;
 }
@@ -449,14 +555,22 @@ void JobSystem::run(Job*& job) noexcept {
     // increase the active job count before we add the job to the queue, because otherwise
     // the job could run and finish before the counter is incremented, which would trigger
     // an assert() in execute(). Either way, it's not "wrong", but the assert() is useful.
-    uint32_t activeJobs = mActiveJobs.fetch_add(1, std::memory_order_relaxed);
+    uint32_t activeJobs = mActiveJobs[size_t(job->priority)].fetch_add(1,
+            std::memory_order_relaxed);
 
-    put(state.workQueue, job);
+    put(getWorkQueue(state, job->priority), job);
 
     HEAVY_SYSTRACE_VALUE32("JobSystem::activeJobs", activeJobs + 1);
 
     // wake-up a thread if needed...
-    wakeOne();
+    if (UTILS_LIKELY(job->priority == JobPriority::NORMAL) ||
+            !mAdoptedThreads.load(std::memory_order_relaxed)) {
+        wakeOne();
+    } else {
+        // An adopted thread waiting on a NORMAL job could take the wake-up and ignore this job,
+        // while the workers that can run it keep sleeping.
+        wakeAll();
+    }
 
     // after run() returns, the job is virtually invalid (it'll die on its own)
     job = nullptr;
@@ -475,8 +589,14 @@ void JobSystem::waitAndRelease(Job*& job) noexcept {
     assert(job->refCount.load(std::memory_order_relaxed) >= 1);
 
     ThreadState& state(getState());
+
+    // Adopted threads (e.g. the render thread) don't pick up jobs of a lower priority than the
+    // one they're waiting on, unless there are no worker threads to run them.
+    const JobPriority lowest = (state.id >= mThreadCount && mThreadCount > 0) ?
+            job->priority : JobPriority::BACKGROUND;
+
     do {
-        if (!execute(state)) {
+        if (!execute(state, lowest)) {
             // test if job has completed first, to possibly avoid taking the lock
             if (hasJobCompleted(job)) {
                 break;
@@ -492,7 +612,7 @@ void JobSystem::waitAndRelease(Job*& job) noexcept {
             // continue to handle more jobs, as they get added.
 
             std::unique_lock<Mutex> lock(mWaiterLock);
-            if (!hasJobCompleted(job) && !hasActiveJobs() && !exitRequested()) {
+            if (!hasJobCompleted(job) && !hasActiveJobs(lowest) && !exitRequested()) {
                 wait(lock, job);
             }
         }
@@ -554,9 +674,24 @@ void JobSystem::emancipate() {
     mThreadMap.erase(iter);
 }
 
+bool JobSystem::setCoreGroup(CoreGroup group) noexcept {
+    std::vector<uint32_t> const cpus = getCoreGroupCpus(group);
+    if (cpus.empty()) {
+        return false;
+    }
+    // only the worker threads are affected, adopted threads are managed by their owner
+    for (size_t i = 0; i < mThreadCount; i++) {
+        mThreadStates[i].cpu.store(cpus[i % cpus.size()], std::memory_order_relaxed);
+    }
+    // busy workers update their affinity after their current job, idle ones when they wake up
+    wakeAll();
+    return true;
+}
+
 io::ostream& operator<<(io::ostream& out, JobSystem const& js) {
     for (auto const& item : js.mThreadStates) {
-        out << size_t(item.id) << ": " << item.workQueue.getCount() << io::endl;
+        out << size_t(item.id) << ": " << item.workQueues[0].getCount()
+            << " (" << item.workQueues[1].getCount() << " background)" << io::endl;
     }
     return out;
 }
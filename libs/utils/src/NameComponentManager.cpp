@@ -56,4 +56,8 @@ void NameComponentManager::gc(const EntityManager& em, size_t ratio) noexcept {
     SingleInstanceComponentManager::gc(em, ratio);
 }
 
+bool NameComponentManager::gcJournal(const EntityManager& em, size_t count) noexcept {
+    return SingleInstanceComponentManager::gcJournal(em, count);
+}
+
 } // namespace utils
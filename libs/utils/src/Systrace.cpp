@@ -220,4 +220,248 @@ void Systrace::int64_body(int fd, int pid, const char* name, int64_t value) noex
 } // namespace details
 } // namespace utils
 
-#endif // ANDROID
+#elif defined(__linux__) && !defined(__EMSCRIPTEN__)
+
+#include <algorithm>
+#include <cinttypes>
+#include <vector>
+
+#include <limits.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <time.h>
+
+namespace utils {
+namespace details {
+
+namespace {
+
+struct Event {
+    uint64_t timestamp;
+    int64_t value;
+    char phase;
+    char name[39];
+};
+
+// A slot's sequence number is odd while its event is being written, and "2 * (index + 1)" once
+// the event with the given ring index has been written. dump() uses it to reject the slots the
+// owning thread writes or overwrites while they're being copied.
+// Slots are 64 bytes, which makes a thread's ring buffer 512 KiB.
+struct Slot {
+    std::atomic<uint64_t> sequence = { 0 };
+    Event event;
+};
+
+static_assert(sizeof(Slot) == 64, "Slot must be 64 bytes");
+
+constexpr size_t EVENTS_PER_THREAD = 8192; // must be a power of two
+constexpr size_t MAX_THREADS = 256;
+
+// Written only by its owning thread, read by dump().
+struct ThreadBuffer {
+    std::atomic<uint64_t> head = { 0 };
+    pid_t tid = 0;
+    char threadName[16] = {};
+    Slot slots[EVENTS_PER_THREAD];
+};
+
+// Thread buffers are never freed so that the events of exited threads can still be dumped.
+// Threads that start tracing after MAX_THREADS buffers have been handed out are not recorded.
+std::atomic<ThreadBuffer*> gThreadBuffers[MAX_THREADS];
+std::atomic<uint32_t> gThreadBufferCount = { 0 };
+thread_local ThreadBuffer* tThreadBuffer = nullptr;
+thread_local bool tThreadBufferUnavailable = false;
+
+pthread_once_t gTraceOnceControl = PTHREAD_ONCE_INIT;
+char gTraceFile[PATH_MAX];
+
+ThreadBuffer* getThreadBuffer() noexcept {
+    ThreadBuffer* buffer = tThreadBuffer;
+    if (UTILS_LIKELY(buffer || tThreadBufferUnavailable)) {
+        return buffer;
+    }
+    const uint32_t index = gThreadBufferCount.fetch_add(1, std::memory_order_relaxed);
+    if (index < MAX_THREADS) {
+        buffer = new ThreadBuffer;
+        buffer->tid = pid_t(syscall(SYS_gettid));
+        pthread_getname_np(pthread_self(), buffer->threadName, sizeof(buffer->threadName));
+        gThreadBuffers[index].store(buffer, std::memory_order_release);
+    }
+    tThreadBuffer = buffer;
+    tThreadBufferUnavailable = buffer == nullptr;
+    return buffer;
+}
+
+void writeString(FILE* file, const char* str) noexcept {
+    fputc('"', file);
+    for (; *str; ++str) {
+        const char c = *str;
+        if (c == '"' || c == '\\') {
+            fputc('\\', file);
+            fputc(c, file);
+        } else if ((unsigned char)c < 0x20) {
+            fprintf(file, "\\u%04x", c);
+        } else {
+            fputc(c, file);
+        }
+    }
+    fputc('"', file);
+}
+
+void writeEvent(FILE* file, pid_t pid, pid_t tid, Event const& e) noexcept {
+    fprintf(file, ",\n{\"ph\":\"%c\",\"ts\":%.3f,\"pid\":%d,\"tid\":%d",
+            e.phase, double(e.timestamp) * 1e-3, pid, tid);
+    if (e.phase != 'E') {
+        fputs(",\"name\":", file);
+        writeString(file, e.name);
+    }
+    if (e.phase == 'b' || e.phase == 'e') {
+        fprintf(file, ",\"cat\":\"systrace\",\"id\":%" PRId64, e.value);
+    } else if (e.phase == 'C') {
+        fprintf(file, ",\"args\":{\"value\":%" PRId64 "}", e.value);
+    }
+    fputc('}', file);
+}
+
+} // anonymous namespace
+
+Systrace::GlobalState Systrace::sGlobalState = {};
+
+void Systrace::init_once() noexcept {
+    const char* path = getenv("FILAMENT_TRACE_FILE");
+    if (path && *path) {
+        strncpy(gTraceFile, path, sizeof(gTraceFile) - 1);
+        sGlobalState.isRecording.store(true, std::memory_order_relaxed);
+        atexit([]() {
+            if (!dump(gTraceFile)) {
+                slog.e << "Unable to write trace file " << gTraceFile << io::endl;
+            }
+        });
+    }
+}
+
+void Systrace::setup() noexcept {
+    pthread_once(&gTraceOnceControl, init_once);
+}
+
+void Systrace::enable(uint32_t tags) noexcept {
+    setup();
+    sGlobalState.isTracingEnabled.fetch_or(tags, std::memory_order_relaxed);
+}
+
+void Systrace::disable(uint32_t tags) noexcept {
+    sGlobalState.isTracingEnabled.fetch_and(~tags, std::memory_order_relaxed);
+}
+
+void Systrace::startRecording() noexcept {
+    setup();
+    sGlobalState.isRecording.store(true, std::memory_order_relaxed);
+}
+
+void Systrace::stopRecording() noexcept {
+    sGlobalState.isRecording.store(false, std::memory_order_relaxed);
+}
+
+bool Systrace::isTracingEnabled(uint32_t tag) noexcept {
+    if (tag) {
+        setup();
+        GlobalState const& s = sGlobalState;
+        return s.isRecording.load(std::memory_order_relaxed) &&
+               bool((s.isTracingEnabled.load(std::memory_order_relaxed) | SYSTRACE_TAG_ALWAYS) & tag);
+    }
+    return false;
+}
+
+void Systrace::init(uint32_t tag) noexcept {
+    mIsTracingEnabled = isTracingEnabled(tag);
+}
+
+void Systrace::record(char phase, const char* name, int64_t value) noexcept {
+    ThreadBuffer* const buffer = getThreadBuffer();
+    if (UTILS_UNLIKELY(!buffer)) {
+        return;
+    }
+    timespec now; // NOLINT
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    // We're the only writer of this buffer. The slot is marked as being written before the event
+    // is modified, and the release stores publish the event to dump().
+    const uint64_t head = buffer->head.load(std::memory_order_relaxed);
+    Slot& slot = buffer->slots[head & (EVENTS_PER_THREAD - 1)];
+    slot.sequence.store(2 * head + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    Event& e = slot.event;
+    e.timestamp = uint64_t(now.tv_sec) * 1000000000u + uint64_t(now.tv_nsec);
+    e.value = value;
+    e.phase = phase;
+    size_t i = 0;
+    if (name) {
+        for (; i < sizeof(e.name) - 1 && name[i]; i++) {
+            e.name[i] = name[i];
+        }
+    }
+    e.name[i] = 0;
+    slot.sequence.store(2 * (head + 1), std::memory_order_release);
+    buffer->head.store(head + 1, std::memory_order_release);
+}
+
+bool Systrace::dump(const char* path) noexcept {
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        return false;
+    }
+
+    const pid_t pid = getpid();
+    fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    fprintf(file, "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":%d,"
+                  "\"args\":{\"name\":\"filament\"}}", pid);
+
+    std::vector<Event> events;
+    const uint32_t count = std::min(uint32_t(MAX_THREADS),
+            gThreadBufferCount.load(std::memory_order_relaxed));
+    for (uint32_t i = 0; i < count; i++) {
+        ThreadBuffer const* buffer = gThreadBuffers[i].load(std::memory_order_acquire);
+        if (!buffer) {
+            continue; // the thread is still registering
+        }
+
+        fprintf(file, ",\n{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":%d,\"tid\":%d,"
+                      "\"args\":{\"name\":", pid, buffer->tid);
+        writeString(file, buffer->threadName);
+        fputs("}}", file);
+
+        const uint64_t end = buffer->head.load(std::memory_order_acquire);
+        const uint64_t begin = end > EVENTS_PER_THREAD ? end - EVENTS_PER_THREAD : 0;
+        events.clear();
+        for (uint64_t j = begin; j < end; j++) {
+            // The owning thread may wrap around while we're copying, only keep the events whose
+            // slot still holds the same, completely written, event before and after the copy.
+            Slot const& slot = buffer->slots[j & (EVENTS_PER_THREAD - 1)];
+            const uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+            if (sequence != 2 * (j + 1)) {
+                continue;
+            }
+            Event e; // NOLINT
+            memcpy(&e, &slot.event, sizeof(Event));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) == sequence) {
+                events.push_back(e);
+            }
+        }
+        for (Event const& e : events) {
+            writeEvent(file, pid, buffer->tid, e);
+        }
+    }
+
+    fprintf(file, "\n]}\n");
+    const bool success = !ferror(file);
+    fclose(file);
+    return success;
+}
+
+} // namespace details
+} // namespace utils
+
+#endif // ANDROID || LINUX
@@ -16,7 +16,10 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <memory>
+#include <thread>
+#include <vector>
 
 #include "../src/EntityManagerImpl.h"
 #include <utils/NameComponentManager.h>
@@ -128,6 +131,91 @@ TEST(EntityTest, Lots) {
     // at this point, we should be getting indices from the free-list exclusively
 }
 
+TEST(EntityTest, Concurrent) {
+    EntityManagerImpl em;
+    constexpr size_t THREAD_COUNT = 4;
+    constexpr size_t ITERATIONS = 2000;
+    constexpr size_t BATCH = 16;
+
+    // each thread keeps half of what it creates alive, so that we exercise both fresh indices
+    // and recycled ones.
+    std::vector<Entity> alive[THREAD_COUNT];
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < THREAD_COUNT; t++) {
+        threads.emplace_back([&em, &kept = alive[t]]() {
+            Entity entities[BATCH];
+            for (size_t i = 0; i < ITERATIONS; i++) {
+                em.create(BATCH, entities);
+                for (auto e : entities) {
+                    EXPECT_TRUE(em.isAlive(e));
+                }
+                kept.push_back(entities[0]);
+                em.destroy(BATCH - 1, entities + 1);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // no Entity can have been handed out twice
+    std::vector<uint32_t> ids;
+    for (auto const& kept : alive) {
+        for (auto e : kept) {
+            EXPECT_TRUE(em.isAlive(e));
+            ids.push_back(e.getId());
+        }
+    }
+    std::sort(ids.begin(), ids.end());
+    EXPECT_EQ(ids.end(), std::adjacent_find(ids.begin(), ids.end()));
+
+    for (auto& kept : alive) {
+        em.destroy(kept.size(), kept.data());
+    }
+}
+
+TEST(EntityTest, FreeIndexQueue) {
+    static constexpr size_t CAPACITY = 1024;
+    constexpr size_t THREAD_COUNT = 4;
+    constexpr size_t ITERATIONS = 20000;
+    FreeIndexQueue queue(CAPACITY);
+    for (uint32_t i = 0; i < CAPACITY / 2; i++) {
+        queue.push(i);
+    }
+
+    // every thread pops an index and pushes it back, while checking that the size never
+    // underflows
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < THREAD_COUNT; t++) {
+        threads.emplace_back([&queue]() {
+            for (size_t i = 0; i < ITERATIONS; i++) {
+                uint32_t index;
+                if (queue.pop(&index)) {
+                    EXPECT_LE(queue.size(), CAPACITY);
+                    queue.push(index);
+                }
+                EXPECT_LE(queue.size(), CAPACITY);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // no index can have been lost or duplicated
+    EXPECT_EQ(CAPACITY / 2, queue.size());
+    std::vector<uint32_t> indices;
+    uint32_t index;
+    while (queue.pop(&index)) {
+        indices.push_back(index);
+    }
+    std::sort(indices.begin(), indices.end());
+    ASSERT_EQ(CAPACITY / 2, indices.size());
+    for (uint32_t i = 0; i < CAPACITY / 2; i++) {
+        EXPECT_EQ(i, indices[i]);
+    }
+    EXPECT_EQ(0, queue.size());
+}
 
 TEST(EntityTest, NameComponent) {
 
@@ -176,3 +264,68 @@ TEST(EntityTest, NameComponent) {
 
     cm.gc(em);
 }
+
+TEST(EntityTest, GcJournal) {
+    EntityManager& em = EntityManager::get();
+    NameComponentManager cm(em);
+
+    Entity entities[256];
+    em.create(256, entities);
+    for (Entity e : entities) {
+        cm.addComponent(e);
+    }
+    // start from a clean journal
+    EXPECT_TRUE(cm.gcJournal(em));
+    EXPECT_EQ(256, cm.getComponentCount());
+
+    // destroy every other entity, all their components must be reclaimed
+    for (size_t i = 0; i < 256; i += 2) {
+        em.destroy(entities[i]);
+    }
+
+    // consume the journal in small steps
+    EXPECT_FALSE(cm.gcJournal(em, 100));
+    EXPECT_EQ(156, cm.getComponentCount());
+    EXPECT_TRUE(cm.gcJournal(em, 100));
+    EXPECT_EQ(128, cm.getComponentCount());
+    for (size_t i = 0; i < 256; i++) {
+        EXPECT_EQ(i % 2 == 1, cm.hasComponent(entities[i]));
+    }
+
+    // overflow the journal, we must fall back to sweeping all components
+    em.destroy(entities[1]);
+    std::vector<Entity> others(EntityManager::getJournalCapacity() + 1);
+    em.create(others.size(), others.data());
+    em.destroy(others.size(), others.data());
+    EXPECT_TRUE(cm.gcJournal(em));
+    EXPECT_EQ(127, cm.getComponentCount());
+    EXPECT_FALSE(cm.hasComponent(entities[1]));
+
+    // after an overflow, components are swept a batch at a time
+    em.destroy(entities[3]);
+    em.create(others.size(), others.data());
+    em.destroy(others.size(), others.data());
+    EXPECT_FALSE(cm.gcJournal(em, 100));
+    EXPECT_FALSE(cm.gcJournal(em, 20));
+    EXPECT_TRUE(cm.hasComponent(entities[3])); // not reached by the sweep yet
+    EXPECT_TRUE(cm.gcJournal(em, 100));
+    EXPECT_EQ(126, cm.getComponentCount());
+    EXPECT_FALSE(cm.hasComponent(entities[3]));
+
+    for (size_t i = 5; i < 256; i += 2) {
+        em.destroy(entities[i]);
+    }
+    EXPECT_TRUE(cm.gcJournal(em));
+    EXPECT_EQ(0, cm.getComponentCount());
+
+    // a manager created after the journal wrapped around doesn't need to sweep
+    em.create(others.size(), others.data());
+    em.destroy(others.size(), others.data());
+    NameComponentManager late(em);
+    EXPECT_TRUE(late.gcJournal(em, 1));
+    Entity e = em.create();
+    late.addComponent(e);
+    em.destroy(e);
+    EXPECT_TRUE(late.gcJournal(em, 1));
+    EXPECT_EQ(0, late.getComponentCount());
+}
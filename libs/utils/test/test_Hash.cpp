@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <utils/Hash.h>
+
+#include <vector>
+
+using namespace utils;
+
+// The reference implementation of MurmurHash64A by Austin Appleby, which requires aligned data.
+static uint64_t referenceMurmurHash64A(const void* key, int len, uint64_t seed) {
+    const uint64_t m = 0xc6a4a7935bd1e995ull;
+    const int r = 47;
+    uint64_t h = seed ^ (len * m);
+    const uint64_t* data = (const uint64_t*) key;
+    const uint64_t* end = data + (len / 8);
+    while (data != end) {
+        uint64_t k = *data++;
+        k *= m;
+        k ^= k >> r;
+        k *= m;
+        h ^= k;
+        h *= m;
+    }
+    const unsigned char* data2 = (const unsigned char*) data;
+    switch (len & 7) {
+        case 7: h ^= uint64_t(data2[6]) << 48;  // fallthrough
+        case 6: h ^= uint64_t(data2[5]) << 40;  // fallthrough
+        case 5: h ^= uint64_t(data2[4]) << 32;  // fallthrough
+        case 4: h ^= uint64_t(data2[3]) << 24;  // fallthrough
+        case 3: h ^= uint64_t(data2[2]) << 16;  // fallthrough
+        case 2: h ^= uint64_t(data2[1]) << 8;   // fallthrough
+        case 1: h ^= uint64_t(data2[0]);
+            h *= m;
+    }
+    h ^= h >> r;
+    h *= m;
+    h ^= h >> r;
+    return h;
+}
+
+TEST(HashTest, Murmur64MatchesReference) {
+    std::vector<uint64_t> storage(16);
+    uint8_t* const bytes = (uint8_t*) storage.data();
+    for (size_t i = 0; i < storage.size() * sizeof(uint64_t); i++) {
+        bytes[i] = uint8_t(i * 31 + 7);
+    }
+    for (int size = 0; size <= 64; size++) {
+        EXPECT_EQ(referenceMurmurHash64A(bytes, size, 0), hash::murmur64(bytes, size));
+        EXPECT_EQ(referenceMurmurHash64A(bytes, size, 42), hash::murmur64(bytes, size, 42));
+    }
+}
+
+TEST(HashTest, Murmur64Unaligned) {
+    std::vector<uint64_t> aligned(16);
+    std::vector<uint64_t> unaligned(17);
+    for (size_t offset = 1; offset < 8; offset++) {
+        uint8_t* const a = (uint8_t*) aligned.data();
+        uint8_t* const u = (uint8_t*) unaligned.data() + offset;
+        for (size_t i = 0; i < aligned.size() * sizeof(uint64_t); i++) {
+            a[i] = u[i] = uint8_t(i * 13 + offset);
+        }
+        for (size_t size = 0; size <= 64; size++) {
+            EXPECT_EQ(hash::murmur64(a, size), hash::murmur64(u, size));
+        }
+    }
+}
+
+TEST(HashTest, Murmur64Content) {
+    uint8_t data[37] = {};
+    const uint64_t h = hash::murmur64(data, sizeof(data));
+    EXPECT_NE(h, hash::murmur64(data, sizeof(data), 1));
+    EXPECT_NE(h, hash::murmur64(data, sizeof(data) - 1));
+    // every byte, including the ones of the tail, changes the hash
+    for (size_t i = 0; i < sizeof(data); i++) {
+        data[i] = 1;
+        EXPECT_NE(h, hash::murmur64(data, sizeof(data)));
+        data[i] = 0;
+    }
+}
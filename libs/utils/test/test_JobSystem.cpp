@@ -342,5 +342,85 @@ TEST(JobSystem, JobSystemDelegates) {
     EXPECT_EQ(4, functor.result);
 
 
+    js.emancipate();
+}
+
+TEST(JobSystem, JobSystemPriority) {
+    JobSystem js(2);
+    js.adopt();
+
+    // background jobs inherit the priority of their parent and all get to run
+    std::atomic_int background = { 0 };
+    JobSystem::Job* root = js.createJob();
+    js.setPriority(root, JobSystem::JobPriority::BACKGROUND);
+    for (int i = 0; i < 64; i++) {
+        js.run(jobs::createJob(js, root, [&background] { background++; }));
+    }
+    root = js.runAndRetain(root);
+
+    // while waiting on a normal job, the adopted thread doesn't run background jobs
+    const auto self = std::this_thread::get_id();
+    std::atomic_bool ranBackgroundHere = { false };
+    JobSystem::Job* slow = js.createJob();
+    js.setPriority(slow, JobSystem::JobPriority::BACKGROUND);
+    for (int i = 0; i < 16; i++) {
+        js.run(jobs::createJob(js, slow, [&ranBackgroundHere, self] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            if (std::this_thread::get_id() == self) {
+                ranBackgroundHere = true;
+            }
+        }));
+    }
+    slow = js.runAndRetain(slow);
+
+    int normal = 0;
+    js.runAndWait(jobs::createJob(js, nullptr, [&normal] { normal++; }));
+    EXPECT_EQ(1, normal);
+    EXPECT_FALSE(ranBackgroundHere);
+
+    js.waitAndRelease(slow);
+    js.waitAndRelease(root);
+    EXPECT_EQ(64, background);
+
+    js.emancipate();
+}
+
+TEST(JobSystem, JobSystemBackgroundWakeUp) {
+    JobSystem js(2);
+    js.adopt();
+
+    // The adopted thread sleeps waiting on a normal job, which runs a background job and waits
+    // for it. The background job must wake up the idle worker, even if the adopted thread, which
+    // ignores background jobs, is woken up first.
+    for (int i = 0; i < 16; i++) {
+        std::atomic_bool done = { false };
+        bool ranInTime = false;
+        js.runAndWait(jobs::createJob(js, nullptr, [&js, &done, &ranInTime] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            JobSystem::Job* background = jobs::createJob(js, nullptr, [&done] { done = true; });
+            js.setPriority(background, JobSystem::JobPriority::BACKGROUND);
+            js.run(background);
+            const auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+            while (!done && std::chrono::steady_clock::now() < timeout) {
+                std::this_thread::yield();
+            }
+            ranInTime = done;
+        }));
+        EXPECT_TRUE(ranInTime);
+    }
+
+    js.emancipate();
+}
+
+TEST(JobSystem, JobSystemCoreGroup) {
+    JobSystem js;
+    js.adopt();
+    EXPECT_TRUE(js.setCoreGroup(JobSystem::CoreGroup::ALL));
+    js.setCoreGroup(JobSystem::CoreGroup::PERFORMANCE);
+
+    int result = 0;
+    js.runAndWait(jobs::createJob(js, nullptr, [&result] { result = 1; }));
+    EXPECT_EQ(1, result);
+
     js.emancipate();
 }
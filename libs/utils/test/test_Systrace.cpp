@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <utils/Systrace.h>
+
+#include <atomic>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+struct CounterEvent {
+    double timestamp;
+    int64_t value;
+    std::string name;
+};
+
+// Returns the counter events of the given thread found in a trace written by SYSTRACE_DUMP.
+std::vector<CounterEvent> readCounters(const char* path, pid_t tid) {
+    std::vector<CounterEvent> events;
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        return events;
+    }
+    char line[256];
+    while (fgets(line, sizeof(line), file)) {
+        double ts;
+        int pid, t;
+        char name[64];
+        int64_t value;
+        if (sscanf(line, R"({"ph":"C","ts":%lf,"pid":%d,"tid":%d,"name":"%63[^"]","args":{"value":%)"
+                SCNd64, &ts, &pid, &t, name, &value) == 5 && t == tid) {
+            events.push_back({ ts, value, name });
+        }
+    }
+    fclose(file);
+    return events;
+}
+
+} // anonymous namespace
+
+TEST(SystraceTest, DumpWhileRecording) {
+    constexpr int64_t COUNT = 500000;
+    const std::string path = testing::TempDir() + "test_systrace.json";
+
+    SYSTRACE_START_RECORDING();
+
+    std::atomic<pid_t> writerTid = { 0 };
+    std::atomic<bool> done = { false };
+    std::thread writer([&]() {
+        writerTid = pid_t(syscall(SYS_gettid));
+        SYSTRACE_CONTEXT();
+        for (int64_t i = 0; i < COUNT; i++) {
+            // The name encodes the parity of the value, so that an event whose name and value
+            // come from two different writes is detected.
+            SYSTRACE_VALUE64((i & 1) ? "odd" : "even", i);
+        }
+        done = true;
+    });
+
+    // Dump repeatedly while the writer wraps around its ring buffer many times: the events that
+    // make it into the file must never be torn and must stay in order.
+    size_t dumps = 0;
+    while (!done || dumps == 0) {
+        ASSERT_TRUE(SYSTRACE_DUMP(path.c_str()));
+        dumps++;
+        const auto events = readCounters(path.c_str(), writerTid);
+        for (size_t i = 0; i < events.size(); i++) {
+            CounterEvent const& e = events[i];
+            ASSERT_GE(e.value, 0);
+            ASSERT_LT(e.value, COUNT);
+            ASSERT_EQ(e.name, (e.value & 1) ? "odd" : "even");
+            if (i > 0) {
+                ASSERT_GT(e.value, events[i - 1].value);
+                ASSERT_GE(e.timestamp, events[i - 1].timestamp);
+            }
+        }
+    }
+    writer.join();
+
+    SYSTRACE_STOP_RECORDING();
+
+    // Once the writer is done, the whole ring buffer is dumped.
+    ASSERT_TRUE(SYSTRACE_DUMP(path.c_str()));
+    const auto events = readCounters(path.c_str(), writerTid);
+    ASSERT_FALSE(events.empty());
+    EXPECT_EQ(events.back().value, COUNT - 1);
+    for (size_t i = 1; i < events.size(); i++) {
+        EXPECT_EQ(events[i].value, events[i - 1].value + 1);
+    }
+
+    remove(path.c_str());
+}
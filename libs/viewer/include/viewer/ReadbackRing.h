@@ -0,0 +1,207 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef VIEWER_READBACK_RING_H
+#define VIEWER_READBACK_RING_H
+
+#include <utils/compiler.h>
+
+#include <memory>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace utils {
+class JobSystem;
+} // namespace utils
+
+namespace filament {
+
+class Engine;
+class Renderer;
+class RenderTarget;
+
+namespace viewer {
+
+/**
+ * ReadbackRing pipelines the read-back of rendered frames, e.g. for video capture.
+ *
+ * Renderer::readPixels() completes asynchronously, several frames after it is issued. Instead of
+ * waiting for each read-back before issuing the next one, the ring keeps a fixed number of pixel
+ * buffers in flight and reuses them across frames. Completed frames are polled with tryAcquire()
+ * and must be given back with release() once the client is done with them.
+ *
+ * Optionally, completed frames are converted on the JobSystem's worker threads before they become
+ * available: alpha can be dropped (RGBA to RGB), linear values can be encoded to sRGB and rows can
+ * be flipped so that the first row is the top of the image.
+ *
+ * Frames are always acquired in the order in which they were read. When all the buffers are in
+ * use, readPixels() does not block, it drops the frame and returns false instead, see
+ * getDroppedFrameCount().
+ *
+ * This is not thread safe, all methods must be called from the thread that owns the Engine. The
+ * ring can be destroyed while read-backs are still in flight.
+ *
+ * Typical usage:
+ * ```
+ * ReadbackRing::Config config;
+ * config.width = width;
+ * config.height = height;
+ * config.format = ReadbackRing::Format::RGB8;
+ * ReadbackRing ring(*engine, config);
+ *
+ * if (renderer->beginFrame(swapChain)) {
+ *     renderer->render(view);
+ *     ring.readPixels(renderer, 0, 0);
+ *     renderer->endFrame();
+ * }
+ * ReadbackRing::Frame frame;
+ * while (ring.tryAcquire(&frame)) {
+ *     encoder.write(frame.data, frame.size);
+ *     ring.release(frame);
+ * }
+ * ```
+ */
+class UTILS_PUBLIC ReadbackRing {
+public:
+    enum class Format : uint8_t {
+        RGBA8,  //!< 4 bytes per pixel
+        RGB8    //!< 3 bytes per pixel, alpha is dropped
+    };
+
+    struct Config {
+        /**
+         * Size in pixels of the region read back by each call to readPixels().
+         */
+        uint32_t width = 0;
+        uint32_t height = 0;
+
+        /**
+         * Number of pixel buffers in flight, at least 1. Read-backs typically complete 2 or 3
+         * frames after they are issued, so fewer than 3 buffers will drop frames.
+         */
+        uint8_t bufferCount = 3;
+
+        /**
+         * Pixel format of the acquired frames.
+         */
+        Format format = Format::RGBA8;
+
+        /**
+         * Whether the color channels are encoded from linear to sRGB. Use this when rendering
+         * into a linear render target.
+         *
+         * The frames are read back as 8-bit values, so it's the 8-bit linear values that are
+         * encoded, which loses most of the precision in the shadows: e.g. linear 0 and 1/255
+         * are encoded as 0 and 13. Rendering into an sRGB render target is preferable when
+         * possible.
+         */
+        bool linearToSrgb = false;
+
+        /**
+         * Whether the first row of the acquired frames is the top of the image, rather than the
+         * bottom as returned by readPixels().
+         */
+        bool flipVertically = false;
+    };
+
+    struct Frame {
+        const uint8_t* data = nullptr;  //!< tightly packed pixels
+        size_t size = 0;                //!< size of data in bytes
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint64_t sequence = 0;          //!< index of the successful readPixels() call
+    };
+
+    ReadbackRing(Engine& engine, Config const& config);
+    ~ReadbackRing();
+
+    ReadbackRing(ReadbackRing const&) = delete;
+    ReadbackRing& operator=(ReadbackRing const&) = delete;
+
+    /**
+     * Reads back the given region of the Renderer's SwapChain into the next free buffer. Must be
+     * called between Renderer::beginFrame() and Renderer::endFrame().
+     *
+     * @return false if no buffer was free, in which case the frame is dropped.
+     */
+    bool readPixels(Renderer* renderer, uint32_t xoffset, uint32_t yoffset);
+
+    /**
+     * Reads back the given region of a RenderTarget into the next free buffer.
+     *
+     * @return false if no buffer was free, in which case the frame is dropped.
+     */
+    bool readPixels(Renderer* renderer, RenderTarget* renderTarget,
+            uint32_t xoffset, uint32_t yoffset);
+
+    /**
+     * Acquires the oldest frame if its read-back and conversion have completed. The data of the
+     * frame remains valid until it is released.
+     *
+     * Read-backs complete when the Engine processes its messages, i.e. during
+     * Renderer::beginFrame() or Engine::pumpMessageQueues().
+     *
+     * @return false if the oldest frame is not available yet, or if there is no frame in flight.
+     */
+    bool tryAcquire(Frame* frame);
+
+    /**
+     * Gives back an acquired frame, so that its buffer can be reused. Frames can be released in
+     * any order.
+     */
+    void release(Frame const& frame);
+
+    /**
+     * Returns the number of frames that have been read but not released yet.
+     */
+    size_t getPendingFrameCount() const noexcept;
+
+    /**
+     * Returns the number of calls to readPixels() that failed because all the buffers were in use.
+     */
+    size_t getDroppedFrameCount() const noexcept { return mDroppedCount; }
+
+    /**
+     * Converts a frame read back as RGBA8, i.e. with its first row at the bottom of the image,
+     * as specified by the format, linearToSrgb and flipVertically fields of the Config. This is
+     * the conversion applied to the frames acquired from a ring.
+     *
+     * @param config    Size and conversion of the frame.
+     * @param src       config.width * config.height RGBA8 pixels.
+     * @param dst       Room for a frame in config.format, must not overlap src.
+     * @param js        If not null, the rows are converted on the JobSystem's threads.
+     */
+    static void convert(Config const& config, const uint8_t* src, uint8_t* dst,
+            utils::JobSystem* js = nullptr) noexcept;
+
+private:
+    struct State;
+
+    bool acquireSlot(uint32_t* slot);
+
+    // Shared with the read-back callbacks, which may run after the ring has been destroyed.
+    std::shared_ptr<State> mState;
+    uint64_t mReadCount = 0;
+    uint64_t mAcquireCount = 0;
+    uint64_t mHeadCount = 0;
+    size_t mDroppedCount = 0;
+};
+
+} // namespace viewer
+} // namespace filament
+
+#endif // VIEWER_READBACK_RING_H
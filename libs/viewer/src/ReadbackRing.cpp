@@ -0,0 +1,315 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <viewer/ReadbackRing.h>
+
+#include <filament/Engine.h>
+#include <filament/Renderer.h>
+
+#include <backend/PixelBufferDescriptor.h>
+
+#include <utils/JobSystem.h>
+#include <utils/Panic.h>
+#include <utils/Systrace.h>
+
+#include <atomic>
+#include <functional>
+
+#include <assert.h>
+#include <math.h>
+#include <string.h>
+
+using namespace utils;
+
+namespace filament {
+namespace viewer {
+
+using PixelBufferDescriptor = backend::PixelBufferDescriptor;
+
+// Everything that the read-back callbacks and the conversion jobs need. The callbacks hold a
+// reference to the state, so the buffers outlive the ring if it is destroyed while read-backs are
+// still in flight.
+struct ReadbackRing::State {
+    enum class SlotState : uint8_t {
+        FREE,
+        READING,    // waiting for the read-back callback
+        CONVERTING, // waiting for the conversion job
+        READY,      // can be acquired
+        ACQUIRED,   // owned by the client until released
+    };
+
+    struct Slot {
+        std::unique_ptr<uint8_t[]> readBuffer;
+        std::unique_ptr<uint8_t[]> convertedBuffer; // only used when a conversion is needed
+        SlotState state = SlotState::FREE;
+        uint64_t sequence = 0;
+        JobSystem::Job* job = nullptr;
+        std::atomic<bool> converted = { false };
+    };
+
+    // Context of a read-back callback.
+    struct Pending {
+        std::shared_ptr<State> state;
+        uint32_t slot;
+    };
+
+    State(JobSystem& js, Config const& config);
+
+    bool needsConversion() const noexcept {
+        return config.format != Format::RGBA8 || config.linearToSrgb || config.flipVertically;
+    }
+
+    size_t getFrameSize() const noexcept {
+        return size_t(config.width) * config.height * (config.format == Format::RGB8 ? 3 : 4);
+    }
+
+    void onReadComplete(uint32_t slot);
+    void convert(uint32_t slot);
+
+    static void onReadPixels(void* buffer, size_t size, void* user);
+
+    JobSystem& jobSystem;
+    const Config config;
+    std::unique_ptr<Slot[]> slots;
+    bool orphaned = false;
+};
+
+// 8-bit linear to 8-bit sRGB
+static const uint8_t* getSrgbTable() noexcept {
+    struct Table {
+        uint8_t values[256];
+        Table() noexcept {
+            for (uint32_t i = 0; i < 256; i++) {
+                const float linear = float(i) / 255.0f;
+                const float encoded = linear <= 0.0031308f ?
+                        linear * 12.92f : 1.055f * powf(linear, 1.0f / 2.4f) - 0.055f;
+                values[i] = uint8_t(encoded * 255.0f + 0.5f);
+            }
+        }
+    };
+    static const Table table;
+    return table.values;
+}
+
+static void convertRow(const uint8_t* UTILS_RESTRICT src, uint8_t* UTILS_RESTRICT dst,
+        uint32_t width, bool dropAlpha, const uint8_t* lut) noexcept {
+    if (dropAlpha) {
+        if (lut) {
+            for (uint32_t x = 0; x < width; x++, src += 4, dst += 3) {
+                dst[0] = lut[src[0]];
+                dst[1] = lut[src[1]];
+                dst[2] = lut[src[2]];
+            }
+        } else {
+            for (uint32_t x = 0; x < width; x++, src += 4, dst += 3) {
+                dst[0] = src[0];
+                dst[1] = src[1];
+                dst[2] = src[2];
+            }
+        }
+    } else if (lut) {
+        for (uint32_t x = 0; x < width; x++, src += 4, dst += 4) {
+            dst[0] = lut[src[0]];
+            dst[1] = lut[src[1]];
+            dst[2] = lut[src[2]];
+            dst[3] = src[3];
+        }
+    } else {
+        memcpy(dst, src, width * 4);
+    }
+}
+
+ReadbackRing::State::State(JobSystem& js, Config const& config)
+        : jobSystem(js), config(config), slots(new Slot[config.bufferCount]) {
+    const size_t readSize = size_t(config.width) * config.height * 4;
+    for (uint32_t i = 0; i < config.bufferCount; i++) {
+        slots[i].readBuffer.reset(new uint8_t[readSize]);
+        if (needsConversion()) {
+            slots[i].convertedBuffer.reset(new uint8_t[getFrameSize()]);
+        }
+    }
+}
+
+void ReadbackRing::State::onReadPixels(void*, size_t, void* user) {
+    Pending* pending = (Pending*) user;
+    std::shared_ptr<State> state = std::move(pending->state);
+    const uint32_t slot = pending->slot;
+    delete pending;
+    if (!state->orphaned) {
+        state->onReadComplete(slot);
+    }
+}
+
+void ReadbackRing::State::onReadComplete(uint32_t index) {
+    Slot& slot = slots[index];
+    assert(slot.state == SlotState::READING);
+    if (!needsConversion()) {
+        slot.state = SlotState::READY;
+        return;
+    }
+
+    slot.state = SlotState::CONVERTING;
+    slot.converted.store(false, std::memory_order_relaxed);
+    JobSystem& js = jobSystem;
+    JobSystem::Job* job = jobs::createJob(js, nullptr, [this, index]() { convert(index); });
+    // conversions must not delay the work of the frames being rendered
+    js.setPriority(job, JobSystem::JobPriority::BACKGROUND);
+    slot.job = js.runAndRetain(job);
+}
+
+void ReadbackRing::State::convert(uint32_t index) {
+    SYSTRACE_CALL();
+    Slot& slot = slots[index];
+    ReadbackRing::convert(config, slot.readBuffer.get(), slot.convertedBuffer.get(), &jobSystem);
+    slot.converted.store(true, std::memory_order_release);
+}
+
+void ReadbackRing::convert(Config const& config, const uint8_t* src, uint8_t* dst,
+        JobSystem* js) noexcept {
+    const uint32_t width = config.width;
+    const uint32_t height = config.height;
+    const bool dropAlpha = config.format == Format::RGB8;
+    const uint8_t* lut = config.linearToSrgb ? getSrgbTable() : nullptr;
+    const size_t srcStride = size_t(width) * 4;
+    const size_t dstStride = size_t(width) * (dropAlpha ? 3 : 4);
+    const bool flip = config.flipVertically;
+
+    auto convertRows = [=](uint32_t start, uint32_t count) {
+        for (uint32_t y = start, end = start + count; y < end; y++) {
+            const uint32_t srcRow = flip ? height - 1 - y : y;
+            convertRow(src + srcRow * srcStride, dst + y * dstStride, width, dropAlpha, lut);
+        }
+    };
+
+    if (js) {
+        js->runAndWait(jobs::parallel_for(*js, nullptr, 0, height,
+                std::cref(convertRows), jobs::CountSplitter<32>()));
+    } else {
+        convertRows(0, height);
+    }
+}
+
+ReadbackRing::ReadbackRing(Engine& engine, Config const& config) {
+    ASSERT_PRECONDITION(config.width > 0 && config.height > 0,
+            "ReadbackRing width and height must be at least 1");
+    ASSERT_PRECONDITION(config.bufferCount > 0, "ReadbackRing bufferCount must be at least 1");
+    mState = std::make_shared<State>(engine.getJobSystem(), config);
+}
+
+ReadbackRing::~ReadbackRing() {
+    // Read-backs still in flight are dropped when their callback runs, but conversions in flight
+    // use the state without holding a reference to it.
+    State& state = *mState;
+    state.orphaned = true;
+    for (uint32_t i = 0; i < state.config.bufferCount; i++) {
+        State::Slot& slot = state.slots[i];
+        if (slot.job) {
+            state.jobSystem.waitAndRelease(slot.job);
+        }
+    }
+}
+
+bool ReadbackRing::acquireSlot(uint32_t* slot) {
+    const uint32_t count = mState->config.bufferCount;
+    if (mReadCount - mHeadCount == count) {
+        mDroppedCount++;
+        return false;
+    }
+    const uint32_t index = uint32_t(mReadCount % count);
+    State::Slot& s = mState->slots[index];
+    assert(s.state == State::SlotState::FREE);
+    s.state = State::SlotState::READING;
+    s.sequence = mReadCount++;
+    *slot = index;
+    return true;
+}
+
+bool ReadbackRing::readPixels(Renderer* renderer, uint32_t xoffset, uint32_t yoffset) {
+    return readPixels(renderer, nullptr, xoffset, yoffset);
+}
+
+bool ReadbackRing::readPixels(Renderer* renderer, RenderTarget* renderTarget,
+        uint32_t xoffset, uint32_t yoffset) {
+    uint32_t slot;
+    if (!acquireSlot(&slot)) {
+        return false;
+    }
+    Config const& config = mState->config;
+    const size_t size = size_t(config.width) * config.height * 4;
+    PixelBufferDescriptor buffer(mState->slots[slot].readBuffer.get(), size,
+            PixelBufferDescriptor::PixelDataFormat::RGBA,
+            PixelBufferDescriptor::PixelDataType::UBYTE,
+            &State::onReadPixels, new State::Pending{ mState, slot });
+    if (renderTarget) {
+        renderer->readPixels(renderTarget, xoffset, yoffset, config.width, config.height,
+                std::move(buffer));
+    } else {
+        renderer->readPixels(xoffset, yoffset, config.width, config.height, std::move(buffer));
+    }
+    return true;
+}
+
+bool ReadbackRing::tryAcquire(Frame* frame) {
+    if (mAcquireCount == mReadCount) {
+        return false;
+    }
+    State& state = *mState;
+    const uint32_t index = uint32_t(mAcquireCount % state.config.bufferCount);
+    State::Slot& slot = state.slots[index];
+    if (slot.state == State::SlotState::CONVERTING) {
+        if (!slot.converted.load(std::memory_order_acquire)) {
+            return false;
+        }
+        state.jobSystem.waitAndRelease(slot.job);
+        slot.job = nullptr;
+        slot.state = State::SlotState::READY;
+    }
+    if (slot.state != State::SlotState::READY) {
+        return false;
+    }
+    slot.state = State::SlotState::ACQUIRED;
+    mAcquireCount++;
+
+    frame->data = state.needsConversion() ? slot.convertedBuffer.get() : slot.readBuffer.get();
+    frame->size = state.getFrameSize();
+    frame->width = state.config.width;
+    frame->height = state.config.height;
+    frame->sequence = slot.sequence;
+    return true;
+}
+
+void ReadbackRing::release(Frame const& frame) {
+    State& state = *mState;
+    const uint32_t count = state.config.bufferCount;
+    State::Slot& slot = state.slots[frame.sequence % count];
+    ASSERT_PRECONDITION(slot.state == State::SlotState::ACQUIRED && slot.sequence == frame.sequence,
+            "ReadbackRing frame %llu was not acquired", (unsigned long long) frame.sequence);
+    slot.state = State::SlotState::FREE;
+
+    // buffers are reused in order, so released frames only free their buffer once all the frames
+    // before them have been released too
+    while (mHeadCount < mAcquireCount &&
+            state.slots[mHeadCount % count].state == State::SlotState::FREE) {
+        mHeadCount++;
+    }
+}
+
+size_t ReadbackRing::getPendingFrameCount() const noexcept {
+    return size_t(mReadCount - mHeadCount);
+}
+
+} // namespace viewer
+} // namespace filament
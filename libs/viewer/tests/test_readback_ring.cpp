@@ -0,0 +1,287 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <viewer/ReadbackRing.h>
+
+#include <filament/Engine.h>
+#include <filament/RenderTarget.h>
+#include <filament/Renderer.h>
+#include <filament/Texture.h>
+
+#include <utils/JobSystem.h>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+
+#include <string.h>
+
+using namespace filament;
+using namespace filament::viewer;
+
+class ReadbackRingTest : public testing::Test {
+protected:
+    static constexpr uint32_t WIDTH = 4;
+    static constexpr uint32_t HEIGHT = 2;
+
+    void SetUp() override {
+        mEngine = Engine::create(Engine::Backend::NOOP);
+        mRenderer = mEngine->createRenderer();
+        mTexture = Texture::Builder()
+                .width(WIDTH)
+                .height(HEIGHT)
+                .usage(Texture::Usage::COLOR_ATTACHMENT | Texture::Usage::SAMPLEABLE)
+                .format(Texture::InternalFormat::RGBA8)
+                .build(*mEngine);
+        mRenderTarget = RenderTarget::Builder()
+                .texture(RenderTarget::AttachmentPoint::COLOR, mTexture)
+                .build(*mEngine);
+    }
+
+    void TearDown() override {
+        mEngine->destroy(mRenderTarget);
+        mEngine->destroy(mTexture);
+        mEngine->destroy(mRenderer);
+        Engine::destroy(&mEngine);
+    }
+
+    bool readPixels(ReadbackRing& ring) {
+        return ring.readPixels(mRenderer, mRenderTarget, 0, 0);
+    }
+
+    // runs the read-backs issued so far and their callbacks
+    void completeReadbacks() {
+        mEngine->flushAndWait();
+        mEngine->pumpMessageQueues();
+    }
+
+    // waits for the conversion of the oldest frame, if any
+    bool acquire(ReadbackRing& ring, ReadbackRing::Frame* frame) {
+        for (int i = 0; i < 1000; i++) {
+            if (ring.tryAcquire(frame)) {
+                return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return false;
+    }
+
+    Engine* mEngine = nullptr;
+    Renderer* mRenderer = nullptr;
+    Texture* mTexture = nullptr;
+    RenderTarget* mRenderTarget = nullptr;
+};
+
+TEST_F(ReadbackRingTest, AcquireInOrder) {
+    ReadbackRing::Config config;
+    config.width = WIDTH;
+    config.height = HEIGHT;
+    ReadbackRing ring(*mEngine, config);
+
+    ReadbackRing::Frame frame;
+    EXPECT_FALSE(ring.tryAcquire(&frame));
+
+    ASSERT_TRUE(readPixels(ring));
+    ASSERT_TRUE(readPixels(ring));
+    EXPECT_EQ(2, ring.getPendingFrameCount());
+
+    // frames are only available once their read-back has completed
+    EXPECT_FALSE(ring.tryAcquire(&frame));
+    completeReadbacks();
+
+    for (uint64_t sequence = 0; sequence < 2; sequence++) {
+        ASSERT_TRUE(ring.tryAcquire(&frame));
+        EXPECT_EQ(sequence, frame.sequence);
+        EXPECT_EQ(WIDTH, frame.width);
+        EXPECT_EQ(HEIGHT, frame.height);
+        EXPECT_EQ(WIDTH * HEIGHT * 4, frame.size);
+        EXPECT_NE(nullptr, frame.data);
+        ring.release(frame);
+    }
+    EXPECT_FALSE(ring.tryAcquire(&frame));
+    EXPECT_EQ(0, ring.getPendingFrameCount());
+    EXPECT_EQ(0, ring.getDroppedFrameCount());
+}
+
+TEST_F(ReadbackRingTest, DropWhenFull) {
+    ReadbackRing::Config config;
+    config.width = WIDTH;
+    config.height = HEIGHT;
+    config.bufferCount = 3;
+    ReadbackRing ring(*mEngine, config);
+
+    for (int i = 0; i < 3; i++) {
+        ASSERT_TRUE(readPixels(ring));
+    }
+    EXPECT_FALSE(readPixels(ring));
+    EXPECT_EQ(1, ring.getDroppedFrameCount());
+    EXPECT_EQ(3, ring.getPendingFrameCount());
+
+    // acquired frames still hold their buffer
+    completeReadbacks();
+    ReadbackRing::Frame frames[3];
+    for (auto& frame : frames) {
+        ASSERT_TRUE(ring.tryAcquire(&frame));
+    }
+    EXPECT_FALSE(readPixels(ring));
+    EXPECT_EQ(2, ring.getDroppedFrameCount());
+
+    // dropped frames don't use a sequence number
+    ring.release(frames[0]);
+    ASSERT_TRUE(readPixels(ring));
+    completeReadbacks();
+    ReadbackRing::Frame frame;
+    ASSERT_TRUE(ring.tryAcquire(&frame));
+    EXPECT_EQ(3, frame.sequence);
+    ring.release(frame);
+    ring.release(frames[1]);
+    ring.release(frames[2]);
+    EXPECT_EQ(0, ring.getPendingFrameCount());
+}
+
+TEST_F(ReadbackRingTest, ReleaseOutOfOrder) {
+    ReadbackRing::Config config;
+    config.width = WIDTH;
+    config.height = HEIGHT;
+    config.bufferCount = 3;
+    ReadbackRing ring(*mEngine, config);
+
+    for (int i = 0; i < 3; i++) {
+        ASSERT_TRUE(readPixels(ring));
+    }
+    completeReadbacks();
+    ReadbackRing::Frame frames[3];
+    for (auto& frame : frames) {
+        ASSERT_TRUE(ring.tryAcquire(&frame));
+    }
+
+    // buffers are reused in order, releasing a later frame doesn't free a buffer
+    ring.release(frames[1]);
+    EXPECT_EQ(3, ring.getPendingFrameCount());
+    EXPECT_FALSE(readPixels(ring));
+
+    // releasing the oldest frame frees its buffer and the one of the frame released before
+    ring.release(frames[0]);
+    EXPECT_EQ(1, ring.getPendingFrameCount());
+    ASSERT_TRUE(readPixels(ring));
+    ASSERT_TRUE(readPixels(ring));
+    EXPECT_FALSE(readPixels(ring));
+    EXPECT_EQ(2, ring.getDroppedFrameCount());
+
+    ring.release(frames[2]);
+    completeReadbacks();
+    for (uint64_t sequence = 3; sequence < 5; sequence++) {
+        ReadbackRing::Frame frame;
+        ASSERT_TRUE(ring.tryAcquire(&frame));
+        EXPECT_EQ(sequence, frame.sequence);
+        ring.release(frame);
+    }
+    EXPECT_EQ(0, ring.getPendingFrameCount());
+}
+
+TEST_F(ReadbackRingTest, ConvertedFrames) {
+    ReadbackRing::Config config;
+    config.width = WIDTH;
+    config.height = HEIGHT;
+    config.format = ReadbackRing::Format::RGB8;
+    config.linearToSrgb = true;
+    config.flipVertically = true;
+    ReadbackRing ring(*mEngine, config);
+
+    ASSERT_TRUE(readPixels(ring));
+    ASSERT_TRUE(readPixels(ring));
+    completeReadbacks();
+    for (uint64_t sequence = 0; sequence < 2; sequence++) {
+        ReadbackRing::Frame frame;
+        ASSERT_TRUE(acquire(ring, &frame));
+        EXPECT_EQ(sequence, frame.sequence);
+        EXPECT_EQ(WIDTH * HEIGHT * 3, frame.size);
+        ring.release(frame);
+    }
+
+    // the ring can be destroyed with read-backs and conversions in flight
+    ASSERT_TRUE(readPixels(ring));
+    mEngine->flushAndWait();
+}
+
+TEST(ReadbackRingConversionTest, Convert) {
+    constexpr uint32_t WIDTH = 2;
+    constexpr uint32_t HEIGHT = 2;
+    // bottom row first, as read back
+    const uint8_t src[WIDTH * HEIGHT * 4] = {
+            0,   1,   2,   3,     4,   5,   6,   7,
+            255, 128, 64,  11,    12,  13,  14,  15,
+    };
+
+    ReadbackRing::Config config;
+    config.width = WIDTH;
+    config.height = HEIGHT;
+
+    {
+        uint8_t dst[WIDTH * HEIGHT * 4];
+        ReadbackRing::convert(config, src, dst);
+        EXPECT_EQ(0, memcmp(src, dst, sizeof(dst)));
+    }
+
+    {
+        // alpha is dropped
+        config.format = ReadbackRing::Format::RGB8;
+        uint8_t dst[WIDTH * HEIGHT * 3];
+        ReadbackRing::convert(config, src, dst);
+        const uint8_t expected[] = {
+                0,   1,   2,      4,   5,   6,
+                255, 128, 64,     12,  13,  14,
+        };
+        EXPECT_EQ(0, memcmp(expected, dst, sizeof(dst)));
+    }
+
+    {
+        // rows are flipped
+        config.flipVertically = true;
+        uint8_t dst[WIDTH * HEIGHT * 3];
+        ReadbackRing::convert(config, src, dst);
+        const uint8_t expected[] = {
+                255, 128, 64,     12,  13,  14,
+                0,   1,   2,      4,   5,   6,
+        };
+        EXPECT_EQ(0, memcmp(expected, dst, sizeof(dst)));
+    }
+
+    {
+        // the color channels are encoded to sRGB, alpha is kept as is
+        config.format = ReadbackRing::Format::RGBA8;
+        config.flipVertically = false;
+        config.linearToSrgb = true;
+        uint8_t dst[WIDTH * HEIGHT * 4];
+        ReadbackRing::convert(config, src, dst);
+        EXPECT_EQ(0, dst[0]);
+        EXPECT_EQ(13, dst[1]);
+        EXPECT_EQ(3, dst[3]);
+        EXPECT_EQ(255, dst[8]);
+        EXPECT_EQ(188, dst[9]);
+        EXPECT_EQ(137, dst[10]);
+        EXPECT_EQ(11, dst[11]);
+
+        // the JobSystem doesn't change the result
+        utils::JobSystem js;
+        js.adopt();
+        uint8_t parallel[WIDTH * HEIGHT * 4];
+        ReadbackRing::convert(config, src, parallel, &js);
+        js.emancipate();
+        EXPECT_EQ(0, memcmp(dst, parallel, sizeof(dst)));
+    }
+}
@@ -35,6 +35,17 @@ struct ShadowData {
     float nearOverFarMinusNear;
 };
 
+struct PerRenderableData {
+    highp mat4 worldFromModelMatrix;
+    highp mat3 worldFromModelNormalMatrix;
+    highp uint morphTargetCount;
+    highp uint flags;
+    highp uint channels;
+    highp uint objectId;
+    highp float userData;
+    highp vec4 reserved[7];
+};
+
 struct BoneData {
     highp mat3x4 transform;    // bone transform is mat4x3 stored in row-major (last row [0,0,0,1])
     highp uvec4 cof;           // 8 first cofactor matrix of transform's upper left
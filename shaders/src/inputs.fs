@@ -13,6 +13,10 @@ LAYOUT_LOCATION(6) SHADING_INTERPOLATION in mediump vec4 vertex_worldTangent;
 
 LAYOUT_LOCATION(7) in highp vec4 vertex_position;
 
+LAYOUT_LOCATION(8) flat in highp int instance_index;
+
+#define objectUniforms objectsUniforms.data[instance_index]
+
 #if defined(HAS_ATTRIBUTE_COLOR)
 LAYOUT_LOCATION(9) in mediump vec4 vertex_color;
 #endif
@@ -67,6 +67,17 @@ LAYOUT_LOCATION(6) SHADING_INTERPOLATION out mediump vec4 vertex_worldTangent;
 
 LAYOUT_LOCATION(7) out highp vec4 vertex_position;
 
+// index of this instance's data in the per-renderable UBO, see main.vs
+LAYOUT_LOCATION(8) flat out highp int instance_index;
+
+#if defined(FILAMENT_VULKAN_SEMANTICS)
+#define instance_id gl_InstanceIndex
+#else
+#define instance_id gl_InstanceID
+#endif
+
+#define objectUniforms objectsUniforms.data[instance_index]
+
 #if defined(HAS_ATTRIBUTE_COLOR)
 LAYOUT_LOCATION(9) out mediump vec4 vertex_color;
 #endif
@@ -7,6 +7,9 @@
  */
 
 void main() {
+    // Instanced draws index the per-renderable UBO with the instance, others bind it at an offset
+    instance_index = instance_id;
+
     // Initialize the inputs to sensible default values, see material_inputs.vs
 #if defined(USE_OPTIMIZED_DEPTH_VERTEX_SHADER)
 
@@ -0,0 +1,199 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <filament/Engine.h>
+
+#include <gltfio/AssetLoader.h>
+#include <gltfio/FilamentAsset.h>
+#include <gltfio/MaterialProvider.h>
+#include <gltfio/ResourceLoader.h>
+
+#include <backend/FileBlobCache.h>
+
+#include <getopt/getopt.h>
+
+#include <utils/EntityManager.h>
+#include <utils/NameComponentManager.h>
+#include <utils/Path.h>
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace filament;
+using namespace gltfio;
+
+using filament::backend::FileBlobCache;
+using utils::Path;
+
+struct Config {
+    std::string cacheDir;
+    size_t maxSize = 256u * 1024u * 1024u;
+    bool recomputeBoundingBoxes = true;
+};
+
+static void printUsage(const char* name) {
+    std::string execName(Path(name).getName());
+    std::string usage(
+            "GLTF-BAKE stores the data that gltfio derives from glTF assets into a cache\n"
+            "Usage:\n"
+            "    GLTF-BAKE [options] --cache-dir=<directory> <gltf or glb file> ...\n"
+            "\n"
+            "The cache directory can then be used with backend::FileBlobCache and\n"
+            "ResourceConfiguration::cache to skip mesh decompression, tangent generation and\n"
+            "bounding box computations when loading the same assets at runtime.\n"
+            "\n"
+            "Options:\n"
+            "   --help, -h\n"
+            "       Print this message\n\n"
+            "   --license\n"
+            "       Print copyright and license information\n\n"
+            "   --cache-dir=<directory>, -d <directory>\n"
+            "       Directory of the cache, created if needed\n\n"
+            "   --max-size=<megabytes>, -s <megabytes>\n"
+            "       Maximum size of the cache, 256 MiB by default\n\n"
+            "   --no-bounds, -n\n"
+            "       Do not bake the recomputed bounding boxes of the primitives\n\n"
+    );
+
+    const std::string from("GLTF-BAKE");
+    for (size_t pos = usage.find(from); pos != std::string::npos; pos = usage.find(from, pos)) {
+        usage.replace(pos, from.length(), execName);
+    }
+    printf("%s", usage.c_str());
+}
+
+static void license() {
+    static const char *license[] = {
+        #include "licenses/licenses.inc"
+        nullptr
+    };
+
+    const char **p = &license[0];
+    while (*p)
+        std::cout << *p++ << std::endl;
+}
+
+static int handleArguments(int argc, char* argv[], Config* config) {
+    static constexpr const char* OPTSTR = "hld:s:n";
+    static const struct option OPTIONS[] = {
+            { "help",      no_argument,       0, 'h' },
+            { "license",   no_argument,       0, 'l' },
+            { "cache-dir", required_argument, 0, 'd' },
+            { "max-size",  required_argument, 0, 's' },
+            { "no-bounds", no_argument,       0, 'n' },
+            { 0, 0, 0, 0 }  // termination of the option list
+    };
+
+    int opt;
+    int optionIndex = 0;
+
+    while ((opt = getopt_long(argc, argv, OPTSTR, OPTIONS, &optionIndex)) >= 0) {
+        std::string arg(optarg ? optarg : "");
+        switch (opt) {
+            default:
+            case 'h':
+                printUsage(argv[0]);
+                exit(0);
+            case 'l':
+                license();
+                exit(0);
+            case 'd':
+                config->cacheDir = arg;
+                break;
+            case 's':
+                config->maxSize = size_t(std::stoul(arg)) * 1024u * 1024u;
+                break;
+            case 'n':
+                config->recomputeBoundingBoxes = false;
+                break;
+        }
+    }
+
+    return optind;
+}
+
+static bool bake(AssetLoader* loader, ResourceConfiguration config, Path const& filename) {
+    std::ifstream in(filename.c_str(), std::ifstream::binary | std::ifstream::in);
+    if (!in) {
+        std::cerr << "Unable to open " << filename << std::endl;
+        return false;
+    }
+    std::vector<uint8_t> buffer(std::istreambuf_iterator<char>(in), {});
+
+    FilamentAsset* asset = filename.getExtension() == "glb" ?
+            loader->createAssetFromBinary(buffer.data(), buffer.size()) :
+            loader->createAssetFromJson(buffer.data(), buffer.size());
+    if (!asset) {
+        std::cerr << "Unable to parse " << filename << std::endl;
+        return false;
+    }
+
+    // The baked data is stored by loadResources().
+    const std::string gltfPath = filename.getAbsolutePath();
+    config.gltfPath = gltfPath.c_str();
+    ResourceLoader resourceLoader(config);
+    const bool success = resourceLoader.loadResources(asset);
+    if (!success) {
+        std::cerr << "Unable to load the resources of " << filename << std::endl;
+    }
+
+    loader->destroyAsset(asset);
+    return success;
+}
+
+int main(int argc, char* argv[]) {
+    Config config;
+    int optionIndex = handleArguments(argc, argv, &config);
+    int numArgs = argc - optionIndex;
+    if (numArgs < 1 || config.cacheDir.empty()) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    Path cacheDir(config.cacheDir);
+    if (!cacheDir.exists() && !cacheDir.mkdirRecursive()) {
+        std::cerr << "Unable to create " << cacheDir << std::endl;
+        return 1;
+    }
+    FileBlobCache cache(cacheDir.c_str(), config.maxSize);
+
+    // Nothing is rendered, the engine is only needed to create the entities and buffers.
+    Engine* engine = Engine::create(Engine::Backend::NOOP);
+    MaterialProvider* materials = createUbershaderLoader(engine);
+    utils::NameComponentManager names(utils::EntityManager::get());
+    AssetLoader* loader = AssetLoader::create({ engine, materials, &names });
+
+    ResourceConfiguration resourceConfig = {};
+    resourceConfig.engine = engine;
+    resourceConfig.normalizeSkinningWeights = true;
+    resourceConfig.recomputeBoundingBoxes = config.recomputeBoundingBoxes;
+    resourceConfig.cache = &cache;
+
+    int result = 0;
+    for (int i = optionIndex; i < argc; i++) {
+        if (!bake(loader, resourceConfig, Path(argv[i]))) {
+            result = 1;
+        }
+    }
+
+    AssetLoader::destroy(&loader);
+    materials->destroyMaterials();
+    delete materials;
+    Engine::destroy(&engine);
+    return result;
+}
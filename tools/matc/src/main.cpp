@@ -16,9 +16,11 @@
 
 #include <stdlib.h>
 
+#include <fstream>
 #include <iostream>
 #include <memory>
 
+#include "matc/BatchCompiler.h"
 #include "matc/Compiler.h"
 #include "matc/CommandlineConfig.h"
 #include "matc/MaterialCompiler.h"
@@ -32,6 +34,22 @@ int main(int argc, char** argv) {
         return EXIT_FAILURE;
     }
 
+    if (!parameters.getBatchFile().empty()) {
+        BatchCompiler batchCompiler(parameters);
+        bool success;
+        if (parameters.getBatchFile() == "-") {
+            success = batchCompiler.run(std::cin);
+        } else {
+            std::ifstream in(parameters.getBatchFile());
+            if (!in) {
+                std::cerr << "Unable to open batch file " << parameters.getBatchFile() << std::endl;
+                return EXIT_FAILURE;
+            }
+            success = batchCompiler.run(in);
+        }
+        return success ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
     const std::unique_ptr<Compiler> compiler = std::make_unique<MaterialCompiler>();
 
     if (!compiler->start(parameters)) {
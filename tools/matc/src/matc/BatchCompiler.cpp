@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "BatchCompiler.h"
+
+#include <filamat/MaterialBuilder.h>
+
+#include <utils/JobSystem.h>
+
+#include "CommandlineConfig.h"
+#include "MaterialCompiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <ctype.h>
+
+using namespace filamat;
+using namespace utils;
+
+namespace matc {
+
+namespace {
+
+// The command line of one material. The configuration refers to the arguments, which must
+// outlive it.
+struct Request {
+    std::vector<std::string> args;
+    std::vector<char*> argv;
+    std::unique_ptr<CommandlineConfig> config;
+};
+
+} // anonymous namespace
+
+// Splits a line into arguments separated by white spaces. Double quotes can be used for arguments
+// that contain white spaces. Returns false if a quote is not closed.
+static bool tokenize(const std::string& line, std::vector<std::string>& args) {
+    std::string arg;
+    bool hasArg = false;
+    bool quoted = false;
+    for (char c : line) {
+        if (c == '"') {
+            quoted = !quoted;
+            hasArg = true;
+        } else if (!quoted && isspace((unsigned char) c)) {
+            if (hasArg) {
+                args.push_back(std::move(arg));
+                arg.clear();
+                hasArg = false;
+            }
+        } else {
+            arg += c;
+            hasArg = true;
+        }
+    }
+    if (hasArg) {
+        args.push_back(std::move(arg));
+    }
+    return !quoted;
+}
+
+BatchCompiler::BatchCompiler(const Config& config) noexcept
+        : mCacheDirectory(config.getCacheDirectory()) {
+}
+
+bool BatchCompiler::run(std::istream& in) {
+    using clock = std::chrono::steady_clock;
+
+    MaterialBuilder::init();
+    JobSystem js;
+    js.adopt();
+
+    // Each material waits for its own jobs while it's being compiled, which lets the waiting
+    // thread run the jobs of other materials, and so on. Bounding the number of materials in
+    // flight bounds how deep these waits nest.
+    const size_t maxInFlight = std::max(1u, std::thread::hardware_concurrency());
+
+    std::mutex lock;
+    std::condition_variable condition;
+    size_t inFlight = 0;
+    bool success = true;
+
+    auto report = [&](bool compiled, clock::duration duration, const std::string& name) {
+        const double ms = std::chrono::duration<double, std::milli>(duration).count();
+        std::lock_guard<std::mutex> guard(lock);
+        std::cout << (compiled ? "ok " : "failed ") << ms << " " << name << std::endl;
+        success = success && compiled;
+    };
+
+    auto compile = [&](Request const& request) {
+        const clock::time_point start = clock::now();
+        MaterialCompiler compiler;
+        const bool compiled = compiler.compile(*request.config, js);
+        report(compiled, clock::now() - start, request.config->getInput()->getName());
+    };
+
+    JobSystem::Job* root = js.createJob();
+    bool first = true;
+    std::string line;
+    while (std::getline(in, line)) {
+        auto request = std::make_shared<Request>();
+        request->args.emplace_back("matc");
+        if (!tokenize(line, request->args)) {
+            report(false, {}, line);
+            continue;
+        }
+        if (request->args.size() == 1 || request->args[1][0] == '#') {
+            // Skip empty lines and comments.
+            continue;
+        }
+        for (std::string& arg : request->args) {
+            request->argv.push_back(arg.data());
+        }
+
+        request->config = std::make_unique<CommandlineConfig>(
+                int(request->argv.size()), request->argv.data());
+        Config& config = *request->config;
+        if (config.getCacheDirectory().empty()) {
+            config.setCacheDirectory(mCacheDirectory);
+        }
+        if (!config.isValid() || config.rawShaderMode() ||
+                !MaterialCompiler().checkParameters(config)) {
+            if (config.rawShaderMode()) {
+                std::cerr << "Raw shaders cannot be compiled in batch mode." << std::endl;
+            }
+            report(false, {}, line);
+            continue;
+        }
+
+        // glslang isn't thread-safe until it has compiled a first shader, and MaterialBuilder
+        // ensures this by compiling the first variant of a material on its own. Compile the first
+        // material on its own as well, so that later materials can start concurrently.
+        if (first) {
+            compile(*request);
+            first = false;
+            continue;
+        }
+
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            condition.wait(guard, [&]() { return inFlight < maxInFlight; });
+            inFlight++;
+        }
+        js.run(jobs::createJob(js, root, [&, request]() {
+            compile(*request);
+            std::lock_guard<std::mutex> guard(lock);
+            inFlight--;
+            condition.notify_one();
+        }));
+    }
+    js.runAndWait(root);
+
+    js.emancipate();
+    MaterialBuilder::shutdown();
+    return success;
+}
+
+} // namespace matc
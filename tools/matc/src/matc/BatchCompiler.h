@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TNT_BATCHCOMPILER_H
+#define TNT_BATCHCOMPILER_H
+
+#include <istream>
+#include <string>
+
+#include "Config.h"
+
+namespace matc {
+
+// Compiles many materials in a single run, see --batch.
+//
+// Each line of the input holds the command line of one material, without the name of the
+// executable. Materials are compiled concurrently on a single JobSystem as the lines are read, so
+// the input can be a pipe that a build system keeps feeding. For each material, a line made of its
+// status ("ok" or "failed"), its compilation time in milliseconds and its input file is printed on
+// the standard output when it completes. Since materials complete out of order, the input file
+// identifies the request that the line answers.
+//
+// The MaterialBuilder is initialized once, and the first material is compiled on its own, after
+// which glslang can be used from several threads at the same time.
+class BatchCompiler {
+public:
+    // Options of the batch configuration that apply to every material, e.g. the cache directory.
+    explicit BatchCompiler(const Config& config) noexcept;
+
+    // Returns false if a line could not be parsed or a material could not be compiled.
+    bool run(std::istream& in);
+
+private:
+    const std::string mCacheDirectory;
+};
+
+} // namespace matc
+
+#endif // TNT_BATCHCOMPILER_H
@@ -67,6 +67,18 @@ static void usage(char* name) {
             "       This variant filter is merged with the filter from the material, if any\n\n"
             "   --version, -v\n"
             "       Print the material version number\n\n"
+            "   --compress, -z\n"
+            "       Compress SPIR-V shaders further, for smaller packages that take a little\n"
+            "       longer to load\n\n"
+            "   --cache-dir=<directory>, -c <directory>\n"
+            "       Reuse the shaders compiled by previous runs from the given directory, and store\n"
+            "       the newly compiled ones there. Concurrent runs can share the directory.\n\n"
+            "   --batch=<file>, -b <file>\n"
+            "       Compile many materials in a single run. Each line of the file holds the options\n"
+            "       and the input file of one material, e.g. -a all -o out.filamat in.mat\n"
+            "       Use - to read the lines from the standard input as they come. The status and\n"
+            "       compilation time of each material are printed on the standard output.\n"
+            "       --cache-dir applies to every material, other options must be given per line.\n\n"
             "Internal use and debugging only:\n"
             "   --optimize-none, -g\n"
             "       Disable all shader optimizations, for debugging\n\n"
@@ -153,7 +165,7 @@ static void parseDefine(std::string defineString,
 }
 
 bool CommandlineConfig::parse() {
-    static constexpr const char* OPTSTR = "hlxo:f:dm:a:p:D:OSEr:vV:gtw";
+    static constexpr const char* OPTSTR = "hlxo:f:dm:a:p:D:OSEr:vV:gtwc:b:z";
     static const struct option OPTIONS[] = {
             { "help",                    no_argument, nullptr, 'h' },
             { "license",                 no_argument, nullptr, 'l' },
@@ -173,12 +185,19 @@ bool CommandlineConfig::parse() {
             { "print",                   no_argument, nullptr, 't' },
             { "version",                 no_argument, nullptr, 'v' },
             { "raw",                     no_argument, nullptr, 'w' },
+            { "cache-dir",         required_argument, nullptr, 'c' },
+            { "batch",             required_argument, nullptr, 'b' },
+            { "compress",                no_argument, nullptr, 'z' },
             { nullptr, 0, nullptr, 0 }  // termination of the option list
     };
 
     int opt;
     int option_index = 0;
 
+    // Batch mode parses several command lines.
+    optind = 1;
+    optreset = 1;
+
     while ((opt = getopt_long(mArgc, mArgv, OPTSTR, OPTIONS, &option_index)) >= 0) {
         std::string arg(optarg ? optarg : "");
         switch (opt) {
@@ -271,6 +290,15 @@ bool CommandlineConfig::parse() {
             case 'w':
                 mRawShaderMode = true;
                 break;
+            case 'c':
+                mCacheDirectory = arg;
+                break;
+            case 'b':
+                mBatchFile = arg;
+                break;
+            case 'z':
+                mCompressSpirv = true;
+                break;
         }
     }
 
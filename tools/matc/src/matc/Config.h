@@ -110,6 +110,10 @@ public:
         return mRawShaderMode;
     }
 
+    bool compressSpirv() const noexcept {
+        return mCompressSpirv;
+    }
+
     uint8_t getVariantFilter() const noexcept {
         return mVariantFilter;
     }
@@ -118,11 +122,24 @@ public:
         return mDefines;
     }
 
+    const std::string& getCacheDirectory() const noexcept {
+        return mCacheDirectory;
+    }
+
+    void setCacheDirectory(std::string directory) noexcept {
+        mCacheDirectory = std::move(directory);
+    }
+
+    const std::string& getBatchFile() const noexcept {
+        return mBatchFile;
+    }
+
 protected:
     bool mDebug = false;
     bool mIsValid = true;
     bool mPrintShaders = false;
     bool mRawShaderMode = false;
+    bool mCompressSpirv = false;
     Optimization mOptimizationLevel = Optimization::PERFORMANCE;
     Metadata mReflectionTarget = Metadata::NONE;
     Platform mPlatform = Platform::ALL;
@@ -130,6 +147,8 @@ protected:
     TargetApi mTargetApi = (TargetApi) 0;
     std::unordered_map<std::string, std::string> mDefines;
     uint8_t mVariantFilter = 0;
+    std::string mCacheDirectory;
+    std::string mBatchFile;
 };
 
 }
@@ -31,6 +31,7 @@
 #include "JsonishLexer.h"
 #include "JsonishParser.h"
 #include "ParametersProcessor.h"
+#include "ShaderCache.h"
 
 #include <GlslangToSpv.h>
 
@@ -258,6 +259,35 @@ bool MaterialCompiler::isValidJsonStart(const char* buffer, size_t size) const n
 }
 
 bool MaterialCompiler::run(const Config& config) {
+    if (config.rawShaderMode()) {
+        Config::Input* input = config.getInput();
+        ssize_t size = input->open();
+        if (size <= 0) {
+            std::cerr << "Input file is empty" << std::endl;
+            return false;
+        }
+        auto buffer = input->read();
+
+        const std::string extension = utils::Path(input->getName()).getExtension();
+        glslang::InitializeProcess();
+        bool success = compileRawShader(buffer.get(), size, config.isDebug(), config.getOutput(),
+                extension.c_str());
+        glslang::FinalizeProcess();
+        return success;
+    }
+
+    MaterialBuilder::init();
+    JobSystem js;
+    js.adopt();
+
+    bool success = compile(config, js);
+
+    js.emancipate();
+    MaterialBuilder::shutdown();
+    return success;
+}
+
+bool MaterialCompiler::compile(const Config& config, JobSystem& js) {
     Config::Input* input = config.getInput();
     ssize_t size = input->open();
     if (size <= 0) {
@@ -269,16 +299,6 @@ bool MaterialCompiler::run(const Config& config) {
     utils::Path materialFilePath = utils::Path(input->getName()).getAbsolutePath();
     assert(materialFilePath.isFile());
 
-    if (config.rawShaderMode()) {
-        const std::string extension = materialFilePath.getExtension();
-        glslang::InitializeProcess();
-        bool success = compileRawShader(buffer.get(), size, config.isDebug(), config.getOutput(),
-                extension.c_str());
-        glslang::FinalizeProcess();
-        return success;
-    }
-
-    MaterialBuilder::init();
     MaterialBuilder builder;
     // Before attempting an expensive lex, let's find out if we were sent pure JSON.
     bool parsed;
@@ -311,21 +331,22 @@ bool MaterialCompiler::run(const Config& config) {
         .optimization(config.getOptimizationLevel())
         .printShaders(config.printShaders())
         .generateDebugInfo(config.isDebug())
+        .compressSpirv(config.compressSpirv())
         .variantFilter(config.getVariantFilter() | builder.getVariantFilter());
 
     for (const auto& define : config.getDefines()) {
         builder.shaderDefine(define.first.c_str(), define.second.c_str());
     }
 
-    JobSystem js;
-    js.adopt();
+    std::unique_ptr<ShaderCache> shaderCache;
+    if (!config.getCacheDirectory().empty()) {
+        shaderCache = std::make_unique<ShaderCache>(config.getCacheDirectory());
+        builder.shaderCache(shaderCache.get());
+    }
 
     // Write builder.build() to output.
     Package package = builder.build(js);
 
-    js.emancipate();
-    MaterialBuilder::shutdown();
-
     if (!package.isValid()) {
         std::cerr << "Could not compile material " << input->getName() << std::endl;
         return false;
@@ -26,6 +26,9 @@
 namespace filamat {
 class MaterialBuilder;
 }
+namespace utils {
+class JobSystem;
+}
 class TestMaterialCompiler;
 
 namespace matc {
@@ -39,6 +42,12 @@ public:
 
     bool checkParameters(const Config& config) override;
 
+    // Compiles the material of the given configuration using a JobSystem that the calling thread
+    // has adopted. Unlike run(), this doesn't initialize the MaterialBuilder, and doesn't support
+    // the raw shader mode. This is used to compile many materials in a single run, see
+    // BatchCompiler.
+    bool compile(const Config& config, utils::JobSystem& js);
+
 private:
     friend class ::TestMaterialCompiler;
 
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ShaderCache.h"
+
+#include <utils/Hash.h>
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace utils;
+
+namespace matc {
+
+// Each blob file holds the size of the key, the key, then the value.
+using KeySize = uint64_t;
+
+ShaderCache::ShaderCache(Path directory) noexcept : mDirectory(std::move(directory)) {
+    if (!mDirectory.exists()) {
+        mDirectory.mkdirRecursive();
+    }
+    // Temporary files must have unique names across all the processes using the cache.
+    std::random_device device;
+    char suffix[32];
+    snprintf(suffix, sizeof(suffix), ".%08x%08x", device(), device());
+    mTempSuffix = suffix;
+}
+
+Path ShaderCache::getBlobPath(const void* key, size_t keySize) const noexcept {
+    char name[32];
+    snprintf(name, sizeof(name), "%016" PRIx64 ".blob", hash::fnv1a(key, keySize));
+    return mDirectory.concat(name);
+}
+
+void ShaderCache::insert(const void* key, size_t keySize,
+        const void* value, size_t valueSize) noexcept {
+    Path path = getBlobPath(key, keySize);
+    if (path.exists()) {
+        return;
+    }
+    Path temp(path.getPath() + mTempSuffix + std::to_string(mTempCount++));
+    FILE* file = fopen(temp.c_str(), "wb");
+    if (!file) {
+        return;
+    }
+    const KeySize size = keySize;
+    bool ok = fwrite(&size, sizeof(size), 1, file) == 1;
+    ok = ok && fwrite(key, keySize, 1, file) == 1;
+    ok = ok && fwrite(value, valueSize, 1, file) == 1;
+    ok = (fclose(file) == 0) && ok;
+    // rename() doesn't replace existing files on all platforms, in which case another process has
+    // already inserted the same blob.
+    if (!ok || ::rename(temp.c_str(), path.c_str()) != 0) {
+        temp.unlinkFile();
+    }
+}
+
+size_t ShaderCache::retrieve(const void* key, size_t keySize,
+        void* value, size_t valueSize) noexcept {
+    std::unique_ptr<FILE, decltype(&fclose)> file(
+            fopen(getBlobPath(key, keySize).c_str(), "rb"), &fclose);
+    if (!file) {
+        return 0;
+    }
+
+    // Check the key, in case of a hash collision.
+    KeySize size = 0;
+    if (fread(&size, sizeof(size), 1, file.get()) != 1 || size != keySize) {
+        return 0;
+    }
+    std::vector<uint8_t> storedKey(keySize);
+    if (fread(storedKey.data(), keySize, 1, file.get()) != 1 ||
+            memcmp(storedKey.data(), key, keySize) != 0) {
+        return 0;
+    }
+
+    const long start = ftell(file.get());
+    if (start < 0 || fseek(file.get(), 0, SEEK_END) != 0) {
+        return 0;
+    }
+    const long end = ftell(file.get());
+    if (end <= start || fseek(file.get(), start, SEEK_SET) != 0) {
+        return 0;
+    }
+    const size_t blobSize = size_t(end - start);
+    if (valueSize < blobSize) {
+        return blobSize;
+    }
+    return fread(value, blobSize, 1, file.get()) == 1 ? blobSize : 0;
+}
+
+} // namespace matc
@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TNT_SHADERCACHE_H_
+#define TNT_SHADERCACHE_H_
+
+#include <backend/Platform.h>
+
+#include <utils/Path.h>
+
+#include <atomic>
+#include <string>
+
+namespace matc {
+
+// The cache of compiled shaders shared by matc runs, see --cache-dir.
+//
+// Unlike backend::FileBlobCache, this cache can be used by several matc processes at the same time,
+// which is what happens when a build system compiles materials in parallel. Each blob is written
+// to a temporary file that is then renamed, and since a given key always maps to the same
+// compiled shader, it doesn't matter which process wins. Blobs are never evicted, the directory can
+// be deleted at any time to clear the cache.
+class ShaderCache : public filament::backend::Platform::BlobCache {
+public:
+    explicit ShaderCache(utils::Path directory) noexcept;
+
+    void insert(const void* key, size_t keySize,
+            const void* value, size_t valueSize) noexcept override;
+
+    size_t retrieve(const void* key, size_t keySize,
+            void* value, size_t valueSize) noexcept override;
+
+private:
+    utils::Path getBlobPath(const void* key, size_t keySize) const noexcept;
+
+    const utils::Path mDirectory;
+    std::string mTempSuffix;
+    std::atomic<uint32_t> mTempCount = 0;
+};
+
+} // namespace matc
+
+#endif
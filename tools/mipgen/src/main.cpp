@@ -50,6 +50,7 @@ static bool g_grayscale = false;
 static bool g_ktxContainer = false;
 static bool g_linearized = false;
 static bool g_quietMode = false;
+static bool g_streaming = false;
 static uint32_t g_mipLevelCount = 0;
 
 static const char* USAGE = R"TXT(
@@ -90,6 +91,10 @@ Options:
    --mip-levels=N, -m N
        specifies the number of mip levels to generate
        if 0 (default), all levels are generated
+   --streaming, -S
+       generate each miplevel from rows streamed out of the input file instead of decoding
+       the whole image, this bounds memory usage for very large images but cannot be combined
+       with --grayscale, --add-alpha, --strip-alpha, the "normals" kernel or KTX output
    --compression=COMPRESSION, -c COMPRESSION
        format specific compression:
 )TXT"
@@ -159,7 +164,7 @@ static void license() {
 }
 
 static int handleArguments(int argc, char* argv[]) {
-    static constexpr const char* OPTSTR = "hLlgpf:c:k:saqm:";
+    static constexpr const char* OPTSTR = "hLlgpf:c:k:saqm:S";
     static const struct option OPTIONS[] = {
             { "help",                 no_argument, 0, 'h' },
             { "license",              no_argument, 0, 'L' },
@@ -173,6 +178,7 @@ static int handleArguments(int argc, char* argv[]) {
             { "add-alpha",            no_argument, 0, 'a' },
             { "quiet",                no_argument, 0, 'q' },
             { "mip-levels",     required_argument, 0, 'm' },
+            { "streaming",            no_argument, 0, 'S' },
             { 0, 0, 0, 0 }  // termination of the option list
     };
 
@@ -214,6 +220,9 @@ static int handleArguments(int argc, char* argv[]) {
             case 'q':
                 g_quietMode = true;
                 break;
+            case 'S':
+                g_streaming = true;
+                break;
             case 'f':
                 if (arg == "png") {
                     g_format = ImageEncoder::Format::PNG;
@@ -260,6 +269,123 @@ static int handleArguments(int argc, char* argv[]) {
     return optind;
 }
 
+static uint32_t getMipLevelCount(uint32_t width, uint32_t height) {
+    uint32_t count = 0;
+    while (width > 1 || height > 1) {
+        ++count;
+        width = std::max(width >> 1u, 1u);
+        height = std::max(height >> 1u, 1u);
+    }
+    return g_mipLevelCount == 0 ? count : min(g_mipLevelCount - 1, count);
+}
+
+static bool generateGallery(const Path& inputPath, const std::string& outputPattern,
+        uint32_t width, uint32_t height, uint32_t count) {
+    if (!g_quietMode) {
+        puts("Generating mipmaps.html...");
+    }
+
+    char path[256];
+    char tag[256];
+    const char* pattern = R"(<image src="%s" width="%dpx" height="%dpx">)";
+    ofstream html("mipmaps.html", ios::trunc);
+    html << HTML_PREFIX;
+    int result = snprintf(tag, sizeof(tag), pattern, inputPath.c_str(), width, height);
+    if (result < 0 || result >= sizeof(tag)) {
+        cerr << "Output pattern is too long." << endl;
+        return false;
+    }
+    html << tag << std::endl;
+    for (uint32_t mip = 1; mip <= count; mip++) {
+        snprintf(path, sizeof(path), outputPattern.c_str(), mip);
+        result = snprintf(tag, sizeof(tag), pattern, path, width, height);
+        if (result < 0 || result >= sizeof(tag)) {
+            cerr << "Output pattern is too long." << endl;
+            return false;
+        }
+        html << tag << std::endl;
+    }
+    html << HTML_SUFFIX;
+    return true;
+}
+
+// Generates each miplevel by resampling rows streamed from the input file straight into the
+// encoder, so that neither the source image nor the miplevels are ever fully held in memory.
+// The input is decoded once per miplevel, which trades decoding time for a bounded footprint.
+static int generateStreaming(const Path& inputPath, const std::string& outputPattern) {
+    if (g_ktxContainer || g_grayscale || g_addAlpha || g_stripAlpha ||
+            g_filter == Filter::GAUSSIAN_NORMALS) {
+        cerr << "Streaming cannot be used with KTX output, --grayscale, --add-alpha, "
+                "--strip-alpha or the normals kernel." << endl;
+        return 1;
+    }
+
+    const auto sourceSpace =
+            g_linearized ? ImageDecoder::ColorSpace::LINEAR : ImageDecoder::ColorSpace::SRGB;
+    const ImageSampler sampler { .horizontalFilter = g_filter, .verticalFilter = g_filter };
+
+    if (!g_quietMode) {
+        puts("Generating miplevels...");
+    }
+
+    uint32_t sourceWidth = 0;
+    uint32_t sourceHeight = 0;
+    uint32_t count = 0;
+    char path[256];
+    for (uint32_t mip = 1; mip == 1 || mip <= count; mip++) {
+        ifstream inputStream(inputPath.getPath(), ios::binary);
+        auto source = ImageDecoder::createRowSource(inputStream, inputPath.getPath(), sourceSpace);
+        if (!source) {
+            cerr << "Unable to open image: " << inputPath.getPath() << endl;
+            return 1;
+        }
+        if (mip == 1) {
+            sourceWidth = source->getWidth();
+            sourceHeight = source->getHeight();
+            count = getMipLevelCount(sourceWidth, sourceHeight);
+            if (count == 0) {
+                break;
+            }
+        }
+
+        const uint32_t width = std::max(sourceWidth >> mip, 1u);
+        const uint32_t height = std::max(sourceHeight >> mip, 1u);
+        int result = snprintf(path, sizeof(path), outputPattern.c_str(), mip);
+        if (result < 0 || result >= sizeof(path)) {
+            cerr << "Output pattern is too long." << endl;
+            return 1;
+        }
+        Path(path).getParent().mkdirRecursive();
+        ofstream outputStream(path, ios::binary | ios::trunc);
+        if (!outputStream) {
+            cerr << "The output file cannot be opened: " << path << endl;
+            continue;
+        }
+        auto sink = ImageEncoder::createRowSink(outputStream, g_format, width, height,
+                source->getChannels(), g_compression, path);
+        if (!sink || !resampleImage(*source, *sink, width, height, sampler)) {
+            cerr << "An error occurred while encoding the image." << endl;
+            return 1;
+        }
+        sink.reset();
+        outputStream.close();
+        if (!outputStream) {
+            cerr << "An error occurred while writing the output file: " << path << endl;
+            return 1;
+        }
+    }
+
+    if (g_createGallery && !generateGallery(inputPath, outputPattern,
+            sourceWidth, sourceHeight, count)) {
+        return 1;
+    }
+
+    if (!g_quietMode) {
+        puts("Done.");
+    }
+    return 0;
+}
+
 int main(int argc, char* argv[]) {
     int optionIndex = handleArguments(argc, argv);
     int numArgs = argc - optionIndex;
@@ -276,6 +402,10 @@ int main(int argc, char* argv[]) {
         g_format = ImageEncoder::chooseFormat(outputPattern, g_linearized);
     }
 
+    if (g_streaming) {
+        return generateStreaming(inputPath, outputPattern);
+    }
+
     if (!g_quietMode) {
         puts("Reading image...");
     }
@@ -455,34 +585,9 @@ int main(int argc, char* argv[]) {
         }
     }
 
-    if (g_createGallery) {
-        if (!g_quietMode) {
-            puts("Generating mipmaps.html...");
-        }
-
-        char tag[256];
-        mip = 1;
-        const char* pattern = R"(<image src="%s" width="%dpx" height="%dpx">)";
-        const uint32_t width = sourceImage.getWidth();
-        const uint32_t height = sourceImage.getHeight();
-        ofstream html("mipmaps.html", ios::trunc);
-        html << HTML_PREFIX;
-        int result = snprintf(tag, sizeof(tag), pattern, inputPath.c_str(), width, height);
-        if (result < 0 || result >= sizeof(tag)) {
-            cerr << "Output pattern is too long." << endl;
-            return 1;
-        }
-        html << tag << std::endl;
-        for (auto image: miplevels) {
-            snprintf(path, sizeof(path), outputPattern.c_str(), mip++);
-            result = snprintf(tag, sizeof(tag), pattern, path, width, height);
-            if (result < 0 || result >= sizeof(tag)) {
-                cerr << "Output pattern is too long." << endl;
-                return 1;
-            }
-            html << tag << std::endl;
-        }
-        html << HTML_SUFFIX;
+    if (g_createGallery && !generateGallery(inputPath, outputPattern,
+            sourceImage.getWidth(), sourceImage.getHeight(), miplevels.size())) {
+        return 1;
     }
 
     if (!g_quietMode) {